@@ -0,0 +1,304 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "async_image_store.h"
+#include "thread_pool.h"
+
+#include <iostream>
+#include <exception>
+#include <algorithm>
+
+#ifdef _WIN32
+#undef min
+#undef max
+#endif
+
+namespace rcg
+{
+
+AsyncImageStore::AsyncImageStore(size_t nthreads, size_t _queue_size)
+{
+  queue_size=std::max(static_cast<size_t>(1), _queue_size);
+  busy=0;
+  running=true;
+
+  stat.queue_depth=0;
+  stat.max_queue_depth=0;
+  stat.written=0;
+  stat.dropped=0;
+  stat.failed=0;
+  stat.bytes=0;
+  stat.bytes_per_second=0;
+  started=false;
+
+  nthreads=ThreadPool::getNumThreads(nthreads);
+
+  for (size_t i=0; i<nthreads; i++)
+  {
+    worker.push_back(std::thread(&AsyncImageStore::run, this));
+  }
+}
+
+AsyncImageStore::~AsyncImageStore()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    running=false;
+  }
+
+  queue_cond.notify_all();
+
+  for (size_t i=0; i<worker.size(); i++)
+  {
+    worker[i].join();
+  }
+}
+
+void AsyncImageStore::setCallback(const StoreCallback &cb)
+{
+  std::lock_guard<std::mutex> lock(cb_mtx);
+  callback=cb;
+}
+
+void AsyncImageStore::setPngOptions(const PngOptions &opt)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  png=opt;
+}
+
+bool AsyncImageStore::storeImage(const std::string &name, ImgFmt fmt,
+                                 const std::shared_ptr<const Image> &image,
+                                 size_t yoffset, size_t height)
+{
+  Job job;
+
+  job.disparity=false;
+  job.name=name;
+  job.fmt=fmt;
+  job.image=image;
+  job.yoffset=yoffset;
+  job.height=height;
+  job.inv=-1;
+  job.scale=1;
+  job.offset=0;
+
+  return push(job);
+}
+
+bool AsyncImageStore::storeImageAsDisparityPFM(const std::string &name,
+                                               const std::shared_ptr<const Image> &image,
+                                               int inv, float scale, float offset)
+{
+  Job job;
+
+  job.disparity=true;
+  job.name=name;
+  job.fmt=PNM;
+  job.image=image;
+  job.yoffset=0;
+  job.height=0;
+  job.inv=inv;
+  job.scale=scale;
+  job.offset=offset;
+
+  return push(job);
+}
+
+void AsyncImageStore::flush()
+{
+  std::unique_lock<std::mutex> lock(mtx);
+
+  while (queue.size() > 0 || busy > 0)
+  {
+    idle_cond.wait(lock);
+  }
+}
+
+size_t AsyncImageStore::getQueueDepth()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return queue.size();
+}
+
+AsyncImageStoreStatistics AsyncImageStore::getStatistics()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+
+  AsyncImageStoreStatistics ret=stat;
+
+  ret.queue_depth=queue.size();
+
+  if (started)
+  {
+    double t=std::chrono::duration<double>(time_last-time_start).count();
+
+    if (t > 0)
+    {
+      ret.bytes_per_second=static_cast<double>(stat.bytes)/t;
+    }
+  }
+
+  return ret;
+}
+
+bool AsyncImageStore::push(const Job &job)
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    if (queue.size() >= queue_size)
+    {
+      stat.dropped++;
+      return false;
+    }
+
+    queue.push_back(job);
+    queue.back().png=png;
+
+    if (!started)
+    {
+      started=true;
+      time_start=std::chrono::steady_clock::now();
+      time_last=time_start;
+    }
+
+    stat.max_queue_depth=std::max(stat.max_queue_depth, queue.size());
+  }
+
+  queue_cond.notify_one();
+
+  return true;
+}
+
+void AsyncImageStore::run()
+{
+  std::unique_lock<std::mutex> lock(mtx);
+
+  while (true)
+  {
+    // wait for the next job, remaining jobs are done before terminating
+
+    while (running && queue.size() == 0)
+    {
+      queue_cond.wait(lock);
+    }
+
+    if (queue.size() == 0)
+    {
+      break;
+    }
+
+    Job job=std::move(queue.front());
+    queue.pop_front();
+    busy++;
+
+    lock.unlock();
+
+    // encode and write image
+
+    std::string name;
+    uint64_t size=0;
+
+    try
+    {
+      if (job.disparity)
+      {
+        name=rcg::storeImageAsDisparityPFM(job.name, *job.image, job.inv, job.scale, job.offset,
+                                           &size);
+      }
+      else
+      {
+        name=rcg::storeImage(job.name, job.fmt, *job.image, job.yoffset, job.height, job.png,
+                             &size);
+      }
+    }
+    catch (const std::exception &ex)
+    {
+      std::cerr << "AsyncImageStore: " << ex.what() << std::endl;
+      name.clear();
+    }
+
+    job.image.reset();
+
+    bool ok=(name.size() > 0);
+
+    if (ok)
+    {
+      std::lock_guard<std::mutex> cblock(cb_mtx);
+
+      if (callback)
+      {
+        // an exception of the callback must not terminate the worker thread
+
+        try
+        {
+          callback(name);
+        }
+        catch (const std::exception &ex)
+        {
+          std::cerr << "AsyncImageStore: Callback for '" << name << "': " << ex.what() << std::endl;
+          ok=false;
+        }
+        catch (...)
+        {
+          std::cerr << "AsyncImageStore: Callback for '" << name << "' failed" << std::endl;
+          ok=false;
+        }
+      }
+    }
+
+    lock.lock();
+
+    if (ok)
+    {
+      stat.written++;
+      stat.bytes+=size;
+    }
+    else
+    {
+      stat.failed++;
+    }
+
+    time_last=std::chrono::steady_clock::now();
+    busy--;
+
+    if (queue.size() == 0 && busy == 0)
+    {
+      idle_cond.notify_all();
+    }
+  }
+}
+
+}
@@ -0,0 +1,226 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_ASYNC_IMAGE_STORE
+#define RC_GENICAM_API_ASYNC_IMAGE_STORE
+
+#include "image_store.h"
+
+#include <memory>
+#include <string>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+
+namespace rcg
+{
+
+/**
+  Callback that is invoked by a writer thread with the full name of each
+  stored image.
+*/
+
+typedef std::function<void (const std::string &name)> StoreCallback;
+
+/**
+  Counters of an asynchronous image store.
+*/
+
+struct AsyncImageStoreStatistics
+{
+  size_t queue_depth;       // number of images that are waiting for storage
+  size_t max_queue_depth;   // maximum number of waiting images
+  uint64_t written;         // number of images that have been stored
+  uint64_t dropped;         // number of images that were dropped because the
+                            // queue was full
+  uint64_t failed;          // number of images that could not be stored or
+                            // for which the callback threw an exception
+  uint64_t bytes;           // number of bytes that have been written
+  double bytes_per_second;  // bytes that have been written per second of
+                            // storage time
+};
+
+/**
+  Stores images in the background. Images are put into a bounded queue, from
+  which they are taken by a pool of writer threads that encode and write them
+  with storeImage() or storeImageAsDisparityPFM(). Images that are created
+  from leased buffers (see Stream::grabLeased()) are stored without copying
+  the pixels.
+
+  Errors are reported on std::cerr and counted.
+*/
+
+class AsyncImageStore
+{
+  public:
+
+    /**
+      Creates the store and starts the writer threads.
+
+      @param nthreads   Number of writer threads. 0 means that the number of
+                        cores is used.
+      @param queue_size Maximum number of images that wait for storage.
+    */
+
+    AsyncImageStore(size_t nthreads=1, size_t queue_size=16);
+
+    /**
+      Stores all images that are still in the queue and stops the writer
+      threads.
+    */
+
+    ~AsyncImageStore();
+
+    /**
+      Sets a callback that is called after an image has been stored. Calls
+      are serialized, so that the callback may e.g. print to std::cout. If the
+      callback throws an exception, then it is reported on std::cerr and the
+      image is counted as failed.
+
+      @param cb Callback.
+    */
+
+    void setCallback(const StoreCallback &cb);
+
+    /**
+      Sets the options that are used for storing images in PNG format. They
+      apply to all images that are queued afterwards.
+
+      @param opt PNG options.
+    */
+
+    void setPngOptions(const PngOptions &opt);
+
+    /**
+      Queues the image for storing with storeImage().
+
+      @param name    Name of output file without suffix.
+      @param fmt     Image file format.
+      @param image   Image to be stored.
+      @param yoffset First image row to be stored.
+      @param height  Number of image rows to be stored. 0 means all rows.
+      @return        False, if the image has been dropped because the queue
+                     is full.
+    */
+
+    bool storeImage(const std::string &name, ImgFmt fmt,
+                    const std::shared_ptr<const Image> &image,
+                    size_t yoffset=0, size_t height=0);
+
+    /**
+      Queues the image for storing with storeImageAsDisparityPFM().
+
+      @param name   Name of output file without suffix.
+      @param image  Image to be stored.
+      @param inv    Value to mark invalid pixels.
+      @param scale  Scale factor for valid values.
+      @param offset Offset for valid values.
+      @return       False, if the image has been dropped because the queue is
+                    full.
+    */
+
+    bool storeImageAsDisparityPFM(const std::string &name,
+                                  const std::shared_ptr<const Image> &image,
+                                  int inv, float scale, float offset);
+
+    /**
+      Waits until all queued images have been stored.
+    */
+
+    void flush();
+
+    /**
+      Returns the number of images that are waiting for storage.
+
+      @return Queue depth.
+    */
+
+    size_t getQueueDepth();
+
+    /**
+      Returns the counters.
+
+      @return Statistics.
+    */
+
+    AsyncImageStoreStatistics getStatistics();
+
+  private:
+
+    AsyncImageStore(class AsyncImageStore &); // forbidden
+    AsyncImageStore &operator=(const AsyncImageStore &); // forbidden
+
+    struct Job
+    {
+      bool disparity;
+      std::string name;
+      ImgFmt fmt;
+      PngOptions png;
+      std::shared_ptr<const Image> image;
+      size_t yoffset, height;
+      int inv;
+      float scale, offset;
+    };
+
+    bool push(const Job &job);
+    void run();
+
+    std::vector<std::thread> worker;
+
+    std::mutex mtx;
+    std::condition_variable queue_cond;
+    std::condition_variable idle_cond;
+    std::deque<Job> queue;
+    size_t queue_size;
+    size_t busy;
+    bool running;
+    PngOptions png;
+
+    std::mutex cb_mtx;
+    StoreCallback callback;
+
+    AsyncImageStoreStatistics stat;
+    bool started;
+    std::chrono::steady_clock::time_point time_start;
+    std::chrono::steady_clock::time_point time_last;
+};
+
+}
+
+#endif
@@ -36,6 +36,7 @@
 #include "buffer.h"
 #include "stream.h"
 #include "config.h"
+#include "chunk_decoder.h"
 
 #include "gentl_wrapper.h"
 #include "exception.h"
@@ -44,6 +45,10 @@
 #include <GenApi/ChunkAdapterU3V.h>
 #include <GenApi/ChunkAdapterGeneric.h>
 
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
 namespace rcg
 {
 
@@ -125,6 +130,83 @@ template<class T> inline T getBufferPartValue(const std::shared_ptr<const GenTLW
   return ret;
 }
 
+/*
+  Pointers are cached like all other values of a buffer.
+*/
+
+inline uint64_t fromPtr(void *p)
+{
+  return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p));
+}
+
+inline void *toPtr(uint64_t v)
+{
+  return reinterpret_cast<void *>(static_cast<uintptr_t>(v));
+}
+
+/*
+  Returns the list of chunks of the buffer as reported by the transport
+  layer. The list is cached in the decoder for each chunk layout ID.
+*/
+
+const std::vector<ChunkDecoder::Chunk> &getChunkList(const std::shared_ptr<const GenTLWrapper> &gentl,
+                                                     void *stream, void *buffer,
+                                                     ChunkDecoder &decoder, uint64_t layout_id)
+{
+  const std::vector<ChunkDecoder::Chunk> *chunk=decoder.getLayout(layout_id);
+
+  if (chunk == 0)
+  {
+    size_t n=0;
+    std::vector<GenTL::SINGLE_CHUNK_DATA> list;
+
+    if (gentl->DSGetBufferChunkData(stream, buffer, 0, &n) == GenTL::GC_ERR_SUCCESS && n > 0)
+    {
+      list.resize(n);
+
+      if (gentl->DSGetBufferChunkData(stream, buffer, list.data(), &n) != GenTL::GC_ERR_SUCCESS)
+      {
+        n=0;
+      }
+    }
+
+    std::vector<ChunkDecoder::Chunk> c(std::min(n, list.size()));
+
+    for (size_t i=0; i<c.size(); i++)
+    {
+      c[i].id=list[i].ChunkID;
+      c[i].offset=static_cast<size_t>(list[i].ChunkOffset);
+      c[i].length=list[i].ChunkLength;
+    }
+
+    chunk=decoder.setLayout(layout_id, c);
+  }
+
+  return *chunk;
+}
+
+}
+
+ChunkData::ChunkData()
+{
+  const double nan=std::numeric_limits<double>::quiet_NaN();
+
+  width=-1;
+  height=-1;
+  exposure_time=nan;
+  gain=nan;
+  scan3d_focal_length=nan;
+  scan3d_baseline=nan;
+  scan3d_principal_point_u=nan;
+  scan3d_principal_point_v=nan;
+  scan3d_coordinate_scale=nan;
+  scan3d_coordinate_offset=nan;
+  scan3d_invalid_data_flag=-1;
+  scan3d_invalid_data_value=nan;
+  line_status_all=-1;
+  rc_noise=nan;
+  rc_brightness=nan;
+  rc_out1_reduction=nan;
 }
 
 Buffer::Buffer(const std::shared_ptr<const GenTLWrapper> &_gentl, Stream *_parent)
@@ -132,21 +214,33 @@ Buffer::Buffer(const std::shared_ptr<const GenTLWrapper> &_gentl, Stream *_paren
   parent=_parent;
   gentl=_gentl;
   buffer=0;
+  payload_type=PAYLOAD_TYPE_UNKNOWN;
   multipart=false;
+  nparts=0;
+  ts_freq=0;
+  generic=false;
+  lazy=false;
+
+  memset(info, 0, sizeof(info));
+  info_known=0;
 }
 
 Buffer::~Buffer()
 {
-  if (chunkadapter)
-  {
-    chunkadapter->DetachBuffer();
-  }
+  detachChunkData();
 }
 
-void Buffer::setNodemap(const std::shared_ptr<GenApi::CNodeMapRef> _nodemap, const std::string &tltype)
+void Buffer::setNodemap(const std::shared_ptr<GenApi::CNodeMapRef> _nodemap, const std::string &tltype,
+                        bool _lazy)
 {
+  detachChunkData();
+
   nodemap=_nodemap;
   chunkadapter.reset();
+  decoder.reset();
+  attachment.reset();
+  generic=false;
+  lazy=_lazy;
 
   if (nodemap != 0)
   {
@@ -163,158 +257,650 @@ void Buffer::setNodemap(const std::shared_ptr<GenApi::CNodeMapRef> _nodemap, con
       else
       {
         chunkadapter=std::shared_ptr<GenApi::CChunkAdapter>(new GenApi::CChunkAdapterGeneric(nodemap->_Ptr));
+        generic=true;
       }
+
+      decoder=std::make_shared<ChunkDecoder>(nodemap);
+
+      attachment=std::make_shared<ChunkAttachment>();
+      attachment->owner=0;
     }
   }
 }
 
+void Buffer::shareNodemap(const Buffer &other)
+{
+  detachChunkData();
+
+  nodemap=other.nodemap;
+  chunkadapter=other.chunkadapter;
+  decoder=other.decoder;
+  attachment=other.attachment;
+  generic=other.generic;
+  lazy=true;
+}
+
 void Buffer::setHandle(void *handle)
 {
+  // the previous buffer must not stay attached, as it may be requeued
+
+  detachChunkData();
+
   buffer=handle;
 
   payload_type=PAYLOAD_TYPE_UNKNOWN;
   multipart=false;
+  nparts=0;
+
+  // all values are queried again on first access
+
+  memset(info, 0, sizeof(info));
+  info_known=0;
+  parts.clear();
 
   if (buffer != 0)
   {
-    payload_type=getBufferValue<size_t>(gentl, parent->getHandle(), buffer,
-                                        GenTL::BUFFER_INFO_PAYLOADTYPE);
+    void *stream=parent->getHandle();
+
+    payload_type=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_PAYLOADTYPE);
+    multipart=(payload_type == PAYLOAD_TYPE_MULTI_PART);
 
-    multipart=getBufferValue<size_t>(gentl, parent->getHandle(), buffer,
-                                     GenTL::BUFFER_INFO_PAYLOADTYPE) == PAYLOAD_TYPE_MULTI_PART;
+    // a buffer that is not multipart is treated as having one part
 
-    if (chunkadapter && !getBufferBool(gentl, parent->getHandle(), buffer,
-      GenTL::BUFFER_INFO_IS_INCOMPLETE))
+    PartInfo unknown;
+    memset(&unknown, 0, sizeof(unknown));
+
+    if (multipart)
     {
-      chunkadapter->AttachBuffer(reinterpret_cast<uint8_t *>(
-        getBufferValue<void *>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_BASE)),
-        static_cast<int64_t>(getBufferValue<size_t>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_SIZE_FILLED)));
+      gentl->DSGetNumBufferParts(stream, buffer, &nparts);
+      parts.assign(nparts, unknown);
     }
-  }
-  else
-  {
-    if (chunkadapter)
+    else
     {
-      chunkadapter->DetachBuffer();
+      if (payload_type != PAYLOAD_TYPE_CHUNK_ONLY)
+      {
+        nparts=1;
+      }
+
+      parts.assign(1, unknown);
+    }
+
+    // attach buffer to the nodemap for accessing chunk data
+
+    if (!lazy || payload_type == PAYLOAD_TYPE_CHUNK_DATA)
+    {
+      attachChunkData();
+    }
+
+    // in case of chunk data payload, image information is taken from chunk
+    // values
+
+    if (payload_type == PAYLOAD_TYPE_CHUNK_DATA && nodemap)
+    {
+      try
+      {
+        setInfo(INFO_TIMESTAMP, getInteger(nodemap, "ChunkTimestamp", 0, 0, true));
+      }
+      catch (const std::exception &)
+      {
+        // ignore error and keep value of transport layer
+      }
+
+      try
+      {
+        setPartInfo(0, PART_WIDTH, getInteger(nodemap, "ChunkWidth", 0, 0, true));
+      }
+      catch (const std::exception &)
+      { }
+
+      try
+      {
+        int64_t height=getInteger(nodemap, "ChunkHeight", 0, 0, true);
+        setPartInfo(0, PART_HEIGHT, height);
+        setPartInfo(0, PART_DELIVERED_HEIGHT, height);
+      }
+      catch (const std::exception &)
+      { }
+
+      try
+      {
+        setPartInfo(0, PART_XOFFSET, getInteger(nodemap, "ChunkOffsetX", 0, 0, true));
+      }
+      catch (const std::exception &)
+      { }
+
+      try
+      {
+        setPartInfo(0, PART_YOFFSET, getInteger(nodemap, "ChunkOffsetY", 0, 0, true));
+      }
+      catch (const std::exception &)
+      { }
+
+      try
+      {
+        setPartInfo(0, PART_FORMAT, getInteger(nodemap, "ChunkPixelFormat", 0, 0, true));
+      }
+      catch (const std::exception &)
+      { }
+
+      setPartInfo(0, PART_IMAGE_PRESENT, 1);
     }
   }
 }
 
-uint32_t Buffer::getNumberOfParts() const
+void Buffer::attachChunkData() const
 {
-  uint32_t ret=0;
+  if (chunkadapter && buffer != 0 && !getIsIncomplete())
+  {
+    std::lock_guard<std::mutex> lock(attachment->mtx);
+    attachLocked();
+  }
+}
 
-  if (multipart)
+void Buffer::attachLocked() const
+{
+  if (attachment->owner != this)
   {
-    gentl->DSGetNumBufferParts(parent->getHandle(), buffer, &ret);
+    if (generic)
+    {
+      // the generic chunk adapter cannot parse the buffer, it needs the list
+      // of chunks from the transport layer
+
+      const std::vector<ChunkDecoder::Chunk> &chunk=getChunkList(gentl, parent->getHandle(),
+                                                                 buffer, *decoder,
+                                                                 getChunkLayoutID());
+
+      std::vector<GenApi::SingleChunkData_t> list(chunk.size());
+
+      for (size_t i=0; i<chunk.size(); i++)
+      {
+        list[i].ChunkID=chunk[i].id;
+        list[i].ChunkOffset=static_cast<ptrdiff_t>(chunk[i].offset);
+        list[i].ChunkLength=chunk[i].length;
+      }
+
+      static_cast<GenApi::CChunkAdapterGeneric *>(chunkadapter.get())->AttachBuffer(
+        reinterpret_cast<uint8_t *>(getGlobalBase()), list.data(),
+        static_cast<int64_t>(list.size()));
+    }
+    else
+    {
+      chunkadapter->AttachBuffer(reinterpret_cast<uint8_t *>(getGlobalBase()),
+                                 static_cast<int64_t>(getSizeFilled()));
+    }
+
+    attachment->owner=this;
   }
-  else
+}
+
+void Buffer::detachChunkData()
+{
+  if (attachment)
   {
-    size_t type=getBufferValue<size_t>(gentl, parent->getHandle(), buffer,
-                                       GenTL::BUFFER_INFO_PAYLOADTYPE);
+    std::lock_guard<std::mutex> lock(attachment->mtx);
 
-    if (type != PAYLOAD_TYPE_CHUNK_ONLY)
+    if (attachment->owner == this)
     {
-      ret=1;
+      chunkadapter->DetachBuffer();
+      attachment->owner=0;
     }
   }
+}
 
-  return ret;
+bool Buffer::getChunkData(ChunkData &data, const std::string &component) const
+{
+  data=ChunkData();
+
+  if (!decoder || buffer == 0 || !getContainsChunkdata() || getIsIncomplete())
+  {
+    return false;
+  }
+
+  // the decoder is shared with the leased buffers of the stream, which may
+  // be used by several threads
+
+  std::lock_guard<std::mutex> lock(attachment->mtx);
+
+  // get list of chunks from transport layer if the layout is not known
+
+  const std::vector<ChunkDecoder::Chunk> &chunk=getChunkList(gentl, parent->getHandle(), buffer,
+                                                             *decoder, getChunkLayoutID());
+
+  decoder->decode(data, reinterpret_cast<const uint8_t *>(getGlobalBase()), getSizeFilled(),
+                  chunk, component, [this]() { attachLocked(); });
+
+  return true;
 }
 
-void *Buffer::getGlobalBase() const
+uint64_t Buffer::getInfo(InfoField f) const
 {
-  return getBufferValue<void *>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_BASE);
+  std::lock_guard<std::mutex> lock(info_mtx);
+  return cachedInfo(f);
 }
 
-size_t Buffer::getGlobalSize() const
+uint64_t Buffer::cachedInfo(InfoField f) const
 {
-  return getBufferValue<size_t>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_SIZE);
+  const uint32_t bit=1u<<f;
+
+  if ((info_known & bit) == 0)
+  {
+    info[f]=queryInfo(f);
+    info_known|=bit;
+  }
+
+  return info[f];
 }
 
-void *Buffer::getBase(uint32_t part) const
+uint64_t Buffer::queryInfo(InfoField f) const
 {
-  if (multipart)
+  if (buffer == 0)
   {
-    return getBufferPartValue<void *>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_BASE);
+    return 0;
   }
-  else
+
+  void *stream=parent->getHandle();
+  uint64_t ret=0;
+
+  switch (f)
   {
-    void *ret=getBufferValue<void *>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_BASE);
+    case INFO_BASE:
+      ret=fromPtr(getBufferValue<void *>(gentl, stream, buffer, GenTL::BUFFER_INFO_BASE));
+      break;
 
-    size_t offset=getBufferValue<size_t>(gentl, parent->getHandle(), buffer,
-                                         GenTL::BUFFER_INFO_IMAGEOFFSET);
+    case INFO_SIZE:
+      ret=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_SIZE);
+      break;
 
-    if (offset > 0)
-    {
-      ret=reinterpret_cast<char *>(ret)+offset;
-    }
+    case INFO_USER_PTR:
+      ret=fromPtr(getBufferValue<void *>(gentl, stream, buffer, GenTL::BUFFER_INFO_USER_PTR));
+      break;
+
+    case INFO_TIMESTAMP:
+      ret=getBufferValue<uint64_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_TIMESTAMP);
+      break;
+
+    case INFO_TIMESTAMP_NS:
+      ret=getBufferValue<uint64_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_TIMESTAMP_NS);
+
+      // if timestamp in nano seconds is not available, then compute it from
+      // timestamp and device frequency, which is only queried once
+
+      if (ret == 0)
+      {
+        const uint64_t ns_freq=1000000000ul;
+
+        if (ts_freq == 0)
+        {
+          ts_freq=parent->getParent()->getTimestampFrequency();
+
+          if (ts_freq == 0)
+          {
+            ts_freq=ns_freq;
+          }
+        }
+
+        ret=cachedInfo(INFO_TIMESTAMP);
+
+        if (ts_freq != ns_freq)
+        {
+          ret=ret/ts_freq*ns_freq+(ns_freq*(ret%ts_freq))/ts_freq;
+        }
+      }
+      break;
+
+    case INFO_FRAMEID:
+      ret=getBufferValue<uint64_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_FRAMEID);
+      break;
+
+    case INFO_SIZE_FILLED:
+      ret=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_SIZE_FILLED);
+      break;
+
+    case INFO_IMAGEOFFSET:
+      ret=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_IMAGEOFFSET);
+      break;
+
+    case INFO_YPADDING:
+      if (!multipart)
+      {
+        ret=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_YPADDING);
+      }
+      break;
+
+    case INFO_DELIVERED_CHUNKPAYLOADSIZE:
+      ret=getBufferValue<size_t>(gentl, stream, buffer,
+                                 GenTL::BUFFER_INFO_DELIVERED_CHUNKPAYLOADSIZE);
+      break;
+
+    case INFO_CHUNKLAYOUTID:
+      ret=getBufferValue<uint64_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_CHUNKLAYOUTID);
+      break;
+
+    case INFO_DATA_SIZE:
+      ret=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_DATA_SIZE);
+      break;
 
-    return ret;
+    case INFO_NEW_DATA:
+      ret=getBufferBool(gentl, stream, buffer, GenTL::BUFFER_INFO_NEW_DATA);
+      break;
+
+    case INFO_IS_QUEUED:
+      ret=getBufferBool(gentl, stream, buffer, GenTL::BUFFER_INFO_IS_QUEUED);
+      break;
+
+    case INFO_IS_ACQUIRING:
+      ret=getBufferBool(gentl, stream, buffer, GenTL::BUFFER_INFO_IS_ACQUIRING);
+      break;
+
+    case INFO_IS_INCOMPLETE:
+      ret=getBufferBool(gentl, stream, buffer, GenTL::BUFFER_INFO_IS_INCOMPLETE);
+      break;
+
+    case INFO_DATA_LARGER_THAN_BUFFER:
+      ret=getBufferBool(gentl, stream, buffer, GenTL::BUFFER_INFO_DATA_LARGER_THAN_BUFFER);
+      break;
+
+    case INFO_CONTAINS_CHUNKDATA:
+      ret=(payload_type == PAYLOAD_TYPE_CHUNK_DATA) ||
+        getBufferBool(gentl, stream, buffer, GenTL::BUFFER_INFO_CONTAINS_CHUNKDATA);
+      break;
+
+    case INFO_BIGENDIAN:
+      {
+        GenTL::INFO_DATATYPE type;
+        int32_t v;
+        size_t size=sizeof(v);
+
+        if (gentl->DSGetBufferInfo(stream, buffer, GenTL::BUFFER_INFO_PIXEL_ENDIANNESS,
+                                   &type, &v, &size) == GenTL::GC_ERR_SUCCESS &&
+            type == GenTL::INFO_DATATYPE_INT32 && v == GenTL::PIXELENDIANNESS_BIG)
+        {
+          ret=1;
+        }
+      }
+      break;
+
+    default:
+      break;
   }
+
+  return ret;
 }
 
-size_t Buffer::getSize(uint32_t part) const
+void Buffer::setInfo(InfoField f, uint64_t v)
 {
-  if (multipart)
+  std::lock_guard<std::mutex> lock(info_mtx);
+
+  info[f]=v;
+  info_known|=1u<<f;
+}
+
+uint64_t Buffer::getPartInfo(uint32_t part, PartField f) const
+{
+  std::lock_guard<std::mutex> lock(info_mtx);
+  return cachedPartInfo(part, f);
+}
+
+uint64_t Buffer::cachedPartInfo(uint32_t part, PartField f) const
+{
+  if (!multipart)
   {
-    return getBufferPartValue<size_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_DATA_SIZE);
+    part=0;
   }
-  else
+
+  if (part >= parts.size())
   {
-    size_t size=getBufferValue<size_t>(gentl, parent->getHandle(), buffer,
-                                       GenTL::BUFFER_INFO_SIZE);
+    return 0;
+  }
 
-    size_t offset=getBufferValue<size_t>(gentl, parent->getHandle(), buffer,
-                                         GenTL::BUFFER_INFO_IMAGEOFFSET);
+  PartInfo &p=parts[part];
+  const uint32_t bit=1u<<f;
 
-    return size-offset;
+  if ((p.known & bit) == 0)
+  {
+    p.value[f]=queryPartInfo(part, f);
+    p.known|=bit;
   }
-}
 
-void *Buffer::getUserPtr() const
-{
-  return getBufferValue<void *>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_USER_PTR);
+  return p.value[f];
 }
 
-uint64_t Buffer::getTimestamp() const
+uint64_t Buffer::queryPartInfo(uint32_t part, PartField f) const
 {
-  if (payload_type == PAYLOAD_TYPE_CHUNK_DATA && nodemap)
+  void *stream=parent->getHandle();
+  uint64_t ret=0;
+
+  if (multipart)
   {
-    try
+    switch (f)
     {
-      return getInteger(nodemap, "ChunkTimestamp", 0, 0, true);
+      case PART_BASE:
+        ret=fromPtr(getBufferPartValue<void *>(gentl, stream, buffer, part,
+                                               GenTL::BUFFER_PART_INFO_BASE));
+        break;
+
+      case PART_SIZE:
+        ret=getBufferPartValue<size_t>(gentl, stream, buffer, part,
+                                       GenTL::BUFFER_PART_INFO_DATA_SIZE);
+        break;
+
+      case PART_DATATYPE:
+        ret=getBufferPartValue<size_t>(gentl, stream, buffer, part,
+                                       GenTL::BUFFER_PART_INFO_DATA_TYPE);
+        break;
+
+      case PART_FORMAT:
+        ret=getBufferPartValue<uint64_t>(gentl, stream, buffer, part,
+                                         GenTL::BUFFER_PART_INFO_DATA_FORMAT);
+        break;
+
+      case PART_FORMAT_NAMESPACE:
+        ret=getBufferPartValue<uint64_t>(gentl, stream, buffer, part,
+                                         GenTL::BUFFER_PART_INFO_DATA_FORMAT_NAMESPACE);
+        break;
+
+      case PART_WIDTH:
+        ret=getBufferPartValue<size_t>(gentl, stream, buffer, part,
+                                       GenTL::BUFFER_PART_INFO_WIDTH);
+        break;
+
+      case PART_HEIGHT:
+        ret=getBufferPartValue<size_t>(gentl, stream, buffer, part,
+                                       GenTL::BUFFER_PART_INFO_HEIGHT);
+        break;
+
+      case PART_XOFFSET:
+        ret=getBufferPartValue<size_t>(gentl, stream, buffer, part,
+                                       GenTL::BUFFER_PART_INFO_XOFFSET);
+        break;
+
+      case PART_YOFFSET:
+        ret=getBufferPartValue<size_t>(gentl, stream, buffer, part,
+                                       GenTL::BUFFER_PART_INFO_YOFFSET);
+        break;
+
+      case PART_XPADDING:
+        ret=getBufferPartValue<size_t>(gentl, stream, buffer, part,
+                                       GenTL::BUFFER_PART_INFO_XPADDING);
+        break;
+
+      case PART_SOURCE_ID:
+        ret=getBufferPartValue<uint64_t>(gentl, stream, buffer, part,
+                                         GenTL::BUFFER_PART_INFO_SOURCE_ID);
+        break;
+
+      case PART_REGION_ID:
+        ret=getBufferPartValue<uint64_t>(gentl, stream, buffer, part,
+                                         GenTL::BUFFER_PART_INFO_REGION_ID);
+        break;
+
+      case PART_PURPOSE_ID:
+        ret=getBufferPartValue<uint64_t>(gentl, stream, buffer, part,
+                                         GenTL::BUFFER_PART_INFO_DATA_PURPOSE_ID);
+        break;
+
+      case PART_DELIVERED_HEIGHT:
+        ret=getBufferPartValue<size_t>(gentl, stream, buffer, part,
+                                       GenTL::BUFFER_PART_INFO_DELIVERED_IMAGEHEIGHT);
+        break;
+
+      case PART_IMAGE_PRESENT:
+        switch (cachedPartInfo(part, PART_DATATYPE))
+        {
+          case PART_DATATYPE_2D_IMAGE:
+          case PART_DATATYPE_2D_PLANE_BIPLANAR:
+          case PART_DATATYPE_2D_PLANE_TRIPLANAR:
+          case PART_DATATYPE_2D_PLANE_QUADPLANAR:
+          case PART_DATATYPE_3D_IMAGE:
+          case PART_DATATYPE_3D_PLANE_BIPLANAR:
+          case PART_DATATYPE_3D_PLANE_TRIPLANAR:
+          case PART_DATATYPE_3D_PLANE_QUADPLANAR:
+          case PART_DATATYPE_CONFIDENCE_MAP:
+            ret=1;
+            break;
+
+          default:
+            break;
+        }
+        break;
+
+      default:
+        break;
     }
-    catch (const std::exception &)
+  }
+  else
+  {
+    switch (f)
     {
-      // ignore error and try getBufferValue()
+      case PART_BASE:
+        {
+          char *base=reinterpret_cast<char *>(toPtr(cachedInfo(INFO_BASE)));
+
+          if (base != 0)
+          {
+            base+=cachedInfo(INFO_IMAGEOFFSET);
+          }
+
+          ret=fromPtr(base);
+        }
+        break;
+
+      case PART_SIZE:
+        ret=cachedInfo(INFO_SIZE)-cachedInfo(INFO_IMAGEOFFSET);
+        break;
+
+      case PART_FORMAT:
+        ret=getBufferValue<uint64_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_PIXELFORMAT);
+        break;
+
+      case PART_FORMAT_NAMESPACE:
+        ret=getBufferValue<uint64_t>(gentl, stream, buffer,
+                                     GenTL::BUFFER_INFO_PIXELFORMAT_NAMESPACE);
+        break;
+
+      case PART_WIDTH:
+        ret=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_WIDTH);
+        break;
+
+      case PART_HEIGHT:
+        ret=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_HEIGHT);
+        break;
+
+      case PART_XOFFSET:
+        ret=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_XOFFSET);
+        break;
+
+      case PART_YOFFSET:
+        ret=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_YOFFSET);
+        break;
+
+      case PART_XPADDING:
+        ret=getBufferValue<size_t>(gentl, stream, buffer, GenTL::BUFFER_INFO_XPADDING);
+        break;
+
+      case PART_DELIVERED_HEIGHT:
+        ret=getBufferValue<size_t>(gentl, stream, buffer,
+                                   GenTL::BUFFER_INFO_DELIVERED_IMAGEHEIGHT);
+        break;
+
+      case PART_IMAGE_PRESENT:
+        ret=getBufferBool(gentl, stream, buffer, GenTL::BUFFER_INFO_IMAGEPRESENT);
+        break;
+
+      default:
+        // data type and the IDs are not defined for buffers that are not
+        // multipart
+        break;
     }
   }
 
-  return getBufferValue<uint64_t>(gentl, parent->getHandle(), buffer,
-                                  GenTL::BUFFER_INFO_TIMESTAMP);
+  return ret;
+}
+
+void Buffer::setPartInfo(uint32_t part, PartField f, uint64_t v)
+{
+  std::lock_guard<std::mutex> lock(info_mtx);
+
+  if (part < parts.size())
+  {
+    parts[part].value[f]=v;
+    parts[part].known|=1u<<f;
+  }
+}
+
+uint32_t Buffer::getNumberOfParts() const
+{
+  return nparts;
+}
+
+void *Buffer::getGlobalBase() const
+{
+  return toPtr(getInfo(INFO_BASE));
+}
+
+size_t Buffer::getGlobalSize() const
+{
+  return static_cast<size_t>(getInfo(INFO_SIZE));
+}
+
+void *Buffer::getBase(uint32_t part) const
+{
+  return toPtr(getPartInfo(part, PART_BASE));
+}
+
+size_t Buffer::getSize(uint32_t part) const
+{
+  return static_cast<size_t>(getPartInfo(part, PART_SIZE));
+}
+
+void *Buffer::getUserPtr() const
+{
+  return toPtr(getInfo(INFO_USER_PTR));
+}
+
+uint64_t Buffer::getTimestamp() const
+{
+  return getInfo(INFO_TIMESTAMP);
 }
 
 bool Buffer::getNewData() const
 {
-  return getBufferBool(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_NEW_DATA);
+  return getInfo(INFO_NEW_DATA) != 0;
 }
 
 bool Buffer::getIsQueued() const
 {
-  return getBufferBool(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_IS_QUEUED);
+  return getInfo(INFO_IS_QUEUED) != 0;
 }
 
 bool Buffer::getIsAcquiring() const
 {
-  return getBufferBool(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_IS_ACQUIRING);
+  return getInfo(INFO_IS_ACQUIRING) != 0;
 }
 
 bool Buffer::getIsIncomplete() const
 {
-  return getBufferBool(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_IS_INCOMPLETE);
+  return getInfo(INFO_IS_INCOMPLETE) != 0;
 }
 
 std::string Buffer::getTLType() const
@@ -324,313 +910,97 @@ std::string Buffer::getTLType() const
 
 size_t Buffer::getSizeFilled() const
 {
-  return getBufferValue<size_t>(gentl, parent->getHandle(), buffer,
-                                GenTL::BUFFER_INFO_SIZE_FILLED);
+  return static_cast<size_t>(getInfo(INFO_SIZE_FILLED));
 }
 
 size_t Buffer::getPartDataType(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<size_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_DATA_TYPE);
-  }
-  else
-  {
-    return 0;
-  }
+  return static_cast<size_t>(getPartInfo(part, PART_DATATYPE));
 }
 
 size_t Buffer::getWidth(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<size_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_WIDTH);
-  }
-  else
-  {
-    if (payload_type == PAYLOAD_TYPE_CHUNK_DATA && nodemap)
-    {
-      try
-      {
-        return getInteger(nodemap, "ChunkWidth", 0, 0, true);
-      }
-      catch (const std::exception &)
-      {
-        // ignore error and try getBufferValue()
-      }
-    }
-
-    return getBufferValue<size_t>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_WIDTH);
-  }
+  return static_cast<size_t>(getPartInfo(part, PART_WIDTH));
 }
 
 size_t Buffer::getHeight(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<size_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_HEIGHT);
-  }
-  else
-  {
-    if (payload_type == PAYLOAD_TYPE_CHUNK_DATA && nodemap)
-    {
-      try
-      {
-        return getInteger(nodemap, "ChunkHeight", 0, 0, true);
-      }
-      catch (const std::exception &)
-      {
-        // ignore error and try getBufferValue()
-      }
-    }
-
-    return getBufferValue<size_t>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_HEIGHT);
-  }
+  return static_cast<size_t>(getPartInfo(part, PART_HEIGHT));
 }
 
 size_t Buffer::getXOffset(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<size_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_XOFFSET);
-  }
-  else
-  {
-    if (payload_type == PAYLOAD_TYPE_CHUNK_DATA && nodemap)
-    {
-      try
-      {
-        return getInteger(nodemap, "ChunkOffsetX", 0, 0, true);
-      }
-      catch (const std::exception &)
-      {
-        // ignore error and try getBufferValue()
-      }
-    }
-
-    return getBufferValue<size_t>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_XOFFSET);
-  }
+  return static_cast<size_t>(getPartInfo(part, PART_XOFFSET));
 }
 
 size_t Buffer::getYOffset(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<size_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_YOFFSET);
-  }
-  else
-  {
-    if (payload_type == PAYLOAD_TYPE_CHUNK_DATA && nodemap)
-    {
-      try
-      {
-        return getInteger(nodemap, "ChunkOffsetY", 0, 0, true);
-      }
-      catch (const std::exception &)
-      {
-        // ignore error and try getBufferValue()
-      }
-    }
-
-    return getBufferValue<size_t>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_YOFFSET);
-  }
+  return static_cast<size_t>(getPartInfo(part, PART_YOFFSET));
 }
 
 size_t Buffer::getXPadding(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<size_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_XPADDING);
-  }
-  else
-  {
-    return getBufferValue<size_t>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_XPADDING);
-  }
+  return static_cast<size_t>(getPartInfo(part, PART_XPADDING));
 }
 
 size_t Buffer::getYPadding() const
 {
-  if (multipart)
-  {
-    return 0;
-  }
-
-  return getBufferValue<size_t>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_YPADDING);
+  return static_cast<size_t>(getInfo(INFO_YPADDING));
 }
 
 uint64_t Buffer::getFrameID() const
 {
-  return getBufferValue<uint64_t>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_FRAMEID);
+  return getInfo(INFO_FRAMEID);
 }
 
 bool Buffer::getImagePresent(uint32_t part) const
 {
-  if (multipart)
-  {
-    size_t type=getBufferPartValue<size_t>(gentl, parent->getHandle(), buffer, part,
-                                           GenTL::BUFFER_PART_INFO_DATA_TYPE);
-
-    bool ret;
-
-    switch (type)
-    {
-      case PART_DATATYPE_2D_IMAGE:
-      case PART_DATATYPE_2D_PLANE_BIPLANAR:
-      case PART_DATATYPE_2D_PLANE_TRIPLANAR:
-      case PART_DATATYPE_2D_PLANE_QUADPLANAR:
-      case PART_DATATYPE_3D_IMAGE:
-      case PART_DATATYPE_3D_PLANE_BIPLANAR:
-      case PART_DATATYPE_3D_PLANE_TRIPLANAR:
-      case PART_DATATYPE_3D_PLANE_QUADPLANAR:
-      case PART_DATATYPE_CONFIDENCE_MAP:
-        ret=true;
-        break;
-
-      default:
-        ret=false;
-        break;
-    }
-
-    return ret;
-  }
-  else
-  {
-    if (payload_type == PAYLOAD_TYPE_CHUNK_DATA && nodemap)
-    {
-      return true;
-    }
-
-    return getBufferBool(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_IMAGEPRESENT);
-  }
+  return getPartInfo(part, PART_IMAGE_PRESENT) != 0;
 }
 
 size_t Buffer::getPayloadType() const
 {
-  return getBufferValue<size_t>(gentl, parent->getHandle(), buffer,
-                                GenTL::BUFFER_INFO_PAYLOADTYPE);
+  return payload_type;
 }
 
 uint64_t Buffer::getPixelFormat(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<uint64_t>(gentl, parent->getHandle(), buffer, part,
-                                        GenTL::BUFFER_PART_INFO_DATA_FORMAT);
-  }
-  else
-  {
-    if (payload_type == PAYLOAD_TYPE_CHUNK_DATA && nodemap)
-    {
-      try
-      {
-        return getInteger(nodemap, "ChunkPixelFormat", 0, 0, true);
-      }
-      catch (const std::exception &)
-      {
-        // ignore error and try getBufferValue()
-      }
-    }
-
-    return getBufferValue<uint64_t>(gentl, parent->getHandle(), buffer,
-                                    GenTL::BUFFER_INFO_PIXELFORMAT);
-  }
+  return getPartInfo(part, PART_FORMAT);
 }
 
 uint64_t Buffer::getPixelFormatNamespace(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<uint64_t>(gentl, parent->getHandle(), buffer, part,
-                                        GenTL::BUFFER_PART_INFO_DATA_FORMAT_NAMESPACE);
-  }
-  else
-  {
-    return getBufferValue<uint64_t>(gentl, parent->getHandle(), buffer,
-                                    GenTL::BUFFER_INFO_PIXELFORMAT_NAMESPACE);
-  }
+  return getPartInfo(part, PART_FORMAT_NAMESPACE);
 }
 
 uint64_t Buffer::getPartSourceID(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<uint64_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_SOURCE_ID);
-  }
-  else
-  {
-    return 0;
-  }
+  return getPartInfo(part, PART_SOURCE_ID);
 }
 
 uint64_t Buffer::getPartRegionID(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<uint64_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_REGION_ID);
-  }
-  else
-  {
-    return 0;
-  }
+  return getPartInfo(part, PART_REGION_ID);
 }
 
 uint64_t Buffer::getPartDataPurposeID(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<uint64_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_DATA_PURPOSE_ID);
-  }
-  else
-  {
-    return 0;
-  }
+  return getPartInfo(part, PART_PURPOSE_ID);
 }
 
 size_t Buffer::getDeliveredImageHeight(uint32_t part) const
 {
-  if (multipart)
-  {
-    return getBufferPartValue<size_t>(gentl, parent->getHandle(), buffer, part,
-                                      GenTL::BUFFER_PART_INFO_DELIVERED_IMAGEHEIGHT);
-  }
-  else
-  {
-    if (payload_type == PAYLOAD_TYPE_CHUNK_DATA && nodemap)
-    {
-      try
-      {
-        return getInteger(nodemap, "ChunkHeight", 0, 0, true);
-      }
-      catch (const std::exception &)
-      {
-        // ignore error and try getBufferValue()
-      }
-    }
-
-    return getBufferValue<size_t>(gentl, parent->getHandle(), buffer,
-                                  GenTL::BUFFER_INFO_DELIVERED_IMAGEHEIGHT);
-  }
+  return static_cast<size_t>(getPartInfo(part, PART_DELIVERED_HEIGHT));
 }
 
 size_t Buffer::getDeliveredChunkPayloadSize() const
 {
-  return getBufferValue<size_t>(gentl, parent->getHandle(), buffer,
-                                GenTL::BUFFER_INFO_DELIVERED_CHUNKPAYLOADSIZE);
+  return static_cast<size_t>(getInfo(INFO_DELIVERED_CHUNKPAYLOADSIZE));
 }
 
 uint64_t Buffer::getChunkLayoutID() const
 {
-  return getBufferValue<uint64_t>(gentl, parent->getHandle(), buffer,
-                                  GenTL::BUFFER_INFO_CHUNKLAYOUTID);
+  return getInfo(INFO_CHUNKLAYOUTID);
 }
 
 std::string Buffer::getFilename() const
@@ -640,78 +1010,27 @@ std::string Buffer::getFilename() const
 
 bool Buffer::isBigEndian() const
 {
-  bool ret=false;
-
-  GenTL::INFO_DATATYPE type;
-  int32_t v;
-  size_t size=sizeof(v);
-  GenTL::GC_ERROR err=GenTL::GC_ERR_SUCCESS;
-
-  if (parent->getHandle() != 0 && buffer != 0)
-  {
-    err=gentl->DSGetBufferInfo(parent->getHandle(), buffer, GenTL::BUFFER_INFO_PIXEL_ENDIANNESS,
-                               &type, &v, &size);
-
-    if (err == GenTL::GC_ERR_SUCCESS && type == GenTL::INFO_DATATYPE_INT32 &&
-        v == GenTL::PIXELENDIANNESS_BIG)
-    {
-      ret=true;
-    }
-  }
-
-  return ret;
+  return getInfo(INFO_BIGENDIAN) != 0;
 }
 
 size_t Buffer::getDataSize() const
 {
-  return getBufferValue<size_t>(gentl, parent->getHandle(), buffer, GenTL::BUFFER_INFO_DATA_SIZE);
+  return static_cast<size_t>(getInfo(INFO_DATA_SIZE));
 }
 
 uint64_t Buffer::getTimestampNS() const
 {
-  uint64_t ret=getBufferValue<uint64_t>(gentl, parent->getHandle(), buffer,
-                                        GenTL::BUFFER_INFO_TIMESTAMP_NS);
-
-  // if timestamp in nano seconds is not available, then compute it from
-  // timestamp and device frequency
-
-  if (ret == 0)
-  {
-    const uint64_t ns_freq=1000000000ul;
-    uint64_t freq=parent->getParent()->getTimestampFrequency();
-
-    if (freq == 0)
-    {
-      freq=ns_freq;
-    }
-
-    ret=getBufferValue<uint64_t>(gentl, parent->getHandle(), buffer,
-                                 GenTL::BUFFER_INFO_TIMESTAMP);
-
-    if (freq != ns_freq)
-    {
-      ret=ret/freq*ns_freq+(ns_freq*(ret%freq))/freq;
-    }
-  }
-
-  return ret;
+  return getInfo(INFO_TIMESTAMP_NS);
 }
 
 bool Buffer::getDataLargerThanBuffer() const
 {
-  return getBufferBool(gentl, parent->getHandle(), buffer,
-                       GenTL::BUFFER_INFO_DATA_LARGER_THAN_BUFFER);
+  return getInfo(INFO_DATA_LARGER_THAN_BUFFER) != 0;
 }
 
 bool Buffer::getContainsChunkdata() const
 {
-  if (payload_type == PAYLOAD_TYPE_CHUNK_DATA)
-  {
-    return true;
-  }
-
-  return getBufferBool(gentl, parent->getHandle(), buffer,
-                       GenTL::BUFFER_INFO_CONTAINS_CHUNKDATA);
+  return getInfo(INFO_CONTAINS_CHUNKDATA) != 0;
 }
 
 void *Buffer::getHandle() const
@@ -41,6 +41,8 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+#include <mutex>
 
 namespace rcg
 {
@@ -108,6 +110,36 @@ enum PARTDATATYPE_IDS
   PART_DATATYPE_CUSTOM_ID            = 1000  /* Starting value for GenTL Producer custom IDs. */
 };
 
+/**
+  Frequently used chunk values of a buffer (see Buffer::getChunkData()). The
+  values are named like the corresponding Chunk* features. Integer values
+  that are not available are set to -1 and float values to NaN.
+*/
+
+struct ChunkData
+{
+  int64_t width;                      // ChunkWidth
+  int64_t height;                     // ChunkHeight
+  double exposure_time;               // ChunkExposureTime in us
+  double gain;                        // ChunkGain
+  double scan3d_focal_length;         // ChunkScan3dFocalLength
+  double scan3d_baseline;             // ChunkScan3dBaseline
+  double scan3d_principal_point_u;    // ChunkScan3dPrincipalPointU
+  double scan3d_principal_point_v;    // ChunkScan3dPrincipalPointV
+  double scan3d_coordinate_scale;     // ChunkScan3dCoordinateScale
+  double scan3d_coordinate_offset;    // ChunkScan3dCoordinateOffset
+  int scan3d_invalid_data_flag;       // ChunkScan3dInvalidDataFlag, 0 or 1
+  double scan3d_invalid_data_value;   // ChunkScan3dInvalidDataValue
+  int64_t line_status_all;            // ChunkLineStatusAll
+  double rc_noise;                    // ChunkRcNoise
+  double rc_brightness;               // ChunkRcBrightness
+  double rc_out1_reduction;           // ChunkRcOut1Reduction
+
+  ChunkData();
+};
+
+class ChunkDecoder;
+
 /**
   The buffer class encapsulates a Genicam buffer that is provided by a stream.
   A multi-part buffer with one image can be treated like a "normal" buffer.
@@ -132,13 +164,36 @@ class Buffer
       true), the the buffer is automatically attached every time when
       setHandle() is called in Stream::grab(). This means that chunk values of
       the last grabbed buffer can be directly accessed through the nodemap.
+
+      If lazy is true, the buffer is only attached to the nodemap on
+      attachChunkData(), which avoids parsing of all chunks by GenApi if only
+      the values of getChunkData() are needed. Buffers with chunk payload type
+      are always attached.
+    */
+
+    void setNodemap(const std::shared_ptr<GenApi::CNodeMapRef> nodemap, const std::string &tltype,
+                    bool lazy=false);
+
+    /**
+      Uses the nodemap, chunk adapter and chunk decoder of the given buffer,
+      e.g. for leased buffers that are created by the stream. The buffer is
+      only attached to the nodemap on attachChunkData(). Access to the shared
+      chunk adapter and decoder is serialized by a mutex that all buffers of
+      the stream share. A buffer is only detached if it is still the one that
+      is attached, so that releasing a buffer does not detach the chunk data
+      of another one.
+
+      @param other Buffer with the nodemap, usually the one of the stream.
     */
 
-    void setNodemap(const std::shared_ptr<GenApi::CNodeMapRef> nodemap, const std::string &tltype);
+    void shareNodemap(const Buffer &other);
 
     /**
       Set the buffer handle that this object should manage. The handle is used
-      until a new handle is set.
+      until a new handle is set. Each value of the buffer and its parts, except
+      for strings, is queried from the transport layer on its first access and
+      cached until the next handle is set. Thus, consumers only pay for the
+      values that they use and repeated calls of getters are cheap.
 
       @param handle Buffer handle that replaces a possibly existing handle.
     */
@@ -475,6 +530,46 @@ class Buffer
 
     bool getContainsChunkdata() const;
 
+    /**
+      Attaches the buffer to the nodemap, so that all chunk values can be
+      accessed through the Chunk* features of the nodemap. This is only
+      necessary if the nodemap has been set with lazy attaching (see
+      setNodemap()) or if it shares the nodemap with other buffers (see
+      shareNodemap()). The buffer stays attached until the next buffer is set
+      or, for shared nodemaps, until another buffer is attached.
+
+      NOTE: If leased buffers are consumed by several threads, reading values
+      through the nodemap after attaching is only meaningful if the threads
+      synchronize with each other. getChunkData() can be called concurrently.
+    */
+
+    void attachChunkData() const;
+
+    /**
+      Decodes frequently used chunk values directly from the chunk data of the
+      buffer. Values of other chunks must be accessed through the nodemap (see
+      attachChunkData()).
+
+      The registers of the chunk features are looked up through the nodemap
+      only once for each component and the list of chunks only once for each
+      chunk layout ID. Thus, this is much faster than reading values through
+      the nodemap. It is not necessary to attach the buffer to the nodemap,
+      unless a value cannot be decoded directly, e.g. because it is computed
+      by a formula.
+
+      NOTE: The method requires that the nodemap has been set and chunks are
+      enabled (see Stream::attachBuffers()).
+
+      @param data      Decoded chunk values.
+      @param component Component name for ChunkComponentSelector, e.g.
+                       "Intensity" or "Disparity". An empty string keeps the
+                       current value of the selector.
+      @return          False if the buffer does not contain chunk data or is
+                       incomplete. In this case, all values are unavailable.
+    */
+
+    bool getChunkData(ChunkData &data, const std::string &component=std::string()) const;
+
     /**
       Get internal stream handle.
 
@@ -488,14 +583,77 @@ class Buffer
     Buffer(class Buffer &); // forbidden
     Buffer &operator=(const Buffer &); // forbidden
 
+    /**
+      Values of the buffer and of its parts. Each value is queried from the
+      transport layer on first access and cached until the next handle is set.
+    */
+
+    enum InfoField
+    {
+      INFO_BASE, INFO_SIZE, INFO_USER_PTR, INFO_TIMESTAMP, INFO_TIMESTAMP_NS, INFO_FRAMEID,
+      INFO_SIZE_FILLED, INFO_IMAGEOFFSET, INFO_YPADDING, INFO_DELIVERED_CHUNKPAYLOADSIZE,
+      INFO_CHUNKLAYOUTID, INFO_DATA_SIZE, INFO_NEW_DATA, INFO_IS_QUEUED, INFO_IS_ACQUIRING,
+      INFO_IS_INCOMPLETE, INFO_DATA_LARGER_THAN_BUFFER, INFO_CONTAINS_CHUNKDATA, INFO_BIGENDIAN,
+      INFO_COUNT
+    };
+
+    enum PartField
+    {
+      PART_BASE, PART_SIZE, PART_DATATYPE, PART_FORMAT, PART_FORMAT_NAMESPACE, PART_WIDTH,
+      PART_HEIGHT, PART_XOFFSET, PART_YOFFSET, PART_XPADDING, PART_SOURCE_ID, PART_REGION_ID,
+      PART_PURPOSE_ID, PART_DELIVERED_HEIGHT, PART_IMAGE_PRESENT, PART_COUNT
+    };
+
+    struct PartInfo
+    {
+      uint64_t value[PART_COUNT];
+      uint32_t known;
+    };
+
+    /**
+      State of a chunk adapter, which is shared by the buffer of a stream and
+      its leased buffers. The mutex protects the chunk adapter and the chunk
+      decoder.
+    */
+
+    struct ChunkAttachment
+    {
+      std::mutex mtx;
+      const Buffer *owner;
+    };
+
+    uint64_t getInfo(InfoField f) const;
+    uint64_t cachedInfo(InfoField f) const;
+    uint64_t queryInfo(InfoField f) const;
+    void setInfo(InfoField f, uint64_t v);
+
+    uint64_t getPartInfo(uint32_t part, PartField f) const;
+    uint64_t cachedPartInfo(uint32_t part, PartField f) const;
+    uint64_t queryPartInfo(uint32_t part, PartField f) const;
+    void setPartInfo(uint32_t part, PartField f, uint64_t v);
+
+    void attachLocked() const;
+    void detachChunkData();
+
     Stream *parent;
     std::shared_ptr<const GenTLWrapper> gentl;
     void *buffer;
     size_t payload_type;
     bool multipart;
+    uint32_t nparts;
+    mutable uint64_t ts_freq;
+
+    mutable std::mutex info_mtx;
+    mutable uint64_t info[INFO_COUNT];
+    mutable uint32_t info_known;
+    mutable std::vector<PartInfo> parts;
 
     std::shared_ptr<GenApi::CNodeMapRef> nodemap;
     std::shared_ptr<GenApi::CChunkAdapter> chunkadapter;
+    std::shared_ptr<ChunkDecoder> decoder;
+    std::shared_ptr<ChunkAttachment> attachment;
+    bool generic;
+    bool lazy;
 };
 
 bool isHostBigEndian();
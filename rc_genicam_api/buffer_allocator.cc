@@ -0,0 +1,373 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "buffer_allocator.h"
+
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#undef min
+#undef max
+#endif
+
+namespace rcg
+{
+
+namespace
+{
+
+const size_t HUGE_PAGE_SIZE=2*1024*1024;
+
+inline size_t roundUp(size_t v, size_t a)
+{
+  return (v+a-1)/a*a;
+}
+
+/**
+  Returns the smallest power of two that is greater or equal to the given
+  value and at least the size of a pointer.
+*/
+
+inline size_t powerOfTwo(size_t v)
+{
+  size_t ret=sizeof(void *);
+
+  while (ret < v)
+  {
+    ret<<=1;
+  }
+
+  return ret;
+}
+
+size_t getPageSize()
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return static_cast<size_t>(info.dwPageSize);
+#else
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+void lockMemory(void *p, size_t size, const char *name)
+{
+#ifdef _WIN32
+  bool ret=(VirtualLock(p, size) != 0);
+#else
+  bool ret=(mlock(p, size) == 0);
+#endif
+
+  if (!ret)
+  {
+    std::cerr << name << ": Warning: Cannot lock memory of " << size << " bytes" << std::endl;
+  }
+}
+
+}
+
+AlignedAllocator::AlignedAllocator(size_t _min_alignment)
+{
+  min_alignment=_min_alignment;
+}
+
+void *AlignedAllocator::allocate(size_t size, size_t alignment)
+{
+  const size_t a=powerOfTwo(std::max(alignment, min_alignment));
+
+#ifdef _WIN32
+  return _aligned_malloc(size, a);
+#else
+  void *p=0;
+
+  if (posix_memalign(&p, a, size) != 0)
+  {
+    p=0;
+  }
+
+  return p;
+#endif
+}
+
+void AlignedAllocator::free(void *p, size_t)
+{
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  ::free(p);
+#endif
+}
+
+HugePageAllocator::HugePageAllocator(bool _lock)
+{
+  lock=_lock;
+}
+
+void *HugePageAllocator::allocate(size_t size, size_t)
+{
+  const size_t n=roundUp(size, HUGE_PAGE_SIZE);
+  void *p=0;
+
+#ifdef _WIN32
+  // large pages are only available with SeLockMemoryPrivilege
+
+  const size_t large=GetLargePageMinimum();
+
+  if (large > 0 && n%large == 0)
+  {
+    p=VirtualAlloc(0, n, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+  }
+
+  if (p == 0)
+  {
+    p=VirtualAlloc(0, n, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+  }
+#else
+  // try explicit huge pages first
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  p=mmap(0, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+         (21 << MAP_HUGE_SHIFT), -1, 0);
+
+  if (p == MAP_FAILED)
+  {
+    p=0;
+  }
+#endif
+
+  // otherwise map 2 MB aligned memory and ask for transparent huge pages
+
+  if (p == 0)
+  {
+    const size_t m=n+HUGE_PAGE_SIZE;
+    void *q=mmap(0, m, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (q == MAP_FAILED)
+    {
+      return 0;
+    }
+
+    const uintptr_t a=(reinterpret_cast<uintptr_t>(q)+HUGE_PAGE_SIZE-1) & ~(HUGE_PAGE_SIZE-1);
+    const size_t head=static_cast<size_t>(a-reinterpret_cast<uintptr_t>(q));
+
+    if (head > 0)
+    {
+      munmap(q, head);
+    }
+
+    if (m-head > n)
+    {
+      munmap(reinterpret_cast<void *>(a+n), m-head-n);
+    }
+
+    p=reinterpret_cast<void *>(a);
+
+#ifdef MADV_HUGEPAGE
+    madvise(p, n, MADV_HUGEPAGE);
+#endif
+  }
+#endif
+
+  if (p != 0 && lock)
+  {
+    lockMemory(p, n, "HugePageAllocator");
+  }
+
+  return p;
+}
+
+void HugePageAllocator::free(void *p, size_t size)
+{
+  if (p != 0)
+  {
+#ifdef _WIN32
+    VirtualFree(p, 0, MEM_RELEASE);
+    (void)size;
+#else
+    munmap(p, roundUp(size, HUGE_PAGE_SIZE));
+#endif
+  }
+}
+
+ArenaAllocator::ArenaAllocator(size_t _capacity, bool lock, const char *_shm_name)
+{
+  capacity=roundUp(_capacity, getPageSize());
+  used=0;
+  count=0;
+  base=0;
+
+#ifdef _WIN32
+  if (_shm_name != 0)
+  {
+    throw std::runtime_error("ArenaAllocator: Shared memory is not supported under Windows");
+  }
+
+  base=VirtualAlloc(0, capacity, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+
+  if (base == 0)
+  {
+    throw std::runtime_error("ArenaAllocator: Cannot allocate arena");
+  }
+
+  // touch all pages
+
+  memset(base, 0, capacity);
+#else
+  int flags=0;
+
+#ifdef MAP_POPULATE
+  flags=MAP_POPULATE;
+#endif
+
+  if (_shm_name != 0)
+  {
+    shm_name=_shm_name;
+
+    int fd=shm_open(shm_name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+
+    if (fd < 0)
+    {
+      throw std::runtime_error("ArenaAllocator: Cannot create shared memory: "+shm_name);
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(capacity)) != 0)
+    {
+      ::close(fd);
+      shm_unlink(shm_name.c_str());
+      throw std::runtime_error("ArenaAllocator: Cannot set size of shared memory: "+shm_name);
+    }
+
+    base=mmap(0, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | flags, fd, 0);
+
+    ::close(fd);
+  }
+  else
+  {
+    base=mmap(0, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+  }
+
+  if (base == MAP_FAILED)
+  {
+    base=0;
+
+    if (shm_name.size() > 0)
+    {
+      shm_unlink(shm_name.c_str());
+    }
+
+    throw std::runtime_error("ArenaAllocator: Cannot map arena");
+  }
+
+  // touch all pages if they could not be populated while mapping
+
+  if (flags == 0)
+  {
+    memset(base, 0, capacity);
+  }
+#endif
+
+  if (lock)
+  {
+    lockMemory(base, capacity, "ArenaAllocator");
+  }
+}
+
+ArenaAllocator::~ArenaAllocator()
+{
+#ifdef _WIN32
+  VirtualFree(base, 0, MEM_RELEASE);
+#else
+  munmap(base, capacity);
+
+  if (shm_name.size() > 0)
+  {
+    shm_unlink(shm_name.c_str());
+  }
+#endif
+}
+
+void *ArenaAllocator::allocate(size_t size, size_t alignment)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+
+  const uintptr_t a=powerOfTwo(std::max(alignment, static_cast<size_t>(64)));
+  const uintptr_t b=reinterpret_cast<uintptr_t>(base);
+  const size_t offset=static_cast<size_t>(((b+used+a-1) & ~(a-1))-b);
+
+  if (offset > capacity || size > capacity-offset)
+  {
+    return 0;
+  }
+
+  used=offset+size;
+  count++;
+
+  return reinterpret_cast<uint8_t *>(base)+offset;
+}
+
+void ArenaAllocator::free(void *, size_t)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+
+  // memory is reused after all buffers have been freed
+
+  if (count > 0)
+  {
+    count--;
+  }
+
+  if (count == 0)
+  {
+    used=0;
+  }
+}
+
+}
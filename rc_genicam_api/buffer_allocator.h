@@ -0,0 +1,199 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_BUFFER_ALLOCATOR
+#define RC_GENICAM_API_BUFFER_ALLOCATOR
+
+#include <mutex>
+#include <string>
+#include <cstddef>
+
+namespace rcg
+{
+
+/**
+  Interface for providing the memory of the buffers of a stream, instead of
+  letting the transport layer allocate it. See Stream::setBufferAllocator().
+*/
+
+class BufferAllocator
+{
+  public:
+
+    virtual ~BufferAllocator() {}
+
+    /**
+      Allocates memory for one buffer.
+
+      @param size      Size of the buffer in bytes.
+      @param alignment Required alignment in bytes as reported by the
+                       transport layer. 0 means that there is no requirement.
+      @return          Pointer to the memory or 0 if it cannot be allocated.
+    */
+
+    virtual void *allocate(size_t size, size_t alignment)=0;
+
+    /**
+      Frees memory that has been allocated by this allocator.
+
+      @param p    Pointer that has been returned by allocate().
+      @param size Size that has been given to allocate().
+    */
+
+    virtual void free(void *p, size_t size)=0;
+};
+
+/**
+  Allocator that returns heap memory with the alignment that is required by
+  the transport layer, but at least with the given minimum alignment.
+*/
+
+class AlignedAllocator : public BufferAllocator
+{
+  public:
+
+    /**
+      Creates the allocator.
+
+      @param min_alignment Minimum alignment in bytes. It must be a power of 2.
+    */
+
+    AlignedAllocator(size_t min_alignment=64);
+
+    void *allocate(size_t size, size_t alignment);
+    void free(void *p, size_t size);
+
+  private:
+
+    size_t min_alignment;
+};
+
+/**
+  Allocator that places each buffer into its own mapping of 2 MB pages. If
+  explicit huge pages are not available, then transparent huge pages are
+  requested for 2 MB aligned memory.
+*/
+
+class HugePageAllocator : public BufferAllocator
+{
+  public:
+
+    /**
+      Creates the allocator.
+
+      @param lock If true, the memory is locked, so that it cannot be swapped
+                  out. A warning is printed if this fails.
+    */
+
+    HugePageAllocator(bool lock=false);
+
+    void *allocate(size_t size, size_t alignment);
+    void free(void *p, size_t size);
+
+  private:
+
+    bool lock;
+};
+
+/**
+  Allocator that maps one contiguous arena of a fixed capacity at
+  construction. The memory is pre-faulted, so that no page faults happen when
+  the first images are received. Buffers are taken from the arena in
+  sequence. The arena is reused after all buffers have been freed.
+
+  Optionally, the arena can be created as named POSIX shared memory object,
+  so that other processes can map the buffers without copying. The offset of
+  a buffer in the shared memory object is the difference between its address
+  and getBase().
+*/
+
+class ArenaAllocator : public BufferAllocator
+{
+  public:
+
+    /**
+      Creates the arena.
+
+      NOTE: A std::runtime_error is thrown if the arena cannot be created.
+
+      @param capacity Capacity of the arena in bytes. It should be large
+                      enough for the maximum number of buffers of a stream.
+      @param lock     If true, the memory is locked, so that it cannot be
+                      swapped out. A warning is printed if this fails.
+      @param shm_name Optional name of a POSIX shared memory object, e.g.
+                      "/rcg_arena". The object is created or replaced and
+                      removed again when the arena is destroyed. Not supported
+                      under Windows.
+    */
+
+    ArenaAllocator(size_t capacity, bool lock=false, const char *shm_name=0);
+    ~ArenaAllocator();
+
+    void *allocate(size_t size, size_t alignment);
+    void free(void *p, size_t size);
+
+    /**
+      Returns the start address of the arena.
+
+      @return Start address.
+    */
+
+    void *getBase() const { return base; }
+
+    /**
+      Returns the capacity of the arena.
+
+      @return Capacity in bytes.
+    */
+
+    size_t getCapacity() const { return capacity; }
+
+  private:
+
+    ArenaAllocator(class ArenaAllocator &); // forbidden
+    ArenaAllocator &operator=(const ArenaAllocator &); // forbidden
+
+    std::mutex mtx;
+
+    std::string shm_name;
+    void *base;
+    size_t capacity;
+    size_t used;
+    size_t count;
+};
+
+}
+
+#endif
@@ -0,0 +1,511 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "chunk_decoder.h"
+#include "config.h"
+
+#include "Base/GCException.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace rcg
+{
+
+namespace
+{
+
+/*
+  Decoded features. The order must correspond to the assignment of values in
+  ChunkDecoder::decode().
+*/
+
+enum FeatureKind { FK_INT, FK_FLOAT, FK_BOOL };
+
+struct Feature
+{
+  const char *name;
+  FeatureKind kind;
+};
+
+const Feature feature[]=
+{
+  { "ChunkWidth", FK_INT },
+  { "ChunkHeight", FK_INT },
+  { "ChunkExposureTime", FK_FLOAT },
+  { "ChunkGain", FK_FLOAT },
+  { "ChunkScan3dFocalLength", FK_FLOAT },
+  { "ChunkScan3dBaseline", FK_FLOAT },
+  { "ChunkScan3dPrincipalPointU", FK_FLOAT },
+  { "ChunkScan3dPrincipalPointV", FK_FLOAT },
+  { "ChunkScan3dCoordinateScale", FK_FLOAT },
+  { "ChunkScan3dCoordinateOffset", FK_FLOAT },
+  { "ChunkScan3dInvalidDataFlag", FK_BOOL },
+  { "ChunkScan3dInvalidDataValue", FK_FLOAT },
+  { "ChunkLineStatusAll", FK_INT },
+  { "ChunkRcNoise", FK_FLOAT },
+  { "ChunkRcBrightness", FK_FLOAT },
+  { "ChunkRcOut1Reduction", FK_FLOAT }
+};
+
+const size_t nfeatures=sizeof(feature)/sizeof(feature[0]);
+
+inline bool getProperty(GenApi::INode *node, const char *name, std::string &value)
+{
+  GENICAM_NAMESPACE::gcstring v, a;
+
+  if (node->GetProperty(name, v, a))
+  {
+    value=v.c_str();
+    return true;
+  }
+
+  return false;
+}
+
+inline bool hasProperty(GenApi::INode *node, const char *name)
+{
+  std::string value;
+  return getProperty(node, name, value);
+}
+
+}
+
+ChunkDecoder::ChunkDecoder(const std::shared_ptr<GenApi::CNodeMapRef> &_nodemap) :
+  nodemap(_nodemap), component_selector(_nodemap, "ChunkComponentSelector")
+{ }
+
+const std::vector<ChunkDecoder::Chunk> *ChunkDecoder::getLayout(uint64_t layout_id) const
+{
+  if (layout_id != 0)
+  {
+    auto it=layout.find(layout_id);
+
+    if (it != layout.end())
+    {
+      return &it->second;
+    }
+  }
+
+  return 0;
+}
+
+const std::vector<ChunkDecoder::Chunk> *ChunkDecoder::setLayout(uint64_t layout_id,
+  const std::vector<Chunk> &chunk)
+{
+  // the number of layouts is expected to be small, but limit it anyway by
+  // removing one of the other layouts
+
+  if (layout.size() >= 16 && layout.find(layout_id) == layout.end())
+  {
+    layout.erase(layout.begin());
+  }
+
+  std::vector<Chunk> &ret=layout[layout_id];
+  ret=chunk;
+
+  return &ret;
+}
+
+void ChunkDecoder::decode(ChunkData &data, const uint8_t *base, size_t size,
+                          const std::vector<Chunk> &chunk, const std::string &component,
+                          const std::function<void()> &attach)
+{
+  const std::vector<Field> &list=resolve(component);
+
+  double value[nfeatures];
+  bool genapi_selected=false;
+
+  for (size_t i=0; i<nfeatures; i++)
+  {
+    value[i]=std::numeric_limits<double>::quiet_NaN();
+
+    if (list[i].type == FT_GENAPI)
+    {
+      // fall back to reading the value through GenApi
+
+      if (!genapi_selected)
+      {
+        attach();
+
+        if (component.size() > 0)
+        {
+          component_selector.setValue(component);
+        }
+
+        genapi_selected=true;
+      }
+
+      try
+      {
+        switch (feature[i].kind)
+        {
+          case FK_INT:
+            value[i]=static_cast<double>(getInteger(nodemap, feature[i].name, 0, 0, true));
+            break;
+
+          case FK_FLOAT:
+            value[i]=getFloat(nodemap, feature[i].name, 0, 0, true);
+            break;
+
+          case FK_BOOL:
+            value[i]=getBoolean(nodemap, feature[i].name, true) ? 1 : 0;
+            break;
+        }
+      }
+      catch (const std::exception &)
+      { }
+    }
+    else if (list[i].type != FT_NONE)
+    {
+      readField(value[i], list[i], base, size, chunk);
+
+      if (feature[i].kind == FK_BOOL && !std::isnan(value[i]))
+      {
+        value[i]=(static_cast<int64_t>(value[i]) == list[i].on_value) ? 1 : 0;
+      }
+    }
+  }
+
+  data.width=std::isnan(value[0]) ? -1 : static_cast<int64_t>(value[0]);
+  data.height=std::isnan(value[1]) ? -1 : static_cast<int64_t>(value[1]);
+  data.exposure_time=value[2];
+  data.gain=value[3];
+  data.scan3d_focal_length=value[4];
+  data.scan3d_baseline=value[5];
+  data.scan3d_principal_point_u=value[6];
+  data.scan3d_principal_point_v=value[7];
+  data.scan3d_coordinate_scale=value[8];
+  data.scan3d_coordinate_offset=value[9];
+  data.scan3d_invalid_data_flag=std::isnan(value[10]) ? -1 : static_cast<int>(value[10]);
+  data.scan3d_invalid_data_value=value[11];
+  data.line_status_all=std::isnan(value[12]) ? -1 : static_cast<int64_t>(value[12]);
+  data.rc_noise=value[13];
+  data.rc_brightness=value[14];
+  data.rc_out1_reduction=value[15];
+}
+
+const std::vector<ChunkDecoder::Field> &ChunkDecoder::resolve(const std::string &component)
+{
+  auto it=field.find(component);
+
+  if (it != field.end())
+  {
+    return it->second;
+  }
+
+  // register addresses may depend on the component selector
+
+  if (component.size() > 0)
+  {
+    component_selector.setValue(component);
+  }
+
+  std::vector<Field> &list=field[component];
+
+  for (size_t i=0; i<nfeatures; i++)
+  {
+    list.push_back(resolveField(feature[i].name, feature[i].kind == FK_BOOL));
+  }
+
+  return list;
+}
+
+ChunkDecoder::Field ChunkDecoder::resolveField(const char *name, bool boolean)
+{
+  Field ret;
+
+  ret.type=FT_NONE;
+  ret.chunk_id=0;
+  ret.address=0;
+  ret.length=0;
+  ret.bigendian=false;
+  ret.sign=false;
+  ret.shift=0;
+  ret.bits=0;
+  ret.on_value=1;
+
+  try
+  {
+    GenApi::INode *node=nodemap->_GetNode(name);
+
+    if (node == 0)
+    {
+      return ret;
+    }
+
+    // reading through GenApi is always possible if the feature exists
+
+    ret.type=FT_GENAPI;
+
+    std::string value;
+
+    if (boolean && getProperty(node, "OnValue", value))
+    {
+      ret.on_value=std::stoll(value, 0, 0);
+    }
+
+    // follow the value pointers of simple nodes to the register, but stop at
+    // nodes that compute or select their value
+
+    for (int i=0; i<4 && dynamic_cast<GenApi::IRegister *>(node) == 0; i++)
+    {
+      if (hasProperty(node, "pIndex") || hasProperty(node, "Formula") ||
+          hasProperty(node, "FormulaFrom") || !getProperty(node, "pValue", value))
+      {
+        return ret;
+      }
+
+      node=nodemap->_GetNode(value.c_str());
+
+      if (node == 0)
+      {
+        return ret;
+      }
+    }
+
+    GenApi::IRegister *reg=dynamic_cast<GenApi::IRegister *>(node);
+
+    if (reg == 0)
+    {
+      return ret;
+    }
+
+    // the register must be located in a chunk with fixed ID
+
+    if (!getProperty(node, "pPort", value))
+    {
+      return ret;
+    }
+
+    GenApi::INode *port=nodemap->_GetNode(value.c_str());
+
+    if (port == 0 || !getProperty(port, "ChunkID", value))
+    {
+      return ret;
+    }
+
+    if (value.compare(0, 2, "0x") == 0 || value.compare(0, 2, "0X") == 0)
+    {
+      value=value.substr(2);
+    }
+
+    uint64_t chunk_id=std::stoull(value, 0, 16);
+    int64_t address=reg->GetAddress();
+    int64_t length=reg->GetLength();
+
+    if (address < 0 || length < 1 || length > 8)
+    {
+      return ret;
+    }
+
+    bool bigendian=(getProperty(node, "Endianess", value) && value == "BigEndian");
+    bool sign=(getProperty(node, "Sign", value) && value == "Signed");
+
+    if (node->GetPrincipalInterfaceType() == GenApi::intfIFloat)
+    {
+      if (length != 4 && length != 8)
+      {
+        return ret;
+      }
+
+      ret.type=FT_FLOAT;
+    }
+    else if (node->GetPrincipalInterfaceType() == GenApi::intfIInteger)
+    {
+      int lsb=-1, msb=-1;
+
+      if (getProperty(node, "Bit", value))
+      {
+        lsb=msb=std::stoi(value, 0, 0);
+      }
+      else if (getProperty(node, "LSB", value))
+      {
+        lsb=std::stoi(value, 0, 0);
+
+        if (getProperty(node, "MSB", value))
+        {
+          msb=std::stoi(value, 0, 0);
+        }
+      }
+
+      if (lsb >= 0 || msb >= 0)
+      {
+        // masked register, the bit numbering depends on the endianess
+
+        int n=static_cast<int>(8*length);
+
+        if (bigendian)
+        {
+          ret.shift=n-1-lsb;
+          ret.bits=lsb-msb+1;
+        }
+        else
+        {
+          ret.shift=lsb;
+          ret.bits=msb-lsb+1;
+        }
+
+        if (lsb < 0 || msb < 0 || ret.shift < 0 || ret.bits < 1 || ret.shift+ret.bits > n)
+        {
+          ret.type=FT_GENAPI;
+          return ret;
+        }
+
+        ret.type=FT_MASKED_INT;
+      }
+      else
+      {
+        ret.type=FT_INT;
+      }
+    }
+    else
+    {
+      return ret;
+    }
+
+    ret.chunk_id=chunk_id;
+    ret.address=static_cast<uint64_t>(address);
+    ret.length=static_cast<size_t>(length);
+    ret.bigendian=bigendian;
+    ret.sign=sign;
+  }
+  catch (const GENICAM_NAMESPACE::GenericException &)
+  {
+    if (ret.type != FT_NONE)
+    {
+      ret.type=FT_GENAPI;
+    }
+  }
+  catch (const std::exception &)
+  {
+    if (ret.type != FT_NONE)
+    {
+      ret.type=FT_GENAPI;
+    }
+  }
+
+  return ret;
+}
+
+bool ChunkDecoder::readField(double &value, const Field &f, const uint8_t *base, size_t size,
+                             const std::vector<Chunk> &chunk) const
+{
+  // find chunk
+
+  const Chunk *c=0;
+  for (size_t i=0; i<chunk.size() && c == 0; i++)
+  {
+    if (chunk[i].id == f.chunk_id)
+    {
+      c=&chunk[i];
+    }
+  }
+
+  if (c == 0 || f.address+f.length > c->length || c->offset+c->length > size)
+  {
+    return false;
+  }
+
+  // get raw value
+
+  const uint8_t *p=base+c->offset+f.address;
+  uint64_t raw=0;
+
+  if (f.bigendian)
+  {
+    for (size_t i=0; i<f.length; i++)
+    {
+      raw=(raw<<8)|p[i];
+    }
+  }
+  else
+  {
+    for (size_t i=f.length; i>0; i--)
+    {
+      raw=(raw<<8)|p[i-1];
+    }
+  }
+
+  // convert value
+
+  int bits=static_cast<int>(8*f.length);
+
+  if (f.type == FT_MASKED_INT)
+  {
+    raw>>=f.shift;
+    bits=f.bits;
+
+    if (bits < 64)
+    {
+      raw&=(static_cast<uint64_t>(1)<<bits)-1;
+    }
+  }
+
+  if (f.type == FT_FLOAT)
+  {
+    if (f.length == 4)
+    {
+      uint32_t v=static_cast<uint32_t>(raw);
+      float fv;
+      memcpy(&fv, &v, sizeof(fv));
+      value=fv;
+    }
+    else
+    {
+      double dv;
+      memcpy(&dv, &raw, sizeof(dv));
+      value=dv;
+    }
+  }
+  else if (f.sign && bits < 64 && (raw & (static_cast<uint64_t>(1)<<(bits-1))) != 0)
+  {
+    value=static_cast<double>(static_cast<int64_t>(raw | (~static_cast<uint64_t>(0)<<bits)));
+  }
+  else if (f.sign)
+  {
+    value=static_cast<double>(static_cast<int64_t>(raw));
+  }
+  else
+  {
+    value=static_cast<double>(raw);
+  }
+
+  return true;
+}
+
+}
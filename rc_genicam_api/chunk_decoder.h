@@ -0,0 +1,163 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_CHUNK_DECODER
+#define RC_GENICAM_API_CHUNK_DECODER
+
+#include "buffer.h"
+#include "feature_handle.h"
+
+#include <GenApi/GenApi.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rcg
+{
+
+/**
+  Internal class for decoding frequently used chunk values (see ChunkData)
+  directly from the chunk data of a buffer.
+
+  For each feature, the register that holds the value is resolved once
+  through the nodemap, i.e. the ID of the chunk, the address and length within
+  the chunk, the endianess and the type of the register. Since addresses may
+  depend on ChunkComponentSelector, this is done once for each component.
+  Afterwards, values are taken from the buffer without any access to GenApi.
+  Features that cannot be resolved, e.g. because they are computed by a
+  formula, are read through GenApi after attaching the buffer to the nodemap.
+
+  The list of chunks in a buffer is cached for each chunk layout ID.
+
+  NOTE: The decoder is not thread safe. It is shared by the buffer of a stream
+  and its leased buffers, which serialize all calls with a common mutex.
+*/
+
+class ChunkDecoder
+{
+  public:
+
+    /**
+      Chunk as reported by the transport layer.
+    */
+
+    struct Chunk
+    {
+      uint64_t id;
+      size_t offset;
+      size_t length;
+    };
+
+    ChunkDecoder(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap);
+
+    /**
+      Returns the cached list of chunks for the given layout ID. The layout ID
+      0 is not cached, since it may signal that the transport layer does not
+      support layout IDs.
+
+      @param layout_id Chunk layout ID of buffer.
+      @return          Pointer to cached list or 0.
+    */
+
+    const std::vector<Chunk> *getLayout(uint64_t layout_id) const;
+
+    /**
+      Stores the list of chunks of the given layout ID. If too many layouts
+      are cached, another layout is removed, which invalidates pointers to
+      that layout.
+
+      @param layout_id Chunk layout ID of buffer.
+      @param chunk     List of chunks.
+      @return          Pointer to stored list.
+    */
+
+    const std::vector<Chunk> *setLayout(uint64_t layout_id, const std::vector<Chunk> &chunk);
+
+    /**
+      Decodes all values from the given chunk data.
+
+      @param data      Decoded values. Values that are not available are set
+                       to -1 or NaN.
+      @param base      Base address of buffer.
+      @param size      Filled size of buffer.
+      @param chunk     List of chunks in the buffer.
+      @param component Component name for ChunkComponentSelector or empty
+                       string.
+      @param attach    Function for attaching the buffer to the nodemap, which
+                       is called before reading values through GenApi.
+    */
+
+    void decode(ChunkData &data, const uint8_t *base, size_t size,
+                const std::vector<Chunk> &chunk, const std::string &component,
+                const std::function<void()> &attach);
+
+  private:
+
+    ChunkDecoder(class ChunkDecoder &); // forbidden
+    ChunkDecoder &operator=(const ChunkDecoder &); // forbidden
+
+    enum FieldType { FT_NONE, FT_INT, FT_MASKED_INT, FT_FLOAT, FT_GENAPI };
+
+    struct Field
+    {
+      FieldType type;
+      uint64_t chunk_id;
+      uint64_t address;
+      size_t length;
+      bool bigendian;
+      bool sign;
+      int shift;
+      int bits;
+      int64_t on_value;
+    };
+
+    const std::vector<Field> &resolve(const std::string &component);
+    Field resolveField(const char *name, bool boolean);
+    bool readField(double &value, const Field &field, const uint8_t *base, size_t size,
+                   const std::vector<Chunk> &chunk) const;
+
+    std::shared_ptr<GenApi::CNodeMapRef> nodemap;
+    FeatureHandle<std::string> component_selector;
+
+    std::map<uint64_t, std::vector<Chunk> > layout;
+    std::map<std::string, std::vector<Field> > field;
+};
+
+}
+
+#endif
@@ -40,6 +40,8 @@
 #include <iomanip>
 #include <limits>
 #include <fstream>
+#include <sstream>
+#include <chrono>
 
 #include "Base/GCException.h"
 
@@ -1156,33 +1158,84 @@ std::string getComponetOfPart(const std::shared_ptr<GenApi::CNodeMapRef> &nodema
   return component;
 }
 
-std::string loadFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *name,
-                     bool exception)
+namespace
 {
-  std::string ret;
 
-  // load file in pieces of 512 bytes
+/*
+  Returns the number of bytes that should be transferred with one read or
+  write operation, which is limited by the length of the FileAccessBuffer
+  register of the device.
+*/
+
+size_t getFileBlockSize(GenApi::FileProtocolAdapter &rf, const char *name,
+                        std::ios_base::openmode mode, size_t blocksize)
+{
+  int64_t n=0;
+
+  try
+  {
+    n=rf.getBufSize(name, mode);
+  }
+  catch (const GENICAM_NAMESPACE::GenericException &)
+  { }
+
+  if (n <= 0)
+  {
+    // fall back to the size that worked with all devices so far
+
+    n=512;
+  }
+
+  if (blocksize > 0 && blocksize < static_cast<size_t>(n))
+  {
+    n=static_cast<int64_t>(blocksize);
+  }
+
+  return static_cast<size_t>(n);
+}
+
+inline double secondsSince(const std::chrono::steady_clock::time_point &start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+
+}
+
+uint64_t loadFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *name,
+  std::ostream &out, bool exception, const FileProgressCallback &progress, size_t blocksize)
+{
+  uint64_t ret=0;
 
   GenApi::FileProtocolAdapter rf;
   rf.attach(nodemap->_Ptr);
 
   if (rf.openFile(name, std::ios::in))
   {
-    int length=std::numeric_limits<int>::max();
+    int64_t length=-1;
     try
     {
       // limit read operation to file size, if available
-      length=static_cast<int>(rcg::getInteger(nodemap, "FileSize", 0, 0, true));
+      length=rcg::getInteger(nodemap, "FileSize", 0, 0, true);
     }
     catch (const std::exception &)
     { }
 
-    size_t off=0, n=512;
-    std::vector<char> buffer(512);
+    uint64_t total=(length > 0 ? static_cast<uint64_t>(length) : 0);
+    auto start=std::chrono::steady_clock::now();
 
-    while (n > 0 && length > 0)
+    std::vector<char> buffer(getFileBlockSize(rf, name, std::ios::in, blocksize));
+    int64_t n=1;
+
+    while (n > 0 && (length < 0 || ret < static_cast<uint64_t>(length)))
     {
-      n=rf.read(buffer.data(), off, std::min(length, static_cast<int>(buffer.size())), name);
+      int64_t len=static_cast<int64_t>(buffer.size());
+
+      if (length >= 0)
+      {
+        len=std::min(len, length-static_cast<int64_t>(ret));
+      }
+
+      n=rf.read(buffer.data(), static_cast<int64_t>(ret), len, name);
 
       if (n == 0)
       {
@@ -1192,20 +1245,34 @@ std::string loadFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const
 
         if (n > 0)
         {
-          n=rf.read(buffer.data(), off, n, name);
+          n=rf.read(buffer.data(), static_cast<int64_t>(ret), std::min(n, len), name);
         }
       }
 
       if (n > 0)
       {
-        ret.append(buffer.data(), n);
-      }
+        out.write(buffer.data(), static_cast<std::streamsize>(n));
+
+        if (!out)
+        {
+          break;
+        }
+
+        ret+=static_cast<uint64_t>(n);
 
-      off+=n;
-      length-=n;
+        if (progress)
+        {
+          progress(ret, total, secondsSince(start));
+        }
+      }
     }
 
     rf.closeFile(name);
+
+    if (!out && exception)
+    {
+      throw std::invalid_argument(std::string("Cannot write data of file: ")+name);
+    }
   }
   else
   {
@@ -1219,37 +1286,77 @@ std::string loadFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const
 }
 
 bool saveFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *name,
-  const std::string &data, bool exception)
+  std::istream &in, bool exception, const FileProgressCallback &progress, size_t blocksize,
+  uint64_t total)
 {
   bool ret=true;
 
-  // store in pieces of 512 bytes
-
   GenApi::FileProtocolAdapter rf;
   rf.attach(nodemap->_Ptr);
 
   if (rf.openFile(name, std::ios::out))
   {
-    size_t off=0, n=512;
-    while (n > 0)
+    auto start=std::chrono::steady_clock::now();
+
+    std::vector<char> buffer(getFileBlockSize(rf, name, std::ios::out, blocksize));
+    uint64_t off=0;
+
+    while (ret && in)
     {
-      n=rf.write(data.c_str()+off, off, std::min(static_cast<size_t>(512), data.size()-off), name);
-      off+=n;
+      in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      int64_t len=static_cast<int64_t>(in.gcount());
+
+      // write block, which may need more than one write operation
+
+      int64_t i=0;
+      while (i < len)
+      {
+        int64_t n=rf.write(buffer.data()+i, static_cast<int64_t>(off), len-i, name);
+
+        if (n <= 0)
+        {
+          ret=false;
+          break;
+        }
+
+        i+=n;
+        off+=static_cast<uint64_t>(n);
+      }
+
+      if (progress && len > 0)
+      {
+        progress(off, total, secondsSince(start));
+      }
     }
 
     rf.closeFile(name);
 
-    if (off != data.size())
+    if (in.bad() && ret)
     {
       if (exception)
       {
-        std::ostringstream out;
-        out << "Error: Can only write " << off << " of " << data.size() << " bytes";
-        throw std::invalid_argument(out.str());
+        throw std::invalid_argument(std::string("Cannot read data for file: ")+name);
       }
 
       ret=false;
     }
+
+    if (!ret)
+    {
+      if (exception)
+      {
+        std::ostringstream out;
+        out << "Error: Can only write " << off;
+
+        if (total > 0)
+        {
+          out << " of " << total;
+        }
+
+        out << " bytes";
+        throw std::invalid_argument(out.str());
+      }
+    }
   }
   else
   {
@@ -1264,6 +1371,21 @@ bool saveFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *n
   return ret;
 }
 
+std::string loadFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *name,
+                     bool exception)
+{
+  std::ostringstream out;
+  loadFile(nodemap, name, out, exception);
+  return out.str();
+}
+
+bool saveFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *name,
+  const std::string &data, bool exception)
+{
+  std::istringstream in(data);
+  return saveFile(nodemap, name, in, exception, FileProgressCallback(), 0, data.size());
+}
+
 bool loadStreamableParameters(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *name,
   bool exception)
 {
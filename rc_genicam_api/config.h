@@ -42,6 +42,8 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <iosfwd>
+#include <functional>
 
 /*
   This module provides convenience functions for setting and retrieving values
@@ -379,6 +381,63 @@ std::string loadFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const
 bool saveFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *name,
   const std::string &data, bool exception=false);
 
+/**
+  Callback for reporting the progress of a file transfer via the GenICam
+  FileAccessControl interface. It is called after each transferred block.
+
+  @param done    Number of bytes that have been transferred so far.
+  @param total   Total number of bytes or 0 if unknown.
+  @param seconds Time since the start of the transfer in seconds.
+*/
+
+typedef std::function<void (uint64_t done, uint64_t total, double seconds)> FileProgressCallback;
+
+/**
+  Loads the contents of a file via the GenICam FileAccessControl interface
+  and writes it into the given stream. The file is transferred in blocks of
+  the size of the FileAccessBuffer register of the device, if the size is not
+  given explicitly.
+
+  @param nodemap   Initialized nodemap.
+  @param name      Name of file.
+  @param out       Output stream.
+  @param exception True if an error should be signaled via exception.
+  @param progress  Optional callback for reporting the progress.
+  @param blocksize Number of bytes per read operation. 0 means that the size
+                   of the FileAccessBuffer register is used. Larger values
+                   are limited to this size.
+  @return          Number of bytes that have been read.
+*/
+
+uint64_t loadFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *name,
+  std::ostream &out, bool exception=false,
+  const FileProgressCallback &progress=FileProgressCallback(), size_t blocksize=0);
+
+/**
+  Reads the given stream until its end and stores the data as file via the
+  GenICam FileAccessControl interface. The file is transferred in blocks of
+  the size of the FileAccessBuffer register of the device, if the size is not
+  given explicitly.
+
+  @param nodemap   Initialized nodemap.
+  @param name      Name of file.
+  @param in        Input stream.
+  @param exception True if an error should be signaled via exception.
+  @param progress  Optional callback for reporting the progress.
+  @param blocksize Number of bytes per write operation. 0 means that the size
+                   of the FileAccessBuffer register is used. Larger values
+                   are limited to this size.
+  @param total     Total number of bytes that will be read from the stream,
+                   only for reporting progress. 0 means unknown.
+  @return          True if file has been written successfully. False in case of
+                   an error.
+*/
+
+bool saveFile(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *name,
+  std::istream &in, bool exception=false,
+  const FileProgressCallback &progress=FileProgressCallback(), size_t blocksize=0,
+  uint64_t total=0);
+
 /**
   Load all streamable parameters from file into the nodemap.
 
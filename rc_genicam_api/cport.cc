@@ -36,15 +36,28 @@
 #include "cport.h"
 #include "exception.h"
 
+#include <Base/GCUtilities.h>
+#include <GenICamVersion.h>
+
+#include <iostream>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <cctype>
+#include <cstdlib>
+#include <cstdio>
 #include <string>
 #include <algorithm>
+#include <mutex>
 
 #ifdef _WIN32
+#include <direct.h>
+#include <process.h>
 #undef min
 #undef max
+#else
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 namespace rcg
@@ -53,85 +66,302 @@ namespace rcg
 CPort::CPort(std::shared_ptr<const GenTLWrapper> _gentl, void **_port) : gentl(_gentl)
 {
   port=_port;
+  batch=false;
+  stacked_read=true;
+  stacked_write=true;
+  transactions=0;
 }
 
 void CPort::Read(void *buffer, int64_t addr, int64_t length)
 {
-  size_t size=0;
+  std::lock_guard<std::mutex> lock(mtx);
 
   if (*port != 0)
   {
-    int retry=1;
-    GenTL::GC_ERROR err=GenTL::GC_ERR_ERROR;
-
-    while (err != GenTL::GC_ERR_SUCCESS && retry > 0)
-    {
-      retry--;
+    // queued writes must reach the device before reading
 
-      size=static_cast<size_t>(length);
-      err=gentl->GCReadPort(*port, static_cast<uint64_t>(addr), buffer, &size);
-    }
-
-    if (err != GenTL::GC_ERR_SUCCESS)
-    {
-      std::ostringstream out;
-      out << "CPort::Read(address=0x" << std::hex << addr << ", length=" <<
-        std::dec << static_cast<size_t>(length) << ")";
+    flushWrites();
+    readSingle(buffer, static_cast<uint64_t>(addr), static_cast<size_t>(length));
+  }
+  else
+  {
+    throw GenTLException("CPort::Read(): Port has been closed");
+  }
+}
 
-      throw GenTLException(out.str(), gentl);
-    }
+void CPort::Write(const void *buffer, int64_t addr, int64_t length)
+{
+  std::lock_guard<std::mutex> lock(mtx);
 
-    if (size == 0)
+  if (*port != 0)
+  {
+    if (batch)
     {
-      throw GenTLException("CPort::Read(): Returned size is 0");
+      queueWrite(buffer, static_cast<uint64_t>(addr), static_cast<size_t>(length));
     }
-
-    while (size < static_cast<size_t>(length))
+    else
     {
-      reinterpret_cast<uint8_t *>(buffer)[size++]=0;
+      writeSingle(buffer, static_cast<uint64_t>(addr), static_cast<size_t>(length));
     }
   }
   else
   {
-    throw GenTLException("CPort::Read(): Port has been closed");
+    throw GenTLException("CPort::Write(): Port has been closed");
   }
 }
 
-void CPort::Write(const void *buffer, int64_t addr, int64_t length)
+GenApi::EAccessMode CPort::GetAccessMode() const
 {
-  size_t size=static_cast<size_t>(length);
-
   if (*port != 0)
   {
-    if (gentl->GCWritePort(*port, static_cast<uint64_t>(addr), buffer, &size) !=
-        GenTL::GC_ERR_SUCCESS)
+    return GenApi::RW;
+  }
+
+  return GenApi::NA;
+}
+
+void CPort::Read(GenApi::PORT_REGISTER_STACK_ENTRY *entries, size_t numEntries)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+
+  if (*port == 0)
+  {
+    throw GenTLException("CPort::Read(): Port has been closed");
+  }
+
+  flushWrites();
+
+  // read with one stacked call or one after the other as fall back
+
+  if (numEntries > 1 && stacked_read && gentl->GCReadPortStacked.isAvailable())
+  {
+    std::vector<GenTL::PORT_REGISTER_STACK_ENTRY> stack(numEntries);
+
+    for (size_t i=0; i<numEntries; i++)
     {
-      std::ostringstream out;
-      out << "CPort::Write(address=0x" << std::hex << addr << ", length=" <<
-        std::dec << length << ")";
+      stack[i].Address=entries[i].Address;
+      stack[i].pBuffer=entries[i].pBuffer;
+      stack[i].Size=entries[i].Size;
+    }
 
-      throw GenTLException(out.str(), gentl);
+    size_t n=numEntries;
+
+    transactions++;
+    GenTL::GC_ERROR err=gentl->GCReadPortStacked(*port, stack.data(), &n);
+
+    if (err == GenTL::GC_ERR_SUCCESS)
+    {
+      return;
     }
 
-    if (size != static_cast<size_t>(length))
+    if (err != GenTL::GC_ERR_NOT_IMPLEMENTED)
     {
-      throw GenTLException("CPort::Write(): Returned size not as expected");
+      const uint64_t addr=entries[std::min(n, numEntries-1)].Address;
+
+      std::ostringstream out;
+      out << "CPort::Read(entries=" << numEntries << ", address=0x" << std::hex << addr << ")";
+
+      throw GenTLException(out.str(), addr, gentl);
     }
+
+    stacked_read=false;
   }
-  else
+
+  for (size_t i=0; i<numEntries; i++)
+  {
+    readSingle(entries[i].pBuffer, entries[i].Address, entries[i].Size);
+  }
+}
+
+void CPort::Write(GenApi::PORT_REGISTER_STACK_ENTRY *entries, size_t numEntries)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+
+  if (*port == 0)
   {
     throw GenTLException("CPort::Write(): Port has been closed");
   }
+
+  // queue all entries and send them immediately if not in batch mode
+
+  for (size_t i=0; i<numEntries; i++)
+  {
+    queueWrite(entries[i].pBuffer, entries[i].Address, entries[i].Size);
+  }
+
+  if (!batch)
+  {
+    flushWrites();
+  }
 }
 
-GenApi::EAccessMode CPort::GetAccessMode() const
+void CPort::startBatch()
 {
+  std::lock_guard<std::mutex> lock(mtx);
+  batch=true;
+}
+
+void CPort::endBatch()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  batch=false;
+
   if (*port != 0)
   {
-    return GenApi::RW;
+    flushWrites();
   }
+  else
+  {
+    pending.clear();
+  }
+}
 
-  return GenApi::NA;
+uint64_t CPort::getNumTransactions() const
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return transactions;
+}
+
+void CPort::setNodeMap(const std::shared_ptr<GenApi::CNodeMapRef> &_nodemap)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  nodemap=_nodemap;
+}
+
+void CPort::readSingle(void *buffer, uint64_t addr, size_t length)
+{
+  size_t size=0;
+  int retry=1;
+  GenTL::GC_ERROR err=GenTL::GC_ERR_ERROR;
+
+  while (err != GenTL::GC_ERR_SUCCESS && retry > 0)
+  {
+    retry--;
+
+    size=length;
+    transactions++;
+    err=gentl->GCReadPort(*port, addr, buffer, &size);
+  }
+
+  if (err != GenTL::GC_ERR_SUCCESS)
+  {
+    std::ostringstream out;
+    out << "CPort::Read(address=0x" << std::hex << addr << ", length=" <<
+      std::dec << length << ")";
+
+    throw GenTLException(out.str(), addr, gentl);
+  }
+
+  if (size == 0)
+  {
+    throw GenTLException("CPort::Read(): Returned size is 0", addr);
+  }
+
+  while (size < length)
+  {
+    reinterpret_cast<uint8_t *>(buffer)[size++]=0;
+  }
+}
+
+void CPort::writeSingle(const void *buffer, uint64_t addr, size_t length)
+{
+  size_t size=length;
+
+  transactions++;
+  if (gentl->GCWritePort(*port, addr, buffer, &size) != GenTL::GC_ERR_SUCCESS)
+  {
+    std::ostringstream out;
+    out << "CPort::Write(address=0x" << std::hex << addr << ", length=" <<
+      std::dec << length << ")";
+
+    throw GenTLException(out.str(), addr, gentl);
+  }
+
+  if (size != length)
+  {
+    std::ostringstream out;
+    out << "CPort::Write(address=0x" << std::hex << addr << "): Returned size not as expected";
+
+    throw GenTLException(out.str(), addr);
+  }
+}
+
+void CPort::queueWrite(const void *buffer, uint64_t addr, size_t length)
+{
+  const uint8_t *p=reinterpret_cast<const uint8_t *>(buffer);
+
+  PendingWrite w;
+  w.address=addr;
+  w.data.assign(p, p+length);
+  pending.push_back(std::move(w));
+}
+
+void CPort::flushWrites()
+{
+  if (pending.size() == 0)
+  {
+    return;
+  }
+
+  // the queue is empty afterwards, also in case of an error
+
+  std::vector<PendingWrite> list;
+  list.swap(pending);
+
+  try
+  {
+    if (list.size() > 1 && stacked_write && gentl->GCWritePortStacked.isAvailable())
+    {
+      std::vector<GenTL::PORT_REGISTER_STACK_ENTRY> stack(list.size());
+
+      for (size_t i=0; i<list.size(); i++)
+      {
+        stack[i].Address=list[i].address;
+        stack[i].pBuffer=list[i].data.data();
+        stack[i].Size=list[i].data.size();
+      }
+
+      size_t n=stack.size();
+
+      transactions++;
+      GenTL::GC_ERROR err=gentl->GCWritePortStacked(*port, stack.data(), &n);
+
+      if (err == GenTL::GC_ERR_SUCCESS)
+      {
+        return;
+      }
+
+      if (err != GenTL::GC_ERR_NOT_IMPLEMENTED)
+      {
+        const uint64_t addr=stack[std::min(n, stack.size()-1)].Address;
+
+        std::ostringstream out;
+        out << "CPort::Write(entries=" << stack.size() << ", address=0x" << std::hex << addr << ")";
+
+        throw GenTLException(out.str(), addr, gentl);
+      }
+
+      stacked_write=false;
+    }
+
+    for (size_t i=0; i<list.size(); i++)
+    {
+      writeSingle(list[i].data.data(), list[i].address, list[i].data.size());
+    }
+  }
+  catch (const GenTLException &)
+  {
+    // the cache of the nodemap contains values that did not reach the device
+
+    std::shared_ptr<GenApi::CNodeMapRef> p=nodemap.lock();
+
+    if (p)
+    {
+      p->_InvalidateNodes();
+    }
+
+    throw;
+  }
 }
 
 namespace
@@ -151,6 +381,508 @@ inline std::string toLower(const std::string &s, size_t start, size_t size)
   return out.str();
 }
 
+/*
+  Replaces all characters that may be critical in file names.
+*/
+
+std::string toFileName(std::string s)
+{
+  for (size_t k=0; k<s.size(); k++)
+  {
+    char c=s[k];
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != '.')
+    {
+      s[k]='_';
+    }
+  }
+
+  return s;
+}
+
+/*
+  Computes the SHA1 hash of the given data as 20 bytes, for verifying cached
+  XML files against the hash that is reported by the device.
+*/
+
+std::string computeSHA1(const char *data, size_t length)
+{
+  uint32_t h[5]={ 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+  // pad message with 0x80, zeros and the length in bits as big endian
+
+  std::string msg(data, length);
+  msg.push_back(static_cast<char>(0x80));
+
+  while (msg.size()%64 != 56)
+  {
+    msg.push_back('\0');
+  }
+
+  uint64_t bits=static_cast<uint64_t>(length)*8;
+  for (int i=7; i>=0; i--)
+  {
+    msg.push_back(static_cast<char>((bits>>(8*i))&0xff));
+  }
+
+  // process blocks of 512 bits
+
+  auto rol=[](uint32_t v, int n) { return (v<<n)|(v>>(32-n)); };
+
+  for (size_t block=0; block<msg.size(); block+=64)
+  {
+    uint32_t w[80];
+
+    for (int i=0; i<16; i++)
+    {
+      const uint8_t *b=reinterpret_cast<const uint8_t *>(msg.data()+block+4*i);
+      w[i]=(static_cast<uint32_t>(b[0])<<24)|(static_cast<uint32_t>(b[1])<<16)|
+           (static_cast<uint32_t>(b[2])<<8)|static_cast<uint32_t>(b[3]);
+    }
+
+    for (int i=16; i<80; i++)
+    {
+      w[i]=rol(w[i-3]^w[i-8]^w[i-14]^w[i-16], 1);
+    }
+
+    uint32_t a=h[0], b=h[1], c=h[2], d=h[3], e=h[4];
+
+    for (int i=0; i<80; i++)
+    {
+      uint32_t f, k;
+
+      if (i < 20)
+      {
+        f=(b&c)|(~b&d);
+        k=0x5a827999;
+      }
+      else if (i < 40)
+      {
+        f=b^c^d;
+        k=0x6ed9eba1;
+      }
+      else if (i < 60)
+      {
+        f=(b&c)|(b&d)|(c&d);
+        k=0x8f1bbcdc;
+      }
+      else
+      {
+        f=b^c^d;
+        k=0xca62c1d6;
+      }
+
+      uint32_t t=rol(a, 5)+f+e+k+w[i];
+      e=d;
+      d=c;
+      c=rol(b, 30);
+      b=a;
+      a=t;
+    }
+
+    h[0]+=a;
+    h[1]+=b;
+    h[2]+=c;
+    h[3]+=d;
+    h[4]+=e;
+  }
+
+  std::string ret;
+
+  for (int i=0; i<5; i++)
+  {
+    for (int j=3; j>=0; j--)
+    {
+      ret.push_back(static_cast<char>((h[i]>>(8*j))&0xff));
+    }
+  }
+
+  return ret;
+}
+
+#ifdef _WIN32
+const char PATH_SEP='\\';
+#else
+const char PATH_SEP='/';
+#endif
+
+/*
+  Creates the given directory including all parent directories. Returns false
+  if the directory does not exist afterwards.
+*/
+
+bool makeDirectory(const std::string &dir)
+{
+  for (size_t i=1; i <= dir.size(); i++)
+  {
+    if (i == dir.size() || dir[i] == '/' || dir[i] == '\\')
+    {
+      std::string sub=dir.substr(0, i);
+
+#ifdef _WIN32
+      _mkdir(sub.c_str());
+#else
+      mkdir(sub.c_str(), 0755);
+#endif
+    }
+  }
+
+#ifdef _WIN32
+  struct _stat st;
+  return _stat(dir.c_str(), &st) == 0 && (st.st_mode & _S_IFDIR) != 0;
+#else
+  struct stat st;
+  return stat(dir.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+/*
+  Returns the directory for caching XML files of devices or an empty string if
+  caching is disabled. The directory can be set with the environment variable
+  RCG_XML_CACHE. Setting it to an empty string disables caching.
+*/
+
+std::string getXMLCacheDirectory()
+{
+  static std::once_flag flag;
+  static std::string dir;
+
+  std::call_once(flag, []()
+  {
+    const char *env=std::getenv("RCG_XML_CACHE");
+
+    if (env != 0)
+    {
+      dir=env;
+    }
+    else
+    {
+#ifdef _WIN32
+      env=std::getenv("LOCALAPPDATA");
+
+      if (env != 0 && env[0] != '\0')
+      {
+        dir=std::string(env)+"\\rc_genicam_api";
+      }
+#else
+      env=std::getenv("XDG_CACHE_HOME");
+
+      if (env != 0 && env[0] != '\0')
+      {
+        dir=std::string(env)+"/rc_genicam_api";
+      }
+      else
+      {
+        env=std::getenv("HOME");
+
+        if (env != 0 && env[0] != '\0')
+        {
+          dir=std::string(env)+"/.cache/rc_genicam_api";
+        }
+      }
+#endif
+    }
+
+    while (dir.size() > 1 && (dir.back() == '/' || dir.back() == '\\'))
+    {
+      dir.pop_back();
+    }
+
+    if (dir.size() > 0)
+    {
+      if (makeDirectory(dir))
+      {
+        // let GenApi cache preprocessed XML files too, unless the user has
+        // already chosen a cache folder for GenApi
+
+        const char *genapi_cache=std::getenv(GENICAM_CACHE_VERSION);
+
+        if (genapi_cache == 0 || genapi_cache[0] == '\0')
+        {
+          std::string genapi_dir=dir+PATH_SEP+"genapi";
+
+          if (makeDirectory(genapi_dir))
+          {
+            GENICAM_NAMESPACE::SetGenICamCacheFolder(genapi_dir.c_str());
+          }
+        }
+      }
+      else
+      {
+        std::cerr << "rc_genicam_api: Cannot create XML cache directory: " << dir << std::endl;
+        dir="";
+      }
+    }
+  });
+
+  return dir;
+}
+
+/*
+  Returns an integer value of the URL info or -1 if it is not available.
+*/
+
+int32_t getURLInfoInt(const std::shared_ptr<const GenTLWrapper> &gentl, void *port,
+                      GenTL::URL_INFO_CMD cmd)
+{
+  GenTL::INFO_DATATYPE type;
+  int32_t value=-1;
+  size_t size=sizeof(value);
+
+  if (gentl->GCGetPortURLInfo(port, 0, cmd, &type, &value, &size) != GenTL::GC_ERR_SUCCESS ||
+      size != sizeof(value))
+  {
+    value=-1;
+  }
+
+  return value;
+}
+
+/*
+  Returns a string value of the port info or an empty string if it is not
+  available.
+*/
+
+std::string getPortInfoString(const std::shared_ptr<const GenTLWrapper> &gentl, void *port,
+                              GenTL::PORT_INFO_CMD cmd)
+{
+  GenTL::INFO_DATATYPE type;
+  char tmp[256]="";
+  size_t size=sizeof(tmp);
+
+  if (gentl->GCGetPortInfo(port, cmd, &type, tmp, &size) != GenTL::GC_ERR_SUCCESS)
+  {
+    tmp[0]='\0';
+  }
+
+  tmp[sizeof(tmp)-1]='\0';
+
+  return std::string(tmp);
+}
+
+/*
+  Returns the file name of the given local XML file in the cache, which is
+  derived from the vendor and model of the port, the name in the URL, the
+  schema and file version, the SHA1 hash and the length. The SHA1 hash is
+  also returned as 20 bytes in sha1 or as empty string if the device does
+  not offer it. An empty string is returned if the device offers neither a
+  SHA1 hash nor a file version, since a changed file could then not be
+  detected.
+*/
+
+std::string getXMLCacheName(const std::shared_ptr<const GenTLWrapper> &gentl, void *port,
+                            const std::string &name, size_t length, std::string &sha1)
+{
+  std::ostringstream out;
+
+  // use the name without path and characters that may be critical in file names
+
+  size_t i=name.find_last_of("/\\");
+  i=(i == std::string::npos ? 0 : i+1);
+
+  std::string base=name.substr(i);
+  std::string suffix;
+
+  if (base.size() > 4 && toLower(base, base.size()-4, 4) == ".zip")
+  {
+    suffix=".zip";
+    base=base.substr(0, base.size()-4);
+  }
+  else
+  {
+    suffix=".xml";
+
+    if (base.size() > 4 && toLower(base, base.size()-4, 4) == ".xml")
+    {
+      base=base.substr(0, base.size()-4);
+    }
+  }
+
+  // different devices may use the same file name and version
+
+  std::string vendor=getPortInfoString(gentl, port, GenTL::PORT_INFO_VENDOR);
+  std::string model=getPortInfoString(gentl, port, GenTL::PORT_INFO_MODEL);
+
+  if (vendor.size() > 0 || model.size() > 0)
+  {
+    out << toFileName(vendor) << "_" << toFileName(model) << "_";
+  }
+
+  out << toFileName(base);
+
+  // append schema and file version
+
+  int32_t schema_major=getURLInfoInt(gentl, port, GenTL::URL_INFO_SCHEMA_VER_MAJOR);
+  int32_t schema_minor=getURLInfoInt(gentl, port, GenTL::URL_INFO_SCHEMA_VER_MINOR);
+  int32_t major=getURLInfoInt(gentl, port, GenTL::URL_INFO_FILE_VER_MAJOR);
+  int32_t minor=getURLInfoInt(gentl, port, GenTL::URL_INFO_FILE_VER_MINOR);
+  int32_t subminor=getURLInfoInt(gentl, port, GenTL::URL_INFO_FILE_VER_SUBMINOR);
+
+  bool unique=false;
+
+  if (schema_major >= 0 && schema_minor >= 0)
+  {
+    out << "_s" << schema_major << "." << schema_minor;
+  }
+
+  if (major >= 0 && minor >= 0 && subminor >= 0)
+  {
+    out << "_v" << major << "." << minor << "." << subminor;
+    unique=true;
+  }
+
+  // append SHA1 hash
+
+  GenTL::INFO_DATATYPE type;
+  uint8_t hash[20];
+  size_t size=sizeof(hash);
+
+  sha1.clear();
+
+  if (gentl->GCGetPortURLInfo(port, 0, GenTL::URL_INFO_FILE_SHA1_HASH, &type, hash, &size) ==
+      GenTL::GC_ERR_SUCCESS && size == sizeof(hash))
+  {
+    bool zero=true;
+    for (size_t k=0; k<sizeof(hash); k++)
+    {
+      zero=zero && hash[k] == 0;
+    }
+
+    if (!zero)
+    {
+      out << "_" << std::hex << std::setfill('0');
+
+      for (size_t k=0; k<sizeof(hash); k++)
+      {
+        out << std::setw(2) << static_cast<int>(hash[k]);
+      }
+
+      out << std::dec;
+      sha1.assign(reinterpret_cast<const char *>(hash), sizeof(hash));
+      unique=true;
+    }
+  }
+
+  if (!unique)
+  {
+    return std::string();
+  }
+
+  out << "_" << length << suffix;
+
+  return out.str();
+}
+
+/*
+  Reads the cached file into the given buffer, which gets one additional byte
+  for a terminating 0. Returns false if the file does not exist or does not
+  have the expected length. If sha1 is not empty, the hash of the file must
+  be the same, otherwise the file is removed and false is returned.
+*/
+
+bool readXMLCache(const std::string &file, std::unique_ptr<char[]> &buffer, size_t length,
+                  const std::string &sha1)
+{
+  std::ifstream in(file, std::ios::binary);
+
+  if (in.good())
+  {
+    in.seekg(0, std::ios::end);
+
+    if (in.good() && static_cast<size_t>(in.tellg()) == length)
+    {
+      in.seekg(0, std::ios::beg);
+
+      std::unique_ptr<char[]> tmp(new char[length+1]);
+
+      if (in.rdbuf()->sgetn(tmp.get(), static_cast<std::streamsize>(length)) ==
+          static_cast<std::streamsize>(length))
+      {
+        tmp.get()[length]='\0';
+
+        if (sha1.size() > 0 && computeSHA1(tmp.get(), length) != sha1)
+        {
+          in.close();
+          std::remove(file.c_str());
+          return false;
+        }
+
+        buffer=std::move(tmp);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/*
+  Stores the buffer in the cache. The file is first written under a temporary
+  name and then renamed, so that concurrent processes never see incomplete
+  files.
+*/
+
+void writeXMLCache(const std::string &file, const char *buffer, size_t length)
+{
+  std::ostringstream tmpname;
+
+#ifdef _WIN32
+  tmpname << file << "." << _getpid() << ".tmp";
+#else
+  tmpname << file << "." << getpid() << ".tmp";
+#endif
+
+  bool ok=false;
+
+  {
+    std::ofstream out(tmpname.str(), std::ios::binary);
+
+    ok=out.good() && out.rdbuf()->sputn(buffer, static_cast<std::streamsize>(length)) ==
+       static_cast<std::streamsize>(length);
+  }
+
+  if (!ok || std::rename(tmpname.str().c_str(), file.c_str()) != 0)
+  {
+    std::remove(tmpname.str().c_str());
+  }
+}
+
+/*
+  Reads the XML or ZIP file from the registers of the device into the given
+  buffer, which gets one additional byte for a terminating 0. The length is
+  updated to the number of bytes that have been read.
+*/
+
+void readXMLFromPort(const std::shared_ptr<const GenTLWrapper> &gentl, void *port,
+                     uint64_t address, std::unique_ptr<char[]> &buffer, size_t &length)
+{
+  buffer.reset(new char[length+1]);
+
+  if (gentl->GCReadPort(port, address, buffer.get(), &length) != GenTL::GC_ERR_SUCCESS)
+  {
+    throw GenTLException("allocNodeMap()", gentl);
+  }
+
+  buffer.get()[length]='\0';
+}
+
+/*
+  Loads the XML or ZIP file from the buffer into the nodemap.
+*/
+
+void loadXMLFromBuffer(GenApi::CNodeMapRef &nodemap, const std::string &name,
+                       const char *buffer, size_t length)
+{
+  if (name.size() > 4 && toLower(name, name.size()-4, 4) == ".zip")
+  {
+    nodemap._LoadXMLFromZIPData(buffer, length);
+  }
+  else
+  {
+    GENICAM_NAMESPACE::gcstring sxml=buffer;
+    nodemap._LoadXMLFromString(sxml);
+  }
+}
+
 }
 
 std::shared_ptr<GenApi::CNodeMapRef> allocNodeMap(std::shared_ptr<const GenTLWrapper> gentl,
@@ -208,16 +940,64 @@ std::shared_ptr<GenApi::CNodeMapRef> allocNodeMap(std::shared_ptr<const GenTLWra
       uint64_t address=std::stoull(saddress, 0, 16);
       size_t length=static_cast<size_t>(std::stoull(slength, 0, 16));
 
-      // read XML or ZIP from registers
+      // get XML or ZIP from cache if available
+
+      std::unique_ptr<char[]> buffer;
+      std::string cache_file, sha1;
+
+      std::string cache_dir=getXMLCacheDirectory();
+      if (cache_dir.size() > 0)
+      {
+        std::string cache_name=getXMLCacheName(gentl, port, name, length, sha1);
+
+        if (cache_name.size() > 0)
+        {
+          cache_file=cache_dir+PATH_SEP+cache_name;
+        }
+      }
+
+      const size_t url_length=length;
+      bool cached=(cache_file.size() > 0 && readXMLCache(cache_file, buffer, length, sha1));
+
+      if (!cached)
+      {
+        // read XML or ZIP from registers
+
+        readXMLFromPort(gentl, port, address, buffer, length);
+
+        if (cache_file.size() > 0 && length == url_length)
+        {
+          writeXMLCache(cache_file, buffer.get(), length);
+        }
+      }
 
-      std::unique_ptr<char[]> buffer(new char[length+1]);
+      // load XML or ZIP from buffer, a cached file that cannot be parsed is
+      // removed and replaced by the file from the device
 
-      if (gentl->GCReadPort(port, address, buffer.get(), &length) != GenTL::GC_ERR_SUCCESS)
+      try
       {
-        throw GenTLException("allocNodeMap()", gentl);
+        loadXMLFromBuffer(*nodemap, name, buffer.get(), length);
       }
+      catch (const GENICAM_NAMESPACE::GenericException &)
+      {
+        if (!cached)
+        {
+          throw;
+        }
+
+        std::remove(cache_file.c_str());
 
-      buffer.get()[length]='\0';
+        length=url_length;
+        readXMLFromPort(gentl, port, address, buffer, length);
+
+        if (length == url_length)
+        {
+          writeXMLCache(cache_file, buffer.get(), length);
+        }
+
+        nodemap.reset(new GenApi::CNodeMapRef());
+        loadXMLFromBuffer(*nodemap, name, buffer.get(), length);
+      }
 
       // store XML file
 
@@ -232,18 +1012,6 @@ std::shared_ptr<GenApi::CNodeMapRef> allocNodeMap(std::shared_ptr<const GenTLWra
 
         out.rdbuf()->sputn(buffer.get(), static_cast<std::streamsize>(length));
       }
-
-      // load XML or ZIP from registers
-
-      if (name.size() > 4 && toLower(name, name.size()-4, 4) == ".zip")
-      {
-        nodemap->_LoadXMLFromZIPData(buffer.get(), length);
-      }
-      else
-      {
-        GENICAM_NAMESPACE::gcstring sxml=buffer.get();
-        nodemap->_LoadXMLFromString(sxml);
-      }
     }
     else if (toLower(url, 0, 5) == "file:")
     {
@@ -290,6 +1058,8 @@ std::shared_ptr<GenApi::CNodeMapRef> allocNodeMap(std::shared_ptr<const GenTLWra
     {
       throw GenTLException((std::string("allocNodeMap(): Cannot connect port: ")+tmp).c_str());
     }
+
+    cport->setNodeMap(nodemap);
   }
   catch (const GENICAM_NAMESPACE::GenericException &ex)
   {
@@ -40,6 +40,10 @@
 
 #include <GenApi/GenApi.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace rcg
 {
 
@@ -47,9 +51,21 @@ namespace rcg
   This is the port definition that connects GenAPI to GenTL. It is implemented
   such that it works with a pointer to a handle. The methods do nothing if the
   handle is 0.
+
+  Stacked accesses are forwarded to GCReadPortStacked() and
+  GCWritePortStacked(), so that the transport layer can send them in one
+  round trip. If the transport layer does not implement stacked accesses, the
+  entries are accessed one after the other.
+
+  In batch mode, writes are queued and sent together with one stacked call
+  before the next read or at the end of the batch. Thus, errors of queued
+  writes are reported by the call that sends them. The exception contains the
+  address of the failing register and all nodes of the connected nodemap are
+  invalidated, since its cache may contain values that never reached the
+  device.
 */
 
-class CPort : public GenApi::IPort
+class CPort : public GenApi::IPortStacked
 {
   public:
 
@@ -59,10 +75,83 @@ class CPort : public GenApi::IPort
     void Write(const void *buffer, int64_t addr, int64_t length);
     GenApi::EAccessMode GetAccessMode() const;
 
+    /**
+      Reads all given registers with one call to the transport layer if
+      possible.
+
+      @param entries    List of entries with address, buffer and size.
+      @param numEntries Number of entries.
+    */
+
+    void Read(GenApi::PORT_REGISTER_STACK_ENTRY *entries, size_t numEntries);
+
+    /**
+      Writes all given registers with one call to the transport layer if
+      possible. The entries are queued in batch mode.
+
+      @param entries    List of entries with address, buffer and size.
+      @param numEntries Number of entries.
+    */
+
+    void Write(GenApi::PORT_REGISTER_STACK_ENTRY *entries, size_t numEntries);
+
+    /**
+      Starts queuing of writes.
+    */
+
+    void startBatch();
+
+    /**
+      Sends all queued writes and leaves batch mode. A GenTLException is thrown
+      if sending fails. Batch mode is left in any case.
+    */
+
+    void endBatch();
+
+    /**
+      Returns the number of calls to the transport layer for accessing
+      registers, which is useful for judging the effect of batching.
+
+      @return Number of read and write calls.
+    */
+
+    uint64_t getNumTransactions() const;
+
+    /**
+      Sets the nodemap that is connected to this port. Its nodes are
+      invalidated if sending of queued writes fails.
+
+      @param nodemap Nodemap.
+    */
+
+    void setNodeMap(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap);
+
   private:
 
+    CPort(class CPort &); // forbidden
+    CPort &operator=(const CPort &); // forbidden
+
+    struct PendingWrite
+    {
+      uint64_t address;
+      std::vector<uint8_t> data;
+    };
+
+    void readSingle(void *buffer, uint64_t addr, size_t length);
+    void writeSingle(const void *buffer, uint64_t addr, size_t length);
+    void queueWrite(const void *buffer, uint64_t addr, size_t length);
+    void flushWrites();
+
     std::shared_ptr<const GenTLWrapper> gentl;
     void **port;
+
+    mutable std::mutex mtx;
+    bool batch;
+    std::vector<PendingWrite> pending;
+    bool stacked_read;
+    bool stacked_write;
+    uint64_t transactions;
+    std::weak_ptr<GenApi::CNodeMapRef> nodemap;
 };
 
 /**
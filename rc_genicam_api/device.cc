@@ -42,6 +42,13 @@
 #include "cport.h"
 
 #include <iostream>
+#include <future>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 namespace rcg
 {
@@ -57,10 +64,21 @@ Device::Device(const std::shared_ptr<Interface> &_parent,
   dev=0;
   rp=0;
   event=0;
+
+  dispatching=false;
+  next_handle=1;
+
+  stat.queue_depth=0;
+  stat.max_queue_depth=0;
+  stat.dispatched=0;
+  stat.mean_latency=0;
+  stat.max_latency=0;
 }
 
 Device::~Device()
 {
+  stopModuleEventDispatcher();
+
   if (n_open > 0)
   {
     try
@@ -141,6 +159,20 @@ void Device::open(ACCESS access)
 
 void Device::close()
 {
+  // the dispatcher must be stopped before the event is unregistered
+
+  bool last=false;
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    last=(n_open == 1);
+  }
+
+  if (last)
+  {
+    stopModuleEventDispatcher();
+  }
+
   std::lock_guard<std::mutex> lock(mtx);
 
   if (n_open > 0)
@@ -151,6 +183,20 @@ void Device::close()
     {
       eventadapter.reset();
 
+      // send writes that are still queued
+
+      if (rport)
+      {
+        try
+        {
+          rport->endBatch();
+        }
+        catch (const std::exception &ex)
+        {
+          std::cerr << "Device::close(): " << ex.what() << std::endl;
+        }
+      }
+
       if (event)
       {
         gentl->GCUnregisterEvent(dev, GenTL::EVENT_MODULE);
@@ -240,19 +286,13 @@ std::string cDevGetInfo(const Device *obj, const std::shared_ptr<const GenTLWrap
 
 }
 
-int64_t Device::getModuleEvent(int64_t _timeout)
+int64_t Device::receiveModuleEvent(uint64_t timeout, size_t &size)
 {
   int64_t eventid=-1;
-  uint64_t timeout=GENTL_INFINITE;
 
   {
     std::lock_guard<std::mutex> lock(mtx);
 
-    if (_timeout >= 0)
-    {
-      timeout=static_cast<uint64_t>(_timeout);
-    }
-
     // check that streaming had been started
 
     if (event == 0)
@@ -275,19 +315,12 @@ int64_t Device::getModuleEvent(int64_t _timeout)
         event_value.resize(value);
       }
     }
-
-    // clear buffer
-
-    for (size_t i=0; i<event_buffer.size(); i++)
-    {
-      event_buffer[i]=0;
-      event_value[i]=0;
-    }
   }
 
-  // get event data
+  // get event data, the producer reports the number of valid bytes so that
+  // the buffers do not have to be cleared before
 
-  size_t size=event_buffer.size();
+  size=event_buffer.size();
 
   GenTL::GC_ERROR err=gentl->EventGetData(event, event_buffer.data(), &size, timeout);
 
@@ -314,7 +347,7 @@ int64_t Device::getModuleEvent(int64_t _timeout)
   {
     GenTL::INFO_DATATYPE type=GenTL::INFO_DATATYPE_UNKNOWN;
     char tmp[80];
-    size_t tmp_size=sizeof(tmp);
+    size_t tmp_size=sizeof(tmp)-1;
 
     err=gentl->EventGetDataInfo(event, event_buffer.data(), size, GenTL::EVENT_DATA_ID,
       &type, tmp, &tmp_size);
@@ -326,6 +359,7 @@ int64_t Device::getModuleEvent(int64_t _timeout)
 
     if (type == GenTL::INFO_DATATYPE_STRING)
     {
+      tmp[std::min(tmp_size, sizeof(tmp)-1)]='\0';
       eventid=std::stoi(std::string(tmp), 0, 16);
     }
     else if (type == GenTL::INFO_DATATYPE_INT32)
@@ -340,9 +374,10 @@ int64_t Device::getModuleEvent(int64_t _timeout)
 
   {
     GenTL::INFO_DATATYPE type=GenTL::INFO_DATATYPE_UNKNOWN;
+    size_t data_size=size;
     size=event_value.size();
 
-    err=gentl->EventGetDataInfo(event, event_buffer.data(), size, GenTL::EVENT_DATA_VALUE,
+    err=gentl->EventGetDataInfo(event, event_buffer.data(), data_size, GenTL::EVENT_DATA_VALUE,
       &type, event_value.data(), &size);
 
     if (err != GenTL::GC_ERR_SUCCESS)
@@ -375,6 +410,28 @@ int64_t Device::getModuleEvent(int64_t _timeout)
   return eventid;
 }
 
+int64_t Device::getModuleEvent(int64_t _timeout)
+{
+  uint64_t timeout=GENTL_INFINITE;
+
+  if (_timeout >= 0)
+  {
+    timeout=static_cast<uint64_t>(_timeout);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(dispatch_mtx);
+
+    if (dispatching)
+    {
+      return -4;
+    }
+  }
+
+  size_t size=0;
+  return receiveModuleEvent(timeout, size);
+}
+
 void Device::abortWaitingForModuleEvents()
 {
   std::lock_guard<std::mutex> lock(mtx);
@@ -385,6 +442,167 @@ void Device::abortWaitingForModuleEvents()
   }
 }
 
+int Device::addModuleEventCallback(int64_t eventid, const ModuleEventCallback &cb)
+{
+  std::lock_guard<std::mutex> lock(cb_mtx);
+
+  EventCallback item;
+  item.handle=next_handle++;
+  item.eventid=eventid;
+  item.cb=cb;
+
+  callback.push_back(item);
+
+  return item.handle;
+}
+
+void Device::removeModuleEventCallback(int handle)
+{
+  std::lock_guard<std::mutex> lock(cb_mtx);
+
+  for (size_t i=0; i<callback.size(); i++)
+  {
+    if (callback[i].handle == handle)
+    {
+      callback.erase(callback.begin()+i);
+      break;
+    }
+  }
+}
+
+void Device::startModuleEventDispatcher()
+{
+  enableModuleEvents();
+
+  std::lock_guard<std::mutex> lock(dispatch_mtx);
+
+  if (!dispatching)
+  {
+    if (dispatcher.joinable())
+    {
+      dispatcher.join();
+    }
+
+    dispatching=true;
+    dispatcher=std::thread(&Device::dispatchModuleEvents, this);
+  }
+}
+
+void Device::stopModuleEventDispatcher()
+{
+  std::thread t;
+
+  {
+    std::lock_guard<std::mutex> lock(dispatch_mtx);
+
+    if (dispatching)
+    {
+      dispatching=false;
+      abortWaitingForModuleEvents();
+    }
+
+    t.swap(dispatcher);
+  }
+
+  if (t.joinable())
+  {
+    t.join();
+  }
+}
+
+ModuleEventStatistics Device::getModuleEventStatistics()
+{
+  std::lock_guard<std::mutex> lock(dispatch_mtx);
+  return stat;
+}
+
+void Device::dispatchModuleEvents()
+{
+  double total_latency=0;
+
+  while (true)
+  {
+    {
+      std::lock_guard<std::mutex> lock(dispatch_mtx);
+
+      if (!dispatching)
+      {
+        break;
+      }
+    }
+
+    // wait for the next event, which also attaches it to the nodemap, with
+    // a timeout for the case that stopping happens before waiting
+
+    int64_t eventid=-1;
+    size_t size=0;
+
+    std::chrono::steady_clock::time_point t0;
+
+    try
+    {
+      eventid=receiveModuleEvent(200, size);
+      t0=std::chrono::steady_clock::now();
+    }
+    catch (const std::exception &ex)
+    {
+      std::cerr << "Device::dispatchModuleEvents(): " << ex.what() << std::endl;
+
+      std::lock_guard<std::mutex> lock(dispatch_mtx);
+      dispatching=false;
+      break;
+    }
+
+    if (eventid == -3)
+    {
+      break;
+    }
+
+    if (eventid < 0)
+    {
+      continue;
+    }
+
+    size_t depth=static_cast<size_t>(getAvailableModuleEvents());
+
+    // deliver event to all callbacks that are registered for the ID, the
+    // event data is passed without copying, since nobody else receives
+    // events while the dispatcher is running
+
+    {
+      std::lock_guard<std::mutex> lock(cb_mtx);
+
+      for (size_t i=0; i<callback.size(); i++)
+      {
+        if (callback[i].eventid < 0 || callback[i].eventid == eventid)
+        {
+          try
+          {
+            callback[i].cb(eventid, event_value.data(), size);
+          }
+          catch (const std::exception &ex)
+          {
+            std::cerr << "Device::dispatchModuleEvents(): " << ex.what() << std::endl;
+          }
+        }
+      }
+    }
+
+    double latency=std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-
+      t0).count();
+
+    std::lock_guard<std::mutex> lock(dispatch_mtx);
+
+    stat.queue_depth=depth;
+    stat.max_queue_depth=std::max(stat.max_queue_depth, depth);
+    stat.dispatched++;
+
+    total_latency+=latency;
+    stat.mean_latency=total_latency/stat.dispatched;
+    stat.max_latency=std::max(stat.max_latency, latency);
+  }
+}
+
 namespace
 {
 
@@ -681,16 +899,68 @@ std::shared_ptr<CPort> Device::getRemotePort()
   return rport;
 }
 
+void Device::startRemoteBatch()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+
+  if (rport)
+  {
+    rport->startBatch();
+  }
+}
+
+void Device::endRemoteBatch()
+{
+  std::shared_ptr<CPort> p;
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    p=rport;
+  }
+
+  if (p)
+  {
+    p->endBatch();
+  }
+}
+
+uint64_t Device::getNumRemoteTransactions()
+{
+  std::shared_ptr<CPort> p;
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    p=rport;
+  }
+
+  if (p)
+  {
+    return p->getNumTransactions();
+  }
+
+  return 0;
+}
+
 void *Device::getHandle() const
 {
   return dev;
 }
 
-std::vector<std::shared_ptr<Device> > getDevices(uint64_t timeout)
+namespace
 {
-  std::vector<std::shared_ptr<Device> > ret;
 
-  std::vector<std::shared_ptr<System> > system=System::getSystems();
+/*
+  Opens all systems and returns all their interfaces. The system index of each
+  interface is optionally returned as well. The systems must be closed after
+  the interfaces have been opened.
+*/
+
+std::vector<std::shared_ptr<Interface> > openSystems(std::vector<std::shared_ptr<System> > &system,
+  std::vector<size_t> *system_index=0)
+{
+  std::vector<std::shared_ptr<Interface> > ret;
+
+  system=System::getSystems();
 
   for (size_t i=0; i<system.size(); i++)
   {
@@ -700,19 +970,196 @@ std::vector<std::shared_ptr<Device> > getDevices(uint64_t timeout)
 
     for (size_t k=0; k<interf.size(); k++)
     {
-      interf[k]->open();
+      ret.push_back(interf[k]);
+
+      if (system_index != 0)
+      {
+        system_index->push_back(i);
+      }
+    }
+  }
+
+  return ret;
+}
 
-      std::vector<std::shared_ptr<Device> > device=interf[k]->getDevices(timeout);
+void closeSystems(std::vector<std::shared_ptr<System> > &system)
+{
+  for (size_t i=0; i<system.size(); i++)
+  {
+    system[i]->close();
+  }
+}
+
+/*
+  Shared state of the threads that search for a device on different
+  interfaces in parallel.
+*/
+
+struct DeviceSearch
+{
+  std::mutex mtx;
+  std::condition_variable cv;
+  size_t pending;
+  std::vector<std::shared_ptr<Device> > found;
+  std::vector<size_t> found_system;
+  std::exception_ptr error;
+};
+
+/*
+  Threads of searches that were still running when the device has already been
+  found. They are joined on the next search, by System::clearSystems() or at
+  program exit.
+*/
+
+class PendingSearches
+{
+  public:
+
+    ~PendingSearches()
+    {
+      join();
+    }
+
+    void join()
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      for (size_t i=0; i<list.size(); i++)
+      {
+        for (size_t k=0; k<list[i].second.size(); k++)
+        {
+          list[i].second[k].join();
+        }
+      }
+
+      list.clear();
+    }
+
+    void add(const std::shared_ptr<DeviceSearch> &search, std::vector<std::thread> &thread)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      // join threads of searches that have finished in the meantime
+
+      size_t j=0;
+      for (size_t i=0; i<list.size(); i++)
+      {
+        bool done;
+
+        {
+          std::lock_guard<std::mutex> search_lock(list[i].first->mtx);
+          done=(list[i].first->pending == 0);
+        }
+
+        if (done)
+        {
+          for (size_t k=0; k<list[i].second.size(); k++)
+          {
+            list[i].second[k].join();
+          }
+        }
+        else
+        {
+          if (j != i)
+          {
+            list[j]=std::move(list[i]);
+          }
+
+          j++;
+        }
+      }
+
+      list.resize(j);
+
+      list.push_back(std::make_pair(search, std::move(thread)));
+    }
+
+  private:
+
+    std::mutex mtx;
+    std::vector<std::pair<std::shared_ptr<DeviceSearch>, std::vector<std::thread> > > list;
+};
+
+/*
+  The pending searches are created on first use, i.e. after the list of
+  systems, so that they are destroyed and joined at exit before the systems
+  and their producers.
+*/
+
+PendingSearches &getPendingSearches()
+{
+  static PendingSearches pending_searches;
+  return pending_searches;
+}
+
+}
+
+std::vector<std::shared_ptr<Device> > getDevices(uint64_t timeout)
+{
+  std::vector<std::shared_ptr<Device> > ret;
+
+  std::vector<std::shared_ptr<System> > system;
+  std::vector<std::shared_ptr<Interface> > interf=openSystems(system);
+
+  // discover devices on all interfaces in parallel
+
+  std::vector<std::future<std::vector<std::shared_ptr<Device> > > > result;
+
+  for (size_t k=0; k<interf.size(); k++)
+  {
+    std::shared_ptr<Interface> p=interf[k];
+
+    p->open();
+
+    result.push_back(std::async(std::launch::async, [p, timeout]()
+    {
+      std::vector<std::shared_ptr<Device> > device;
+
+      try
+      {
+        device=p->getDevices(timeout);
+      }
+      catch (...)
+      {
+        p->close();
+        throw;
+      }
+
+      p->close();
+
+      return device;
+    }));
+  }
+
+  // collect devices in the order of systems and interfaces
+
+  std::exception_ptr error;
+
+  for (size_t k=0; k<result.size(); k++)
+  {
+    try
+    {
+      std::vector<std::shared_ptr<Device> > device=result[k].get();
 
       for (size_t j=0; j<device.size(); j++)
       {
         ret.push_back(device[j]);
       }
-
-      interf[k]->close();
     }
+    catch (...)
+    {
+      if (!error)
+      {
+        error=std::current_exception();
+      }
+    }
+  }
 
-    system[i]->close();
+  closeSystems(system);
+
+  if (error)
+  {
+    std::rethrow_exception(error);
   }
 
   return ret;
@@ -725,7 +1172,6 @@ std::vector<std::shared_ptr<Device> > getDevices()
 
 std::shared_ptr<Device> getDevice(const char *id, uint64_t timeout)
 {
-  int found=0;
   std::shared_ptr<Device> ret;
 
   if (id != 0 && *id != '\0')
@@ -742,70 +1188,142 @@ std::shared_ptr<Device> getDevice(const char *id, uint64_t timeout)
       devid=devid.substr(p+1);
     }
 
-    // go through all systems
+    // get all interfaces of all systems
 
-    std::vector<std::shared_ptr<System> > system=System::getSystems();
+    std::vector<std::shared_ptr<System> > system;
+    std::vector<size_t> system_index;
+    std::vector<std::shared_ptr<Interface> > interf=openSystems(system, &system_index);
 
-    for (size_t i=0; i<system.size(); i++)
-    {
-      system[i]->open();
+    // search the device on all interfaces or only on the specified interface
+    // in parallel
 
-      // get all interfaces
+    std::shared_ptr<DeviceSearch> search(new DeviceSearch());
+    search->pending=0;
 
-      std::vector<std::shared_ptr<Interface> > interf=system[i]->getInterfaces();
+    std::vector<std::thread> thread;
 
-      if (interfid.size() > 0)
+    try
+    {
+      for (size_t k=0; k<interf.size(); k++)
       {
-        // if an interface is defined, then only search this interface
-
-        for (size_t k=0; k<interf.size(); k++)
+        if (interfid.size() == 0 || interf[k]->getID() == interfid)
         {
-          if (interf[k]->getID() == interfid)
+          std::shared_ptr<Interface> ip=interf[k];
+          size_t si=system_index[k];
+
+          ip->open();
+
+          {
+            std::lock_guard<std::mutex> lock(search->mtx);
+            search->pending++;
+          }
+
+          thread.push_back(std::thread([search, ip, si, devid, timeout]()
           {
-            interf[k]->open();
+            std::shared_ptr<Device> dev;
+            std::exception_ptr error;
+
+            try
+            {
+              dev=ip->getDevice(devid.c_str(), timeout);
+            }
+            catch (...)
+            {
+              error=std::current_exception();
+            }
+
+            ip->close();
 
-            std::shared_ptr<Device> dev=interf[k]->getDevice(devid.c_str(), timeout);
+            std::lock_guard<std::mutex> lock(search->mtx);
 
             if (dev)
             {
-              ret=dev;
-              found++;
+              search->found.push_back(dev);
+              search->found_system.push_back(si);
             }
 
-            interf[k]->close();
-          }
+            if (error && !search->error)
+            {
+              search->error=error;
+            }
+
+            search->pending--;
+            search->cv.notify_all();
+          }));
         }
       }
-      else
+    }
+    catch (...)
+    {
+      for (size_t k=0; k<thread.size(); k++)
       {
-        // if interface is not defined, then check all interfaces
+        thread[k].join();
+      }
 
-        std::shared_ptr<Device> dev;
-        for (size_t k=0; k<interf.size() && !dev; k++)
-        {
-          interf[k]->open();
+      closeSystems(system);
+      throw;
+    }
 
-          dev=interf[k]->getDevice(devid.c_str(), timeout);
+    // systems are kept open by the interfaces as long as needed
 
-          if (dev)
-          {
-            ret=dev;
-            found++;
-          }
+    closeSystems(system);
+
+    // wait until the device is found or all searches are finished
 
-          interf[k]->close();
+    std::exception_ptr error;
+    bool done;
+
+    {
+      std::unique_lock<std::mutex> lock(search->mtx);
+
+      search->cv.wait(lock, [search]()
+      {
+        return search->pending == 0 || search->found.size() > 0;
+      });
+
+      // a device may be found through different interfaces of the same
+      // producer, but not through different producers
+
+      for (size_t i=0; i<search->found.size(); i++)
+      {
+        if (search->found_system[i] != search->found_system[0])
+        {
+          std::cerr << "ERROR: Finding device '" << id << "' through different producers."
+                    << std::endl;
+
+          search->found.clear();
+          break;
         }
       }
 
-      system[i]->close();
+      if (search->found.size() > 0)
+      {
+        ret=search->found[0];
+      }
+      else
+      {
+        error=search->error;
+      }
+
+      done=(search->pending == 0);
     }
-  }
 
-  if (found > 1)
-  {
-    std::cerr << "ERROR: Finding device '" << id << "' through different producers."
-              << std::endl;
-    ret.reset();
+    if (done)
+    {
+      for (size_t k=0; k<thread.size(); k++)
+      {
+        thread[k].join();
+      }
+    }
+    else
+    {
+      getPendingSearches().add(search, thread);
+    }
+
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
   }
 
   return ret;
@@ -816,4 +1334,9 @@ std::shared_ptr<Device> getDevice(const char *id)
   return getDevice(id, 1000);
 }
 
+void joinPendingDeviceSearches()
+{
+  getPendingSearches().join();
+}
+
 }
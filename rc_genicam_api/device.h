@@ -39,6 +39,9 @@
 #include "interface.h"
 
 #include <mutex>
+#include <thread>
+#include <functional>
+#include <vector>
 
 #include <GenApi/EventAdapterGeneric.h>
 
@@ -47,6 +50,30 @@ namespace rcg
 
 class Stream;
 
+/**
+  Callback that is invoked by the module event dispatcher of a device for each
+  received event. The data of the event is only valid during the call.
+*/
+
+typedef std::function<void (int64_t eventid, const uint8_t *data, size_t size)>
+  ModuleEventCallback;
+
+/**
+  Counters of the module event dispatcher of a device.
+*/
+
+struct ModuleEventStatistics
+{
+  size_t queue_depth;       // number of events that waited in the event queue
+                            // of the transport layer after the last event
+  size_t max_queue_depth;   // maximum number of waiting events
+  uint64_t dispatched;      // number of events that have been dispatched
+  double mean_latency;      // mean time in ms from receiving an event until
+                            // all callbacks returned
+  double max_latency;       // maximum time in ms from receiving an event
+                            // until all callbacks returned
+};
+
 /**
   The device class encapsulates a Genicam device.
 
@@ -122,12 +149,14 @@ class Device : public std::enable_shared_from_this<Device>
       device nodemap.
 
       NOTE: This can be called from a different thread to wait for the event.
+      It must not be used while the module event dispatcher is running.
 
       @param timeout Timeout in ms. A value < 0 sets waiting time to infinite.
       @return        Event ID or
                      -1 if the method returned due to timeout,
                      -2 if waiting was interrupted due to calling abortWaitingForModuleEvents(),
-                     -3 if module events have not been enabled.
+                     -3 if module events have not been enabled,
+                     -4 if the module event dispatcher is running.
     */
 
     int64_t getModuleEvent(int64_t timeout=-1);
@@ -138,6 +167,54 @@ class Device : public std::enable_shared_from_this<Device>
 
     void abortWaitingForModuleEvents();
 
+    /**
+      Registers a callback for module events with the given ID. The callback
+      is invoked by the module event dispatcher thread after the event has
+      been attached to the local device nodemap.
+
+      NOTE: Callbacks must not add or remove callbacks or stop the dispatcher.
+
+      @param eventid Event ID or -1 for receiving all events.
+      @param cb      Callback.
+      @return        Handle for removing the callback.
+    */
+
+    int addModuleEventCallback(int64_t eventid, const ModuleEventCallback &cb);
+
+    /**
+      Removes a callback that has been registered by addModuleEventCallback().
+
+      @param handle Handle of the callback.
+    */
+
+    void removeModuleEventCallback(int handle);
+
+    /**
+      Enables module events and starts a thread that receives all module
+      events of the device, attaches them to the local device nodemap and
+      delivers them to the registered callbacks. Does nothing if the
+      dispatcher is already running. The dispatcher is stopped automatically
+      when the device is closed. Errors are reported on std::cerr and stop
+      the dispatcher.
+    */
+
+    void startModuleEventDispatcher();
+
+    /**
+      Stops the module event dispatcher thread. Does nothing if the
+      dispatcher is not running.
+    */
+
+    void stopModuleEventDispatcher();
+
+    /**
+      Returns the counters of the module event dispatcher.
+
+      @return Statistics.
+    */
+
+    ModuleEventStatistics getModuleEventStatistics();
+
     /**
       Returns the currently available streams of this device.
 
@@ -294,6 +371,36 @@ class Device : public std::enable_shared_from_this<Device>
 
     std::shared_ptr<CPort> getRemotePort();
 
+    /**
+      Starts queuing of register writes to the remote device. The queued
+      writes are sent together with as few calls to the transport layer as
+      possible, before the next register read or when endRemoteBatch() is
+      called. This reduces the number of round trips e.g. when many parameters
+      are set one after the other.
+
+      NOTE: Errors of queued writes are reported by the call that sends them.
+      getRemoteNodeMap() must be called before calling this method.
+    */
+
+    void startRemoteBatch();
+
+    /**
+      Sends all queued writes to the remote device and stops queuing. A
+      GenTLException is thrown if sending fails.
+    */
+
+    void endRemoteBatch();
+
+    /**
+      Returns the number of calls to the transport layer that have been made
+      for reading and writing registers of the remote device. This can be
+      used for checking the effect of stacked accesses and batches.
+
+      @return Number of transactions or 0 if the remote port is not open.
+    */
+
+    uint64_t getNumRemoteTransactions();
+
     /**
       Get internal interface handle.
 
@@ -307,6 +414,16 @@ class Device : public std::enable_shared_from_this<Device>
     Device(class Device &); // forbidden
     Device &operator=(const Device &); // forbidden
 
+    int64_t receiveModuleEvent(uint64_t timeout, size_t &size);
+    void dispatchModuleEvents();
+
+    struct EventCallback
+    {
+      int handle;
+      int64_t eventid;
+      ModuleEventCallback cb;
+    };
+
     std::shared_ptr<Interface> parent;
     std::shared_ptr<const GenTLWrapper> gentl;
     std::string id;
@@ -325,11 +442,23 @@ class Device : public std::enable_shared_from_this<Device>
     std::shared_ptr<GenApi::CEventAdapterGeneric> eventadapter;
 
     std::vector<std::weak_ptr<Stream> > slist;
+
+    std::mutex dispatch_mtx;
+    std::thread dispatcher;
+    bool dispatching;
+
+    std::mutex cb_mtx;
+    std::vector<EventCallback> callback;
+    int next_handle;
+
+    ModuleEventStatistics stat;
 };
 
 /**
   Returns a list of all devices that are available across all transport layers
-  and interfaces.
+  and interfaces. The discovery is done on all interfaces in parallel. The time
+  that the discovery took on each interface can be queried afterwards by
+  Interface::getDiscoveryTime().
 
   @param timeout Timeout in ms for discovery of devices on each interface. The
                  function without this parameter uses a timeout of 1000 ms.
@@ -345,6 +474,26 @@ std::vector<std::shared_ptr<Device> > getDevices();
   i.e. "[<interfaca_id>[:]]<device_id>". If the interface ID is not given, then
   all interfaces are sought and the first device with the given ID returned.
 
+  All interfaces are sought in parallel and the function returns as soon as
+  the device has been found, while the discovery on the remaining interfaces
+  finishes in the background.
+
+  NOTE: The first device that is found is returned. If a device can be
+  reached through more than one interface, e.g. through several network
+  interfaces, then the returned device belongs to the interface with the
+  fastest discovery, not to the first interface in the order of systems and
+  interfaces, and it may differ from call to call. An interface ID should be
+  given as prefix if a certain interface is required.
+
+  NOTE: Finding the same device through different producers is only reported
+  as error, i.e. a null pointer is returned, if this happens before the
+  function returns. Thus, this error depends on the timing of the discovery
+  on the different interfaces and may occur in one call but not in another.
+
+  NOTE: Searches that are still running when the function returns are joined
+  by the next call of getDevice(), by System::clearSystems() or at program
+  exit. These calls may therefore block up to the given timeout.
+
   @param devid   Device ID.
   @param timeout Timeout in ms for discovery of devices on each interface. The
                  function without this parameter uses a timeout of 1000 ms.
@@ -49,11 +49,16 @@ GenTLException::GenTLException(const std::string &_msg)
   msg=_msg;
   gentl_msg=_msg;
   gentl_code=GenTL::GC_ERR_ERROR;
+  has_address=false;
+  address=0;
 }
 
 GenTLException::GenTLException(const std::string &_msg,
                                const std::shared_ptr<const GenTLWrapper> &gentl)
 {
+  has_address=false;
+  address=0;
+
   char tmp[1024]="";
   size_t tmp_size=sizeof(tmp);
 
@@ -78,6 +83,22 @@ GenTLException::GenTLException(const std::string &_msg,
   msg=out.str();
 }
 
+GenTLException::GenTLException(const std::string &_msg, uint64_t _address,
+                               const std::shared_ptr<const GenTLWrapper> &gentl)
+{
+  if (gentl)
+  {
+    *this=GenTLException(_msg, gentl);
+  }
+  else
+  {
+    *this=GenTLException(_msg);
+  }
+
+  has_address=true;
+  address=_address;
+}
+
 GenTLException::~GenTLException()
 { }
 
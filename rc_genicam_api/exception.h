@@ -53,17 +53,34 @@ class GenTLException : public std::exception
     std::string msg;
     std::string gentl_msg;
     GenTL::GC_ERROR gentl_code;
+    bool has_address;
+    uint64_t address;
 
   public:
 
     GenTLException(const std::string &msg);
     GenTLException(const std::string &msg, const std::shared_ptr<const GenTLWrapper> &gentl);
 
+    /**
+      Creates an exception for a failed register access. The message of the
+      GenTL producer is only included if gentl is given.
+
+      @param msg     Error message.
+      @param address Address of the register that could not be accessed.
+      @param gentl   Optional pointer to the GenTL wrapper of the producer.
+    */
+
+    GenTLException(const std::string &msg, uint64_t address,
+                   const std::shared_ptr<const GenTLWrapper> &gentl=std::shared_ptr<const GenTLWrapper>());
+
     virtual ~GenTLException();
 
     GenTL::GC_ERROR getGenTLCode() const noexcept { return gentl_code; }
     const char *getGenTLMessage() const noexcept { return gentl_msg.c_str(); }
 
+    bool hasAddress() const noexcept { return has_address; }
+    uint64_t getAddress() const noexcept { return address; }
+
     virtual const char *what() const noexcept;
 };
 
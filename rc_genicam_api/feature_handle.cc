@@ -0,0 +1,198 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "feature_handle.h"
+
+#include "Base/GCException.h"
+
+#include <stdexcept>
+
+namespace rcg
+{
+
+namespace
+{
+
+inline bool getNodeValue(GenApi::IBoolean *val, bool igncache)
+{
+  return val->GetValue(false, igncache);
+}
+
+inline int64_t getNodeValue(GenApi::IInteger *val, bool igncache)
+{
+  return val->GetValue(false, igncache);
+}
+
+inline double getNodeValue(GenApi::IFloat *val, bool igncache)
+{
+  return val->GetValue(false, igncache);
+}
+
+inline std::string getNodeValue(GenApi::IValue *val, bool igncache)
+{
+  return std::string(val->ToString(false, igncache).c_str());
+}
+
+inline void setNodeValue(GenApi::IBoolean *val, bool value)
+{
+  val->SetValue(value);
+}
+
+inline void setNodeValue(GenApi::IInteger *val, int64_t value)
+{
+  val->SetValue(value);
+}
+
+inline void setNodeValue(GenApi::IFloat *val, double value)
+{
+  val->SetValue(value);
+}
+
+inline void setNodeValue(GenApi::IValue *val, const std::string &value)
+{
+  val->FromString(value.c_str());
+}
+
+}
+
+template<class T> FeatureHandle<T>::FeatureHandle()
+{
+  val=0;
+}
+
+template<class T> FeatureHandle<T>::FeatureHandle(
+  const std::shared_ptr<GenApi::CNodeMapRef> &_nodemap, const char *_name, bool exception)
+{
+  name=_name;
+  val=0;
+
+  try
+  {
+    GenApi::INode *node=_nodemap->_GetNode(_name);
+
+    if (node != 0)
+    {
+      val=dynamic_cast<typename FeatureInterface<T>::Type *>(node);
+
+      if (val != 0)
+      {
+        nodemap=_nodemap;
+      }
+      else if (exception)
+      {
+        throw std::invalid_argument(std::string("Feature has different datatype: ")+name);
+      }
+    }
+    else if (exception)
+    {
+      throw std::invalid_argument(std::string("Feature not found: ")+name);
+    }
+  }
+  catch (const GENICAM_NAMESPACE::GenericException &ex)
+  {
+    if (exception)
+    {
+      throw std::invalid_argument(ex.what());
+    }
+  }
+}
+
+template<class T> bool FeatureHandle<T>::isReadable() const
+{
+  return val != 0 && GenApi::IsReadable(val);
+}
+
+template<class T> bool FeatureHandle<T>::isWritable() const
+{
+  return val != 0 && GenApi::IsWritable(val);
+}
+
+template<class T> T FeatureHandle<T>::getValue(bool exception, bool igncache) const
+{
+  if (val != 0)
+  {
+    // access rights are checked by GenApi, which throws an exception
+
+    try
+    {
+      return getNodeValue(val, igncache);
+    }
+    catch (const GENICAM_NAMESPACE::GenericException &ex)
+    {
+      if (exception)
+      {
+        throw std::invalid_argument(ex.what());
+      }
+    }
+  }
+  else if (exception)
+  {
+    throw std::invalid_argument(std::string("Invalid feature handle: ")+name);
+  }
+
+  return T();
+}
+
+template<class T> bool FeatureHandle<T>::setValue(const T &value, bool exception) const
+{
+  if (val != 0)
+  {
+    try
+    {
+      setNodeValue(val, value);
+      return true;
+    }
+    catch (const GENICAM_NAMESPACE::GenericException &ex)
+    {
+      if (exception)
+      {
+        throw std::invalid_argument(ex.what());
+      }
+    }
+  }
+  else if (exception)
+  {
+    throw std::invalid_argument(std::string("Invalid feature handle: ")+name);
+  }
+
+  return false;
+}
+
+template class FeatureHandle<bool>;
+template class FeatureHandle<int64_t>;
+template class FeatureHandle<double>;
+template class FeatureHandle<std::string>;
+
+}
@@ -0,0 +1,164 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_FEATURE_HANDLE
+#define RC_GENICAM_API_FEATURE_HANDLE
+
+#include <GenApi/GenApi.h>
+
+#include <memory>
+#include <string>
+
+namespace rcg
+{
+
+/**
+  GenApi interface that is used for features of the given value type.
+  Features of type std::string are accessed through their string
+  representation, which is the symbolic name of the current entry for
+  enumerations.
+*/
+
+template<class T> struct FeatureInterface;
+
+template<> struct FeatureInterface<bool> { typedef GenApi::IBoolean Type; };
+template<> struct FeatureInterface<int64_t> { typedef GenApi::IInteger Type; };
+template<> struct FeatureInterface<double> { typedef GenApi::IFloat Type; };
+template<> struct FeatureInterface<std::string> { typedef GenApi::IValue Type; };
+
+/**
+  A feature handle looks up a feature of a nodemap once and keeps the pointer
+  to its interface. Getting and setting values through the handle avoids the
+  lookup by name, the type check and the explicit access checks that the
+  functions of config.h perform on each call. This is useful for features
+  that are accessed often, e.g. chunk data of each received buffer.
+
+  Handles are available for the value types bool, int64_t, double and
+  std::string.
+
+  The handle keeps a reference to the nodemap. Nevertheless, it must not be
+  used after closing the object (e.g. device) that the nodemap belongs to.
+  Like the nodemap, a handle is not thread safe.
+*/
+
+template<class T> class FeatureHandle
+{
+  public:
+
+    /**
+      Creates an invalid handle.
+    */
+
+    FeatureHandle();
+
+    /**
+      Looks up the feature in the given nodemap.
+
+      @param nodemap   Initialized nodemap.
+      @param name      Name of feature.
+      @param exception True if std::invalid_argument should be thrown if the
+                       feature does not exist or has a different datatype.
+                       Otherwise, the handle is invalid in this case.
+    */
+
+    FeatureHandle(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const char *name,
+                  bool exception=false);
+
+    /**
+      Returns the name of the feature.
+
+      @return Name of feature.
+    */
+
+    const std::string &getName() const { return name; }
+
+    /**
+      Returns true if the feature has been found with the expected datatype.
+
+      @return True if handle is valid.
+    */
+
+    bool isValid() const { return val != 0; }
+
+    /**
+      Checks if the feature is currently readable.
+
+      @return True if readable.
+    */
+
+    bool isReadable() const;
+
+    /**
+      Checks if the feature is currently writable.
+
+      @return True if writable.
+    */
+
+    bool isWritable() const;
+
+    /**
+      Returns the value of the feature.
+
+      @param exception True if std::invalid_argument should be thrown if the
+                       handle is invalid or the feature is not readable.
+      @param igncache  True if value is always read from the device, even if
+                       cached.
+      @return          Value or a default constructed value (e.g. 0) in case
+                       of an error.
+    */
+
+    T getValue(bool exception=false, bool igncache=false) const;
+
+    /**
+      Sets the value of the feature.
+
+      @param value     New value.
+      @param exception True if std::invalid_argument should be thrown if the
+                       handle is invalid or the value cannot be set.
+      @return          True if the value has been set.
+    */
+
+    bool setValue(const T &value, bool exception=false) const;
+
+  private:
+
+    std::shared_ptr<GenApi::CNodeMapRef> nodemap;
+    std::string name;
+    typename FeatureInterface<T>::Type *val;
+};
+
+}
+
+#endif
@@ -0,0 +1,223 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gentl_profile.h"
+
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
+
+namespace rcg
+{
+
+namespace
+{
+
+/*
+  Profiling is enabled by environment variable by default.
+*/
+
+bool getDefaultProfiling()
+{
+  const char *s=std::getenv("RCG_GENTL_PROFILE");
+  return s != 0 && s[0] != '\0' && std::string(s) != "0";
+}
+
+std::atomic<bool> profiling(getDefaultProfiling());
+
+/*
+  Atomically raises the stored value.
+*/
+
+inline void storeMax(std::atomic<uint64_t> &a, uint64_t v)
+{
+  uint64_t cur=a.load(std::memory_order_relaxed);
+  while (v > cur && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed)) { }
+}
+
+}
+
+void setGenTLProfiling(bool enable)
+{
+  profiling=enable;
+}
+
+bool isGenTLProfilingEnabled()
+{
+  return profiling;
+}
+
+GenTLCallStatistics::GenTLCallStatistics(const char *_name) : name(_name)
+{
+  count=0;
+  total_ns=0;
+  max_ns=0;
+}
+
+void GenTLCallStatistics::add(void *h, uint64_t ns)
+{
+  count.fetch_add(1, std::memory_order_relaxed);
+  total_ns.fetch_add(ns, std::memory_order_relaxed);
+  storeMax(max_ns, ns);
+
+  if (h != 0)
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    Counter &c=handle[h];
+    c.count++;
+    c.total_ns+=ns;
+    c.max_ns=std::max(c.max_ns, ns);
+  }
+}
+
+GenTLProfile::GenTLProfile(const std::string &_filename)
+{
+  filename=_filename;
+}
+
+GenTLCallStatistics *GenTLProfile::add(const char *name)
+{
+  std::lock_guard<std::mutex> lock(mtx);
+
+  function.emplace_back(name);
+
+  return &function.back();
+}
+
+namespace
+{
+
+void printCounter(std::ostream &out, const std::string &name, uint64_t count, uint64_t total_ns,
+                  uint64_t max_ns)
+{
+  out << std::left << std::setw(28) << name << std::right << std::setw(10) << count
+      << std::setw(14) << total_ns/1.0e6 << std::setw(12) << total_ns/1.0e3/count
+      << std::setw(12) << max_ns/1.0e3 << std::endl;
+}
+
+}
+
+std::vector<GenTLProfile::Function> GenTLProfile::getSnapshot()
+{
+  std::vector<Function> list;
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    // copy the counters, since they may change while sorting
+
+    for (size_t i=0; i<function.size(); i++)
+    {
+      GenTLCallStatistics &f=function[i];
+
+      Function item;
+      item.name=f.name;
+      item.counter.count=f.count.load(std::memory_order_relaxed);
+      item.counter.total_ns=f.total_ns.load(std::memory_order_relaxed);
+      item.counter.max_ns=f.max_ns.load(std::memory_order_relaxed);
+
+      if (item.counter.count > 0)
+      {
+        std::lock_guard<std::mutex> hlock(f.mtx);
+        item.handle.assign(f.handle.begin(), f.handle.end());
+
+        list.push_back(std::move(item));
+      }
+    }
+  }
+
+  // rank functions and handles by total time
+
+  std::sort(list.begin(), list.end(), [](const Function &a, const Function &b)
+  {
+    return a.counter.total_ns > b.counter.total_ns;
+  });
+
+  for (size_t i=0; i<list.size(); i++)
+  {
+    std::sort(list[i].handle.begin(), list[i].handle.end(),
+      [](const std::pair<void *, GenTLCallStatistics::Counter> &a,
+         const std::pair<void *, GenTLCallStatistics::Counter> &b)
+    {
+      return a.second.total_ns > b.second.total_ns;
+    });
+  }
+
+  return list;
+}
+
+std::string GenTLProfile::getReport()
+{
+  std::vector<Function> list=getSnapshot();
+
+  std::ostringstream out;
+
+  out << "GenTL profile of " << filename << ":" << std::endl;
+  out << std::fixed << std::setprecision(3);
+  out << std::left << std::setw(28) << "Function" << std::right << std::setw(10) << "Calls"
+      << std::setw(14) << "Total [ms]" << std::setw(12) << "Mean [us]" << std::setw(12)
+      << "Max [us]" << std::endl;
+
+  for (size_t i=0; i<list.size(); i++)
+  {
+    const Function &f=list[i];
+
+    printCounter(out, f.name, f.counter.count, f.counter.total_ns, f.counter.max_ns);
+
+    // report the handles with the highest total time, if the function was
+    // called with more than one handle
+
+    const std::vector<std::pair<void *, GenTLCallStatistics::Counter> > &hlist=f.handle;
+
+    if (hlist.size() > 1)
+    {
+      for (size_t k=0; k<hlist.size() && k<5; k++)
+      {
+        std::ostringstream name;
+        name << "  handle " << hlist[k].first;
+
+        printCounter(out, name.str(), hlist[k].second.count, hlist[k].second.total_ns,
+                     hlist[k].second.max_ns);
+      }
+    }
+  }
+
+  return out.str();
+}
+
+}
@@ -0,0 +1,174 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_GENTL_PROFILE
+#define RC_GENICAM_API_GENTL_PROFILE
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <deque>
+#include <map>
+#include <vector>
+#include <cstdint>
+
+namespace rcg
+{
+
+/**
+  Enables or disables profiling of the GenTL producers that are loaded
+  afterwards. By default, profiling is enabled if the environment variable
+  RCG_GENTL_PROFILE is set to a value other than 0.
+
+  @param enable True for enabling profiling.
+*/
+
+void setGenTLProfiling(bool enable);
+
+/**
+  Returns if profiling of GenTL producers is enabled.
+
+  @return True if enabled.
+*/
+
+bool isGenTLProfilingEnabled();
+
+/**
+  Counters of the calls of one GenTL function.
+*/
+
+class GenTLCallStatistics
+{
+  public:
+
+    GenTLCallStatistics(const char *name);
+
+    /**
+      Records a call.
+
+      @param handle Handle that is given as first parameter or 0.
+      @param ns     Duration of the call in nano seconds.
+    */
+
+    void add(void *handle, uint64_t ns);
+
+    struct Counter
+    {
+      uint64_t count;
+      uint64_t total_ns;
+      uint64_t max_ns;
+    };
+
+    const std::string name;
+
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total_ns;
+    std::atomic<uint64_t> max_ns;
+
+    std::mutex mtx;
+    std::map<void *, Counter> handle;
+
+  private:
+
+    GenTLCallStatistics(class GenTLCallStatistics &); // forbidden
+    GenTLCallStatistics &operator=(const GenTLCallStatistics &); // forbidden
+};
+
+/**
+  Collection of the call statistics of all functions of one GenTL producer.
+*/
+
+class GenTLProfile
+{
+  public:
+
+    GenTLProfile(const std::string &filename);
+
+    /**
+      Creates the statistics for the given function. The returned object stays
+      valid until the profile is destroyed.
+
+      @param name Name of the GenTL function.
+      @return     Pointer to statistics.
+    */
+
+    GenTLCallStatistics *add(const char *name);
+
+    /**
+      Copy of the counters of one function and of all handles that it has
+      been called with.
+    */
+
+    struct Function
+    {
+      std::string name;
+      GenTLCallStatistics::Counter counter;
+      std::vector<std::pair<void *, GenTLCallStatistics::Counter> > handle;
+    };
+
+    /**
+      Returns a copy of the counters of all functions that have been called,
+      ranked by the total time that has been spent in them. The handles of
+      each function are ranked in the same way.
+
+      @return List of functions.
+    */
+
+    std::vector<Function> getSnapshot();
+
+    /**
+      Returns a report of all functions that have been called, ranked by the
+      total time that has been spent in them. For each function, the handles
+      with the highest total time are listed as well.
+
+      @return Report as multi line string.
+    */
+
+    std::string getReport();
+
+  private:
+
+    GenTLProfile(class GenTLProfile &); // forbidden
+    GenTLProfile &operator=(const GenTLProfile &); // forbidden
+
+    std::string filename;
+
+    std::mutex mtx;
+    std::deque<GenTLCallStatistics> function;
+};
+
+}
+
+#endif
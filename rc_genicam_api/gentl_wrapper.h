@@ -36,10 +36,14 @@
 #ifndef RC_GENICAM_API_GENTL_WRAPPER
 #define RC_GENICAM_API_GENTL_WRAPPER
 
+#include "gentl_profile.h"
+
 #include <GenTL/GenTL_v1_6.h>
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <chrono>
 
 namespace rcg
 {
@@ -56,7 +60,95 @@ namespace rcg
 std::vector<std::string> getAvailableGenTLs(const char *paths);
 
 /**
-  Wrapper for dynamically loaded GenICam transport layers.
+  Returns the handle that is given as first parameter of a GenTL function or 0
+  if the first parameter is not a handle.
+*/
+
+inline void *getFirstHandle()
+{
+  return 0;
+}
+
+template<class... R> inline void *getFirstHandle(void *handle, R...)
+{
+  return handle;
+}
+
+template<class T, class... R> inline void *getFirstHandle(T, R...)
+{
+  return 0;
+}
+
+/**
+  Pointer to a function of a GenTL producer, which can be called like the
+  function itself. If profiling is enabled, the number of calls and the time
+  spent in the function are recorded for each function and handle.
+*/
+
+template<class F> class GenTLFunction;
+
+template<class... A> class GenTLFunction<GenTL::GC_ERROR (GC_CALLTYPE *)(A...)>
+{
+  public:
+
+    GenTLFunction()
+    {
+      fn=0;
+      stat=0;
+    }
+
+    /**
+      Sets the function pointer.
+
+      @param p       Pointer to the function in the producer library.
+      @param name    Name of the function.
+      @param profile Profile for recording calls or 0 if profiling is disabled.
+    */
+
+    void set(void *p, const char *name, GenTLProfile *profile)
+    {
+      *reinterpret_cast<void**>(&fn)=p;
+
+      if (profile != 0)
+      {
+        stat=profile->add(name);
+      }
+    }
+
+    /**
+      Returns true if the function has been resolved.
+    */
+
+    bool isAvailable() const { return fn != 0; }
+
+    GenTL::GC_ERROR operator()(A... args) const
+    {
+      if (stat == 0)
+      {
+        return fn(args...);
+      }
+
+      auto t0=std::chrono::steady_clock::now();
+      GenTL::GC_ERROR ret=fn(args...);
+      auto t1=std::chrono::steady_clock::now();
+
+      stat->add(getFirstHandle(args...), static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1-t0).count()));
+
+      return ret;
+    }
+
+  private:
+
+    GenTL::GC_ERROR (GC_CALLTYPE *fn)(A...);
+    GenTLCallStatistics *stat;
+};
+
+/**
+  Wrapper for dynamically loaded GenICam transport layers. If profiling is
+  enabled (see setGenTLProfiling()) when the transport layer is loaded, all
+  calls into the transport layer are counted and timed and a report is printed
+  on std::cerr when the transport layer is unloaded.
 */
 
 class GenTLWrapper
@@ -79,80 +171,98 @@ class GenTLWrapper
     GenTLWrapper(const std::string &filename);
     ~GenTLWrapper();
 
+    /**
+      Returns the report of all calls into the transport layer, if profiling
+      is enabled.
+
+      @return Report or empty string if profiling is disabled.
+    */
+
+    std::string getProfilingReport() const;
+
+    /**
+      Returns a copy of the counters of all calls into the transport layer, if
+      profiling is enabled.
+
+      @return Counters per function or empty list if profiling is disabled.
+    */
+
+    std::vector<GenTLProfile::Function> getProfilingSnapshot() const;
+
     // C interface functions of GenTL
 
-    GenTL::PGCGetInfo GCGetInfo;
-    GenTL::PGCGetLastError GCGetLastError;
-    GenTL::PGCInitLib GCInitLib;
-    GenTL::PGCCloseLib GCCloseLib;
-    GenTL::PGCReadPort GCReadPort;
-    GenTL::PGCWritePort GCWritePort;
-    GenTL::PGCGetPortURL GCGetPortURL;
-    GenTL::PGCGetPortInfo GCGetPortInfo;
-
-    GenTL::PGCRegisterEvent GCRegisterEvent;
-    GenTL::PGCUnregisterEvent GCUnregisterEvent;
-    GenTL::PEventGetData EventGetData;
-    GenTL::PEventGetDataInfo EventGetDataInfo;
-    GenTL::PEventGetInfo EventGetInfo;
-    GenTL::PEventFlush EventFlush;
-    GenTL::PEventKill EventKill;
-    GenTL::PTLOpen TLOpen;
-    GenTL::PTLClose TLClose;
-    GenTL::PTLGetInfo TLGetInfo;
-    GenTL::PTLGetNumInterfaces TLGetNumInterfaces;
-    GenTL::PTLGetInterfaceID TLGetInterfaceID;
-    GenTL::PTLGetInterfaceInfo TLGetInterfaceInfo;
-    GenTL::PTLOpenInterface TLOpenInterface;
-    GenTL::PTLUpdateInterfaceList TLUpdateInterfaceList;
-    GenTL::PIFClose IFClose;
-    GenTL::PIFGetInfo IFGetInfo;
-    GenTL::PIFGetNumDevices IFGetNumDevices;
-    GenTL::PIFGetDeviceID IFGetDeviceID;
-    GenTL::PIFUpdateDeviceList IFUpdateDeviceList;
-    GenTL::PIFGetDeviceInfo IFGetDeviceInfo;
-    GenTL::PIFOpenDevice IFOpenDevice;
-
-    GenTL::PDevGetPort DevGetPort;
-    GenTL::PDevGetNumDataStreams DevGetNumDataStreams;
-    GenTL::PDevGetDataStreamID DevGetDataStreamID;
-    GenTL::PDevOpenDataStream DevOpenDataStream;
-    GenTL::PDevGetInfo DevGetInfo;
-    GenTL::PDevClose DevClose;
-
-    GenTL::PDSAnnounceBuffer DSAnnounceBuffer;
-    GenTL::PDSAllocAndAnnounceBuffer DSAllocAndAnnounceBuffer;
-    GenTL::PDSFlushQueue DSFlushQueue;
-    GenTL::PDSStartAcquisition DSStartAcquisition;
-    GenTL::PDSStopAcquisition DSStopAcquisition;
-    GenTL::PDSGetInfo DSGetInfo;
-    GenTL::PDSGetBufferID DSGetBufferID;
-    GenTL::PDSClose DSClose;
-    GenTL::PDSRevokeBuffer DSRevokeBuffer;
-    GenTL::PDSQueueBuffer DSQueueBuffer;
-    GenTL::PDSGetBufferInfo DSGetBufferInfo;
+    GenTLFunction<GenTL::PGCGetInfo> GCGetInfo;
+    GenTLFunction<GenTL::PGCGetLastError> GCGetLastError;
+    GenTLFunction<GenTL::PGCInitLib> GCInitLib;
+    GenTLFunction<GenTL::PGCCloseLib> GCCloseLib;
+    GenTLFunction<GenTL::PGCReadPort> GCReadPort;
+    GenTLFunction<GenTL::PGCWritePort> GCWritePort;
+    GenTLFunction<GenTL::PGCGetPortURL> GCGetPortURL;
+    GenTLFunction<GenTL::PGCGetPortInfo> GCGetPortInfo;
+
+    GenTLFunction<GenTL::PGCRegisterEvent> GCRegisterEvent;
+    GenTLFunction<GenTL::PGCUnregisterEvent> GCUnregisterEvent;
+    GenTLFunction<GenTL::PEventGetData> EventGetData;
+    GenTLFunction<GenTL::PEventGetDataInfo> EventGetDataInfo;
+    GenTLFunction<GenTL::PEventGetInfo> EventGetInfo;
+    GenTLFunction<GenTL::PEventFlush> EventFlush;
+    GenTLFunction<GenTL::PEventKill> EventKill;
+    GenTLFunction<GenTL::PTLOpen> TLOpen;
+    GenTLFunction<GenTL::PTLClose> TLClose;
+    GenTLFunction<GenTL::PTLGetInfo> TLGetInfo;
+    GenTLFunction<GenTL::PTLGetNumInterfaces> TLGetNumInterfaces;
+    GenTLFunction<GenTL::PTLGetInterfaceID> TLGetInterfaceID;
+    GenTLFunction<GenTL::PTLGetInterfaceInfo> TLGetInterfaceInfo;
+    GenTLFunction<GenTL::PTLOpenInterface> TLOpenInterface;
+    GenTLFunction<GenTL::PTLUpdateInterfaceList> TLUpdateInterfaceList;
+    GenTLFunction<GenTL::PIFClose> IFClose;
+    GenTLFunction<GenTL::PIFGetInfo> IFGetInfo;
+    GenTLFunction<GenTL::PIFGetNumDevices> IFGetNumDevices;
+    GenTLFunction<GenTL::PIFGetDeviceID> IFGetDeviceID;
+    GenTLFunction<GenTL::PIFUpdateDeviceList> IFUpdateDeviceList;
+    GenTLFunction<GenTL::PIFGetDeviceInfo> IFGetDeviceInfo;
+    GenTLFunction<GenTL::PIFOpenDevice> IFOpenDevice;
+
+    GenTLFunction<GenTL::PDevGetPort> DevGetPort;
+    GenTLFunction<GenTL::PDevGetNumDataStreams> DevGetNumDataStreams;
+    GenTLFunction<GenTL::PDevGetDataStreamID> DevGetDataStreamID;
+    GenTLFunction<GenTL::PDevOpenDataStream> DevOpenDataStream;
+    GenTLFunction<GenTL::PDevGetInfo> DevGetInfo;
+    GenTLFunction<GenTL::PDevClose> DevClose;
+
+    GenTLFunction<GenTL::PDSAnnounceBuffer> DSAnnounceBuffer;
+    GenTLFunction<GenTL::PDSAllocAndAnnounceBuffer> DSAllocAndAnnounceBuffer;
+    GenTLFunction<GenTL::PDSFlushQueue> DSFlushQueue;
+    GenTLFunction<GenTL::PDSStartAcquisition> DSStartAcquisition;
+    GenTLFunction<GenTL::PDSStopAcquisition> DSStopAcquisition;
+    GenTLFunction<GenTL::PDSGetInfo> DSGetInfo;
+    GenTLFunction<GenTL::PDSGetBufferID> DSGetBufferID;
+    GenTLFunction<GenTL::PDSClose> DSClose;
+    GenTLFunction<GenTL::PDSRevokeBuffer> DSRevokeBuffer;
+    GenTLFunction<GenTL::PDSQueueBuffer> DSQueueBuffer;
+    GenTLFunction<GenTL::PDSGetBufferInfo> DSGetBufferInfo;
 
     // GenTL v1.1
 
-    GenTL::PGCGetNumPortURLs GCGetNumPortURLs;
-    GenTL::PGCGetPortURLInfo GCGetPortURLInfo;
-    GenTL::PGCReadPortStacked GCReadPortStacked;
-    GenTL::PGCWritePortStacked GCWritePortStacked;
+    GenTLFunction<GenTL::PGCGetNumPortURLs> GCGetNumPortURLs;
+    GenTLFunction<GenTL::PGCGetPortURLInfo> GCGetPortURLInfo;
+    GenTLFunction<GenTL::PGCReadPortStacked> GCReadPortStacked;
+    GenTLFunction<GenTL::PGCWritePortStacked> GCWritePortStacked;
 
     // GenTL v1.3
 
-    GenTL::PDSGetBufferChunkData DSGetBufferChunkData;
+    GenTLFunction<GenTL::PDSGetBufferChunkData> DSGetBufferChunkData;
 
     // GenTL v1.4
 
-    GenTL::PIFGetParentTL IFGetParentTL;
-    GenTL::PDevGetParentIF DevGetParentIF;
-    GenTL::PDSGetParentDev DSGetParentDev;
+    GenTLFunction<GenTL::PIFGetParentTL> IFGetParentTL;
+    GenTLFunction<GenTL::PDevGetParentIF> DevGetParentIF;
+    GenTLFunction<GenTL::PDSGetParentDev> DSGetParentDev;
 
     // GenTL v1.5
 
-    GenTL::PDSGetNumBufferParts DSGetNumBufferParts;
-    GenTL::PDSGetBufferPartInfo DSGetBufferPartInfo;
+    GenTLFunction<GenTL::PDSGetNumBufferParts> DSGetNumBufferParts;
+    GenTLFunction<GenTL::PDSGetBufferPartInfo> DSGetBufferPartInfo;
 
   private:
 
@@ -160,6 +270,7 @@ class GenTLWrapper
     GenTLWrapper &operator=(const GenTLWrapper &); // forbidden
 
     void *lib;
+    std::unique_ptr<GenTLProfile> profile;
 };
 
 }
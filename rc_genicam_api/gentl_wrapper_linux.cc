@@ -119,75 +119,80 @@ GenTLWrapper::GenTLWrapper(const std::string &filename)
 
   dlerror(); // clear possible existing error
 
+  if (isGenTLProfilingEnabled())
+  {
+    profile.reset(new GenTLProfile(filename));
+  }
+
   // resolve function calls that will only be used privately
 
-  *reinterpret_cast<void**>(&GCInitLib)=dlsym(lib, "GCInitLib");
-  *reinterpret_cast<void**>(&GCCloseLib)=dlsym(lib, "GCCloseLib");
+  GCInitLib.set(dlsym(lib, "GCInitLib"), "GCInitLib", profile.get());
+  GCCloseLib.set(dlsym(lib, "GCCloseLib"), "GCCloseLib", profile.get());
 
   // resolve public symbols
 
-  *reinterpret_cast<void**>(&GCGetInfo)=dlsym(lib, "GCGetInfo");
-  *reinterpret_cast<void**>(&GCGetLastError)=dlsym(lib, "GCGetLastError");
-  *reinterpret_cast<void**>(&GCReadPort)=dlsym(lib, "GCReadPort");
-  *reinterpret_cast<void**>(&GCWritePort)=dlsym(lib, "GCWritePort");
-  *reinterpret_cast<void**>(&GCGetPortURL)=dlsym(lib, "GCGetPortURL");
-  *reinterpret_cast<void**>(&GCGetPortInfo)=dlsym(lib, "GCGetPortInfo");
-
-  *reinterpret_cast<void**>(&GCRegisterEvent)=dlsym(lib, "GCRegisterEvent");
-  *reinterpret_cast<void**>(&GCUnregisterEvent)=dlsym(lib, "GCUnregisterEvent");
-  *reinterpret_cast<void**>(&EventGetData)=dlsym(lib, "EventGetData");
-  *reinterpret_cast<void**>(&EventGetDataInfo)=dlsym(lib, "EventGetDataInfo");
-  *reinterpret_cast<void**>(&EventGetInfo)=dlsym(lib, "EventGetInfo");
-  *reinterpret_cast<void**>(&EventFlush)=dlsym(lib, "EventFlush");
-  *reinterpret_cast<void**>(&EventKill)=dlsym(lib, "EventKill");
-  *reinterpret_cast<void**>(&TLOpen)=dlsym(lib, "TLOpen");
-  *reinterpret_cast<void**>(&TLClose)=dlsym(lib, "TLClose");
-  *reinterpret_cast<void**>(&TLGetInfo)=dlsym(lib, "TLGetInfo");
-  *reinterpret_cast<void**>(&TLGetNumInterfaces)=dlsym(lib, "TLGetNumInterfaces");
-  *reinterpret_cast<void**>(&TLGetInterfaceID)=dlsym(lib, "TLGetInterfaceID");
-  *reinterpret_cast<void**>(&TLGetInterfaceInfo)=dlsym(lib, "TLGetInterfaceInfo");
-  *reinterpret_cast<void**>(&TLOpenInterface)=dlsym(lib, "TLOpenInterface");
-  *reinterpret_cast<void**>(&TLUpdateInterfaceList)=dlsym(lib, "TLUpdateInterfaceList");
-  *reinterpret_cast<void**>(&IFClose)=dlsym(lib, "IFClose");
-  *reinterpret_cast<void**>(&IFGetInfo)=dlsym(lib, "IFGetInfo");
-  *reinterpret_cast<void**>(&IFGetNumDevices)=dlsym(lib, "IFGetNumDevices");
-  *reinterpret_cast<void**>(&IFGetDeviceID)=dlsym(lib, "IFGetDeviceID");
-  *reinterpret_cast<void**>(&IFUpdateDeviceList)=dlsym(lib, "IFUpdateDeviceList");
-  *reinterpret_cast<void**>(&IFGetDeviceInfo)=dlsym(lib, "IFGetDeviceInfo");
-  *reinterpret_cast<void**>(&IFOpenDevice)=dlsym(lib, "IFOpenDevice");
-
-  *reinterpret_cast<void**>(&DevGetPort)=dlsym(lib, "DevGetPort");
-  *reinterpret_cast<void**>(&DevGetNumDataStreams)=dlsym(lib, "DevGetNumDataStreams");
-  *reinterpret_cast<void**>(&DevGetDataStreamID)=dlsym(lib, "DevGetDataStreamID");
-  *reinterpret_cast<void**>(&DevOpenDataStream)=dlsym(lib, "DevOpenDataStream");
-  *reinterpret_cast<void**>(&DevGetInfo)=dlsym(lib, "DevGetInfo");
-  *reinterpret_cast<void**>(&DevClose)=dlsym(lib, "DevClose");
-
-  *reinterpret_cast<void**>(&DSAnnounceBuffer)=dlsym(lib, "DSAnnounceBuffer");
-  *reinterpret_cast<void**>(&DSAllocAndAnnounceBuffer)=dlsym(lib, "DSAllocAndAnnounceBuffer");
-  *reinterpret_cast<void**>(&DSFlushQueue)=dlsym(lib, "DSFlushQueue");
-  *reinterpret_cast<void**>(&DSStartAcquisition)=dlsym(lib, "DSStartAcquisition");
-  *reinterpret_cast<void**>(&DSStopAcquisition)=dlsym(lib, "DSStopAcquisition");
-  *reinterpret_cast<void**>(&DSGetInfo)=dlsym(lib, "DSGetInfo");
-  *reinterpret_cast<void**>(&DSGetBufferID)=dlsym(lib, "DSGetBufferID");
-  *reinterpret_cast<void**>(&DSClose)=dlsym(lib, "DSClose");
-  *reinterpret_cast<void**>(&DSRevokeBuffer)=dlsym(lib, "DSRevokeBuffer");
-  *reinterpret_cast<void**>(&DSQueueBuffer)=dlsym(lib, "DSQueueBuffer");
-  *reinterpret_cast<void**>(&DSGetBufferInfo)=dlsym(lib, "DSGetBufferInfo");
-
-  *reinterpret_cast<void**>(&GCGetNumPortURLs)=dlsym(lib, "GCGetNumPortURLs");
-  *reinterpret_cast<void**>(&GCGetPortURLInfo)=dlsym(lib, "GCGetPortURLInfo");
-  *reinterpret_cast<void**>(&GCReadPortStacked)=dlsym(lib, "GCReadPortStacked");
-  *reinterpret_cast<void**>(&GCWritePortStacked)=dlsym(lib, "GCWritePortStacked");
-
-  *reinterpret_cast<void**>(&DSGetBufferChunkData)=dlsym(lib, "DSGetBufferChunkData");
-
-  *reinterpret_cast<void**>(&IFGetParentTL)=dlsym(lib, "IFGetParentTL");
-  *reinterpret_cast<void**>(&DevGetParentIF)=dlsym(lib, "DevGetParentIF");
-  *reinterpret_cast<void**>(&DSGetParentDev)=dlsym(lib, "DSGetParentDev");
-
-  *reinterpret_cast<void**>(&DSGetNumBufferParts)=dlsym(lib, "DSGetNumBufferParts");
-  *reinterpret_cast<void**>(&DSGetBufferPartInfo)=dlsym(lib, "DSGetBufferPartInfo");
+  GCGetInfo.set(dlsym(lib, "GCGetInfo"), "GCGetInfo", profile.get());
+  GCGetLastError.set(dlsym(lib, "GCGetLastError"), "GCGetLastError", profile.get());
+  GCReadPort.set(dlsym(lib, "GCReadPort"), "GCReadPort", profile.get());
+  GCWritePort.set(dlsym(lib, "GCWritePort"), "GCWritePort", profile.get());
+  GCGetPortURL.set(dlsym(lib, "GCGetPortURL"), "GCGetPortURL", profile.get());
+  GCGetPortInfo.set(dlsym(lib, "GCGetPortInfo"), "GCGetPortInfo", profile.get());
+
+  GCRegisterEvent.set(dlsym(lib, "GCRegisterEvent"), "GCRegisterEvent", profile.get());
+  GCUnregisterEvent.set(dlsym(lib, "GCUnregisterEvent"), "GCUnregisterEvent", profile.get());
+  EventGetData.set(dlsym(lib, "EventGetData"), "EventGetData", profile.get());
+  EventGetDataInfo.set(dlsym(lib, "EventGetDataInfo"), "EventGetDataInfo", profile.get());
+  EventGetInfo.set(dlsym(lib, "EventGetInfo"), "EventGetInfo", profile.get());
+  EventFlush.set(dlsym(lib, "EventFlush"), "EventFlush", profile.get());
+  EventKill.set(dlsym(lib, "EventKill"), "EventKill", profile.get());
+  TLOpen.set(dlsym(lib, "TLOpen"), "TLOpen", profile.get());
+  TLClose.set(dlsym(lib, "TLClose"), "TLClose", profile.get());
+  TLGetInfo.set(dlsym(lib, "TLGetInfo"), "TLGetInfo", profile.get());
+  TLGetNumInterfaces.set(dlsym(lib, "TLGetNumInterfaces"), "TLGetNumInterfaces", profile.get());
+  TLGetInterfaceID.set(dlsym(lib, "TLGetInterfaceID"), "TLGetInterfaceID", profile.get());
+  TLGetInterfaceInfo.set(dlsym(lib, "TLGetInterfaceInfo"), "TLGetInterfaceInfo", profile.get());
+  TLOpenInterface.set(dlsym(lib, "TLOpenInterface"), "TLOpenInterface", profile.get());
+  TLUpdateInterfaceList.set(dlsym(lib, "TLUpdateInterfaceList"), "TLUpdateInterfaceList", profile.get());
+  IFClose.set(dlsym(lib, "IFClose"), "IFClose", profile.get());
+  IFGetInfo.set(dlsym(lib, "IFGetInfo"), "IFGetInfo", profile.get());
+  IFGetNumDevices.set(dlsym(lib, "IFGetNumDevices"), "IFGetNumDevices", profile.get());
+  IFGetDeviceID.set(dlsym(lib, "IFGetDeviceID"), "IFGetDeviceID", profile.get());
+  IFUpdateDeviceList.set(dlsym(lib, "IFUpdateDeviceList"), "IFUpdateDeviceList", profile.get());
+  IFGetDeviceInfo.set(dlsym(lib, "IFGetDeviceInfo"), "IFGetDeviceInfo", profile.get());
+  IFOpenDevice.set(dlsym(lib, "IFOpenDevice"), "IFOpenDevice", profile.get());
+
+  DevGetPort.set(dlsym(lib, "DevGetPort"), "DevGetPort", profile.get());
+  DevGetNumDataStreams.set(dlsym(lib, "DevGetNumDataStreams"), "DevGetNumDataStreams", profile.get());
+  DevGetDataStreamID.set(dlsym(lib, "DevGetDataStreamID"), "DevGetDataStreamID", profile.get());
+  DevOpenDataStream.set(dlsym(lib, "DevOpenDataStream"), "DevOpenDataStream", profile.get());
+  DevGetInfo.set(dlsym(lib, "DevGetInfo"), "DevGetInfo", profile.get());
+  DevClose.set(dlsym(lib, "DevClose"), "DevClose", profile.get());
+
+  DSAnnounceBuffer.set(dlsym(lib, "DSAnnounceBuffer"), "DSAnnounceBuffer", profile.get());
+  DSAllocAndAnnounceBuffer.set(dlsym(lib, "DSAllocAndAnnounceBuffer"), "DSAllocAndAnnounceBuffer", profile.get());
+  DSFlushQueue.set(dlsym(lib, "DSFlushQueue"), "DSFlushQueue", profile.get());
+  DSStartAcquisition.set(dlsym(lib, "DSStartAcquisition"), "DSStartAcquisition", profile.get());
+  DSStopAcquisition.set(dlsym(lib, "DSStopAcquisition"), "DSStopAcquisition", profile.get());
+  DSGetInfo.set(dlsym(lib, "DSGetInfo"), "DSGetInfo", profile.get());
+  DSGetBufferID.set(dlsym(lib, "DSGetBufferID"), "DSGetBufferID", profile.get());
+  DSClose.set(dlsym(lib, "DSClose"), "DSClose", profile.get());
+  DSRevokeBuffer.set(dlsym(lib, "DSRevokeBuffer"), "DSRevokeBuffer", profile.get());
+  DSQueueBuffer.set(dlsym(lib, "DSQueueBuffer"), "DSQueueBuffer", profile.get());
+  DSGetBufferInfo.set(dlsym(lib, "DSGetBufferInfo"), "DSGetBufferInfo", profile.get());
+
+  GCGetNumPortURLs.set(dlsym(lib, "GCGetNumPortURLs"), "GCGetNumPortURLs", profile.get());
+  GCGetPortURLInfo.set(dlsym(lib, "GCGetPortURLInfo"), "GCGetPortURLInfo", profile.get());
+  GCReadPortStacked.set(dlsym(lib, "GCReadPortStacked"), "GCReadPortStacked", profile.get());
+  GCWritePortStacked.set(dlsym(lib, "GCWritePortStacked"), "GCWritePortStacked", profile.get());
+
+  DSGetBufferChunkData.set(dlsym(lib, "DSGetBufferChunkData"), "DSGetBufferChunkData", profile.get());
+
+  IFGetParentTL.set(dlsym(lib, "IFGetParentTL"), "IFGetParentTL", profile.get());
+  DevGetParentIF.set(dlsym(lib, "DevGetParentIF"), "DevGetParentIF", profile.get());
+  DSGetParentDev.set(dlsym(lib, "DSGetParentDev"), "DSGetParentDev", profile.get());
+
+  DSGetNumBufferParts.set(dlsym(lib, "DSGetNumBufferParts"), "DSGetNumBufferParts", profile.get());
+  DSGetBufferPartInfo.set(dlsym(lib, "DSGetBufferPartInfo"), "DSGetBufferPartInfo", profile.get());
 
   const char *err=dlerror();
 
@@ -201,7 +206,32 @@ GenTLWrapper::GenTLWrapper(const std::string &filename)
 
 GenTLWrapper::~GenTLWrapper()
 {
+  if (profile)
+  {
+    std::cerr << profile->getReport();
+  }
+
   dlclose(lib);
 }
 
+std::string GenTLWrapper::getProfilingReport() const
+{
+  if (profile)
+  {
+    return profile->getReport();
+  }
+
+  return std::string();
+}
+
+std::vector<GenTLProfile::Function> GenTLWrapper::getProfilingSnapshot() const
+{
+  if (profile)
+  {
+    return profile->getSnapshot();
+  }
+
+  return std::vector<GenTLProfile::Function>();
+}
+
 }
@@ -104,7 +104,7 @@ std::vector<std::string> getAvailableGenTLs(const char *paths)
 namespace
 {
 
-inline FARPROC getFunction(HMODULE lib, const char *name)
+inline void *getFunction(HMODULE lib, const char *name)
 {
   FARPROC ret=GetProcAddress(lib, name);
 
@@ -120,7 +120,7 @@ inline FARPROC getFunction(HMODULE lib, const char *name)
     throw std::invalid_argument(out.str());
   }
 
-  return ret;
+  return reinterpret_cast<void *>(ret);
 }
 
 }
@@ -141,82 +141,112 @@ GenTLWrapper::GenTLWrapper(const std::string &filename)
     throw std::invalid_argument(out.str());
   }
 
+  if (isGenTLProfilingEnabled())
+  {
+    profile.reset(new GenTLProfile(filename));
+  }
+
   // resolve function calls that will only be used privately
 
-  *reinterpret_cast<void**>(&GCInitLib)=getFunction(lp, "GCInitLib");
-  *reinterpret_cast<void**>(&GCCloseLib)=getFunction(lp, "GCCloseLib");
+  GCInitLib.set(getFunction(lp, "GCInitLib"), "GCInitLib", profile.get());
+  GCCloseLib.set(getFunction(lp, "GCCloseLib"), "GCCloseLib", profile.get());
 
   // resolve public symbols
 
-  *reinterpret_cast<void**>(&GCGetInfo)=getFunction(lp, "GCGetInfo");
-  *reinterpret_cast<void**>(&GCGetLastError)=getFunction(lp, "GCGetLastError");
-  *reinterpret_cast<void**>(&GCReadPort)=getFunction(lp, "GCReadPort");
-  *reinterpret_cast<void**>(&GCWritePort)=getFunction(lp, "GCWritePort");
-  *reinterpret_cast<void**>(&GCGetPortURL)=getFunction(lp, "GCGetPortURL");
-  *reinterpret_cast<void**>(&GCGetPortInfo)=getFunction(lp, "GCGetPortInfo");
-
-  *reinterpret_cast<void**>(&GCRegisterEvent)=getFunction(lp, "GCRegisterEvent");
-  *reinterpret_cast<void**>(&GCUnregisterEvent)=getFunction(lp, "GCUnregisterEvent");
-  *reinterpret_cast<void**>(&EventGetData)=getFunction(lp, "EventGetData");
-  *reinterpret_cast<void**>(&EventGetDataInfo)=getFunction(lp, "EventGetDataInfo");
-  *reinterpret_cast<void**>(&EventGetInfo)=getFunction(lp, "EventGetInfo");
-  *reinterpret_cast<void**>(&EventFlush)=getFunction(lp, "EventFlush");
-  *reinterpret_cast<void**>(&EventKill)=getFunction(lp, "EventKill");
-  *reinterpret_cast<void**>(&TLOpen)=getFunction(lp, "TLOpen");
-  *reinterpret_cast<void**>(&TLClose)=getFunction(lp, "TLClose");
-  *reinterpret_cast<void**>(&TLGetInfo)=getFunction(lp, "TLGetInfo");
-  *reinterpret_cast<void**>(&TLGetNumInterfaces)=getFunction(lp, "TLGetNumInterfaces");
-  *reinterpret_cast<void**>(&TLGetInterfaceID)=getFunction(lp, "TLGetInterfaceID");
-  *reinterpret_cast<void**>(&TLGetInterfaceInfo)=getFunction(lp, "TLGetInterfaceInfo");
-  *reinterpret_cast<void**>(&TLOpenInterface)=getFunction(lp, "TLOpenInterface");
-  *reinterpret_cast<void**>(&TLUpdateInterfaceList)=getFunction(lp, "TLUpdateInterfaceList");
-  *reinterpret_cast<void**>(&IFClose)=getFunction(lp, "IFClose");
-  *reinterpret_cast<void**>(&IFGetInfo)=getFunction(lp, "IFGetInfo");
-  *reinterpret_cast<void**>(&IFGetNumDevices)=getFunction(lp, "IFGetNumDevices");
-  *reinterpret_cast<void**>(&IFGetDeviceID)=getFunction(lp, "IFGetDeviceID");
-  *reinterpret_cast<void**>(&IFUpdateDeviceList)=getFunction(lp, "IFUpdateDeviceList");
-  *reinterpret_cast<void**>(&IFGetDeviceInfo)=getFunction(lp, "IFGetDeviceInfo");
-  *reinterpret_cast<void**>(&IFOpenDevice)=getFunction(lp, "IFOpenDevice");
-
-  *reinterpret_cast<void**>(&DevGetPort)=getFunction(lp, "DevGetPort");
-  *reinterpret_cast<void**>(&DevGetNumDataStreams)=getFunction(lp, "DevGetNumDataStreams");
-  *reinterpret_cast<void**>(&DevGetDataStreamID)=getFunction(lp, "DevGetDataStreamID");
-  *reinterpret_cast<void**>(&DevOpenDataStream)=getFunction(lp, "DevOpenDataStream");
-  *reinterpret_cast<void**>(&DevGetInfo)=getFunction(lp, "DevGetInfo");
-  *reinterpret_cast<void**>(&DevClose)=getFunction(lp, "DevClose");
-
-  *reinterpret_cast<void**>(&DSAnnounceBuffer)=getFunction(lp, "DSAnnounceBuffer");
-  *reinterpret_cast<void**>(&DSAllocAndAnnounceBuffer)=getFunction(lp, "DSAllocAndAnnounceBuffer");
-  *reinterpret_cast<void**>(&DSFlushQueue)=getFunction(lp, "DSFlushQueue");
-  *reinterpret_cast<void**>(&DSStartAcquisition)=getFunction(lp, "DSStartAcquisition");
-  *reinterpret_cast<void**>(&DSStopAcquisition)=getFunction(lp, "DSStopAcquisition");
-  *reinterpret_cast<void**>(&DSGetInfo)=getFunction(lp, "DSGetInfo");
-  *reinterpret_cast<void**>(&DSGetBufferID)=getFunction(lp, "DSGetBufferID");
-  *reinterpret_cast<void**>(&DSClose)=getFunction(lp, "DSClose");
-  *reinterpret_cast<void**>(&DSRevokeBuffer)=getFunction(lp, "DSRevokeBuffer");
-  *reinterpret_cast<void**>(&DSQueueBuffer)=getFunction(lp, "DSQueueBuffer");
-  *reinterpret_cast<void**>(&DSGetBufferInfo)=getFunction(lp, "DSGetBufferInfo");
-
-  *reinterpret_cast<void**>(&GCGetNumPortURLs)=getFunction(lp, "GCGetNumPortURLs");
-  *reinterpret_cast<void**>(&GCGetPortURLInfo)=getFunction(lp, "GCGetPortURLInfo");
-  *reinterpret_cast<void**>(&GCReadPortStacked)=getFunction(lp, "GCReadPortStacked");
-  *reinterpret_cast<void**>(&GCWritePortStacked)=getFunction(lp, "GCWritePortStacked");
-
-  *reinterpret_cast<void**>(&DSGetBufferChunkData)=getFunction(lp, "DSGetBufferChunkData");
-
-  *reinterpret_cast<void**>(&IFGetParentTL)=getFunction(lp, "IFGetParentTL");
-  *reinterpret_cast<void**>(&DevGetParentIF)=getFunction(lp, "DevGetParentIF");
-  *reinterpret_cast<void**>(&DSGetParentDev)=getFunction(lp, "DSGetParentDev");
-
-  *reinterpret_cast<void**>(&DSGetNumBufferParts)=getFunction(lp, "DSGetNumBufferParts");
-  *reinterpret_cast<void**>(&DSGetBufferPartInfo)=getFunction(lp, "DSGetBufferPartInfo");
+  GCGetInfo.set(getFunction(lp, "GCGetInfo"), "GCGetInfo", profile.get());
+  GCGetLastError.set(getFunction(lp, "GCGetLastError"), "GCGetLastError", profile.get());
+  GCReadPort.set(getFunction(lp, "GCReadPort"), "GCReadPort", profile.get());
+  GCWritePort.set(getFunction(lp, "GCWritePort"), "GCWritePort", profile.get());
+  GCGetPortURL.set(getFunction(lp, "GCGetPortURL"), "GCGetPortURL", profile.get());
+  GCGetPortInfo.set(getFunction(lp, "GCGetPortInfo"), "GCGetPortInfo", profile.get());
+
+  GCRegisterEvent.set(getFunction(lp, "GCRegisterEvent"), "GCRegisterEvent", profile.get());
+  GCUnregisterEvent.set(getFunction(lp, "GCUnregisterEvent"), "GCUnregisterEvent", profile.get());
+  EventGetData.set(getFunction(lp, "EventGetData"), "EventGetData", profile.get());
+  EventGetDataInfo.set(getFunction(lp, "EventGetDataInfo"), "EventGetDataInfo", profile.get());
+  EventGetInfo.set(getFunction(lp, "EventGetInfo"), "EventGetInfo", profile.get());
+  EventFlush.set(getFunction(lp, "EventFlush"), "EventFlush", profile.get());
+  EventKill.set(getFunction(lp, "EventKill"), "EventKill", profile.get());
+  TLOpen.set(getFunction(lp, "TLOpen"), "TLOpen", profile.get());
+  TLClose.set(getFunction(lp, "TLClose"), "TLClose", profile.get());
+  TLGetInfo.set(getFunction(lp, "TLGetInfo"), "TLGetInfo", profile.get());
+  TLGetNumInterfaces.set(getFunction(lp, "TLGetNumInterfaces"), "TLGetNumInterfaces", profile.get());
+  TLGetInterfaceID.set(getFunction(lp, "TLGetInterfaceID"), "TLGetInterfaceID", profile.get());
+  TLGetInterfaceInfo.set(getFunction(lp, "TLGetInterfaceInfo"), "TLGetInterfaceInfo", profile.get());
+  TLOpenInterface.set(getFunction(lp, "TLOpenInterface"), "TLOpenInterface", profile.get());
+  TLUpdateInterfaceList.set(getFunction(lp, "TLUpdateInterfaceList"), "TLUpdateInterfaceList", profile.get());
+  IFClose.set(getFunction(lp, "IFClose"), "IFClose", profile.get());
+  IFGetInfo.set(getFunction(lp, "IFGetInfo"), "IFGetInfo", profile.get());
+  IFGetNumDevices.set(getFunction(lp, "IFGetNumDevices"), "IFGetNumDevices", profile.get());
+  IFGetDeviceID.set(getFunction(lp, "IFGetDeviceID"), "IFGetDeviceID", profile.get());
+  IFUpdateDeviceList.set(getFunction(lp, "IFUpdateDeviceList"), "IFUpdateDeviceList", profile.get());
+  IFGetDeviceInfo.set(getFunction(lp, "IFGetDeviceInfo"), "IFGetDeviceInfo", profile.get());
+  IFOpenDevice.set(getFunction(lp, "IFOpenDevice"), "IFOpenDevice", profile.get());
+
+  DevGetPort.set(getFunction(lp, "DevGetPort"), "DevGetPort", profile.get());
+  DevGetNumDataStreams.set(getFunction(lp, "DevGetNumDataStreams"), "DevGetNumDataStreams", profile.get());
+  DevGetDataStreamID.set(getFunction(lp, "DevGetDataStreamID"), "DevGetDataStreamID", profile.get());
+  DevOpenDataStream.set(getFunction(lp, "DevOpenDataStream"), "DevOpenDataStream", profile.get());
+  DevGetInfo.set(getFunction(lp, "DevGetInfo"), "DevGetInfo", profile.get());
+  DevClose.set(getFunction(lp, "DevClose"), "DevClose", profile.get());
+
+  DSAnnounceBuffer.set(getFunction(lp, "DSAnnounceBuffer"), "DSAnnounceBuffer", profile.get());
+  DSAllocAndAnnounceBuffer.set(getFunction(lp, "DSAllocAndAnnounceBuffer"), "DSAllocAndAnnounceBuffer", profile.get());
+  DSFlushQueue.set(getFunction(lp, "DSFlushQueue"), "DSFlushQueue", profile.get());
+  DSStartAcquisition.set(getFunction(lp, "DSStartAcquisition"), "DSStartAcquisition", profile.get());
+  DSStopAcquisition.set(getFunction(lp, "DSStopAcquisition"), "DSStopAcquisition", profile.get());
+  DSGetInfo.set(getFunction(lp, "DSGetInfo"), "DSGetInfo", profile.get());
+  DSGetBufferID.set(getFunction(lp, "DSGetBufferID"), "DSGetBufferID", profile.get());
+  DSClose.set(getFunction(lp, "DSClose"), "DSClose", profile.get());
+  DSRevokeBuffer.set(getFunction(lp, "DSRevokeBuffer"), "DSRevokeBuffer", profile.get());
+  DSQueueBuffer.set(getFunction(lp, "DSQueueBuffer"), "DSQueueBuffer", profile.get());
+  DSGetBufferInfo.set(getFunction(lp, "DSGetBufferInfo"), "DSGetBufferInfo", profile.get());
+
+  GCGetNumPortURLs.set(getFunction(lp, "GCGetNumPortURLs"), "GCGetNumPortURLs", profile.get());
+  GCGetPortURLInfo.set(getFunction(lp, "GCGetPortURLInfo"), "GCGetPortURLInfo", profile.get());
+  GCReadPortStacked.set(getFunction(lp, "GCReadPortStacked"), "GCReadPortStacked", profile.get());
+  GCWritePortStacked.set(getFunction(lp, "GCWritePortStacked"), "GCWritePortStacked", profile.get());
+
+  DSGetBufferChunkData.set(getFunction(lp, "DSGetBufferChunkData"), "DSGetBufferChunkData", profile.get());
+
+  IFGetParentTL.set(getFunction(lp, "IFGetParentTL"), "IFGetParentTL", profile.get());
+  DevGetParentIF.set(getFunction(lp, "DevGetParentIF"), "DevGetParentIF", profile.get());
+  DSGetParentDev.set(getFunction(lp, "DSGetParentDev"), "DSGetParentDev", profile.get());
+
+  DSGetNumBufferParts.set(getFunction(lp, "DSGetNumBufferParts"), "DSGetNumBufferParts", profile.get());
+  DSGetBufferPartInfo.set(getFunction(lp, "DSGetBufferPartInfo"), "DSGetBufferPartInfo", profile.get());
 
   lib=static_cast<void *>(lp);
 }
 
 GenTLWrapper::~GenTLWrapper()
 {
+  if (profile)
+  {
+    std::cerr << profile->getReport();
+  }
+
   FreeLibrary(static_cast<HMODULE>(lib));
 }
 
+std::string GenTLWrapper::getProfilingReport() const
+{
+  if (profile)
+  {
+    return profile->getReport();
+  }
+
+  return std::string();
+}
+
+std::vector<GenTLProfile::Function> GenTLWrapper::getProfilingSnapshot() const
+{
+  if (profile)
+  {
+    return profile->getSnapshot();
+  }
+
+  return std::vector<GenTLProfile::Function>();
+}
+
 }
@@ -37,8 +37,11 @@
 
 #include "exception.h"
 #include "pixel_formats.h"
+#include "image_kernels.h"
+#include "thread_pool.h"
 
 #include <cstring>
+#include <algorithm>
 
 #ifdef _WIN32
 #undef min
@@ -49,6 +52,45 @@ namespace rcg
 {
 
 Image::Image(const Buffer *buffer, uint32_t part)
+{
+  const size_t size=init(buffer, part);
+
+  pixel.reset(new uint8_t [size]);
+
+  memcpy(pixel.get(), reinterpret_cast<uint8_t *>(buffer->getBase(part)), size);
+
+  pixels=pixel.get();
+}
+
+Image::Image(const std::shared_ptr<const Buffer> &buffer, uint32_t part)
+{
+  init(buffer.get(), part);
+
+  owner=buffer;
+  pixels=reinterpret_cast<const uint8_t *>(buffer->getBase(part));
+}
+
+Image::Image(const std::shared_ptr<const void> &_owner, const uint8_t *_pixels,
+             uint64_t _timestamp, size_t _width, size_t _height, size_t _xoffset,
+             size_t _yoffset, size_t _xpadding, size_t _ypadding, uint64_t _frameid,
+             uint64_t _pixelformat, bool _bigendian)
+{
+  owner=_owner;
+  pixels=_pixels;
+
+  timestamp=_timestamp;
+  width=_width;
+  height=_height;
+  xoffset=_xoffset;
+  yoffset=_yoffset;
+  xpadding=_xpadding;
+  ypadding=_ypadding;
+  frameid=_frameid;
+  pixelformat=_pixelformat;
+  bigendian=_bigendian;
+}
+
+size_t Image::init(const Buffer *buffer, uint32_t part)
 {
   if (buffer->getImagePresent(part))
   {
@@ -64,16 +106,12 @@ Image::Image(const Buffer *buffer, uint32_t part)
     pixelformat=buffer->getPixelFormat(part);
     bigendian=buffer->isBigEndian();
 
-    const size_t size=std::min(buffer->getSize(part), buffer->getSizeFilled());
-
     if (buffer->getSizeFilled() == 0)
     {
       throw GenTLException("Image without data");
     }
 
-    pixel.reset(new uint8_t [size]);
-
-    memcpy(pixel.get(), reinterpret_cast<uint8_t *>(buffer->getBase(part)), size);
+    return std::min(buffer->getSize(part), buffer->getSizeFilled());
   }
   else
   {
@@ -307,186 +345,47 @@ namespace
 {
 
 /*
-  Convert at green pixel in green-red row.
+  Returns the index of the given row, mirrored at the image border if it is
+  outside of the image.
 */
 
-inline void convertGreenGR(uint8_t &r, uint8_t &g, uint8_t &b,
-  const uint8_t *&row0, const uint8_t *&row1, const uint8_t *&row2)
+inline size_t mirrorRow(ptrdiff_t k, size_t height)
 {
-  r=static_cast<uint8_t>((static_cast<int>(*row1)+row1[2]+1)>>1);
-  g=row1[1];
-  b=static_cast<uint8_t>((static_cast<int>(row0[1])+row2[1]+1)>>1);
+  const ptrdiff_t h=static_cast<ptrdiff_t>(height);
 
-  row0++; row1++; row2++;
-}
-
-/*
-  Convert at green pixel in green-blue row.
-*/
-
-inline void convertGreenGB(uint8_t &r, uint8_t &g, uint8_t &b,
-  const uint8_t *&row0, const uint8_t *&row1, const uint8_t *&row2)
-{
-  r=static_cast<uint8_t>((static_cast<int>(row0[1])+row2[1]+1)>>1);
-  g=row1[1];
-  b=static_cast<uint8_t>((static_cast<int>(*row1)+row1[2]+1)>>1);
-
-  row0++; row1++; row2++;
-}
-
-/*
-  Convert at red pixel.
-*/
-
-inline void convertRed(uint8_t &r, uint8_t &g, uint8_t &b,
-  const uint8_t *&row0, const uint8_t *&row1, const uint8_t *&row2)
-{
-  r=row1[1];
-  g=static_cast<uint8_t>((static_cast<int>(row0[1])+row2[1]+*row1+row1[2]+2)>>2);
-  b=static_cast<uint8_t>((static_cast<int>(*row0)+row0[2]+*row2+row2[2]+2)>>2);
-
-  row0++; row1++; row2++;
-}
-
-/*
-  Convert at blue pixel.
-*/
-
-inline void convertBlue(uint8_t &r, uint8_t &g, uint8_t &b,
-  const uint8_t *&row0, const uint8_t *&row1, const uint8_t *&row2)
-{
-  r=static_cast<uint8_t>((static_cast<int>(*row0)+row0[2]+*row2+row2[2]+2)>>2);
-  g=static_cast<uint8_t>((static_cast<int>(row0[1])+row2[1]+*row1+row1[2]+2)>>2);
-  b=row1[1];
-
-  row0++; row1++; row2++;
-}
-
-/*
-  Convert RGB to monochrome.
-*/
-
-inline uint8_t rgb2Grey(uint8_t r, uint8_t g, uint8_t b)
-{
-  return static_cast<uint8_t>((9798*static_cast<uint32_t>(r)+
-                               19234*static_cast<uint32_t>(g)+
-                               3736*static_cast<uint32_t>(b)+16384)>>15);
-}
-
-inline void storeRGBMono(uint8_t *&rgb_out, uint8_t *&mono_out, uint8_t red, uint8_t green,
-  uint8_t blue)
-{
-  if (rgb_out)
+  if (k < 0)
   {
-    *rgb_out++ = red;
-    *rgb_out++ = green;
-    *rgb_out++ = blue;
+    k=-k;
   }
 
-  if (mono_out)
+  if (k >= h)
   {
-    *mono_out++ = rgb2Grey(red, green, blue);
+    k=2*h-2-k;
   }
+
+  return static_cast<size_t>(std::max(static_cast<ptrdiff_t>(0), std::min(k, h-1)));
 }
 
 /*
-  Convert green-red image row.
+  Copies an image row into a buffer that is 2 pixel larger, with mirrored
+  border pixels to avoid a special treatment of the image border.
 */
 
-void convertBayerGR(uint8_t *rgb_out, uint8_t *mono_out,
-  const uint8_t *row0, const uint8_t *row1, const uint8_t *row2,
-  bool greenfirst, size_t width)
+inline void loadExtendedRow(uint8_t *row, const uint8_t *raw, size_t width)
 {
-  uint8_t red, green, blue;
-
-  // convert if first pixel is green
-
-  size_t i=0;
-
-  if (greenfirst)
-  {
-    convertGreenGR(red, green, blue, row0, row1, row2);
-    storeRGBMono(rgb_out, mono_out, red, green, blue);
-
-    i++;
-  }
-
-  while (i+1 < width)
-  {
-    // convert at red pixel
-
-    convertRed(red, green, blue, row0, row1, row2);
-    storeRGBMono(rgb_out, mono_out, red, green, blue);
-
-    // convert at green pixel
-
-    convertGreenGR(red, green, blue, row0, row1, row2);
-    storeRGBMono(rgb_out, mono_out, red, green, blue);
-
-    i+=2;
-  }
-
-  // convert at red pixel
-
-  if (i < width)
-  {
-    convertRed(red, green, blue, row0, row1, row2);
-    storeRGBMono(rgb_out, mono_out, red, green, blue);
-  }
+  memcpy(row+1, raw, width*sizeof(uint8_t));
+  row[0]=row[2]; row[width+1]=row[width-1];
 }
 
 /*
-  Convert green-blue image row.
+  Converts the rows k0 to k1-1 of the image. All pointers refer to the
+  beginning of the image.
 */
 
-void convertBayerGB(uint8_t *rgb_out, uint8_t *mono_out,
-  const uint8_t *row0, const uint8_t *row1, const uint8_t *row2,
-  bool greenfirst, size_t width)
+void convertRows(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint64_t pixelformat,
+  size_t width, size_t height, size_t xpadding, size_t k0, size_t k1)
 {
-  uint8_t red, green, blue;
-
-  // convert if first pixel is green
-
-  size_t i=0;
-
-  if (greenfirst)
-  {
-    convertGreenGB(red, green, blue, row0, row1, row2);
-    storeRGBMono(rgb_out, mono_out, red, green, blue);
-
-    i++;
-  }
-
-  while (i+1 < width)
-  {
-    // convert at red pixel
-
-    convertBlue(red, green, blue, row0, row1, row2);
-    storeRGBMono(rgb_out, mono_out, red, green, blue);
-
-    // convert at green pixel
-
-    convertGreenGB(red, green, blue, row0, row1, row2);
-    storeRGBMono(rgb_out, mono_out, red, green, blue);
-
-    i+=2;
-  }
-
-  // convert at red pixel
-
-  if (i < width)
-  {
-    convertBlue(red, green, blue, row0, row1, row2);
-    storeRGBMono(rgb_out, mono_out, red, green, blue);
-  }
-}
-
-}
-
-bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint64_t pixelformat,
-  size_t width, size_t height, size_t xpadding)
-{
-  bool ret=true;
+  const ImageKernels &kernels=getImageKernels();
 
   switch (pixelformat)
   {
@@ -494,17 +393,16 @@ bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint6
     case Confidence8:
     case Error8:
       {
-        for (size_t k=0; k<height; k++)
+        raw+=k0*(width+xpadding);
+        if (rgb_out) rgb_out+=3*k0*width;
+        if (mono_out) mono_out+=k0*width;
+
+        for (size_t k=k0; k<k1; k++)
         {
           if (rgb_out)
           {
-            for (size_t i=0; i<width; i++)
-            {
-              uint8_t v=raw[i];
-              *rgb_out++ = v;
-              *rgb_out++ = v;
-              *rgb_out++ = v;
-            }
+            kernels.monoToRGB(rgb_out, raw, width);
+            rgb_out+=3*width;
           }
 
           if (mono_out)
@@ -520,30 +418,28 @@ bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint6
 
     case YCbCr411_8:
       {
+        // all pixels of the last group are converted if the width is not a
+        // multiple of 4
+
+        size_t n=(width+3)&~static_cast<size_t>(3);
         size_t pstep=(width>>2)*6+xpadding;
-        for (size_t k=0; k<height; k++)
+
+        raw+=k0*pstep;
+        if (rgb_out) rgb_out+=3*k0*n;
+        if (mono_out) mono_out+=k0*n;
+
+        for (size_t k=k0; k<k1; k++)
         {
-          for (size_t i=0; i<width; i+=4)
+          if (rgb_out)
           {
-            if (rgb_out)
-            {
-              uint8_t rgb[12];
-              convYCbCr411toQuadRGB(rgb, raw, static_cast<int>(i));
-
-              for (int j=0; j<12; j++)
-              {
-                *rgb_out++ = rgb[j];
-              }
-            }
-
-            if (mono_out)
-            {
-              size_t j=(i>>2)*6;
-              *mono_out++ = raw[j];
-              *mono_out++ = raw[j+1];
-              *mono_out++ = raw[j+3];
-              *mono_out++ = raw[j+4];
-            }
+            kernels.ycbcr411ToRGB(rgb_out, raw, n);
+            rgb_out+=3*n;
+          }
+
+          if (mono_out)
+          {
+            kernels.ycbcr411ToMono(mono_out, raw, n);
+            mono_out+=n;
           }
 
           raw+=pstep;
@@ -554,30 +450,25 @@ bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint6
     case YCbCr422_8:
     case YUV422_8:
       {
+        size_t n=(width+3)&~static_cast<size_t>(3);
         size_t pstep=(width>>2)*8+xpadding;
-        for (size_t k=0; k<height; k++)
+
+        raw+=k0*pstep;
+        if (rgb_out) rgb_out+=3*k0*n;
+        if (mono_out) mono_out+=k0*n;
+
+        for (size_t k=k0; k<k1; k++)
         {
-          for (size_t i=0; i<width; i+=4)
+          if (rgb_out)
           {
-            if (rgb_out)
-            {
-              uint8_t rgb[12];
-              convYCbCr422toQuadRGB(rgb, raw, static_cast<int>(i));
-
-              for (int j=0; j<12; j++)
-              {
-                *rgb_out++ = rgb[j];
-              }
-            }
-
-            if (mono_out)
-            {
-              size_t j=(i>>2)*8;
-              *mono_out++ = raw[j];
-              *mono_out++ = raw[j+2];
-              *mono_out++ = raw[j+4];
-              *mono_out++ = raw[j+6];
-            }
+            kernels.ycbcr422ToRGB(rgb_out, raw, n);
+            rgb_out+=3*n;
+          }
+
+          if (mono_out)
+          {
+            kernels.ycbcr422ToMono(mono_out, raw, n);
+            mono_out+=n;
           }
 
           raw+=pstep;
@@ -587,7 +478,11 @@ bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint6
 
     case RGB8:
       {
-        for (size_t k=0; k<height; k++)
+        raw+=k0*(3*width+xpadding);
+        if (rgb_out) rgb_out+=3*k0*width;
+        if (mono_out) mono_out+=k0*width;
+
+        for (size_t k=k0; k<k1; k++)
         {
           if (rgb_out)
           {
@@ -597,12 +492,8 @@ bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint6
 
           if (mono_out)
           {
-            size_t j=0;
-            for (size_t i=0; i<width; i++)
-            {
-              *mono_out++ = rgb2Grey(raw[j], raw[j+1], raw[j+2]);
-              j+=3;
-            }
+            kernels.rgbToMono(mono_out, raw, width);
+            mono_out+=width;
           }
 
           raw+=3*width+xpadding;
@@ -622,8 +513,19 @@ bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint6
         bool greenfirst=(pixelformat == BayerGR8 || pixelformat == BayerGB8);
         bool red=(pixelformat == BayerRG8 || pixelformat == BayerGR8);
 
+        if (k0 & 1)
+        {
+          greenfirst=!greenfirst;
+          red=!red;
+        }
+
+        if (rgb_out) rgb_out+=3*k0*width;
+        if (mono_out) mono_out+=k0*width;
+
         // setup temporary buffer that is 1 pixel larger than the image
 
+        const size_t lstep=width+xpadding;
+
         std::unique_ptr<uint8_t []> buffer(new uint8_t [(width+2)*3]);
         uint8_t *row[3];
 
@@ -631,47 +533,31 @@ bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint6
         row[1]=row[0]+width+2;
         row[2]=row[1]+width+2;
 
-        // initialize buffer with 2 rows, extended by two pixel to avoid a special
-        // treatment for the image border
-
-        memcpy(row[1]+1, raw+width+xpadding, width*sizeof(uint8_t));
-        memcpy(row[2]+1, raw, width*sizeof(uint8_t));
+        // initialize buffer with the row above the first row and the first
+        // row, using mirrored rows at the image border
 
-        row[1][0]=row[1][2]; row[1][width+1]=row[1][width-1];
-        row[2][0]=row[2][2]; row[2][width+1]=row[2][width-1];
+        loadExtendedRow(row[1], raw+mirrorRow(static_cast<ptrdiff_t>(k0)-1, height)*lstep, width);
+        loadExtendedRow(row[2], raw+k0*lstep, width);
 
         // for all rows
 
-        for (size_t k=0; k<height; k++)
+        for (size_t k=k0; k<k1; k++)
         {
           // store next extended row in buffer
 
-          if (k+1 < height)
-          {
-            uint8_t *p=row[0];
-            row[0]=row[1];
-            row[1]=row[2];
-            row[2]=p;
-
-            memcpy(row[2]+1, raw+(k+1)*(width+xpadding), width*sizeof(uint8_t));
-
-            row[2][0]=row[2][2]; row[2][width+1]=row[2][width-1];
-          }
+          uint8_t *p=row[0];
+          row[0]=row[1];
+          row[1]=row[2];
+          row[2]=p;
 
-          if (red)
-          {
-            convertBayerGR(rgb_out, mono_out, row[0], row[1], row[2], greenfirst, width);
+          loadExtendedRow(row[2], raw+mirrorRow(static_cast<ptrdiff_t>(k)+1, height)*lstep,
+                          width);
 
-            if (rgb_out) rgb_out+=3*width;
-            if (mono_out) mono_out+=width;
-          }
-          else
-          {
-            convertBayerGB(rgb_out, mono_out, row[0], row[1], row[2], greenfirst, width);
+          kernels.bayerToRGB(rgb_out, mono_out, row[0], row[1], row[2], red, greenfirst,
+                             width);
 
-            if (rgb_out) rgb_out+=3*width;
-            if (mono_out) mono_out+=width;
-          }
+          if (rgb_out) rgb_out+=3*width;
+          if (mono_out) mono_out+=width;
 
           greenfirst=!greenfirst;
           red=!red;
@@ -680,11 +566,50 @@ bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint6
       break;
 
     default:
-      ret=false;
       break;
   }
+}
+
+}
+
+bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint64_t pixelformat,
+  size_t width, size_t height, size_t xpadding)
+{
+  return convertImage(rgb_out, mono_out, raw, pixelformat, width, height, xpadding, 1);
+}
+
+bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint64_t pixelformat,
+  size_t width, size_t height, size_t xpadding, size_t nthreads)
+{
+  if (!isFormatSupported(pixelformat, false))
+  {
+    return false;
+  }
+
+  // split image into bands of rows with an even number of rows, so that all
+  // bands start with the same Bayer pattern, and with a minimum size to keep
+  // the overhead low
+
+  const size_t min_rows=16;
+
+  size_t nbands=std::min(ThreadPool::getNumThreads(nthreads), (height+min_rows-1)/min_rows);
+
+  if (nbands <= 1)
+  {
+    convertRows(rgb_out, mono_out, raw, pixelformat, width, height, xpadding, 0, height);
+    return true;
+  }
+
+  const size_t band=((height+nbands-1)/nbands+1)&~static_cast<size_t>(1);
+  nbands=(height+band-1)/band;
+
+  ThreadPool::getInstance().parallelFor(nbands, nbands, [&](size_t i)
+  {
+    convertRows(rgb_out, mono_out, raw, pixelformat, width, height, xpadding, i*band,
+                std::min(height, (i+1)*band));
+  });
 
-  return ret;
+  return true;
 }
 
 bool isFormatSupported(uint64_t pixelformat, bool only_color)
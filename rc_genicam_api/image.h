@@ -65,13 +65,48 @@ class Image
 
     Image(const Buffer *buffer, uint32_t part);
 
+    /**
+      Creates the image as view onto the pixels of a leased buffer (see
+      Stream::grabLeased()), without copying the data. The image keeps the
+      lease until it is destroyed.
+
+      @param buffer Leased buffer.
+      @param part   Part number from which the image should be created.
+    */
+
+    Image(const std::shared_ptr<const Buffer> &buffer, uint32_t part);
+
+    /**
+      Creates the image as view onto pixels in memory that is managed by
+      someone else, without copying the data. The image keeps a reference to
+      the given owner until it is destroyed.
+
+      @param owner       Object that keeps the pixel memory valid.
+      @param pixels      Pointer to the pixels.
+      @param timestamp   Timestamp in nano seconds.
+      @param width       Width of image.
+      @param height      Height of image.
+      @param xoffset     Offset of image in x direction.
+      @param yoffset     Offset of image in y direction.
+      @param xpadding    Padding at the end of each row in bytes.
+      @param ypadding    Padding at the end of the image in bytes.
+      @param frameid     Frame ID.
+      @param pixelformat Pixel format.
+      @param bigendian   True if pixels with more than one byte are stored big
+                         endian.
+    */
+
+    Image(const std::shared_ptr<const void> &owner, const uint8_t *pixels, uint64_t timestamp,
+          size_t width, size_t height, size_t xoffset, size_t yoffset, size_t xpadding,
+          size_t ypadding, uint64_t frameid, uint64_t pixelformat, bool bigendian);
+
     /**
       Pointer to pixel information of the image.
 
       @return Pointer to pixels.
     */
 
-    const uint8_t *getPixels() const { return pixel.get(); }
+    const uint8_t *getPixels() const { return pixels; }
 
     uint64_t getTimestampNS() const { return timestamp; }
 
@@ -90,7 +125,11 @@ class Image
     Image(class Image &); // forbidden
     Image &operator=(const Image &); // forbidden
 
+    size_t init(const Buffer *buffer, uint32_t part);
+
     std::unique_ptr<uint8_t []> pixel;
+    std::shared_ptr<const void> owner;
+    const uint8_t *pixels;
 
     uint64_t timestamp;
     size_t width;
@@ -188,6 +227,30 @@ void getColor(uint8_t rgb[3], const std::shared_ptr<const Image> &img,
 bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint64_t pixelformat,
   size_t width, size_t height, size_t xpadding);
 
+/**
+  Converts image to RGB and monochrome format like the function above, but
+  splits the image into bands of rows that are converted in parallel by a pool
+  of worker threads, which is owned by the library. The result is the same as
+  for sequential conversion.
+
+  @param rgb_out     Pointer to target array for rgb image. The array must have
+                     a size of 3*width*height pixel. The pointer can be 0.
+  @param mono_out    Pointer to target array for monochrome image. The array
+                     must have a size of width*height pixel. The pointer can be 0.
+  @param raw         Pointer to input pixels.
+  @param pixelformat Pixel format of input.
+  @param width       Width of image.
+  @param height      Height of image.
+  @param xpadding    Padding of input image.
+  @param nthreads    Number of threads, including the calling thread. 0 means
+                     that the number of cores is used.
+  @return            False, if pixelformat is not supported. In this case,
+                     nothing is written to the target pointers.
+*/
+
+bool convertImage(uint8_t *rgb_out, uint8_t *mono_out, const uint8_t *raw, uint64_t pixelformat,
+  size_t width, size_t height, size_t xpadding, size_t nthreads);
+
 /**
   Returns true if the given pixel format is supported by the convertImage()
   function.
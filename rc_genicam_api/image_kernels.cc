@@ -0,0 +1,461 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "image_kernels.h"
+#include "image.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace rcg
+{
+
+namespace
+{
+
+/*
+  Convert at green pixel in green-red row.
+*/
+
+inline void convertGreenGR(uint8_t &r, uint8_t &g, uint8_t &b,
+  const uint8_t *&row0, const uint8_t *&row1, const uint8_t *&row2)
+{
+  r=static_cast<uint8_t>((static_cast<int>(*row1)+row1[2]+1)>>1);
+  g=row1[1];
+  b=static_cast<uint8_t>((static_cast<int>(row0[1])+row2[1]+1)>>1);
+
+  row0++; row1++; row2++;
+}
+
+/*
+  Convert at green pixel in green-blue row.
+*/
+
+inline void convertGreenGB(uint8_t &r, uint8_t &g, uint8_t &b,
+  const uint8_t *&row0, const uint8_t *&row1, const uint8_t *&row2)
+{
+  r=static_cast<uint8_t>((static_cast<int>(row0[1])+row2[1]+1)>>1);
+  g=row1[1];
+  b=static_cast<uint8_t>((static_cast<int>(*row1)+row1[2]+1)>>1);
+
+  row0++; row1++; row2++;
+}
+
+/*
+  Convert at red pixel.
+*/
+
+inline void convertRed(uint8_t &r, uint8_t &g, uint8_t &b,
+  const uint8_t *&row0, const uint8_t *&row1, const uint8_t *&row2)
+{
+  r=row1[1];
+  g=static_cast<uint8_t>((static_cast<int>(row0[1])+row2[1]+*row1+row1[2]+2)>>2);
+  b=static_cast<uint8_t>((static_cast<int>(*row0)+row0[2]+*row2+row2[2]+2)>>2);
+
+  row0++; row1++; row2++;
+}
+
+/*
+  Convert at blue pixel.
+*/
+
+inline void convertBlue(uint8_t &r, uint8_t &g, uint8_t &b,
+  const uint8_t *&row0, const uint8_t *&row1, const uint8_t *&row2)
+{
+  r=static_cast<uint8_t>((static_cast<int>(*row0)+row0[2]+*row2+row2[2]+2)>>2);
+  g=static_cast<uint8_t>((static_cast<int>(row0[1])+row2[1]+*row1+row1[2]+2)>>2);
+  b=row1[1];
+
+  row0++; row1++; row2++;
+}
+
+/*
+  Convert RGB to monochrome.
+*/
+
+inline uint8_t rgb2Grey(uint8_t r, uint8_t g, uint8_t b)
+{
+  return static_cast<uint8_t>((9798*static_cast<uint32_t>(r)+
+                               19234*static_cast<uint32_t>(g)+
+                               3736*static_cast<uint32_t>(b)+16384)>>15);
+}
+
+inline void storeRGBMono(uint8_t *&rgb_out, uint8_t *&mono_out, uint8_t red, uint8_t green,
+  uint8_t blue)
+{
+  if (rgb_out)
+  {
+    *rgb_out++ = red;
+    *rgb_out++ = green;
+    *rgb_out++ = blue;
+  }
+
+  if (mono_out)
+  {
+    *mono_out++ = rgb2Grey(red, green, blue);
+  }
+}
+
+/*
+  Convert green-red image row.
+*/
+
+void convertBayerGR(uint8_t *rgb_out, uint8_t *mono_out,
+  const uint8_t *row0, const uint8_t *row1, const uint8_t *row2,
+  bool greenfirst, size_t width)
+{
+  uint8_t red, green, blue;
+
+  // convert if first pixel is green
+
+  size_t i=0;
+
+  if (greenfirst && i < width)
+  {
+    convertGreenGR(red, green, blue, row0, row1, row2);
+    storeRGBMono(rgb_out, mono_out, red, green, blue);
+
+    i++;
+  }
+
+  while (i+1 < width)
+  {
+    // convert at red pixel
+
+    convertRed(red, green, blue, row0, row1, row2);
+    storeRGBMono(rgb_out, mono_out, red, green, blue);
+
+    // convert at green pixel
+
+    convertGreenGR(red, green, blue, row0, row1, row2);
+    storeRGBMono(rgb_out, mono_out, red, green, blue);
+
+    i+=2;
+  }
+
+  // convert at red pixel
+
+  if (i < width)
+  {
+    convertRed(red, green, blue, row0, row1, row2);
+    storeRGBMono(rgb_out, mono_out, red, green, blue);
+  }
+}
+
+/*
+  Convert green-blue image row.
+*/
+
+void convertBayerGB(uint8_t *rgb_out, uint8_t *mono_out,
+  const uint8_t *row0, const uint8_t *row1, const uint8_t *row2,
+  bool greenfirst, size_t width)
+{
+  uint8_t red, green, blue;
+
+  // convert if first pixel is green
+
+  size_t i=0;
+
+  if (greenfirst && i < width)
+  {
+    convertGreenGB(red, green, blue, row0, row1, row2);
+    storeRGBMono(rgb_out, mono_out, red, green, blue);
+
+    i++;
+  }
+
+  while (i+1 < width)
+  {
+    // convert at blue pixel
+
+    convertBlue(red, green, blue, row0, row1, row2);
+    storeRGBMono(rgb_out, mono_out, red, green, blue);
+
+    // convert at green pixel
+
+    convertGreenGB(red, green, blue, row0, row1, row2);
+    storeRGBMono(rgb_out, mono_out, red, green, blue);
+
+    i+=2;
+  }
+
+  // convert at blue pixel
+
+  if (i < width)
+  {
+    convertBlue(red, green, blue, row0, row1, row2);
+    storeRGBMono(rgb_out, mono_out, red, green, blue);
+  }
+}
+
+void scalarMonoToRGB(uint8_t *rgb, const uint8_t *mono, size_t n)
+{
+  for (size_t i=0; i<n; i++)
+  {
+    uint8_t v=mono[i];
+    *rgb++ = v;
+    *rgb++ = v;
+    *rgb++ = v;
+  }
+}
+
+void scalarRGBToMono(uint8_t *mono, const uint8_t *rgb, size_t n)
+{
+  for (size_t i=0; i<n; i++)
+  {
+    *mono++ = rgb2Grey(rgb[0], rgb[1], rgb[2]);
+    rgb+=3;
+  }
+}
+
+void scalarYCbCr411ToRGB(uint8_t *rgb, const uint8_t *src, size_t n)
+{
+  for (size_t i=0; i<n; i+=4)
+  {
+    convYCbCr411toQuadRGB(rgb, src, static_cast<int>(i));
+    rgb+=12;
+  }
+}
+
+void scalarYCbCr411ToMono(uint8_t *mono, const uint8_t *src, size_t n)
+{
+  for (size_t i=0; i<n; i+=4)
+  {
+    *mono++ = src[0];
+    *mono++ = src[1];
+    *mono++ = src[3];
+    *mono++ = src[4];
+    src+=6;
+  }
+}
+
+void scalarYCbCr422ToRGB(uint8_t *rgb, const uint8_t *src, size_t n)
+{
+  for (size_t i=0; i<n; i+=4)
+  {
+    convYCbCr422toQuadRGB(rgb, src, static_cast<int>(i));
+    rgb+=12;
+  }
+}
+
+void scalarYCbCr422ToMono(uint8_t *mono, const uint8_t *src, size_t n)
+{
+  for (size_t i=0; i<n; i+=4)
+  {
+    *mono++ = src[0];
+    *mono++ = src[2];
+    *mono++ = src[4];
+    *mono++ = src[6];
+    src+=8;
+  }
+}
+
+void scalarBayerToRGB(uint8_t *rgb, uint8_t *mono, const uint8_t *row0, const uint8_t *row1,
+                      const uint8_t *row2, bool red, bool greenfirst, size_t n)
+{
+  if (red)
+  {
+    convertBayerGR(rgb, mono, row0, row1, row2, greenfirst, n);
+  }
+  else
+  {
+    convertBayerGB(rgb, mono, row0, row1, row2, greenfirst, n);
+  }
+}
+
+/*
+  Checks if the CPU supports the given instruction set.
+*/
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+bool cpuSupportsSSSE3()
+{
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("ssse3");
+}
+
+bool cpuSupportsAVX2()
+{
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+
+bool cpuSupportsSSSE3()
+{
+  int info[4];
+  __cpuid(info, 1);
+  return (info[2] & (1<<9)) != 0;
+}
+
+bool cpuSupportsAVX2()
+{
+  int info[4];
+  __cpuid(info, 0);
+
+  if (info[0] < 7)
+  {
+    return false;
+  }
+
+  // check that the OS saves the AVX registers
+
+  __cpuid(info, 1);
+
+  if ((info[2] & (1<<27)) == 0 || (info[2] & (1<<28)) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+  {
+    return false;
+  }
+
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1<<5)) != 0;
+}
+
+#else
+
+bool cpuSupportsSSSE3()
+{
+  return false;
+}
+
+bool cpuSupportsAVX2()
+{
+  return false;
+}
+
+#endif
+
+const ImageKernels *selectImageKernels()
+{
+  std::string limit;
+
+  const char *env=std::getenv("RCG_IMAGE_KERNELS");
+  if (env != 0)
+  {
+    limit=env;
+  }
+
+  const ImageKernels *ret=&getScalarImageKernels();
+
+  if (limit == "scalar")
+  {
+    return ret;
+  }
+
+  if (getNEONImageKernels() != 0)
+  {
+    ret=getNEONImageKernels();
+
+    if (limit == "neon")
+    {
+      return ret;
+    }
+  }
+
+  if (getSSSE3ImageKernels() != 0 && cpuSupportsSSSE3())
+  {
+    ret=getSSSE3ImageKernels();
+
+    if (limit == "ssse3")
+    {
+      return ret;
+    }
+  }
+
+  if (getAVX2ImageKernels() != 0 && cpuSupportsAVX2())
+  {
+    ret=getAVX2ImageKernels();
+  }
+
+  return ret;
+}
+
+}
+
+const ImageKernels &getScalarImageKernels()
+{
+  static const ImageKernels kernels=
+  {
+    "scalar",
+    scalarMonoToRGB,
+    scalarRGBToMono,
+    scalarYCbCr411ToRGB,
+    scalarYCbCr411ToMono,
+    scalarYCbCr422ToRGB,
+    scalarYCbCr422ToMono,
+    scalarBayerToRGB
+  };
+
+  return kernels;
+}
+
+std::vector<const ImageKernels *> getSupportedImageKernels()
+{
+  std::vector<const ImageKernels *> ret;
+
+  ret.push_back(&getScalarImageKernels());
+
+  if (getNEONImageKernels() != 0)
+  {
+    ret.push_back(getNEONImageKernels());
+  }
+
+  if (getSSSE3ImageKernels() != 0 && cpuSupportsSSSE3())
+  {
+    ret.push_back(getSSSE3ImageKernels());
+  }
+
+  if (getAVX2ImageKernels() != 0 && cpuSupportsAVX2())
+  {
+    ret.push_back(getAVX2ImageKernels());
+  }
+
+  return ret;
+}
+
+const ImageKernels &getImageKernels()
+{
+  static const ImageKernels *kernels=selectImageKernels();
+  return *kernels;
+}
+
+}
@@ -0,0 +1,110 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_IMAGE_KERNELS
+#define RC_GENICAM_API_IMAGE_KERNELS
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace rcg
+{
+
+/**
+  Table of row conversion functions that are used by convertImage(). There is
+  one scalar reference implementation and optional vectorized implementations
+  for different instruction sets. All implementations must produce exactly the
+  same output as the reference implementation.
+
+  The YCbCr functions expect the number of pixels to be a multiple of 4. The
+  Bayer function expects three rows that are extended by one pixel on the left
+  and right side. Either rgb or mono may be 0 in the Bayer function.
+*/
+
+struct ImageKernels
+{
+  const char *name;
+
+  void (*monoToRGB)(uint8_t *rgb, const uint8_t *mono, size_t n);
+  void (*rgbToMono)(uint8_t *mono, const uint8_t *rgb, size_t n);
+
+  void (*ycbcr411ToRGB)(uint8_t *rgb, const uint8_t *src, size_t n);
+  void (*ycbcr411ToMono)(uint8_t *mono, const uint8_t *src, size_t n);
+
+  void (*ycbcr422ToRGB)(uint8_t *rgb, const uint8_t *src, size_t n);
+  void (*ycbcr422ToMono)(uint8_t *mono, const uint8_t *src, size_t n);
+
+  void (*bayerToRGB)(uint8_t *rgb, uint8_t *mono, const uint8_t *row0,
+                     const uint8_t *row1, const uint8_t *row2, bool red,
+                     bool greenfirst, size_t n);
+};
+
+/**
+  Returns the scalar reference implementation.
+*/
+
+const ImageKernels &getScalarImageKernels();
+
+/**
+  Returns the implementations for specific instruction sets or 0 if they are
+  not compiled in. The caller must check that the CPU supports the instruction
+  set before calling any of the functions.
+*/
+
+const ImageKernels *getSSSE3ImageKernels();
+const ImageKernels *getAVX2ImageKernels();
+const ImageKernels *getNEONImageKernels();
+
+/**
+  Returns all implementations that are compiled in and supported by the CPU,
+  starting with the scalar reference implementation, e.g. for comparing them.
+*/
+
+std::vector<const ImageKernels *> getSupportedImageKernels();
+
+/**
+  Returns the fastest implementation that is supported by the CPU. The
+  environment variable RCG_IMAGE_KERNELS can be set to 'scalar', 'ssse3',
+  'avx2' or 'neon' for limiting the selection, e.g. for comparing the
+  implementations.
+*/
+
+const ImageKernels &getImageKernels();
+
+}
+
+#endif
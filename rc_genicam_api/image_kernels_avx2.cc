@@ -0,0 +1,137 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+  This file is compiled with AVX2 enabled. The functions must only be called
+  after checking that the CPU supports AVX2.
+*/
+
+#include "image_kernels.h"
+
+#if defined(__AVX2__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+
+#include "image_kernels_x86.h"
+
+namespace rcg
+{
+
+namespace
+{
+
+/*
+  Vector operations on 256 bit registers. Both 128 bit lanes are loaded and
+  stored independently, using the given stride between the lanes.
+*/
+
+struct AVX2Ops
+{
+  typedef __m256i V;
+
+  static const size_t lanes=2;
+
+  static inline V load(const uint8_t *p, size_t stride)
+  {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(p))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(p+stride)), 1);
+  }
+
+  static inline void store(uint8_t *p, size_t stride, V v)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm256_castsi256_si128(v));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p+stride), _mm256_extracti128_si256(v, 1));
+  }
+
+  static inline V pattern(const int8_t *p)
+  {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+  }
+
+  static inline V zero() { return _mm256_setzero_si256(); }
+  static inline V set16(int16_t v) { return _mm256_set1_epi16(v); }
+  static inline V set32(int32_t v) { return _mm256_set1_epi32(v); }
+
+  static inline V shuffle(V a, V m) { return _mm256_shuffle_epi8(a, m); }
+  template<int imm> static inline V shuffle16(V a)
+  {
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(a, imm), imm);
+  }
+
+  static inline V or_(V a, V b) { return _mm256_or_si256(a, b); }
+  static inline V and_(V a, V b) { return _mm256_and_si256(a, b); }
+  static inline V blend(V m, V a, V b) { return _mm256_blendv_epi8(b, a, m); }
+
+  static inline V unpacklo8(V a, V b) { return _mm256_unpacklo_epi8(a, b); }
+  static inline V unpackhi8(V a, V b) { return _mm256_unpackhi_epi8(a, b); }
+  static inline V unpacklo16(V a, V b) { return _mm256_unpacklo_epi16(a, b); }
+  static inline V unpackhi16(V a, V b) { return _mm256_unpackhi_epi16(a, b); }
+  static inline V packus16(V a, V b) { return _mm256_packus_epi16(a, b); }
+  static inline V packs32(V a, V b) { return _mm256_packs_epi32(a, b); }
+
+  static inline V avg8(V a, V b) { return _mm256_avg_epu8(a, b); }
+  static inline V add16(V a, V b) { return _mm256_add_epi16(a, b); }
+  static inline V sub16(V a, V b) { return _mm256_sub_epi16(a, b); }
+  static inline V mul16(V a, V b) { return _mm256_mullo_epi16(a, b); }
+  static inline V add32(V a, V b) { return _mm256_add_epi32(a, b); }
+  static inline V madd(V a, V b) { return _mm256_madd_epi16(a, b); }
+
+  template<int n> static inline V srai16(V a) { return _mm256_srai_epi16(a, n); }
+  template<int n> static inline V srli16(V a) { return _mm256_srli_epi16(a, n); }
+  template<int n> static inline V srli32(V a) { return _mm256_srli_epi32(a, n); }
+};
+
+}
+
+const ImageKernels *getAVX2ImageKernels()
+{
+  static const ImageKernels kernels=createImageKernels<AVX2Ops>("avx2");
+  return &kernels;
+}
+
+}
+
+#else
+
+namespace rcg
+{
+
+const ImageKernels *getAVX2ImageKernels()
+{
+  return 0;
+}
+
+}
+
+#endif
@@ -0,0 +1,386 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+  This file contains the NEON implementation, which is only compiled if the
+  compiler generates code for a CPU with NEON, i.e. on all 64 bit ARM CPUs and
+  on 32 bit ARM CPUs if NEON is explicitly enabled.
+*/
+
+#include "image_kernels.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace rcg
+{
+
+namespace
+{
+
+const uint8_t green_even[16]={255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0};
+const uint8_t green_odd[16]={0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255, 0, 255};
+
+/*
+  Converts RGB of 8 pixels to monochrome in the same way as the scalar
+  implementation, i.e. (9798*r+19234*g+3736*b+16384)>>15.
+*/
+
+inline uint8x8_t rgbToGrey(uint8x8_t r, uint8x8_t g, uint8x8_t b)
+{
+  uint16x8_t r16=vmovl_u8(r);
+  uint16x8_t g16=vmovl_u8(g);
+  uint16x8_t b16=vmovl_u8(b);
+
+  uint32x4_t s0=vmull_n_u16(vget_low_u16(r16), 9798);
+  s0=vmlal_n_u16(s0, vget_low_u16(g16), 19234);
+  s0=vmlal_n_u16(s0, vget_low_u16(b16), 3736);
+
+  uint32x4_t s1=vmull_n_u16(vget_high_u16(r16), 9798);
+  s1=vmlal_n_u16(s1, vget_high_u16(g16), 19234);
+  s1=vmlal_n_u16(s1, vget_high_u16(b16), 3736);
+
+  return vmovn_u16(vcombine_u16(vrshrn_n_u32(s0, 15), vrshrn_n_u32(s1, 15)));
+}
+
+inline uint8x16_t rgbToGrey(uint8x16_t r, uint8x16_t g, uint8x16_t b)
+{
+  return vcombine_u8(rgbToGrey(vget_low_u8(r), vget_low_u8(g), vget_low_u8(b)),
+                     rgbToGrey(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b)));
+}
+
+/*
+  Computes the offsets for red, green and blue from 8 Cb and Cr values in the
+  same way as the scalar implementation.
+*/
+
+inline void colorOffsets(int16x8_t &rc, int16x8_t &gc, int16x8_t &bc, uint8x8_t cb8,
+                         uint8x8_t cr8)
+{
+  const int16x8_t k=vdupq_n_s16(16384+32);
+  const int16x8_t off=vdupq_n_s16(256);
+
+  int16x8_t cb=vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(cb8)), vdupq_n_s16(128));
+  int16x8_t cr=vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(cr8)), vdupq_n_s16(128));
+
+  rc=vsubq_s16(vshrq_n_s16(vaddq_s16(vmulq_n_s16(cr, 90), k), 6), off);
+  gc=vsubq_s16(vshrq_n_s16(vaddq_s16(vaddq_s16(vmulq_n_s16(cb, -22), vmulq_n_s16(cr, -46)),
+                                     k), 6), off);
+  bc=vsubq_s16(vshrq_n_s16(vaddq_s16(vmulq_n_s16(cb, 113), k), 6), off);
+}
+
+/*
+  Adds the offset to 8 Y values and clamps the result.
+*/
+
+inline uint8x8_t addClamp(uint8x8_t y, int16x8_t c)
+{
+  return vqmovun_s16(vaddq_s16(vreinterpretq_s16_u16(vmovl_u8(y)), c));
+}
+
+/*
+  Computes (a+b+c+d+2)>>2 for each byte.
+*/
+
+inline uint8x16_t avg4(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d)
+{
+  uint16x8_t lo=vaddq_u16(vaddl_u8(vget_low_u8(a), vget_low_u8(b)),
+                          vaddl_u8(vget_low_u8(c), vget_low_u8(d)));
+  uint16x8_t hi=vaddq_u16(vaddl_u8(vget_high_u8(a), vget_high_u8(b)),
+                          vaddl_u8(vget_high_u8(c), vget_high_u8(d)));
+
+  return vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2));
+}
+
+void neonMonoToRGB(uint8_t *rgb, const uint8_t *mono, size_t n)
+{
+  size_t i=0;
+  while (i+16 <= n)
+  {
+    uint8x16x3_t v;
+
+    v.val[0]=vld1q_u8(mono+i);
+    v.val[1]=v.val[0];
+    v.val[2]=v.val[0];
+
+    vst3q_u8(rgb, v);
+
+    rgb+=48;
+    i+=16;
+  }
+
+  getScalarImageKernels().monoToRGB(rgb, mono+i, n-i);
+}
+
+void neonRGBToMono(uint8_t *mono, const uint8_t *rgb, size_t n)
+{
+  size_t i=0;
+  while (i+16 <= n)
+  {
+    uint8x16x3_t v=vld3q_u8(rgb);
+
+    vst1q_u8(mono+i, rgbToGrey(v.val[0], v.val[1], v.val[2]));
+
+    rgb+=48;
+    i+=16;
+  }
+
+  getScalarImageKernels().rgbToMono(mono+i, rgb, n-i);
+}
+
+/*
+  Loads 32 pixels in YCbCr411 format, which are 48 bytes. Every 3 bytes
+  contain either Y0, Y1 and Cb or Y2, Y3 and Cr of a group of 4 pixels. The Y
+  values are returned in pixel order. Cb and Cr are returned per group.
+*/
+
+inline void loadYCbCr411(uint8x16x2_t &y, uint8x8_t &cb, uint8x8_t &cr, const uint8_t *src)
+{
+  uint8x16x3_t v=vld3q_u8(src);
+  uint8x8x2_t c=vuzp_u8(vget_low_u8(v.val[2]), vget_high_u8(v.val[2]));
+
+  y=vzipq_u8(v.val[0], v.val[1]);
+  cb=c.val[0];
+  cr=c.val[1];
+}
+
+void neonYCbCr411ToRGB(uint8_t *rgb, const uint8_t *src, size_t n)
+{
+  size_t i=0;
+  while (i+32 <= n)
+  {
+    uint8x16x2_t y;
+    uint8x8_t cb, cr;
+
+    loadYCbCr411(y, cb, cr, src);
+
+    int16x8_t c[3];
+    colorOffsets(c[0], c[1], c[2], cb, cr);
+
+    // replicate the offsets of each group for all 4 pixels of the group
+
+    int16x8_t cc[3][4];
+    for (int j=0; j<3; j++)
+    {
+      int16x8x2_t a=vzipq_s16(c[j], c[j]);
+      int16x8x2_t b0=vzipq_s16(a.val[0], a.val[0]);
+      int16x8x2_t b1=vzipq_s16(a.val[1], a.val[1]);
+
+      cc[j][0]=b0.val[0];
+      cc[j][1]=b0.val[1];
+      cc[j][2]=b1.val[0];
+      cc[j][3]=b1.val[1];
+    }
+
+    for (int k=0; k<2; k++)
+    {
+      uint8x16x3_t v;
+
+      for (int j=0; j<3; j++)
+      {
+        v.val[j]=vcombine_u8(addClamp(vget_low_u8(y.val[k]), cc[j][2*k]),
+                             addClamp(vget_high_u8(y.val[k]), cc[j][2*k+1]));
+      }
+
+      vst3q_u8(rgb, v);
+      rgb+=48;
+    }
+
+    src+=48;
+    i+=32;
+  }
+
+  getScalarImageKernels().ycbcr411ToRGB(rgb, src, n-i);
+}
+
+void neonYCbCr411ToMono(uint8_t *mono, const uint8_t *src, size_t n)
+{
+  size_t i=0;
+  while (i+32 <= n)
+  {
+    uint8x16x2_t y;
+    uint8x8_t cb, cr;
+
+    loadYCbCr411(y, cb, cr, src);
+
+    vst1q_u8(mono+i, y.val[0]);
+    vst1q_u8(mono+i+16, y.val[1]);
+
+    src+=48;
+    i+=32;
+  }
+
+  getScalarImageKernels().ycbcr411ToMono(mono+i, src, n-i);
+}
+
+void neonYCbCr422ToRGB(uint8_t *rgb, const uint8_t *src, size_t n)
+{
+  size_t i=0;
+  while (i+16 <= n)
+  {
+    // Y0, Cb, Y1 and Cr of 8 pairs of pixels
+
+    uint8x8x4_t v=vld4_u8(src);
+
+    int16x8_t c[3];
+    colorOffsets(c[0], c[1], c[2], v.val[1], v.val[3]);
+
+    uint8x16x3_t out;
+
+    for (int j=0; j<3; j++)
+    {
+      uint8x8x2_t p=vzip_u8(addClamp(v.val[0], c[j]), addClamp(v.val[2], c[j]));
+      out.val[j]=vcombine_u8(p.val[0], p.val[1]);
+    }
+
+    vst3q_u8(rgb, out);
+
+    src+=32;
+    rgb+=48;
+    i+=16;
+  }
+
+  getScalarImageKernels().ycbcr422ToRGB(rgb, src, n-i);
+}
+
+void neonYCbCr422ToMono(uint8_t *mono, const uint8_t *src, size_t n)
+{
+  size_t i=0;
+  while (i+16 <= n)
+  {
+    uint8x16x2_t v=vld2q_u8(src);
+
+    vst1q_u8(mono+i, v.val[0]);
+
+    src+=32;
+    i+=16;
+  }
+
+  getScalarImageKernels().ycbcr422ToMono(mono+i, src, n-i);
+}
+
+void neonBayerToRGB(uint8_t *rgb, uint8_t *mono, const uint8_t *row0, const uint8_t *row1,
+                    const uint8_t *row2, bool red, bool greenfirst, size_t n)
+{
+  const uint8x16_t green=vld1q_u8(greenfirst ? green_even : green_odd);
+
+  size_t i=0;
+  while (i+16 <= n)
+  {
+    // neighbourhood of all pixels
+
+    uint8x16_t left=vld1q_u8(row1+i);
+    uint8x16_t center=vld1q_u8(row1+i+1);
+    uint8x16_t right=vld1q_u8(row1+i+2);
+    uint8x16_t up=vld1q_u8(row0+i+1);
+    uint8x16_t down=vld1q_u8(row2+i+1);
+
+    uint8x16_t hor=vrhaddq_u8(left, right);
+    uint8x16_t ver=vrhaddq_u8(up, down);
+    uint8x16_t cross=avg4(left, right, up, down);
+    uint8x16_t diag=avg4(vld1q_u8(row0+i), vld1q_u8(row0+i+2), vld1q_u8(row2+i),
+                         vld1q_u8(row2+i+2));
+
+    // select values depending on the color of the pixel
+
+    uint8x16x3_t v;
+
+    v.val[1]=vbslq_u8(green, center, cross);
+
+    if (red)
+    {
+      v.val[0]=vbslq_u8(green, hor, center);
+      v.val[2]=vbslq_u8(green, ver, diag);
+    }
+    else
+    {
+      v.val[0]=vbslq_u8(green, ver, diag);
+      v.val[2]=vbslq_u8(green, hor, center);
+    }
+
+    if (rgb)
+    {
+      vst3q_u8(rgb, v);
+      rgb+=48;
+    }
+
+    if (mono)
+    {
+      vst1q_u8(mono, rgbToGrey(v.val[0], v.val[1], v.val[2]));
+      mono+=16;
+    }
+
+    i+=16;
+  }
+
+  getScalarImageKernels().bayerToRGB(rgb, mono, row0+i, row1+i, row2+i, red, greenfirst,
+                                     n-i);
+}
+
+}
+
+const ImageKernels *getNEONImageKernels()
+{
+  static const ImageKernels kernels=
+  {
+    "neon",
+    neonMonoToRGB,
+    neonRGBToMono,
+    neonYCbCr411ToRGB,
+    neonYCbCr411ToMono,
+    neonYCbCr422ToRGB,
+    neonYCbCr422ToMono,
+    neonBayerToRGB
+  };
+
+  return &kernels;
+}
+
+}
+
+#else
+
+namespace rcg
+{
+
+const ImageKernels *getNEONImageKernels()
+{
+  return 0;
+}
+
+}
+
+#endif
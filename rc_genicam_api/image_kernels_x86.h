@@ -0,0 +1,511 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_IMAGE_KERNELS_X86
+#define RC_GENICAM_API_IMAGE_KERNELS_X86
+
+/*
+  Vectorized row conversion functions for x86. The functions are implemented
+  as templates on a class that provides the vector operations, so that the
+  same code can be compiled for SSSE3 with 128 bit registers and for AVX2 with
+  256 bit registers. All operations that are used work independently on 128
+  bit lanes. Each lane processes 16 consecutive pixels, i.e. AVX2 processes two
+  blocks of 16 pixels at once.
+
+  This file must only be included by the source files that are compiled for
+  the corresponding instruction set. Everything is defined in an anonymous
+  namespace to ensure that no code that is compiled for a specific instruction
+  set is shared with other source files by the linker.
+*/
+
+#include "image_kernels.h"
+
+#include <immintrin.h>
+
+namespace rcg
+{
+
+namespace
+{
+
+/*
+  Shuffle masks for converting 16 planar red, green and blue values into 48
+  interleaved bytes. Index [q][c] is for output register q and channel c.
+*/
+
+const int8_t interleave_rgb[3][3][16]=
+{
+  {{0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128, 5},
+   {-128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128},
+   {-128, -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128}},
+  {{-128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10, -128},
+   {5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10},
+   {-128, 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128}},
+  {{-128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128, -128},
+   {-128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128},
+   {10, -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15}}
+};
+
+/*
+  Shuffle masks for converting 48 interleaved bytes into 16 planar red, green
+  and blue values. Index [c][q] is for channel c and input register q.
+*/
+
+const int8_t deinterleave_rgb[3][3][16]=
+{
+  {{0, 3, 6, 9, 12, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128},
+   {-128, -128, -128, -128, -128, -128, 2, 5, 8, 11, 14, -128, -128, -128, -128, -128},
+   {-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 1, 4, 7, 10, 13}},
+  {{1, 4, 7, 10, 13, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128},
+   {-128, -128, -128, -128, -128, 0, 3, 6, 9, 12, 15, -128, -128, -128, -128, -128},
+   {-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 2, 5, 8, 11, 14}},
+  {{2, 5, 8, 11, 14, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128},
+   {-128, -128, -128, -128, -128, 1, 4, 7, 10, 13, -128, -128, -128, -128, -128, -128},
+   {-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 0, 3, 6, 9, 12, 15}}
+};
+
+/*
+  Shuffle masks for replicating 16 monochrome values into 48 bytes.
+*/
+
+const int8_t replicate_mono[3][16]=
+{
+  {0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5},
+  {5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10},
+  {10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15}
+};
+
+/*
+  Shuffle masks for extracting Y, Cb and Cr as 16 bit values from 16 pixels
+  in YCbCr411 format, which are 24 bytes. The first register contains bytes 0
+  to 15 and the second register bytes 8 to 23. Index [0] is for pixel 0 to 7
+  from the first register and index [1] for pixel 8 to 15 from the second
+  register.
+*/
+
+const int8_t ycbcr411_y[2][16]=
+{
+  {0, -128, 1, -128, 3, -128, 4, -128, 6, -128, 7, -128, 9, -128, 10, -128},
+  {4, -128, 5, -128, 7, -128, 8, -128, 10, -128, 11, -128, 13, -128, 14, -128}
+};
+
+const int8_t ycbcr411_cb[2][16]=
+{
+  {2, -128, 2, -128, 2, -128, 2, -128, 8, -128, 8, -128, 8, -128, 8, -128},
+  {6, -128, 6, -128, 6, -128, 6, -128, 12, -128, 12, -128, 12, -128, 12, -128}
+};
+
+const int8_t ycbcr411_cr[2][16]=
+{
+  {5, -128, 5, -128, 5, -128, 5, -128, 11, -128, 11, -128, 11, -128, 11, -128},
+  {9, -128, 9, -128, 9, -128, 9, -128, 15, -128, 15, -128, 15, -128, 15, -128}
+};
+
+/*
+  Masks for selecting green pixels in Bayer rows, starting with green or not.
+*/
+
+const int8_t green_even[16]={-1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0};
+const int8_t green_odd[16]={0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1};
+
+/*
+  Stores 16 planar red, green and blue values per lane as interleaved RGB.
+*/
+
+template<class O> inline void storeRGB(uint8_t *rgb, typename O::V r, typename O::V g,
+                                       typename O::V b)
+{
+  for (int q=0; q<3; q++)
+  {
+    typename O::V v=O::or_(O::or_(O::shuffle(r, O::pattern(interleave_rgb[q][0])),
+                                  O::shuffle(g, O::pattern(interleave_rgb[q][1]))),
+                           O::shuffle(b, O::pattern(interleave_rgb[q][2])));
+
+    O::store(rgb+16*q, 48, v);
+  }
+}
+
+/*
+  Converts RGB to monochrome in the same way as the scalar implementation,
+  i.e. (9798*r+19234*g+3736*b+16384)>>15.
+*/
+
+template<class O> inline typename O::V rgbToGrey(typename O::V r, typename O::V g,
+                                                 typename O::V b)
+{
+  const typename O::V z=O::zero();
+  const typename O::V crg=O::set32((19234<<16)|9798);
+  const typename O::V cb=O::set32((16384<<16)|3736);
+  const typename O::V one=O::set16(1);
+
+  typename O::V v[2];
+
+  for (int k=0; k<2; k++)
+  {
+    typename O::V r16, g16, b16;
+
+    if (k == 0)
+    {
+      r16=O::unpacklo8(r, z);
+      g16=O::unpacklo8(g, z);
+      b16=O::unpacklo8(b, z);
+    }
+    else
+    {
+      r16=O::unpackhi8(r, z);
+      g16=O::unpackhi8(g, z);
+      b16=O::unpackhi8(b, z);
+    }
+
+    typename O::V s0=O::add32(O::madd(O::unpacklo16(r16, g16), crg),
+                              O::madd(O::unpacklo16(b16, one), cb));
+    typename O::V s1=O::add32(O::madd(O::unpackhi16(r16, g16), crg),
+                              O::madd(O::unpackhi16(b16, one), cb));
+
+    v[k]=O::packs32(O::template srli32<15>(s0), O::template srli32<15>(s1));
+  }
+
+  return O::packus16(v[0], v[1]);
+}
+
+/*
+  Converts Y, Cb and Cr as 16 bit values into red, green and blue as 16 bit
+  values, which still have to be clamped. The computation is the same as in
+  the scalar implementation.
+*/
+
+template<class O> inline void ycbcrToRGB16(typename O::V &r, typename O::V &g,
+                                           typename O::V &b, typename O::V y,
+                                           typename O::V cb, typename O::V cr)
+{
+  const typename O::V k=O::set16(16384+32);
+  const typename O::V off=O::set16(256);
+
+  cb=O::sub16(cb, O::set16(128));
+  cr=O::sub16(cr, O::set16(128));
+
+  typename O::V rc=O::add16(O::mul16(cr, O::set16(90)), k);
+  typename O::V gc=O::add16(O::add16(O::mul16(cb, O::set16(-22)), O::mul16(cr, O::set16(-46))),
+                            k);
+  typename O::V bc=O::add16(O::mul16(cb, O::set16(113)), k);
+
+  r=O::add16(y, O::sub16(O::template srai16<6>(rc), off));
+  g=O::add16(y, O::sub16(O::template srai16<6>(gc), off));
+  b=O::add16(y, O::sub16(O::template srai16<6>(bc), off));
+}
+
+/*
+  Computes (a+b+c+d+2)>>2 for each byte.
+*/
+
+template<class O> inline typename O::V avg4(typename O::V a, typename O::V b, typename O::V c,
+                                            typename O::V d)
+{
+  const typename O::V z=O::zero();
+  const typename O::V two=O::set16(2);
+
+  typename O::V lo=O::add16(O::add16(O::unpacklo8(a, z), O::unpacklo8(b, z)),
+                            O::add16(O::unpacklo8(c, z), O::unpacklo8(d, z)));
+  typename O::V hi=O::add16(O::add16(O::unpackhi8(a, z), O::unpackhi8(b, z)),
+                            O::add16(O::unpackhi8(c, z), O::unpackhi8(d, z)));
+
+  lo=O::template srli16<2>(O::add16(lo, two));
+  hi=O::template srli16<2>(O::add16(hi, two));
+
+  return O::packus16(lo, hi);
+}
+
+template<class O> void monoToRGB(uint8_t *rgb, const uint8_t *mono, size_t n)
+{
+  const size_t step=16*O::lanes;
+
+  size_t i=0;
+  while (i+step <= n)
+  {
+    typename O::V v=O::load(mono+i, 16);
+
+    for (int q=0; q<3; q++)
+    {
+      O::store(rgb+16*q, 48, O::shuffle(v, O::pattern(replicate_mono[q])));
+    }
+
+    rgb+=3*step;
+    i+=step;
+  }
+
+  getScalarImageKernels().monoToRGB(rgb, mono+i, n-i);
+}
+
+template<class O> void rgbToMono(uint8_t *mono, const uint8_t *rgb, size_t n)
+{
+  const size_t step=16*O::lanes;
+
+  size_t i=0;
+  while (i+step <= n)
+  {
+    typename O::V in[3];
+    typename O::V c[3];
+
+    for (int q=0; q<3; q++)
+    {
+      in[q]=O::load(rgb+16*q, 48);
+    }
+
+    for (int k=0; k<3; k++)
+    {
+      c[k]=O::or_(O::or_(O::shuffle(in[0], O::pattern(deinterleave_rgb[k][0])),
+                         O::shuffle(in[1], O::pattern(deinterleave_rgb[k][1]))),
+                  O::shuffle(in[2], O::pattern(deinterleave_rgb[k][2])));
+    }
+
+    O::store(mono+i, 16, rgbToGrey<O>(c[0], c[1], c[2]));
+
+    rgb+=3*step;
+    i+=step;
+  }
+
+  getScalarImageKernels().rgbToMono(mono+i, rgb, n-i);
+}
+
+template<class O> inline void loadYCbCr411(typename O::V y[2], typename O::V cb[2],
+                                           typename O::V cr[2], const uint8_t *src)
+{
+  typename O::V in[2];
+
+  in[0]=O::load(src, 24);
+  in[1]=O::load(src+8, 24);
+
+  for (int k=0; k<2; k++)
+  {
+    y[k]=O::shuffle(in[k], O::pattern(ycbcr411_y[k]));
+    cb[k]=O::shuffle(in[k], O::pattern(ycbcr411_cb[k]));
+    cr[k]=O::shuffle(in[k], O::pattern(ycbcr411_cr[k]));
+  }
+}
+
+template<class O> inline void loadYCbCr422(typename O::V y[2], typename O::V cb[2],
+                                           typename O::V cr[2], const uint8_t *src)
+{
+  const typename O::V mask=O::set16(0xff);
+
+  for (int k=0; k<2; k++)
+  {
+    typename O::V in=O::load(src+16*k, 32);
+    typename O::V c=O::template srli16<8>(in);
+
+    y[k]=O::and_(in, mask);
+    cb[k]=O::template shuffle16<_MM_SHUFFLE(2, 2, 0, 0)>(c);
+    cr[k]=O::template shuffle16<_MM_SHUFFLE(3, 3, 1, 1)>(c);
+  }
+}
+
+template<class O> inline void storeYCbCrRGB(uint8_t *rgb, const typename O::V y[2],
+                                            const typename O::V cb[2], const typename O::V cr[2])
+{
+  typename O::V r[2], g[2], b[2];
+
+  for (int k=0; k<2; k++)
+  {
+    ycbcrToRGB16<O>(r[k], g[k], b[k], y[k], cb[k], cr[k]);
+  }
+
+  storeRGB<O>(rgb, O::packus16(r[0], r[1]), O::packus16(g[0], g[1]),
+              O::packus16(b[0], b[1]));
+}
+
+template<class O> void ycbcr411ToRGB(uint8_t *rgb, const uint8_t *src, size_t n)
+{
+  const size_t step=16*O::lanes;
+
+  size_t i=0;
+  while (i+step <= n)
+  {
+    typename O::V y[2], cb[2], cr[2];
+
+    loadYCbCr411<O>(y, cb, cr, src);
+    storeYCbCrRGB<O>(rgb, y, cb, cr);
+
+    src+=step*6/4;
+    rgb+=3*step;
+    i+=step;
+  }
+
+  getScalarImageKernels().ycbcr411ToRGB(rgb, src, n-i);
+}
+
+template<class O> void ycbcr411ToMono(uint8_t *mono, const uint8_t *src, size_t n)
+{
+  const size_t step=16*O::lanes;
+
+  size_t i=0;
+  while (i+step <= n)
+  {
+    typename O::V y[2], cb[2], cr[2];
+
+    loadYCbCr411<O>(y, cb, cr, src);
+    O::store(mono+i, 16, O::packus16(y[0], y[1]));
+
+    src+=step*6/4;
+    i+=step;
+  }
+
+  getScalarImageKernels().ycbcr411ToMono(mono+i, src, n-i);
+}
+
+template<class O> void ycbcr422ToRGB(uint8_t *rgb, const uint8_t *src, size_t n)
+{
+  const size_t step=16*O::lanes;
+
+  size_t i=0;
+  while (i+step <= n)
+  {
+    typename O::V y[2], cb[2], cr[2];
+
+    loadYCbCr422<O>(y, cb, cr, src);
+    storeYCbCrRGB<O>(rgb, y, cb, cr);
+
+    src+=2*step;
+    rgb+=3*step;
+    i+=step;
+  }
+
+  getScalarImageKernels().ycbcr422ToRGB(rgb, src, n-i);
+}
+
+template<class O> void ycbcr422ToMono(uint8_t *mono, const uint8_t *src, size_t n)
+{
+  const typename O::V mask=O::set16(0xff);
+  const size_t step=16*O::lanes;
+
+  size_t i=0;
+  while (i+step <= n)
+  {
+    typename O::V y0=O::and_(O::load(src, 32), mask);
+    typename O::V y1=O::and_(O::load(src+16, 32), mask);
+
+    O::store(mono+i, 16, O::packus16(y0, y1));
+
+    src+=2*step;
+    i+=step;
+  }
+
+  getScalarImageKernels().ycbcr422ToMono(mono+i, src, n-i);
+}
+
+template<class O> void bayerToRGB(uint8_t *rgb, uint8_t *mono, const uint8_t *row0,
+                                  const uint8_t *row1, const uint8_t *row2, bool red,
+                                  bool greenfirst, size_t n)
+{
+  const typename O::V green=O::pattern(greenfirst ? green_even : green_odd);
+  const size_t step=16*O::lanes;
+
+  size_t i=0;
+  while (i+step <= n)
+  {
+    // neighbourhood of all pixels
+
+    typename O::V left=O::load(row1+i, 16);
+    typename O::V center=O::load(row1+i+1, 16);
+    typename O::V right=O::load(row1+i+2, 16);
+    typename O::V up=O::load(row0+i+1, 16);
+    typename O::V down=O::load(row2+i+1, 16);
+
+    typename O::V hor=O::avg8(left, right);
+    typename O::V ver=O::avg8(up, down);
+    typename O::V cross=avg4<O>(left, right, up, down);
+    typename O::V diag=avg4<O>(O::load(row0+i, 16), O::load(row0+i+2, 16),
+                               O::load(row2+i, 16), O::load(row2+i+2, 16));
+
+    // select values depending on the color of the pixel
+
+    typename O::V r, g, b;
+
+    g=O::blend(green, center, cross);
+
+    if (red)
+    {
+      r=O::blend(green, hor, center);
+      b=O::blend(green, ver, diag);
+    }
+    else
+    {
+      r=O::blend(green, ver, diag);
+      b=O::blend(green, hor, center);
+    }
+
+    if (rgb)
+    {
+      storeRGB<O>(rgb, r, g, b);
+      rgb+=3*step;
+    }
+
+    if (mono)
+    {
+      O::store(mono, 16, rgbToGrey<O>(r, g, b));
+      mono+=step;
+    }
+
+    i+=step;
+  }
+
+  getScalarImageKernels().bayerToRGB(rgb, mono, row0+i, row1+i, row2+i, red, greenfirst,
+                                     n-i);
+}
+
+/*
+  Creates the table of functions for the given vector operations.
+*/
+
+template<class O> ImageKernels createImageKernels(const char *name)
+{
+  ImageKernels ret;
+
+  ret.name=name;
+  ret.monoToRGB=monoToRGB<O>;
+  ret.rgbToMono=rgbToMono<O>;
+  ret.ycbcr411ToRGB=ycbcr411ToRGB<O>;
+  ret.ycbcr411ToMono=ycbcr411ToMono<O>;
+  ret.ycbcr422ToRGB=ycbcr422ToRGB<O>;
+  ret.ycbcr422ToMono=ycbcr422ToMono<O>;
+  ret.bayerToRGB=bayerToRGB<O>;
+
+  return ret;
+}
+
+}
+
+}
+
+#endif
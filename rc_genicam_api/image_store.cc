@@ -35,8 +35,13 @@
 
 #include "image_store.h"
 #include "pixel_formats.h"
+#include "thread_pool.h"
 
 #include <exception>
+#include <stdexcept>
+#include <vector>
+#include <memory>
+#include <cstdlib>
 
 #include <iostream>
 #include <fstream>
@@ -47,6 +52,7 @@
 
 #ifdef INCLUDE_PNG
 #include <png.h>
+#include <zlib.h>
 #endif
 
 #ifdef _WIN32
@@ -116,8 +122,19 @@ class IOException : public std::exception
     std::string msg;
 };
 
+/*
+  Returns the number of bytes that have been written into the stream or 0 in
+  case of an error.
+*/
+
+inline uint64_t getWrittenBytes(std::ofstream &out)
+{
+  std::streamoff n=out.tellp();
+  return n > 0 ? static_cast<uint64_t>(n) : 0;
+}
+
 std::string storeImagePNM(const std::string &name, const Image &image, size_t yoffset,
-  size_t height)
+  size_t height, uint64_t &bytes)
 {
   size_t width=image.getWidth();
   size_t real_height=image.getHeight();
@@ -160,6 +177,7 @@ std::string storeImagePNM(const std::string &name, const Image &image, size_t yo
           p+=px;
         }
 
+        bytes=getWrittenBytes(out);
         out.close();
       }
       break;
@@ -207,6 +225,7 @@ std::string storeImagePNM(const std::string &name, const Image &image, size_t yo
           }
         }
 
+        bytes=getWrittenBytes(out);
         out.close();
       }
       break;
@@ -259,6 +278,7 @@ std::string storeImagePNM(const std::string &name, const Image &image, size_t yo
           p+=pstep;
         }
 
+        bytes=getWrittenBytes(out);
         out.close();
       }
       break;
@@ -299,6 +319,7 @@ std::string storeImagePNM(const std::string &name, const Image &image, size_t yo
             }
           }
 
+          bytes=getWrittenBytes(out);
           out.close();
         }
         else
@@ -315,248 +336,521 @@ std::string storeImagePNM(const std::string &name, const Image &image, size_t yo
 
 #ifdef INCLUDE_PNG
 
-std::string storeImagePNG(const std::string &name, const Image &image, size_t yoffset,
-  size_t height)
+/*
+  Collects pointers to all rows of the image in the byte order of PNG.
+  Pixels are converted into the given buffer if necessary. False is returned
+  if the pixel format is not supported.
+*/
+
+bool getPNGRows(std::vector<const uint8_t *> &row, std::unique_ptr<uint8_t []> &buffer,
+  int &depth, int &color, size_t &rowbytes, const Image &image, size_t yoffset, size_t height,
+  size_t nthreads)
 {
   size_t width=image.getWidth();
-  size_t real_height=image.getHeight();
-
-  if (height == 0) height=real_height;
-
-  yoffset=std::min(yoffset, real_height);
-  height=std::min(height, real_height-yoffset);
-
-  const unsigned char *p=static_cast<const unsigned char *>(image.getPixels());
-
+  const uint8_t *p=image.getPixels();
   size_t px=image.getXPadding();
-
   uint64_t format=image.getPixelFormat();
-  std::string full_name;
+
+  row.resize(height);
 
   switch (format)
   {
-    case Mono8: // store 8 bit monochrome image
+    case Mono8: // 8 bit monochrome image
     case Confidence8:
     case Error8:
       {
-        // open file and init
-
-        full_name=ensureNewFileName(name+".png");
-        FILE *out=fopen(full_name.c_str(), "wb");
+        depth=8;
+        color=PNG_COLOR_TYPE_GRAY;
+        rowbytes=width;
 
-        if (!out)
+        p+=(width+px)*yoffset;
+        for (size_t k=0; k<height; k++)
         {
-          throw new IOException("Cannot store file: "+full_name);
+          row[k]=p;
+          p+=width+px;
         }
+      }
+      break;
 
-        png_structp png=png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
-        png_infop info=png_create_info_struct(png);
-        setjmp(png_jmpbuf(png));
-
-        // write header
-
-        png_init_io(png, out);
-        png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_GRAY,
-          PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-          PNG_FILTER_TYPE_DEFAULT);
-        png_write_info(png, info);
+    case Mono16:
+    case Coord3D_C16: // 16 bit monochrome image, which is big endian in PNG
+      {
+        depth=16;
+        color=PNG_COLOR_TYPE_GRAY;
+        rowbytes=2*width;
 
-        // write image body
+        p+=(2*width+px)*yoffset;
 
-        p+=(width+px)*yoffset;
-        for (size_t k=0; k<height; k++)
+        if (image.isBigEndian())
         {
-          png_write_row(png, const_cast<png_bytep>(p));
-          p+=width+px;
+          for (size_t k=0; k<height; k++)
+          {
+            row[k]=p;
+            p+=2*width+px;
+          }
         }
+        else
+        {
+          buffer.reset(new uint8_t [rowbytes*height]);
+
+          uint8_t *t=buffer.get();
+          for (size_t k=0; k<height; k++)
+          {
+            row[k]=t;
 
-        // close file
+            for (size_t i=0; i<width; i++)
+            {
+              *t++=p[1];
+              *t++=p[0];
+              p+=2;
+            }
 
-        png_write_end(png, info);
-        fclose(out);
-        png_destroy_write_struct(&png, &info);
+            p+=px;
+          }
+        }
       }
       break;
 
-    case Mono16:
-    case Coord3D_C16: // store 16 bit monochrome image
+    case RGB8: // 8 bit color image
       {
-        // open file and init
+        depth=8;
+        color=PNG_COLOR_TYPE_RGB;
+        rowbytes=3*width;
 
-        full_name=ensureNewFileName(name+".png");
-        FILE *out=fopen(full_name.c_str(), "wb");
-
-        if (!out)
+        p+=(3*width+px)*yoffset;
+        for (size_t k=0; k<height; k++)
         {
-          throw new IOException("Cannot store file: "+full_name);
+          row[k]=p;
+          p+=3*width+px;
         }
+      }
+      break;
 
-        png_structp png=png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
-        png_infop info=png_create_info_struct(png);
-        setjmp(png_jmpbuf(png));
-
-        // write header
+    default: // try to convert into color image
+      {
+        depth=8;
+        color=PNG_COLOR_TYPE_RGB;
+        rowbytes=3*width;
 
-        png_init_io(png, out);
-        png_set_IHDR(png, info, width, height, 16, PNG_COLOR_TYPE_GRAY,
-          PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-          PNG_FILTER_TYPE_DEFAULT);
-        png_write_info(png, info);
+        if (format == YCbCr411_8)
+        {
+          p+=((width>>2)*6+px)*yoffset;
+        }
+        else if (format == YCbCr422_8 || format == YUV422_8)
+        {
+          p+=((width>>2)*8+px)*yoffset;
+        }
+        else
+        {
+          p+=(width+px)*yoffset;
+        }
 
-        // write image body
+        buffer.reset(new uint8_t [rowbytes*height]);
 
-        if (!image.isBigEndian())
+        if (!convertImage(buffer.get(), 0, p, format, width, height, px, nthreads))
         {
-          png_set_swap(png);
+          return false;
         }
 
-        p+=(2*width+px)*yoffset;
         for (size_t k=0; k<height; k++)
         {
-          png_write_row(png, const_cast<png_bytep>(p));
-          p+=2*width+px;
+          row[k]=buffer.get()+k*rowbytes;
         }
+      }
+      break;
+  }
+
+  return true;
+}
+
+/*
+  Applies the PNG filter to one row. The first byte of the target is the
+  filter type. The prior row is 0 for the first row of the image.
+*/
+
+inline uint8_t paeth(int a, int b, int c)
+{
+  int p=a+b-c;
+  int pa=std::abs(p-a);
+  int pb=std::abs(p-b);
+  int pc=std::abs(p-c);
+
+  if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+  if (pb <= pc) return static_cast<uint8_t>(b);
+  return static_cast<uint8_t>(c);
+}
+
+void filterRow(uint8_t *out, PngFilter filter, const uint8_t *row, const uint8_t *prior,
+  size_t rowbytes, size_t bpp)
+{
+  *out++=static_cast<uint8_t>(filter-PNGF_NONE);
 
-        // close file
+  switch (filter)
+  {
+    default:
+    case PNGF_NONE:
+      std::copy(row, row+rowbytes, out);
+      break;
 
-        png_write_end(png, info);
-        fclose(out);
-        png_destroy_write_struct(&png, &info);
+    case PNGF_SUB:
+      for (size_t i=0; i<rowbytes; i++)
+      {
+        out[i]=static_cast<uint8_t>(row[i]-(i >= bpp ? row[i-bpp] : 0));
       }
       break;
 
-    case YCbCr411_8: // convert and store as color image
-    case YCbCr422_8:
-    case YUV422_8:
+    case PNGF_UP:
+      for (size_t i=0; i<rowbytes; i++)
       {
-        // open file and init
+        out[i]=static_cast<uint8_t>(row[i]-(prior != 0 ? prior[i] : 0));
+      }
+      break;
 
-        full_name=ensureNewFileName(name+".png");
-        FILE *out=fopen(full_name.c_str(), "wb");
+    case PNGF_AVG:
+      for (size_t i=0; i<rowbytes; i++)
+      {
+        int a=(i >= bpp ? row[i-bpp] : 0);
+        int b=(prior != 0 ? prior[i] : 0);
+        out[i]=static_cast<uint8_t>(row[i]-((a+b)>>1));
+      }
+      break;
 
-        if (!out)
-        {
-          throw new IOException("Cannot store file: "+full_name);
-        }
+    case PNGF_PAETH:
+      for (size_t i=0; i<rowbytes; i++)
+      {
+        int a=(i >= bpp ? row[i-bpp] : 0);
+        int b=(prior != 0 ? prior[i] : 0);
+        int c=(i >= bpp && prior != 0 ? prior[i-bpp] : 0);
+        out[i]=static_cast<uint8_t>(row[i]-paeth(a, b, c));
+      }
+      break;
+  }
+}
 
-        png_structp png=png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
-        png_infop info=png_create_info_struct(png);
-        setjmp(png_jmpbuf(png));
+/*
+  Chooses the filter with the minimum sum of absolute values, like libpng.
+*/
 
-        // write header
+void filterRowAdaptive(uint8_t *out, uint8_t *tmp, const uint8_t *row, const uint8_t *prior,
+  size_t rowbytes, size_t bpp)
+{
+  uint64_t best=std::numeric_limits<uint64_t>::max();
 
-        png_init_io(png, out);
-        png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGB,
-          PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-          PNG_FILTER_TYPE_DEFAULT);
-        png_write_info(png, info);
+  for (int f=PNGF_NONE; f<=PNGF_PAETH; f++)
+  {
+    filterRow(tmp, static_cast<PngFilter>(f), row, prior, rowbytes, bpp);
 
-        // write image body
+    uint64_t sum=0;
+    for (size_t i=1; i<=rowbytes; i++)
+    {
+      sum+=static_cast<uint64_t>(std::abs(static_cast<int>(static_cast<int8_t>(tmp[i]))));
+    }
 
-        uint8_t *tmp=new uint8_t [3*width];
+    if (sum < best)
+    {
+      best=sum;
+      std::copy(tmp, tmp+rowbytes+1, out);
+    }
+  }
+}
 
-        size_t pstep;
-        if (format == YCbCr411_8)
-        {
-          pstep=(width>>2)*6+px;
-        }
-        else
-        {
-          pstep=(width>>2)*8+px;
-        }
+void writeBE32(uint8_t *p, uint32_t v)
+{
+  p[0]=static_cast<uint8_t>(v>>24);
+  p[1]=static_cast<uint8_t>(v>>16);
+  p[2]=static_cast<uint8_t>(v>>8);
+  p[3]=static_cast<uint8_t>(v);
+}
 
-        p+=pstep*yoffset;
-        for (size_t k=0; k<height; k++)
-        {
-          if (format == YCbCr411_8)
-          {
-            for (size_t i=0; i<width; i+=4)
-            {
-              convYCbCr411toQuadRGB(tmp+3*i, p, static_cast<int>(i));
-            }
-          }
-          else
-          {
-            for (size_t i=0; i<width; i+=4)
-            {
-              convYCbCr422toQuadRGB(tmp+3*i, p, static_cast<int>(i));
-            }
-          }
+void writePNGChunk(FILE *out, const char *type, const uint8_t *data, size_t size)
+{
+  uint8_t v[4];
 
-          png_write_row(png, tmp);
-          p+=pstep;
-        }
+  writeBE32(v, static_cast<uint32_t>(size));
+  fwrite(v, 1, 4, out);
 
-        // close file
+  uLong crc=crc32(0, reinterpret_cast<const Bytef *>(type), 4);
+  if (size > 0)
+  {
+    crc=crc32(crc, data, static_cast<uInt>(size));
+  }
 
-        png_write_end(png, info);
-        fclose(out);
-        png_destroy_write_struct(&png, &info);
-      }
+  fwrite(type, 1, 4, out);
+
+  if (size > 0)
+  {
+    fwrite(data, 1, size, out);
+  }
+
+  writeBE32(v, static_cast<uint32_t>(crc));
+  fwrite(v, 1, 4, out);
+}
+
+/*
+  Writes the PNG file with libpng.
+*/
+
+void writePNGSequential(FILE *out, const std::vector<const uint8_t *> &row, size_t width,
+  int depth, int color, const PngOptions &opt)
+{
+  png_structp png=png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+  png_infop info=png_create_info_struct(png);
+
+  if (setjmp(png_jmpbuf(png)))
+  {
+    png_destroy_write_struct(&png, &info);
+    throw IOException("storeImage(): Writing of PNG image failed");
+  }
+
+  // write header
+
+  png_init_io(png, out);
+  png_set_IHDR(png, info, static_cast<png_uint_32>(width), static_cast<png_uint_32>(row.size()),
+    depth, color, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+
+  if (opt.level >= 0)
+  {
+    png_set_compression_level(png, std::min(opt.level, 9));
+  }
+
+  switch (opt.filter)
+  {
+    default:
+    case PNGF_ADAPTIVE:
       break;
 
-    default: // try to store as color image
-      {
-        std::unique_ptr<uint8_t []> rgb_pixel(new uint8_t [3*width*height]);
+    case PNGF_NONE:
+      png_set_filter(png, 0, PNG_FILTER_NONE);
+      break;
 
-        if (format == RGB8)
-        {
-          p+=(3*width+px)*yoffset;
-        }
-        else
-        {
-          p+=(width+px)*yoffset;
-        }
+    case PNGF_SUB:
+      png_set_filter(png, 0, PNG_FILTER_SUB);
+      break;
 
-        if (convertImage(rgb_pixel.get(), 0, p, format, width, height, px))
-        {
-          p=rgb_pixel.get();
+    case PNGF_UP:
+      png_set_filter(png, 0, PNG_FILTER_UP);
+      break;
 
-          // open file and init
+    case PNGF_AVG:
+      png_set_filter(png, 0, PNG_FILTER_AVG);
+      break;
 
-          full_name=ensureNewFileName(name+".png");
-          FILE *out=fopen(full_name.c_str(), "wb");
+    case PNGF_PAETH:
+      png_set_filter(png, 0, PNG_FILTER_PAETH);
+      break;
+  }
 
-          if (!out)
-          {
-            throw new IOException("Cannot store file: "+full_name);
-          }
+  png_write_info(png, info);
 
-          png_structp png=png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
-          png_infop info=png_create_info_struct(png);
-          setjmp(png_jmpbuf(png));
+  // write image body
 
-          // write header
+  png_write_rows(png, const_cast<png_bytepp>(row.data()), static_cast<png_uint_32>(row.size()));
 
-          png_init_io(png, out);
-          png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGB,
-            PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-            PNG_FILTER_TYPE_DEFAULT);
-          png_write_info(png, info);
+  // close file
 
-          // write image body
+  png_write_end(png, info);
+  png_destroy_write_struct(&png, &info);
+}
 
-          for (size_t k=0; k<height; k++)
-          {
-            png_write_row(png, const_cast<png_bytep>(p));
-            p+=3*width;
-          }
+/*
+  Writes the PNG file by filtering and compressing bands of rows in parallel.
+  All bands, except the last one, are terminated by a sync flush, so that
+  the raw deflate streams can be concatenated. The checksum of the zlib stream
+  is combined from the checksums of all bands.
+*/
+
+void writePNGParallel(FILE *out, const std::vector<const uint8_t *> &row, size_t width,
+  int depth, int color, size_t rowbytes, const PngOptions &opt, size_t nthreads)
+{
+  const size_t height=row.size();
+  const size_t bpp=(depth/8)*(color == PNG_COLOR_TYPE_RGB ? 3 : 1);
+  const int level=(opt.level >= 0 ? std::min(opt.level, 9) : Z_DEFAULT_COMPRESSION);
 
-          // close file
+  // split into bands of at least 16 rows
 
-          png_write_end(png, info);
-          fclose(out);
-          png_destroy_write_struct(&png, &info);
-        }
-        else
-        {
-          throw IOException(std::string("storeImage(): Unsupported pixel format: ")+
-            GetPixelFormatName(static_cast<PfncFormat>(image.getPixelFormat())));
-        }
+  size_t nbands=std::max(static_cast<size_t>(1), std::min(nthreads, height/16));
+  size_t rows_per_band=(height+nbands-1)/nbands;
+  nbands=(height+rows_per_band-1)/rows_per_band;
+
+  std::vector<std::vector<uint8_t> > band(nbands);
+  std::vector<uLong> adler(nbands);
+  std::vector<size_t> raw_size(nbands);
+
+  ThreadPool::getInstance().parallelFor(nbands, nthreads, [&](size_t b)
+  {
+    size_t k0=b*rows_per_band;
+    size_t k1=std::min(height, k0+rows_per_band);
+
+    // filter rows
+
+    std::vector<uint8_t> raw((rowbytes+1)*(k1-k0));
+    std::vector<uint8_t> tmp(rowbytes+1);
+
+    for (size_t k=k0; k<k1; k++)
+    {
+      uint8_t *t=raw.data()+(rowbytes+1)*(k-k0);
+      const uint8_t *prior=(k > 0 ? row[k-1] : 0);
+
+      if (opt.filter == PNGF_ADAPTIVE)
+      {
+        filterRowAdaptive(t, tmp.data(), row[k], prior, rowbytes, bpp);
       }
-      break;
+      else
+      {
+        filterRow(t, opt.filter, row[k], prior, rowbytes, bpp);
+      }
+    }
+
+    adler[b]=adler32(adler32(0, 0, 0), raw.data(), static_cast<uInt>(raw.size()));
+    raw_size[b]=raw.size();
+
+    // compress as raw deflate stream
+
+    z_stream zs;
+    zs.zalloc=Z_NULL;
+    zs.zfree=Z_NULL;
+    zs.opaque=Z_NULL;
+
+    if (deflateInit2(&zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      throw IOException("storeImage(): Cannot initialize compression");
+    }
+
+    std::vector<uint8_t> &data=band[b];
+    data.resize(deflateBound(&zs, static_cast<uLong>(raw.size()))+16);
+
+    zs.next_in=raw.data();
+    zs.avail_in=static_cast<uInt>(raw.size());
+    zs.next_out=data.data();
+    zs.avail_out=static_cast<uInt>(data.size());
+
+    int flush=(b+1 < nbands ? Z_SYNC_FLUSH : Z_FINISH);
+    int ret=deflate(&zs, flush);
+
+    while ((flush == Z_FINISH && ret == Z_OK) || (flush == Z_SYNC_FLUSH && zs.avail_out == 0))
+    {
+      size_t n=data.size();
+      data.resize(2*n);
+      zs.next_out=data.data()+n;
+      zs.avail_out=static_cast<uInt>(n);
+      ret=deflate(&zs, flush);
+    }
+
+    data.resize(data.size()-zs.avail_out);
+    deflateEnd(&zs);
+
+    if (ret != Z_OK && ret != Z_STREAM_END)
+    {
+      throw IOException("storeImage(): Compression failed");
+    }
+  });
+
+  // write signature and header
+
+  static const uint8_t signature[8]={ 137, 80, 78, 71, 13, 10, 26, 10 };
+  fwrite(signature, 1, 8, out);
+
+  uint8_t ihdr[13];
+  writeBE32(ihdr, static_cast<uint32_t>(width));
+  writeBE32(ihdr+4, static_cast<uint32_t>(height));
+  ihdr[8]=static_cast<uint8_t>(depth);
+  ihdr[9]=static_cast<uint8_t>(color);
+  ihdr[10]=0;
+  ihdr[11]=0;
+  ihdr[12]=0;
+
+  writePNGChunk(out, "IHDR", ihdr, sizeof(ihdr));
+
+  // write zlib header, followed by all bands and the combined checksum
+
+  uint8_t zhdr[2]={ 0x78, 0x9c };
+  if (level >= 0 && level <= 1) zhdr[1]=0x01;
+  else if (level >= 2 && level <= 5) zhdr[1]=0x5e;
+  else if (level >= 7) zhdr[1]=0xda;
+
+  writePNGChunk(out, "IDAT", zhdr, 2);
+
+  uLong sum=adler[0];
+  for (size_t b=0; b<nbands; b++)
+  {
+    writePNGChunk(out, "IDAT", band[b].data(), band[b].size());
+
+    if (b > 0)
+    {
+      sum=adler32_combine(sum, adler[b], static_cast<z_off_t>(raw_size[b]));
+    }
   }
 
+  uint8_t zsum[4];
+  writeBE32(zsum, static_cast<uint32_t>(sum));
+  writePNGChunk(out, "IDAT", zsum, 4);
+
+  writePNGChunk(out, "IEND", 0, 0);
+}
+
+std::string storeImagePNG(const std::string &name, const Image &image, size_t yoffset,
+  size_t height, const PngOptions &opt, uint64_t &bytes)
+{
+  size_t width=image.getWidth();
+  size_t real_height=image.getHeight();
+
+  if (height == 0) height=real_height;
+
+  yoffset=std::min(yoffset, real_height);
+  height=std::min(height, real_height-yoffset);
+
+  size_t nthreads=ThreadPool::getNumThreads(opt.nthreads);
+
+  // get rows in PNG byte order
+
+  std::vector<const uint8_t *> row;
+  std::unique_ptr<uint8_t []> buffer;
+  int depth=8, color=PNG_COLOR_TYPE_GRAY;
+  size_t rowbytes=0;
+
+  if (!getPNGRows(row, buffer, depth, color, rowbytes, image, yoffset, height, nthreads))
+  {
+    throw IOException(std::string("storeImage(): Unsupported pixel format: ")+
+      GetPixelFormatName(static_cast<PfncFormat>(image.getPixelFormat())));
+  }
+
+  // open file and write
+
+  std::string full_name=ensureNewFileName(name+".png");
+  FILE *out=fopen(full_name.c_str(), "wb");
+
+  if (!out)
+  {
+    throw IOException("Cannot store file: "+full_name);
+  }
+
+  try
+  {
+    if (nthreads > 1 && height >= 32)
+    {
+      writePNGParallel(out, row, width, depth, color, rowbytes, opt, nthreads);
+    }
+    else
+    {
+      writePNGSequential(out, row, width, depth, color, opt);
+    }
+  }
+  catch (...)
+  {
+    fclose(out);
+    throw;
+  }
+
+  if (ferror(out))
+  {
+    fclose(out);
+    throw IOException("Cannot store file: "+full_name);
+  }
+
+  long n=ftell(out);
+  bytes=n > 0 ? static_cast<uint64_t>(n) : 0;
+  fclose(out);
+
   return full_name;
 }
 
@@ -564,16 +858,51 @@ std::string storeImagePNG(const std::string &name, const Image &image, size_t yo
 
 }
 
+PngOptions getPngPreset(const std::string &preset, size_t nthreads)
+{
+  PngOptions ret;
+
+  if (preset == "best")
+  {
+    ret.level=9;
+  }
+  else if (preset == "fast")
+  {
+    ret.level=1;
+    ret.filter=PNGF_UP;
+  }
+  else if (preset == "none")
+  {
+    ret.level=0;
+    ret.filter=PNGF_NONE;
+  }
+  else if (preset != "default")
+  {
+    throw std::invalid_argument("Unknown PNG preset: "+preset);
+  }
+
+  ret.nthreads=nthreads;
+
+  return ret;
+}
+
 std::string storeImage(const std::string &name, ImgFmt fmt, const Image &image,
   size_t yoffset, size_t height)
+{
+  return storeImage(name, fmt, image, yoffset, height, PngOptions());
+}
+
+std::string storeImage(const std::string &name, ImgFmt fmt, const Image &image,
+  size_t yoffset, size_t height, const PngOptions &png, uint64_t *bytes)
 {
   std::string ret;
+  uint64_t size=0;
 
   switch (fmt)
   {
     case PNG:
 #ifdef INCLUDE_PNG
-      ret=storeImagePNG(name, image, yoffset, height);
+      ret=storeImagePNG(name, image, yoffset, height, png, size);
 #else
       throw IOException("storeImage(): Support for PNG image file format is not compiled in!");
 #endif
@@ -581,15 +910,20 @@ std::string storeImage(const std::string &name, ImgFmt fmt, const Image &image,
 
     default:
     case PNM:
-      ret=storeImagePNM(name, image, yoffset, height);
+      ret=storeImagePNM(name, image, yoffset, height, size);
       break;
   }
 
+  if (bytes != 0)
+  {
+    *bytes=size;
+  }
+
   return ret;
 }
 
 std::string storeImageAsDisparityPFM(const std::string &name, const Image &image, int inv,
-  float scale, float offset)
+  float scale, float offset, uint64_t *bytes)
 {
   if (image.getPixelFormat() != Coord3D_C16)
   {
@@ -673,6 +1007,11 @@ std::string storeImageAsDisparityPFM(const std::string &name, const Image &image
     }
   }
 
+  if (bytes != 0)
+  {
+    *bytes=getWrittenBytes(out);
+  }
+
   out.close();
 
   return full_name;
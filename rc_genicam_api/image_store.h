@@ -45,6 +45,44 @@ namespace rcg
 
 enum ImgFmt { PNM, PNG };
 
+/**
+  Filter that is applied to the rows of a PNG image before compression.
+  PNGF_ADAPTIVE chooses the best filter for each row, which gives the smallest
+  files, but is slowest.
+*/
+
+enum PngFilter { PNGF_ADAPTIVE, PNGF_NONE, PNGF_SUB, PNGF_UP, PNGF_AVG, PNGF_PAETH };
+
+/**
+  Options for storing images in PNG format.
+*/
+
+struct PngOptions
+{
+  int level;        // compression level from 0 (no compression) to 9 (best
+                    // compression), -1 is the default of zlib
+  PngFilter filter; // row filter
+  size_t nthreads;  // number of threads for compressing bands of rows in
+                    // parallel, 1 means sequential, 0 the number of cores
+
+  PngOptions() : level(-1), filter(PNGF_ADAPTIVE), nthreads(1) { }
+};
+
+/**
+  Returns options for one of the presets 'default', 'best', 'fast' and
+  'none'. The 'fast' preset is intended for recording at frame rate and uses
+  the fastest compression level with the up filter. The 'none' preset writes
+  uncompressed PNG files.
+
+  NOTE: std::invalid_argument is thrown if the preset is unknown.
+
+  @param preset   Name of preset.
+  @param nthreads Number of threads for compression.
+  @return         PNG options.
+*/
+
+PngOptions getPngPreset(const std::string &preset, size_t nthreads=1);
+
 /**
   This method checks if the given file name already exists and produces a new
   file name if this happens.
@@ -68,6 +106,28 @@ std::string ensureNewFileName(std::string name);
 std::string storeImage(const std::string &name, ImgFmt fmt, const Image &image,
   size_t yoffset=0, size_t height=0);
 
+/**
+  Stores the given image like the function above, but with the given options
+  for the PNG format, which are ignored for other formats.
+
+  If more than one thread is requested, then the image is split into bands of
+  rows that are filtered and compressed in parallel and stitched into one
+  valid PNG stream. Files are slightly larger, since the compression of each
+  band starts without a dictionary.
+
+  @param name    Name of output file without suffix.
+  @param fmt     Image file format.
+  @param image   Image to be stored.
+  @param yoffset First image row to be stored.
+  @param height  Number of image rows to be stored. 0 means all rows.
+  @param png     Options for PNG format.
+  @param bytes   Optional pointer that receives the number of bytes that
+                 have been written into the file.
+*/
+
+std::string storeImage(const std::string &name, ImgFmt fmt, const Image &image,
+  size_t yoffset, size_t height, const PngOptions &png, uint64_t *bytes=0);
+
 /**
   Stores the given image as disparity. The image format must be Coord3D_C16.
 
@@ -79,10 +139,12 @@ std::string storeImage(const std::string &name, ImgFmt fmt, const Image &image,
   @param inv    Value to mark invalid pixels.
   @param scale  Scale factor for valid values.
   @param offset Offset for valid values.
+  @param bytes  Optional pointer that receives the number of bytes that have
+                been written into the file.
 */
 
 std::string storeImageAsDisparityPFM(const std::string &name, const Image &image,
-  int inv, float scale, float offset);
+  int inv, float scale, float offset, uint64_t *bytes=0);
 
 }
 
@@ -48,52 +48,75 @@ namespace rcg
 ImageList::ImageList(size_t _maxsize)
 {
   maxsize=std::max(static_cast<size_t>(1), _maxsize);
+  head=0;
+  count=0;
+
+  time.resize(maxsize);
+  list.resize(maxsize);
 }
 
 void ImageList::add(const std::shared_ptr<const Image> &image)
 {
-  list.push_back(image);
+  const uint64_t timestamp=image->getTimestampNS();
+
+  // find position after all images with the same or older timestamp, which is
+  // normally the end of the list
+
+  size_t p=upperBound(timestamp);
 
-  while (list.size() > maxsize)
+  // drop the oldest image if the list is full
+
+  if (count == maxsize)
   {
-    list.erase(list.begin());
+    if (p == 0)
+    {
+      return; // the new image would be dropped immediately
+    }
+
+    list[head].reset();
+    head=index(1);
+    count--;
+    p--;
   }
-}
 
-void ImageList::add(const Buffer *buffer, uint32_t part)
-{
-  list.push_back(std::shared_ptr<const Image>(new Image(buffer, part)));
+  // move newer images for making space and insert image
 
-  while (list.size() > maxsize)
+  for (size_t i=count; i>p; i--)
   {
-    list.erase(list.begin());
+    time[index(i)]=time[index(i-1)];
+    list[index(i)]=std::move(list[index(i-1)]);
   }
+
+  time[index(p)]=timestamp;
+  list[index(p)]=image;
+  count++;
+}
+
+void ImageList::add(const Buffer *buffer, uint32_t part)
+{
+  add(std::shared_ptr<const Image>(new Image(buffer, part)));
 }
 
 void ImageList::removeOld(uint64_t timestamp)
 {
-  size_t i=0;
+  const size_t p=upperBound(timestamp);
 
-  while (i < list.size())
+  for (size_t i=0; i<p; i++)
   {
-    if (list[i]->getTimestampNS() <= timestamp)
-    {
-      list.erase(list.begin()+static_cast<int>(i));
-    }
-    else
-    {
-      i++;
-    }
+    list[index(i)].reset();
   }
+
+  head=index(p);
+  count-=p;
 }
 
 uint64_t ImageList::getOldestTime() const
 {
   uint64_t ret=0;
 
-  if (list.size() > 0)
+  if (count > 0)
   {
-    ret=list[0]->getTimestampNS();
+    ret=time[head];
   }
 
   return ret;
@@ -101,55 +124,45 @@ uint64_t ImageList::getOldestTime() const
 
 std::shared_ptr<const Image> ImageList::find(uint64_t timestamp) const
 {
-  for (size_t i=0; i<list.size(); i++)
-  {
-    if (list[i]->getTimestampNS() == timestamp)
-    {
-      return list[i];
-    }
-  }
+  const size_t p=lowerBound(timestamp);
 
-  return std::shared_ptr<const Image>();
-}
-
-namespace
-{
-
-inline uint64_t absDiff(uint64_t a, uint64_t b)
-{
-  if (a < b)
+  if (p < count && time[index(p)] == timestamp)
   {
-    return b-a;
+    return list[index(p)];
   }
 
-  return a-b;
-}
-
+  return std::shared_ptr<const Image>();
 }
 
 std::shared_ptr<const Image> ImageList::find(uint64_t timestamp, uint64_t tolerance) const
 {
-  if (list.size() > 0)
+  if (count > 0)
   {
     if (tolerance > 0)
     {
-      size_t min_i=0;
-      uint64_t min_ad=absDiff(list[0]->getTimestampNS(), timestamp);
+      // the closest timestamp is either the first that is not older or the
+      // one before, which is preferred if the difference is the same
 
-      for (size_t i=1; i<list.size(); i++)
+      const size_t p=lowerBound(timestamp);
+
+      size_t min_i=count;
+      uint64_t min_ad=0;
+
+      if (p > 0)
       {
-        uint64_t ad=absDiff(list[i]->getTimestampNS(), timestamp);
+        min_i=lowerBound(time[index(p-1)]); // first of images with same time
+        min_ad=timestamp-time[index(p-1)];
+      }
 
-        if (ad < min_ad)
-        {
-          min_i=i;
-          min_ad=ad;
-        }
+      if (p < count && (min_i == count || time[index(p)]-timestamp < min_ad))
+      {
+        min_i=p;
+        min_ad=time[index(p)]-timestamp;
       }
 
       if (min_ad < tolerance)
       {
-        return list[min_i];
+        return list[index(min_i)];
       }
     }
     else
@@ -161,4 +174,53 @@ std::shared_ptr<const Image> ImageList::find(uint64_t timestamp, uint64_t tolera
   return std::shared_ptr<const Image>();
 }
 
+size_t ImageList::lowerBound(uint64_t timestamp) const
+{
+  size_t lo=0, hi=count;
+
+  while (lo < hi)
+  {
+    const size_t m=(lo+hi)>>1;
+
+    if (time[index(m)] < timestamp)
+    {
+      lo=m+1;
+    }
+    else
+    {
+      hi=m;
+    }
+  }
+
+  return lo;
+}
+
+size_t ImageList::upperBound(uint64_t timestamp) const
+{
+  size_t lo=0, hi=count;
+
+  // check last element first, since new images are normally added at the end
+
+  if (count > 0 && time[index(count-1)] <= timestamp)
+  {
+    return count;
+  }
+
+  while (lo < hi)
+  {
+    const size_t m=(lo+hi)>>1;
+
+    if (time[index(m)] <= timestamp)
+    {
+      lo=m+1;
+    }
+    else
+    {
+      hi=m;
+    }
+  }
+
+  return lo;
+}
+
 }
@@ -48,6 +48,10 @@ namespace rcg
   An object of this class manages a limited number of images. It is intended as
   a helper class for time synchronization of different images that can be
   associated by timestamp.
+
+  The images are kept in a ring buffer that is sorted by timestamp. Adding an
+  image with the newest timestamp and removing the oldest images is done in
+  constant time per image. Searching is done by binary search.
 */
 
 class ImageList
@@ -65,7 +69,8 @@ class ImageList
 
     /**
       Adds the given image to the internal list. If the maximum number of
-      elements is exceeded, then the oldes image will be dropped.
+      elements is exceeded, then the image with the oldest timestamp will be
+      dropped.
 
       @param image Image to be added.
     */
@@ -74,8 +79,8 @@ class ImageList
 
     /**
       Creates an image from the given buffer and adds it to the internal list.
-      If the maximum number of elements is exceeded, then the oldes image will
-      be dropped.
+      If the maximum number of elements is exceeded, then the image with the
+      oldest timestamp will be dropped.
 
       @param buffer Buffer from which an image will be created.
       @param part   Part number from which the image should be created.
@@ -100,6 +105,14 @@ class ImageList
 
     uint64_t getOldestTime() const;
 
+    /**
+      Returns the number of images in the list.
+
+      @return Number of images.
+    */
+
+    size_t size() const { return count; }
+
     /**
       Returns the image that has the given timestamp. If the image cannot be
       found, then a nullptr is returned.
@@ -111,10 +124,11 @@ class ImageList
     std::shared_ptr<const Image> find(uint64_t timestamp) const;
 
     /**
-      Returns the oldest image that has a timestamp within the tolerance of the
-      given timestamp. If the tolerance is <= 0, then the behaviour is the same
-      as for find(timestamp). If the image cannot be found, then a nullptr is
-      returned.
+      Returns the image with the timestamp that is closest to the given
+      timestamp, if the difference is less than the tolerance. If two images
+      have the same distance, then the older one is returned. If the tolerance
+      is <= 0, then the behaviour is the same as for find(timestamp). If the
+      image cannot be found, then a nullptr is returned.
 
       @param timestamp Timestamp.
       @param tolerance Maximum tolarance added or subtracted to the timestamp.
@@ -126,7 +140,18 @@ class ImageList
 
   private:
 
+    size_t lowerBound(uint64_t timestamp) const;
+    size_t upperBound(uint64_t timestamp) const;
+
+    size_t index(size_t i) const
+    {
+      i+=head;
+      return i < maxsize ? i : i-maxsize;
+    }
+
     size_t maxsize;
+    size_t head, count;
+    std::vector<uint64_t> time;
     std::vector<std::shared_ptr<const Image> > list;
 };
 
@@ -0,0 +1,278 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "imagesetsync.h"
+#include "config.h"
+
+#include <stdexcept>
+#include <limits>
+
+namespace rcg
+{
+
+ImageSetSynchronizer::ImageSetSynchronizer(const std::shared_ptr<GenApi::CNodeMapRef> &_nodemap,
+                                           size_t _maxsize) : nodemap(_nodemap)
+{
+  maxsize=_maxsize;
+  last=0;
+  stat.complete=0;
+  stat.dropped=0;
+  stat.mismatched=0;
+  stat.ignored=0;
+}
+
+size_t ImageSetSynchronizer::addComponent(const std::string &name, uint64_t tolerance)
+{
+  if (!nodemap)
+  {
+    throw std::invalid_argument("ImageSetSynchronizer: Nodemap is required for routing by component name");
+  }
+
+  std::shared_ptr<Component> c=std::make_shared<Component>(maxsize);
+
+  c->name=name;
+  c->sourceid=0;
+  c->tolerance=tolerance;
+
+  comp.push_back(c);
+
+  return comp.size()-1;
+}
+
+size_t ImageSetSynchronizer::addSource(uint64_t sourceid, uint64_t tolerance)
+{
+  std::shared_ptr<Component> c=std::make_shared<Component>(maxsize);
+
+  c->sourceid=sourceid;
+  c->tolerance=tolerance;
+
+  comp.push_back(c);
+
+  return comp.size()-1;
+}
+
+void ImageSetSynchronizer::setCallback(const ImageSetCallback &cb)
+{
+  callback=cb;
+}
+
+size_t ImageSetSynchronizer::add(const Buffer *buffer)
+{
+  size_t ret=0;
+
+  if (!buffer->getIsIncomplete())
+  {
+    uint32_t n=buffer->getNumberOfParts();
+    for (uint32_t part=0; part<n; part++)
+    {
+      if (buffer->getImagePresent(part))
+      {
+        int k=getComponent(buffer, part);
+
+        if (k >= 0)
+        {
+          ret+=add(static_cast<size_t>(k), std::shared_ptr<const Image>(new Image(buffer, part)));
+        }
+        else
+        {
+          stat.ignored++;
+        }
+      }
+    }
+  }
+
+  return ret;
+}
+
+size_t ImageSetSynchronizer::add(const std::shared_ptr<const Buffer> &buffer)
+{
+  size_t ret=0;
+
+  if (!buffer->getIsIncomplete())
+  {
+    uint32_t n=buffer->getNumberOfParts();
+    for (uint32_t part=0; part<n; part++)
+    {
+      if (buffer->getImagePresent(part))
+      {
+        int k=getComponent(buffer.get(), part);
+
+        if (k >= 0)
+        {
+          ret+=add(static_cast<size_t>(k), std::shared_ptr<const Image>(new Image(buffer, part)));
+        }
+        else
+        {
+          stat.ignored++;
+        }
+      }
+    }
+  }
+
+  return ret;
+}
+
+size_t ImageSetSynchronizer::add(size_t component, const std::shared_ptr<const Image> &image)
+{
+  if (component >= comp.size())
+  {
+    throw std::invalid_argument("ImageSetSynchronizer: Unknown component index");
+  }
+
+  const uint64_t timestamp=image->getTimestampNS();
+
+  // reference images that are not newer than the last set can never be
+  // completed
+
+  if (component == 0 && stat.complete > 0 && timestamp <= last)
+  {
+    stat.mismatched++;
+    return 0;
+  }
+
+  // add image, which drops one image if the list is full
+
+  ImageList &list=comp[component]->list;
+
+  if (list.size() >= maxsize)
+  {
+    stat.dropped++;
+  }
+
+  list.add(image);
+
+  // find the reference image that belongs to the new image and try to
+  // complete the set
+
+  if (component == 0)
+  {
+    return complete(timestamp);
+  }
+
+  std::shared_ptr<const Image> ref=comp[0]->list.find(timestamp, comp[component]->tolerance);
+
+  if (ref)
+  {
+    return complete(ref->getTimestampNS());
+  }
+
+  return 0;
+}
+
+void ImageSetSynchronizer::clear()
+{
+  for (size_t k=0; k<comp.size(); k++)
+  {
+    ImageList &list=comp[k]->list;
+
+    stat.dropped+=list.size();
+    list.removeOld(std::numeric_limits<uint64_t>::max());
+  }
+}
+
+int ImageSetSynchronizer::getComponent(const Buffer *buffer, uint32_t part) const
+{
+  if (nodemap)
+  {
+    // the chunk data of lazily attached or leased buffers must be attached
+    // before the component can be determined
+
+    buffer->attachChunkData();
+    std::string name=getComponetOfPart(nodemap, buffer, part);
+
+    for (size_t k=0; k<comp.size(); k++)
+    {
+      if (comp[k]->name.size() > 0 && comp[k]->name == name)
+      {
+        return static_cast<int>(k);
+      }
+    }
+  }
+
+  uint64_t sourceid=buffer->getPartSourceID(part);
+
+  for (size_t k=0; k<comp.size(); k++)
+  {
+    if (comp[k]->name.size() == 0 && comp[k]->sourceid == sourceid)
+    {
+      return static_cast<int>(k);
+    }
+  }
+
+  return -1;
+}
+
+size_t ImageSetSynchronizer::complete(uint64_t timestamp)
+{
+  // one lookup per component
+
+  std::vector<std::shared_ptr<const Image> > set(comp.size());
+
+  set[0]=comp[0]->list.find(timestamp);
+
+  for (size_t k=1; k<comp.size(); k++)
+  {
+    set[k]=comp[k]->list.find(timestamp, comp[k]->tolerance);
+
+    if (!set[k])
+    {
+      return 0;
+    }
+  }
+
+  // remove the images of the set and all older ones from the lists
+
+  last=timestamp;
+
+  for (size_t k=0; k<comp.size(); k++)
+  {
+    ImageList &list=comp[k]->list;
+
+    size_t n=list.size();
+    list.removeOld(set[k]->getTimestampNS());
+    stat.dropped+=n-list.size()-1;
+  }
+
+  stat.complete++;
+
+  if (callback)
+  {
+    callback(set);
+  }
+
+  return 1;
+}
+
+}
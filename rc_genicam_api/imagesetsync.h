@@ -0,0 +1,224 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_IMAGESETSYNC
+#define RC_GENICAM_API_IMAGESETSYNC
+
+#include "imagelist.h"
+
+#include <GenApi/GenApi.h>
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <functional>
+
+namespace rcg
+{
+
+/**
+  Callback that receives a complete set of synchronized images. The images are
+  given in the order in which the components have been added to the
+  synchronizer.
+*/
+
+typedef std::function<void (const std::vector<std::shared_ptr<const Image> > &set)> ImageSetCallback;
+
+/**
+  Counters of an image set synchronizer.
+*/
+
+struct ImageSetStatistics
+{
+  uint64_t complete;   // number of complete image sets that have been emitted
+  uint64_t dropped;    // number of images that have been discarded without
+                       // becoming part of a set
+  uint64_t mismatched; // number of reference images that arrived with a
+                       // timestamp that is not newer than the last emitted set
+  uint64_t ignored;    // number of image parts that belong to no component
+};
+
+/**
+  An object of this class collects images of different components, e.g. the
+  left, disparity, confidence and error image of a stereo camera, and
+  synchronizes them by timestamp. Images are routed to components by the
+  component name (if a nodemap is given) or by the source ID of the buffer
+  part. The first component is the reference. All other components are
+  matched to the timestamp of a reference image with the tolerance that is
+  given for the component. Complete sets are passed to a callback, after which
+  the images of the set and all older ones are removed.
+
+  Buffers that are received via Stream::grabLeased() or the acquisition thread
+  are referenced by the images without copying the pixels. In this case, the
+  number of buffers that is given to Stream::startStreaming() must be large
+  enough for all images that are held by the synchronizer.
+
+  Routing by component name requires chunk data. The buffers must therefore
+  be attached to the nodemap (see Stream::attachBuffers()), which is also the
+  case for leased buffers. The synchronizer attaches each buffer before its
+  parts are routed, so that lazy attaching is sufficient. The nodemap must
+  not be used concurrently by other threads while buffers are added, since
+  all buffers share the chunk features of the nodemap.
+
+  NOTE: The class is not thread safe. All images must be added from the same
+  thread.
+*/
+
+class ImageSetSynchronizer
+{
+  public:
+
+    /**
+      Creates an image set synchronizer.
+
+      @param nodemap Remote nodemap of the device, which is used for
+                     determining the component name of buffer parts. If it is
+                     0, then parts are routed by their source ID.
+      @param maxsize Maximum number of images that are kept for each component.
+    */
+
+    ImageSetSynchronizer(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap=0,
+                         size_t maxsize=25);
+
+    /**
+      Adds a component that is identified by the component name, as returned
+      by getComponetOfPart(). A nodemap must have been given to the
+      constructor.
+
+      @param name      Component name, e.g. Intensity or Disparity.
+      @param tolerance Maximum difference of the timestamp to the timestamp of
+                       the reference image in nano seconds. It is ignored for
+                       the first component.
+      @return          Index of the component in the emitted image sets.
+    */
+
+    size_t addComponent(const std::string &name, uint64_t tolerance=0);
+
+    /**
+      Adds a component that is identified by the source ID of the buffer part.
+
+      @param sourceid  Source ID, see Buffer::getPartSourceID().
+      @param tolerance Maximum difference of the timestamp to the timestamp of
+                       the reference image in nano seconds. It is ignored for
+                       the first component.
+      @return          Index of the component in the emitted image sets.
+    */
+
+    size_t addSource(uint64_t sourceid, uint64_t tolerance=0);
+
+    /**
+      Sets the callback that receives all complete image sets.
+
+      @param cb Callback.
+    */
+
+    void setCallback(const ImageSetCallback &cb);
+
+    /**
+      Adds all complete images of the buffer by copying the pixels, since the
+      buffer is only valid until the next grab.
+
+      @param buffer Grabbed buffer.
+      @return       Number of image sets that have been completed.
+    */
+
+    size_t add(const Buffer *buffer);
+
+    /**
+      Adds all complete images of the leased buffer without copying the
+      pixels.
+
+      @param buffer Leased buffer.
+      @return       Number of image sets that have been completed.
+    */
+
+    size_t add(const std::shared_ptr<const Buffer> &buffer);
+
+    /**
+      Adds an image to the given component.
+
+      @param component Index of component as returned by addComponent() or
+                       addSource().
+      @param image     Image.
+      @return          Number of image sets that have been completed, i.e. 0
+                       or 1.
+    */
+
+    size_t add(size_t component, const std::shared_ptr<const Image> &image);
+
+    /**
+      Removes all images that are currently held.
+    */
+
+    void clear();
+
+    /**
+      Returns the counters.
+
+      @return Statistics.
+    */
+
+    const ImageSetStatistics &getStatistics() const { return stat; }
+
+  private:
+
+    ImageSetSynchronizer(class ImageSetSynchronizer &); // forbidden
+    ImageSetSynchronizer &operator=(const ImageSetSynchronizer &); // forbidden
+
+    int getComponent(const Buffer *buffer, uint32_t part) const;
+    size_t complete(uint64_t timestamp);
+
+    struct Component
+    {
+      std::string name;
+      uint64_t sourceid;
+      uint64_t tolerance;
+      ImageList list;
+
+      Component(size_t maxsize) : list(maxsize) { }
+    };
+
+    std::shared_ptr<GenApi::CNodeMapRef> nodemap;
+    size_t maxsize;
+    std::vector<std::shared_ptr<Component> > comp;
+    ImageSetCallback callback;
+
+    uint64_t last;
+    ImageSetStatistics stat;
+};
+
+}
+
+#endif
@@ -41,6 +41,7 @@
 #include "cport.h"
 
 #include <iostream>
+#include <chrono>
 
 namespace rcg
 {
@@ -54,6 +55,7 @@ Interface::Interface(const std::shared_ptr<System> &_parent,
 
   n_open=0;
   ifh=0;
+  discovery_time=-1;
 }
 
 Interface::~Interface()
@@ -159,6 +161,8 @@ std::vector<std::shared_ptr<Device> > Interface::getDevices(uint64_t timeout)
 
     // update available interfaces
 
+    auto start=std::chrono::steady_clock::now();
+
     GenTL::GC_ERROR err=gentl->IFUpdateDeviceList(ifh, 0, timeout);
 
     if (err == GenTL::GC_ERR_INVALID_HANDLE)
@@ -180,6 +184,9 @@ std::vector<std::shared_ptr<Device> > Interface::getDevices(uint64_t timeout)
       err=gentl->IFUpdateDeviceList(ifh, 0, timeout);
     }
 
+    discovery_time=std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-
+                                                             start).count();
+
     if (err != GenTL::GC_ERR_SUCCESS)
     {
       throw GenTLException(std::string("Interface::getDevices() (1) ")+id+" "+std::to_string(err), gentl);
@@ -291,6 +298,12 @@ std::shared_ptr<Device> Interface::getDevice(const char *devid)
   return getDevice(devid, 1000);
 }
 
+double Interface::getDiscoveryTime()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return discovery_time;
+}
+
 namespace
 {
 
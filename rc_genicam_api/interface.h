@@ -122,6 +122,15 @@ class Interface : public std::enable_shared_from_this<Interface>
     std::shared_ptr<Device> getDevice(const char *devid, uint64_t timeout);
     std::shared_ptr<Device> getDevice(const char *devid);
 
+    /**
+      Returns the time that the last discovery of devices on this interface
+      took, i.e. the last call of getDevices() or getDevice().
+
+      @return Time in ms or a negative value if no discovery has been done yet.
+    */
+
+    double getDiscoveryTime();
+
     /**
       Returns the display name of the interface.
 
@@ -176,6 +185,7 @@ class Interface : public std::enable_shared_from_this<Interface>
 
     int n_open;
     void *ifh;
+    double discovery_time;
 
     std::shared_ptr<CPort> cport;
     std::shared_ptr<GenApi::CNodeMapRef> nodemap;
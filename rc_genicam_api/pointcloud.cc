@@ -34,6 +34,8 @@
  */
 
 #include "pointcloud.h"
+#include "reprojector.h"
+#include "thread_pool.h"
 
 #include <iostream>
 #include <fstream>
@@ -42,6 +44,9 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cstring>
 
 #ifdef _WIN32
 #undef min
@@ -81,94 +86,159 @@ inline uint16_t getUint16(const uint8_t *p, bool bigendian, size_t i)
   return ret;
 }
 
+/*
+  Returns true if the values in the 2x2 neighbourhood, starting with pixel
+  i-1 in the given rows, are forming at least one triangle. The number of
+  valid values is returned in valid.
+*/
+
+inline bool isTriangle(int &valid, const Reprojector &rp, const uint8_t *row0,
+                       const uint8_t *row1, bool bigendian, size_t i, uint16_t vstep)
+{
+  uint16_t v[4];
+  v[0]=getUint16(row0, bigendian, i-1);
+  v[1]=getUint16(row0, bigendian, i);
+  v[2]=getUint16(row1, bigendian, i-1);
+  v[3]=getUint16(row1, bigendian, i);
+
+  uint16_t vmin=65535;
+  uint16_t vmax=0;
+  valid=0;
+
+  for (int jj=0; jj<4; jj++)
+  {
+    if (rp.getFactor(v[jj]) != 0)
+    {
+      vmin=std::min(vmin, v[jj]);
+      vmax=std::max(vmax, v[jj]);
+      valid++;
+    }
+  }
+
+  return valid >= 3 && vmax-vmin <= vstep;
 }
 
-void storePointCloud(std::string name, double f, double t, double scale,
-                     std::shared_ptr<const Image> left,
-                     std::shared_ptr<const Image> disp,
-                     std::shared_ptr<const Image> conf,
-                     std::shared_ptr<const Image> error)
+/*
+  Computes the vertex indices of all valid disparities of one row.
+*/
+
+inline void getRowIndex(uint32_t *index, const Reprojector &rp, const uint8_t *row,
+                        bool bigendian, size_t width, uint32_t first)
 {
-  // get size and scale factor between left image and disparity image
+  for (size_t i=0; i<width; i++)
+  {
+    index[i]=0xffffffff;
+    if (rp.getFactor(getUint16(row, bigendian, i)) != 0) index[i]=first++;
+  }
+}
 
-  size_t width=disp->getWidth();
-  size_t height=disp->getHeight();
-  bool bigendian=disp->isBigEndian();
-  size_t ds=(left->getWidth()+disp->getWidth()-1)/disp->getWidth();
+/*
+  Calls the given function for bands of rows in parallel.
+*/
 
-  // convert focal length factor into focal length in (disparity) pixels
+void forRowBands(size_t height, size_t nthreads,
+                 const std::function<void (size_t k0, size_t k1)> &fn)
+{
+  nthreads=ThreadPool::getNumThreads(nthreads);
 
-  f*=width;
+  const size_t nbands=std::max(static_cast<size_t>(1), std::min(height, 4*nthreads));
+  const size_t band=(height+nbands-1)/nbands;
 
-  // get pointer to disparity data and size of row in bytes
+  ThreadPool::getInstance().parallelFor(nbands, nthreads, [&](size_t b)
+  {
+    const size_t k0=std::min(height, b*band);
+    const size_t k1=std::min(height, k0+band);
 
-  const uint8_t *dps=disp->getPixels();
-  size_t dstep=disp->getWidth()*sizeof(uint16_t)+disp->getXPadding();
+    if (k0 < k1)
+    {
+      fn(k0, k1);
+    }
+  });
+}
+
+/*
+  Formats n elements in blocks in parallel and writes the blocks in the
+  correct order to the output stream.
+*/
 
-  // count number of valid disparities and store vertice index in a temporary
-  // index image
+void writeParallel(std::ostream &out, size_t n, size_t nthreads,
+                   const std::function<void (std::string &s, size_t i0, size_t i1)> &format)
+{
+  const size_t block=16384;
 
-  size_t vi=0;
-  const uint32_t vinvalid=0xffffffff;
-  std::vector<uint32_t> vindex(width*height);
+  nthreads=ThreadPool::getNumThreads(nthreads);
+  std::vector<std::string> buffer(nthreads);
 
-  uint32_t n=0;
-  for (size_t k=0; k<height; k++)
+  for (size_t i=0; i<n; i+=block*nthreads)
   {
-    int j=0;
-    for (size_t i=0; i<width; i++)
+    const size_t m=std::min(nthreads, (n-i+block-1)/block);
+
+    ThreadPool::getInstance().parallelFor(m, nthreads, [&](size_t j)
     {
-      vindex[vi]=vinvalid;
-      if ((dps[j]|dps[j+1]) != 0) vindex[vi]=n++;
+      const size_t i0=i+j*block;
 
-      j+=2;
-      vi++;
-    }
+      buffer[j].clear();
+      format(buffer[j], i0, std::min(n, i0+block));
+    });
 
-    dps+=dstep;
+    for (size_t j=0; j<m; j++)
+    {
+      out.write(buffer[j].data(), static_cast<std::streamsize>(buffer[j].size()));
+    }
   }
+}
 
-  dps=disp->getPixels();
+/*
+  Appends values in little endian byte order.
+*/
 
-  // count number of triangles
+inline void appendLE(std::string &s, uint32_t v)
+{
+  char p[4];
 
-  const uint16_t vstep=static_cast<uint16_t>(std::ceil(2/scale));
+  p[0]=static_cast<char>(v&0xff);
+  p[1]=static_cast<char>((v>>8)&0xff);
+  p[2]=static_cast<char>((v>>16)&0xff);
+  p[3]=static_cast<char>((v>>24)&0xff);
 
-  int tn=0;
-  for (size_t k=1; k<height; k++)
-  {
-    for (size_t i=1; i<width; i++)
-    {
-      uint16_t v[4];
-      v[0]=getUint16(dps, bigendian, i-1);
-      v[1]=getUint16(dps, bigendian, i);
-      v[2]=getUint16(dps+dstep, bigendian, i-1);
-      v[3]=getUint16(dps+dstep, bigendian, i);
+  s.append(p, 4);
+}
 
-      uint16_t vmin=65535;
-      uint16_t vmax=0;
-      int valid=0;
+inline void appendLE(std::string &s, float v)
+{
+  uint32_t u;
+  memcpy(&u, &v, sizeof(u));
+  appendLE(s, u);
+}
 
-      for (int jj=0; jj<4; jj++)
-      {
-        if (v[jj])
-        {
-          vmin=std::min(vmin, v[jj]);
-          vmax=std::max(vmax, v[jj]);
-          valid++;
-        }
-      }
+}
 
-      if (valid >= 3 && vmax-vmin <= vstep)
-      {
-        tn+=valid-2;
-      }
-    }
+void computePointCloud(PointCloud &pc, double f, double t, double scale,
+                       std::shared_ptr<const Image> left,
+                       std::shared_ptr<const Image> disp,
+                       std::shared_ptr<const Image> conf,
+                       std::shared_ptr<const Image> error,
+                       size_t nthreads)
+{
+  // get size and scale factor between left image and disparity image
 
-    dps+=dstep;
-  }
+  const size_t width=disp->getWidth();
+  const size_t height=disp->getHeight();
+  const bool bigendian=disp->isBigEndian();
+  const size_t ds=(left->getWidth()+disp->getWidth()-1)/disp->getWidth();
+
+  // convert focal length factor into focal length in (disparity) pixels and
+  // setup reprojection with the principal point in the image center
+
+  f*=width;
+
+  Reprojector rp;
+  rp.setParameters(f, t, 0.5*width, 0.5*height, scale);
 
-  dps=disp->getPixels();
+  // get pointer to disparity data and size of row in bytes
+
+  const uint8_t *dps=disp->getPixels();
+  const size_t dstep=disp->getWidth()*sizeof(uint16_t)+disp->getXPadding();
 
   // get pointer to optional confidence and error data and size of row in bytes
 
@@ -187,169 +257,311 @@ void storePointCloud(std::string name, double f, double t, double scale,
     estep=error->getWidth()*sizeof(uint8_t)+error->getXPadding();
   }
 
-  // open output file and write ASCII PLY header
+  // count number of valid disparities in each row and number of triangles
+  // between each row and the row above
 
-  if (name.size() == 0)
+  const uint16_t vstep=static_cast<uint16_t>(std::ceil(2/scale));
+
+  std::vector<uint32_t> vfirst(height+1, 0);
+  std::vector<uint32_t> tfirst(height+1, 0);
+
+  forRowBands(height, nthreads, [&](size_t k0, size_t k1)
   {
-    std::ostringstream os;
-    double timestamp=left->getTimestampNS()/1000000000.0;
-    os << "rc_visard_" << std::setprecision(16) << timestamp << ".ply";
-    name=os.str();
-  }
+    for (size_t k=k0; k<k1; k++)
+    {
+      const uint8_t *row=dps+k*dstep;
 
-  std::ofstream out(name);
+      uint32_t n=0;
+      for (size_t i=0; i<width; i++)
+      {
+        if (rp.getFactor(getUint16(row, bigendian, i)) != 0) n++;
+      }
 
-  out << "ply" << std::endl;
-  out << "format ascii 1.0" << std::endl;
-  out << "comment Created with gc_pointcloud from Roboception GmbH" << std::endl;
-  out << "comment Camera [1 0 0; 0 1 0; 0 0 1] [0 0 0]" << std::endl;
-  out << "element vertex " << n << std::endl;
-  out << "property float32 x" << std::endl;
-  out << "property float32 y" << std::endl;
-  out << "property float32 z" << std::endl;
-  out << "property float32 scan_size" << std::endl; // i.e. size of 3D point
+      vfirst[k+1]=n;
 
-  if (cps != 0)
-  {
-    out << "property float32 scan_conf" << std::endl; // optional confidence
-  }
+      if (k > 0)
+      {
+        uint32_t tn=0;
+        for (size_t i=1; i<width; i++)
+        {
+          int valid;
+          if (isTriangle(valid, rp, row-dstep, row, bigendian, i, vstep))
+          {
+            tn+=static_cast<uint32_t>(valid-2);
+          }
+        }
+
+        tfirst[k+1]=tn;
+      }
+    }
+  });
 
-  if (eps != 0)
+  // compute index of first vertex and first triangle of each row
+
+  for (size_t k=0; k<height; k++)
   {
-    out << "property float32 scan_error" << std::endl; // optional error in 3D along line of sight
+    vfirst[k+1]+=vfirst[k];
+    tfirst[k+1]+=tfirst[k];
   }
 
-  out << "property uint8 diffuse_red" << std::endl;
-  out << "property uint8 diffuse_green" << std::endl;
-  out << "property uint8 diffuse_blue" << std::endl;
-  out << "element face " << tn << std::endl;
-  out << "property list uint8 uint32 vertex_indices" << std::endl;
-  out << "end_header" << std::endl;
+  const size_t n=vfirst[height];
 
-  // create colored point cloud
+  pc.timestamp=left->getTimestampNS();
+  pc.xyz.resize(3*n);
+  pc.size.resize(n);
+  pc.conf.resize(cps != 0 ? n : 0);
+  pc.error.resize(eps != 0 ? n : 0);
+  pc.rgb.resize(3*n);
+  pc.faces.resize(3*static_cast<size_t>(tfirst[height]));
 
-  for (size_t k=0; k<height; k++)
+  // create colored points and triangles
+
+  forRowBands(height, nthreads, [&](size_t k0, size_t k1)
   {
-    for (size_t i=0; i<width; i++)
+    std::vector<uint32_t> index0(width), index1(width);
+
+    if (k0 > 0)
     {
-      // convert disparity from fixed comma 16 bit integer into float value
+      getRowIndex(index1.data(), rp, dps+(k0-1)*dstep, bigendian, width, vfirst[k0-1]);
+    }
 
-      double d=scale*getUint16(dps, bigendian, i);
+    for (size_t k=k0; k<k1; k++)
+    {
+      const uint8_t *row=dps+k*dstep;
+
+      // points
 
-      // if disparity is valid and color can be obtained
+      const size_t j0=vfirst[k];
+      const size_t nrow=vfirst[k+1]-j0;
 
-      if (d)
+      if (nrow > 0)
       {
-        // reconstruct 3D point from disparity value
+        size_t j=j0;
 
-        double x=(i+0.5-0.5*width)*t/d;
-        double y=(k+0.5-0.5*height)*t/d;
-        double z=f*t/d;
+        // reproject all valid disparities of the row and store them compactly
 
-        // compute size of reconstructed point
+        for (size_t i=0; i<width; i++)
+        {
+          const float q=rp.getFactor(getUint16(row, bigendian, i));
 
-        double x2=(i-0.5*width)*t/d;
-        double size=2*1.4*std::abs(x2-x);
+          if (q != 0)
+          {
+            pc.xyz[3*j]=static_cast<float>(i+0.5-0.5*width)*q;
+            pc.xyz[3*j+1]=static_cast<float>(k+0.5-0.5*height)*q;
+            pc.xyz[3*j+2]=static_cast<float>(f)*q;
 
-        // get corresponding color value
+            // size of reconstructed point
 
-        uint8_t rgb[3];
-        getColor(rgb, left, static_cast<uint32_t>(ds), static_cast<uint32_t>(i),
-                 static_cast<uint32_t>(k));
+            pc.size[j]=1.4f*q;
 
-        // store colored point, optionally with confidence and error
+            // optional confidence and error
 
-        out << x << " " << y << " " << z << " " << size << " ";
+            if (cps != 0)
+            {
+              pc.conf[j]=static_cast<float>(cps[k*cstep+i]/255.0);
+            }
 
-        if (cps != 0)
-        {
-          out << cps[i]/255.0 << " ";
+            if (eps != 0)
+            {
+              pc.error[j]=static_cast<float>(eps[k*estep+i]*scale*f/t)*q*q;
+            }
+
+            // get corresponding color value
+
+            getColor(&pc.rgb[3*j], left, static_cast<uint32_t>(ds), static_cast<uint32_t>(i),
+                     static_cast<uint32_t>(k));
+
+            j++;
+          }
         }
+      }
 
-        if (eps != 0)
+      // triangles between this row and the row above
+
+      index0.swap(index1);
+      getRowIndex(index1.data(), rp, row, bigendian, width, vfirst[k]);
+
+      if (k > 0)
+      {
+        uint32_t *fc=&pc.faces[3*static_cast<size_t>(tfirst[k])];
+
+        for (size_t i=1; i<width; i++)
         {
-          out << eps[i]*scale*f*t/(d*d) << " ";
+          int valid;
+          if (isTriangle(valid, rp, row-dstep, row, bigendian, i, vstep))
+          {
+            uint32_t v[4];
+            int jj=0;
+
+            if (index0[i-1] != 0xffffffff) v[jj++]=index0[i-1];
+            if (index1[i-1] != 0xffffffff) v[jj++]=index1[i-1];
+            if (index1[i] != 0xffffffff) v[jj++]=index1[i];
+            if (index0[i] != 0xffffffff) v[jj++]=index0[i];
+
+            *fc++=v[0]; *fc++=v[1]; *fc++=v[2];
+
+            if (jj == 4)
+            {
+              *fc++=v[2]; *fc++=v[3]; *fc++=v[0];
+            }
+          }
         }
-
-        out << static_cast<int>(rgb[0]) << " ";
-        out << static_cast<int>(rgb[1]) << " ";
-        out << static_cast<int>(rgb[2]) << std::endl;
       }
     }
+  });
+}
+
+void storePointCloud(std::string name, const PointCloud &pc, PlyFmt fmt, size_t nthreads)
+{
+  const size_t n=pc.getNumPoints();
+  const size_t tn=pc.getNumTriangles();
+  const bool has_conf=pc.conf.size() > 0;
+  const bool has_error=pc.error.size() > 0;
 
-    dps+=dstep;
-    cps+=cstep;
-    eps+=estep;
+  // open output file and write PLY header
+
+  if (name.size() == 0)
+  {
+    std::ostringstream os;
+    double timestamp=pc.timestamp/1000000000.0;
+    os << "rc_visard_" << std::setprecision(16) << timestamp << ".ply";
+    name=os.str();
   }
 
-  dps=disp->getPixels();
+  std::ofstream out(name, std::ios::binary);
 
-  // create triangles
+  if (!out)
+  {
+    throw std::runtime_error("storePointCloud(): Cannot store file: "+name);
+  }
+
+  out << "ply\n";
 
-  uint32_t *ips=vindex.data();
-  for (size_t k=1; k<height; k++)
+  if (fmt == PLY_BINARY)
   {
-    for (size_t i=1; i<width; i++)
-    {
-      uint16_t v[4];
-      v[0]=getUint16(dps, bigendian, i-1);
-      v[1]=getUint16(dps, bigendian, i);
-      v[2]=getUint16(dps+dstep, bigendian, i-1);
-      v[3]=getUint16(dps+dstep, bigendian, i);
+    out << "format binary_little_endian 1.0\n";
+  }
+  else
+  {
+    out << "format ascii 1.0\n";
+  }
 
-      uint16_t vmin=65535;
-      uint16_t vmax=0;
-      int valid=0;
+  out << "comment Created with gc_pointcloud from Roboception GmbH\n";
+  out << "comment Camera [1 0 0; 0 1 0; 0 0 1] [0 0 0]\n";
+  out << "element vertex " << n << "\n";
+  out << "property float32 x\n";
+  out << "property float32 y\n";
+  out << "property float32 z\n";
+  out << "property float32 scan_size\n"; // i.e. size of 3D point
+
+  if (has_conf)
+  {
+    out << "property float32 scan_conf\n"; // optional confidence
+  }
 
-      for (int jj=0; jj<4; jj++)
+  if (has_error)
+  {
+    out << "property float32 scan_error\n"; // optional error in 3D along line of sight
+  }
+
+  out << "property uint8 diffuse_red\n";
+  out << "property uint8 diffuse_green\n";
+  out << "property uint8 diffuse_blue\n";
+  out << "element face " << tn << "\n";
+  out << "property list uint8 uint32 vertex_indices\n";
+  out << "end_header\n";
+
+  if (fmt == PLY_BINARY)
+  {
+    writeParallel(out, n, nthreads, [&](std::string &s, size_t i0, size_t i1)
+    {
+      for (size_t i=i0; i<i1; i++)
       {
-        if (v[jj])
-        {
-          vmin=std::min(vmin, v[jj]);
-          vmax=std::max(vmax, v[jj]);
-          valid++;
-        }
+        appendLE(s, pc.xyz[3*i]);
+        appendLE(s, pc.xyz[3*i+1]);
+        appendLE(s, pc.xyz[3*i+2]);
+        appendLE(s, pc.size[i]);
+
+        if (has_conf) appendLE(s, pc.conf[i]);
+        if (has_error) appendLE(s, pc.error[i]);
+
+        s.append(reinterpret_cast<const char *>(&pc.rgb[3*i]), 3);
       }
+    });
 
-      if (valid >= 3 && vmax-vmin <= vstep)
+    writeParallel(out, tn, nthreads, [&](std::string &s, size_t i0, size_t i1)
+    {
+      for (size_t i=i0; i<i1; i++)
       {
-        int j=0;
-        uint32_t fc[4];
+        s.push_back(3);
+        appendLE(s, pc.faces[3*i]);
+        appendLE(s, pc.faces[3*i+1]);
+        appendLE(s, pc.faces[3*i+2]);
+      }
+    });
+  }
+  else
+  {
+    writeParallel(out, n, nthreads, [&](std::string &s, size_t i0, size_t i1)
+    {
+      std::ostringstream os;
 
-        if (ips[i-1] != vinvalid)
-        {
-          fc[j++]=ips[i-1];
-        }
+      for (size_t i=i0; i<i1; i++)
+      {
+        os << pc.xyz[3*i] << " " << pc.xyz[3*i+1] << " " << pc.xyz[3*i+2] << " "
+           << pc.size[i] << " ";
 
-        if (ips[width+i-1] != vinvalid)
-        {
-          fc[j++]=ips[width+i-1];
-        }
+        if (has_conf) os << pc.conf[i] << " ";
+        if (has_error) os << pc.error[i] << " ";
 
-        if (ips[width+i] != vinvalid)
-        {
-          fc[j++]=ips[width+i];
-        }
+        os << static_cast<int>(pc.rgb[3*i]) << " ";
+        os << static_cast<int>(pc.rgb[3*i+1]) << " ";
+        os << static_cast<int>(pc.rgb[3*i+2]) << "\n";
+      }
 
-        if (ips[i] != vinvalid)
-        {
-          fc[j++]=ips[i];
-        }
+      s=os.str();
+    });
 
-        out << "3 " << fc[0] << ' ' << fc[1] << ' ' << fc[2] << std::endl;
+    writeParallel(out, tn, nthreads, [&](std::string &s, size_t i0, size_t i1)
+    {
+      std::ostringstream os;
 
-        if (j == 4)
-        {
-          out << "3 " << fc[2] << ' ' << fc[3] << ' ' << fc[0] << std::endl;
-        }
+      for (size_t i=i0; i<i1; i++)
+      {
+        os << "3 " << pc.faces[3*i] << ' ' << pc.faces[3*i+1] << ' ' << pc.faces[3*i+2] << "\n";
       }
-    }
 
-    ips+=width;
-    dps+=dstep;
+      s=os.str();
+    });
   }
 
   out.close();
+
+  if (!out)
+  {
+    throw std::runtime_error("storePointCloud(): Cannot store file: "+name);
+  }
+}
+
+void storePointCloud(std::string name, double f, double t, double scale,
+                     std::shared_ptr<const Image> left,
+                     std::shared_ptr<const Image> disp,
+                     std::shared_ptr<const Image> conf,
+                     std::shared_ptr<const Image> error)
+{
+  storePointCloud(name, f, t, scale, left, disp, conf, error, PLY_ASCII, 0);
+}
+
+void storePointCloud(std::string name, double f, double t, double scale,
+                     std::shared_ptr<const Image> left,
+                     std::shared_ptr<const Image> disp,
+                     std::shared_ptr<const Image> conf,
+                     std::shared_ptr<const Image> error,
+                     PlyFmt fmt, size_t nthreads)
+{
+  PointCloud pc;
+  computePointCloud(pc, f, t, scale, left, disp, conf, error, nthreads);
+  storePointCloud(name, pc, fmt, nthreads);
 }
 
 }
@@ -40,14 +40,98 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace rcg
 {
 
+enum PlyFmt { PLY_ASCII, PLY_BINARY };
+
+/**
+  Colored point cloud with triangles, as computed by computePointCloud(). All
+  values are stored in packed arrays, with one entry per point for size, conf
+  and error and three entries per point for xyz and rgb.
+*/
+
+struct PointCloud
+{
+  uint64_t timestamp;          // timestamp of left image in ns
+
+  std::vector<float> xyz;      // x, y, z coordinates of all points in m
+  std::vector<float> size;     // size of all reconstructed points in m
+  std::vector<float> conf;     // confidences between 0 and 1, or empty
+  std::vector<float> error;    // errors along line of sight in m, or empty
+  std::vector<uint8_t> rgb;    // red, green and blue color of all points
+
+  std::vector<uint32_t> faces; // three point indices for each triangle
+
+  /**
+    Returns the number of points.
+  */
+
+  size_t getNumPoints() const { return size.size(); }
+
+  /**
+    Returns the number of triangles.
+  */
+
+  size_t getNumTriangles() const { return faces.size()/3; }
+};
+
+/*
+  Computes a point cloud from the given synchronized left and disparity image
+  pair. The rows of the images are processed in parallel.
+
+  @param pc       Point cloud that receives the result.
+  @param f        Focal length factor (to be multiplicated with image width).
+  @param t        Baseline in m.
+  @param scale    Disparity scale factor.
+  @param left     Left camera image. The image must have format Mono8 or
+                  YCbCr411_8.
+  @param disp     Corresponding disparity image, possibly downscaled by an
+                  integer factor. The image must be in format Coord3D_C16.
+  @param conf     Optional corresponding confidence image in the same size as
+                  disp. The image must be in format Confidence8.
+  @param error    Optional corresponding error image in the same size as disp.
+                  The image must be in format Error8.
+  @param nthreads Number of threads. 0 means that the number of cores is used.
+*/
+
+void computePointCloud(PointCloud &pc, double f, double t, double scale,
+                       std::shared_ptr<const Image> left,
+                       std::shared_ptr<const Image> disp,
+                       std::shared_ptr<const Image> conf=0,
+                       std::shared_ptr<const Image> error=0,
+                       size_t nthreads=0);
+
+/*
+  Stores the given point cloud in ply format.
+
+  NOTE: An exception that is based on std::exception is thrown if the file
+  cannot be written.
+
+  @param name     Name of output file. If empty, a standard file name with
+                  timestamp is used.
+  @param pc       Point cloud.
+  @param fmt      Ascii or binary little endian ply format.
+  @param nthreads Number of threads for formatting the data. 0 means that the
+                  number of cores is used.
+*/
+
+void storePointCloud(std::string name, const PointCloud &pc, PlyFmt fmt=PLY_ASCII,
+                     size_t nthreads=0);
+
 /*
   Computes a point cloud from the given synchronized left and disparity image
   pair and stores it in ply ascii format.
 
+  NOTE: Since the point cloud is computed and written by the functions above,
+  an exception that is based on std::exception is thrown if the file cannot be
+  written, while earlier versions silently ignored write errors. The values are
+  written with the precision of float32, as declared in the ply header, instead
+  of double precision as before, so that the last printed digit can differ
+  from files that have been written by earlier versions.
+
   @param name    Name of output file. If empty, a standard file name with
                  timestamp is used.
   @param f       Focal length factor (to be multiplicated with image width).
@@ -69,6 +153,22 @@ void storePointCloud(std::string name, double f, double t, double scale,
                      std::shared_ptr<const Image> conf=0,
                      std::shared_ptr<const Image> error=0);
 
+/*
+  Computes a point cloud from the given synchronized left and disparity image
+  pair and stores it in the given ply format. See above for the parameters.
+
+  NOTE: An exception that is based on std::exception is thrown if the file
+  cannot be written. Ascii values are written with float32 precision, as for
+  the function above.
+*/
+
+void storePointCloud(std::string name, double f, double t, double scale,
+                     std::shared_ptr<const Image> left,
+                     std::shared_ptr<const Image> disp,
+                     std::shared_ptr<const Image> conf,
+                     std::shared_ptr<const Image> error,
+                     PlyFmt fmt, size_t nthreads=0);
+
 }
 
 #endif
@@ -0,0 +1,575 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "recording.h"
+
+#include "recording_format.h"
+#include "exception.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace rcg
+{
+
+namespace
+{
+
+inline size_t roundUp(size_t v, size_t a)
+{
+  return (v+a-1)/a*a;
+}
+
+const uint8_t zero[REC_ALIGN]={ 0 };
+
+/*
+  Returns true if the image that is described by the part, including row and
+  image padding, fits into the data of the part. All values are checked
+  before multiplying them, since they may come from a corrupt file. The
+  number of bits per pixel is encoded in bits 16 to 23 of the pixel format.
+*/
+
+bool isImageInPart(const RecPart &p, uint64_t ypadding)
+{
+  const uint64_t bits=(p.pixelformat>>16)&0xff;
+
+  if (bits == 0 || p.width > p.size || p.height > p.size || p.xpadding > p.size ||
+      ypadding > p.size)
+  {
+    return false;
+  }
+
+  const uint64_t stride=(p.width*bits+7)/8+p.xpadding;
+
+  return p.height == 0 || (stride <= (p.size-ypadding)/p.height);
+}
+
+}
+
+/**
+  Mapping of the recording file that is shared by the reader and all frames.
+*/
+
+struct RecordingMapping
+{
+  const uint8_t *base;
+  size_t size;
+
+  RecordingMapping() : base(0), size(0) { }
+
+  ~RecordingMapping()
+  {
+    if (base != 0)
+    {
+      munmap(const_cast<uint8_t *>(base), size);
+    }
+  }
+
+  const RecFrame *frame(uint64_t offset) const
+  {
+    return reinterpret_cast<const RecFrame *>(base+offset);
+  }
+};
+
+RecordingWriter::RecordingWriter(const std::string &_name, size_t buffer_size)
+{
+  name=_name;
+  staged=0;
+  written=0;
+
+  staging.resize(roundUp(std::max(buffer_size, REC_ALIGN), REC_ALIGN));
+
+  fd=::open(name.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+
+  if (fd < 0)
+  {
+    throw GenTLException("RecordingWriter::RecordingWriter(): Cannot create file: "+name);
+  }
+
+  // file header, padded to the alignment
+
+  RecHeader header;
+  memset(&header, 0, sizeof(header));
+
+  header.magic=REC_MAGIC;
+  header.version=REC_VERSION;
+  header.align=REC_ALIGN;
+
+  emit(&header, sizeof(header));
+  emit(zero, REC_ALIGN-sizeof(header));
+}
+
+RecordingWriter::~RecordingWriter()
+{
+  try
+  {
+    close();
+  }
+  catch (...) // do not throw exceptions in destructor
+  { }
+}
+
+void RecordingWriter::append(const Buffer *buffer)
+{
+  if (fd < 0)
+  {
+    throw GenTLException("RecordingWriter::append(): File is closed: "+name);
+  }
+
+  // parts that are outside of the global buffer are appended with aligned
+  // offsets
+
+  const uint8_t *gbase=reinterpret_cast<const uint8_t *>(buffer->getGlobalBase());
+  const size_t gsize=(gbase != 0 ? buffer->getSizeFilled() : 0);
+  const uint32_t nparts=std::min(buffer->getNumberOfParts(), REC_MAX_PARTS);
+
+  RecFrame frame;
+  memset(&frame, 0, sizeof(frame));
+
+  size_t offset=gsize;
+
+  for (uint32_t i=0; i<nparts; i++)
+  {
+    RecPart &part=frame.part[i];
+    const uint8_t *base=reinterpret_cast<const uint8_t *>(buffer->getBase(i));
+
+    part.size=buffer->getSize(i);
+
+    if (base >= gbase && base < gbase+gsize)
+    {
+      part.offset=static_cast<uint64_t>(base-gbase);
+      part.size=std::min(static_cast<size_t>(part.size), gsize-static_cast<size_t>(part.offset));
+    }
+    else
+    {
+      part.offset=roundUp(offset, REC_DATA_ALIGN);
+      offset=part.offset+part.size;
+    }
+
+    part.width=buffer->getWidth(i);
+    part.height=buffer->getHeight(i);
+    part.xoffset=buffer->getXOffset(i);
+    part.yoffset=buffer->getYOffset(i);
+    part.xpadding=buffer->getXPadding(i);
+    part.pixelformat=buffer->getPixelFormat(i);
+    part.source_id=buffer->getPartSourceID(i);
+    part.datatype=buffer->getPartDataType(i);
+
+    // images of incomplete buffers or images that do not fit into the
+    // recorded data are marked as not present
+
+    part.image_present=(buffer->getImagePresent(i) && !buffer->getIsIncomplete() &&
+                        isImageInPart(part, buffer->getYPadding())) ? 1 : 0;
+  }
+
+  frame.magic=REC_FRAME_MAGIC;
+  frame.nparts=nparts;
+  frame.data_offset=roundUp(sizeof(RecFrame), REC_DATA_ALIGN);
+  frame.record_size=roundUp(frame.data_offset+offset, REC_ALIGN);
+  frame.timestamp_ns=buffer->getTimestampNS();
+  frame.frameid=buffer->getFrameID();
+  frame.payload_type=buffer->getPayloadType();
+  frame.size_filled=gsize;
+  frame.ypadding=buffer->getYPadding();
+  frame.chunk_layout_id=buffer->getChunkLayoutID();
+  frame.bigendian=buffer->isBigEndian() ? 1 : 0;
+  frame.incomplete=buffer->getIsIncomplete() ? 1 : 0;
+  frame.contains_chunkdata=buffer->getContainsChunkdata() ? 1 : 0;
+
+  RecordingIndexEntry entry;
+  entry.offset=written+staged;
+  entry.timestamp_ns=frame.timestamp_ns;
+  entry.frameid=frame.frameid;
+
+  // write frame header, data and padding
+
+  emit(&frame, sizeof(frame));
+  emit(zero, frame.data_offset-sizeof(frame));
+
+  if (gsize > 0)
+  {
+    emit(gbase, gsize);
+  }
+
+  size_t pos=gsize;
+
+  for (uint32_t i=0; i<nparts; i++)
+  {
+    const uint8_t *base=reinterpret_cast<const uint8_t *>(buffer->getBase(i));
+
+    if (!(base >= gbase && base < gbase+gsize))
+    {
+      emit(zero, frame.part[i].offset-pos);
+      emit(base, frame.part[i].size);
+      pos=frame.part[i].offset+frame.part[i].size;
+    }
+  }
+
+  emit(zero, frame.record_size-frame.data_offset-offset);
+
+  index.push_back(entry);
+}
+
+void RecordingWriter::close()
+{
+  if (fd < 0)
+  {
+    return;
+  }
+
+  // index and trailer
+
+  RecTrailer trailer;
+  memset(&trailer, 0, sizeof(trailer));
+
+  trailer.magic=REC_INDEX_MAGIC;
+  trailer.version=REC_VERSION;
+  trailer.nframes=index.size();
+  trailer.index_offset=written+staged;
+
+  if (index.size() > 0)
+  {
+    emit(index.data(), index.size()*sizeof(RecordingIndexEntry));
+  }
+
+  emit(&trailer, sizeof(trailer));
+
+  // write remaining data
+
+  try
+  {
+    writeAll(staging.data(), staged);
+    written+=staged;
+    staged=0;
+  }
+  catch (...)
+  {
+    ::close(fd);
+    fd=-1;
+    throw;
+  }
+
+  int ret=::close(fd);
+  fd=-1;
+
+  if (ret != 0)
+  {
+    throw GenTLException("RecordingWriter::close(): Cannot write file: "+name);
+  }
+}
+
+void RecordingWriter::emit(const void *data, size_t size)
+{
+  const uint8_t *p=reinterpret_cast<const uint8_t *>(data);
+
+  while (size > 0)
+  {
+    size_t n=std::min(size, staging.size()-staged);
+
+    memcpy(staging.data()+staged, p, n);
+    staged+=n;
+    p+=n;
+    size-=n;
+
+    // write full staging buffer, which always starts at an aligned position
+
+    if (staged == staging.size())
+    {
+      writeAll(staging.data(), staged);
+      written+=staged;
+      staged=0;
+    }
+  }
+}
+
+void RecordingWriter::writeAll(const uint8_t *data, size_t size)
+{
+  while (size > 0)
+  {
+    ssize_t n=::write(fd, data, size);
+
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+
+    if (n <= 0)
+    {
+      throw GenTLException("RecordingWriter: Cannot write file: "+name);
+    }
+
+    data+=n;
+    size-=static_cast<size_t>(n);
+  }
+}
+
+RecordingFrame::RecordingFrame(const std::shared_ptr<RecordingMapping> &_mapping,
+                               uint64_t _offset, uint32_t _absent)
+{
+  mapping=_mapping;
+  offset=_offset;
+  absent=_absent;
+}
+
+uint32_t RecordingFrame::getNumberOfParts() const
+{
+  return mapping->frame(offset)->nparts;
+}
+
+std::shared_ptr<const Image> RecordingFrame::getImage(uint32_t part) const
+{
+  const RecFrame *f=mapping->frame(offset);
+
+  if (!getImagePresent(part))
+  {
+    throw GenTLException("RecordingFrame::getImage(): No image available");
+  }
+
+  const RecPart &p=f->part[part];
+
+  return std::make_shared<Image>(shared_from_this(), getGlobalBase()+p.offset,
+                                 f->timestamp_ns, p.width, p.height, p.xoffset, p.yoffset,
+                                 p.xpadding, f->ypadding, f->frameid, p.pixelformat,
+                                 f->bigendian != 0);
+}
+
+bool RecordingFrame::getImagePresent(uint32_t part) const
+{
+  const RecFrame *f=mapping->frame(offset);
+  return part < f->nparts && f->part[part].image_present != 0 && (absent & (1u<<part)) == 0;
+}
+
+uint64_t RecordingFrame::getPixelFormat(uint32_t part) const
+{
+  const RecFrame *f=mapping->frame(offset);
+  return part < f->nparts ? f->part[part].pixelformat : 0;
+}
+
+uint64_t RecordingFrame::getPartSourceID(uint32_t part) const
+{
+  const RecFrame *f=mapping->frame(offset);
+  return part < f->nparts ? f->part[part].source_id : 0;
+}
+
+size_t RecordingFrame::getPartDataType(uint32_t part) const
+{
+  const RecFrame *f=mapping->frame(offset);
+  return part < f->nparts ? static_cast<size_t>(f->part[part].datatype) : 0;
+}
+
+uint64_t RecordingFrame::getTimestampNS() const
+{
+  return mapping->frame(offset)->timestamp_ns;
+}
+
+uint64_t RecordingFrame::getFrameID() const
+{
+  return mapping->frame(offset)->frameid;
+}
+
+size_t RecordingFrame::getPayloadType() const
+{
+  return static_cast<size_t>(mapping->frame(offset)->payload_type);
+}
+
+bool RecordingFrame::getIsIncomplete() const
+{
+  return mapping->frame(offset)->incomplete != 0;
+}
+
+bool RecordingFrame::getContainsChunkdata() const
+{
+  return mapping->frame(offset)->contains_chunkdata != 0;
+}
+
+uint64_t RecordingFrame::getChunkLayoutID() const
+{
+  return mapping->frame(offset)->chunk_layout_id;
+}
+
+const uint8_t *RecordingFrame::getGlobalBase() const
+{
+  return mapping->base+offset+mapping->frame(offset)->data_offset;
+}
+
+size_t RecordingFrame::getSizeFilled() const
+{
+  return static_cast<size_t>(mapping->frame(offset)->size_filled);
+}
+
+RecordingReader::RecordingReader(const std::string &name)
+{
+  int fd=::open(name.c_str(), O_RDONLY);
+
+  if (fd < 0)
+  {
+    throw GenTLException("RecordingReader::RecordingReader(): Cannot open file: "+name);
+  }
+
+  struct stat st;
+
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < REC_ALIGN)
+  {
+    ::close(fd);
+    throw GenTLException("RecordingReader::RecordingReader(): Invalid file: "+name);
+  }
+
+  mapping=std::make_shared<RecordingMapping>();
+  mapping->size=static_cast<size_t>(st.st_size);
+
+  void *p=mmap(0, mapping->size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+
+  if (p == MAP_FAILED)
+  {
+    throw GenTLException("RecordingReader::RecordingReader(): Cannot map file: "+name);
+  }
+
+  mapping->base=reinterpret_cast<const uint8_t *>(p);
+
+  const RecHeader *header=reinterpret_cast<const RecHeader *>(mapping->base);
+
+  if (header->magic != REC_MAGIC || header->version != REC_VERSION ||
+      header->align != REC_ALIGN)
+  {
+    throw GenTLException("RecordingReader::RecordingReader(): Invalid file: "+name);
+  }
+
+  // take the index from the end of the file if it is complete
+
+  const size_t size=mapping->size;
+  const RecTrailer *trailer=reinterpret_cast<const RecTrailer *>(mapping->base+size-
+                                                                  sizeof(RecTrailer));
+
+  // the number of frames is checked first, so that the size of the index
+  // cannot overflow
+
+  const uint64_t max_frames=(size-sizeof(RecTrailer))/sizeof(RecordingIndexEntry);
+
+  if (trailer->magic == REC_INDEX_MAGIC && trailer->version == REC_VERSION &&
+      trailer->nframes <= max_frames &&
+      trailer->index_offset == size-sizeof(RecTrailer)-trailer->nframes*sizeof(RecordingIndexEntry))
+  {
+    const RecordingIndexEntry *entry=reinterpret_cast<const RecordingIndexEntry *>(
+      mapping->base+trailer->index_offset);
+
+    index.assign(entry, entry+trailer->nframes);
+  }
+  else
+  {
+    // otherwise, scan all frames that have been written completely
+
+    size_t offset=REC_ALIGN;
+
+    while (offset+sizeof(RecFrame) <= size)
+    {
+      const RecFrame *f=mapping->frame(offset);
+
+      if (f->magic != REC_FRAME_MAGIC || f->record_size == 0 ||
+          f->record_size > size-offset)
+      {
+        break;
+      }
+
+      RecordingIndexEntry entry;
+      entry.offset=offset;
+      entry.timestamp_ns=f->timestamp_ns;
+      entry.frameid=f->frameid;
+
+      index.push_back(entry);
+
+      offset+=f->record_size;
+    }
+  }
+
+  // check all entries, so that frames can be accessed safely, images that do
+  // not fit into their part are treated as absent
+
+  absent.assign(index.size(), 0);
+
+  for (size_t i=0; i<index.size(); i++)
+  {
+    const uint64_t offset=index[i].offset;
+    const RecFrame *f=mapping->frame(offset);
+
+    bool valid=(offset <= size-sizeof(RecFrame) && f->magic == REC_FRAME_MAGIC &&
+                f->nparts <= REC_MAX_PARTS && f->record_size <= size-offset &&
+                f->data_offset <= f->record_size &&
+                f->size_filled <= f->record_size-f->data_offset);
+
+    for (uint32_t k=0; valid && k<f->nparts; k++)
+    {
+      const RecPart &p=f->part[k];
+      const uint64_t available=f->record_size-f->data_offset;
+
+      valid=(p.offset <= available && p.size <= available-p.offset);
+
+      if (valid && p.image_present != 0 && !isImageInPart(p, f->ypadding))
+      {
+        absent[i]|=1u<<k;
+      }
+    }
+
+    if (!valid)
+    {
+      throw GenTLException("RecordingReader::RecordingReader(): Invalid frame in file: "+name);
+    }
+  }
+}
+
+size_t RecordingReader::find(uint64_t timestamp) const
+{
+  return static_cast<size_t>(std::lower_bound(index.begin(), index.end(), timestamp,
+    [](const RecordingIndexEntry &e, uint64_t t) { return e.timestamp_ns < t; })-
+    index.begin());
+}
+
+std::shared_ptr<const RecordingFrame> RecordingReader::getFrame(size_t i) const
+{
+  if (i >= index.size())
+  {
+    throw GenTLException("RecordingReader::getFrame(): Index out of range");
+  }
+
+  return std::make_shared<RecordingFrame>(mapping, index[i].offset, absent[i]);
+}
+
+}
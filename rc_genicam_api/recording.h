@@ -0,0 +1,294 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_RECORDING
+#define RC_GENICAM_API_RECORDING
+
+#include "image.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rcg
+{
+
+struct RecordingMapping;
+
+/**
+  Entry of the index of a recording file.
+*/
+
+struct RecordingIndexEntry
+{
+  uint64_t offset;       // position of the frame in the file
+  uint64_t timestamp_ns; // timestamp of the frame
+  uint64_t frameid;      // frame ID
+};
+
+/**
+  The writer appends complete buffers, including meta data, part layout and
+  chunk data, to a raw recording file. Frames are padded to multiples of the
+  page size and collected in a large staging buffer, so that the file is
+  written in large aligned blocks. An index of all frames is appended when
+  the file is closed. Files that have not been closed properly can still be
+  read, since the reader then scans all frames.
+
+  NOTE: This class is only available under Linux. A GenTLException is thrown
+  in case of a severe error.
+*/
+
+class RecordingWriter
+{
+  public:
+
+    /**
+      Creates or replaces the recording file.
+
+      @param name        File name.
+      @param buffer_size Size of the staging buffer in bytes. It is rounded up
+                         to a multiple of the page size.
+    */
+
+    RecordingWriter(const std::string &name, size_t buffer_size=16*1024*1024);
+
+    /**
+      Closes the file, if this has not been done before.
+    */
+
+    ~RecordingWriter();
+
+    /**
+      Appends the given buffer. Images of incomplete buffers and images that
+      do not fit into the data of their part are recorded as not present,
+      while the data itself is recorded as received.
+
+      @param buffer Buffer.
+    */
+
+    void append(const Buffer *buffer);
+
+    /**
+      Writes all remaining data and the index and closes the file.
+    */
+
+    void close();
+
+    /**
+      Returns the number of frames that have been appended.
+
+      @return Number of frames.
+    */
+
+    uint64_t getNumFrames() const { return index.size(); }
+
+    /**
+      Returns the number of bytes that have been appended.
+
+      @return Number of bytes.
+    */
+
+    uint64_t getNumBytes() const { return written+staged; }
+
+  private:
+
+    RecordingWriter(class RecordingWriter &); // forbidden
+    RecordingWriter &operator=(const RecordingWriter &); // forbidden
+
+    void emit(const void *data, size_t size);
+    void writeAll(const uint8_t *data, size_t size);
+
+    std::string name;
+    int fd;
+    std::vector<uint8_t> staging;
+    size_t staged;
+    uint64_t written;
+    std::vector<RecordingIndexEntry> index;
+};
+
+/**
+  A frame of a recording. The images that are created from the frame refer
+  to the memory mapped file without copying. Images that do not fit into the
+  data of their part are reported as not present.
+*/
+
+class RecordingFrame : public std::enable_shared_from_this<RecordingFrame>
+{
+  public:
+
+    RecordingFrame(const std::shared_ptr<RecordingMapping> &mapping, uint64_t offset,
+                   uint32_t absent=0);
+
+    /**
+      Returns the number of parts of the frame. See
+      Buffer::getNumberOfParts().
+
+      @return Number of parts.
+    */
+
+    uint32_t getNumberOfParts() const;
+
+    /**
+      Returns a view onto the given part of the frame without copying. The
+      view keeps the file mapped.
+
+      NOTE: A GenTLException is thrown if the part does not contain an image.
+
+      @param part Part number.
+      @return     Image.
+    */
+
+    std::shared_ptr<const Image> getImage(uint32_t part) const;
+
+    bool getImagePresent(uint32_t part) const;
+    uint64_t getPixelFormat(uint32_t part) const;
+    uint64_t getPartSourceID(uint32_t part) const;
+    size_t getPartDataType(uint32_t part) const;
+
+    uint64_t getTimestampNS() const;
+    uint64_t getFrameID() const;
+    size_t getPayloadType() const;
+    bool getIsIncomplete() const;
+    bool getContainsChunkdata() const;
+    uint64_t getChunkLayoutID() const;
+
+    /**
+      Returns a pointer to the copy of the complete buffer, including chunk
+      data.
+
+      @return Pointer to buffer data.
+    */
+
+    const uint8_t *getGlobalBase() const;
+
+    /**
+      Returns the number of valid bytes of the complete buffer.
+
+      @return Size in bytes.
+    */
+
+    size_t getSizeFilled() const;
+
+  private:
+
+    RecordingFrame(class RecordingFrame &); // forbidden
+    RecordingFrame &operator=(const RecordingFrame &); // forbidden
+
+    std::shared_ptr<RecordingMapping> mapping;
+    uint64_t offset;
+    uint32_t absent;
+};
+
+/**
+  The reader maps a recording file into memory and provides random access to
+  all frames.
+
+  NOTE: This class is only available under Linux. A GenTLException is thrown
+  in case of a severe error.
+*/
+
+class RecordingReader
+{
+  public:
+
+    /**
+      Maps the given recording file.
+
+      @param name File name.
+    */
+
+    RecordingReader(const std::string &name);
+
+    /**
+      Returns the number of frames.
+
+      @return Number of frames.
+    */
+
+    size_t getNumFrames() const { return index.size(); }
+
+    /**
+      Returns the timestamp of the given frame without accessing the frame.
+
+      @param i Index of frame.
+      @return  Timestamp in nano seconds.
+    */
+
+    uint64_t getTimestampNS(size_t i) const { return index[i].timestamp_ns; }
+
+    /**
+      Returns the frame ID of the given frame without accessing the frame.
+
+      @param i Index of frame.
+      @return  Frame ID.
+    */
+
+    uint64_t getFrameID(size_t i) const { return index[i].frameid; }
+
+    /**
+      Returns the index of the first frame with a timestamp that is not older
+      than the given one. Timestamps are expected to increase within the
+      recording.
+
+      @param timestamp Timestamp in nano seconds.
+      @return          Index of frame or getNumFrames() if there is none.
+    */
+
+    size_t find(uint64_t timestamp) const;
+
+    /**
+      Returns the given frame.
+
+      NOTE: A GenTLException is thrown if the index is out of range.
+
+      @param i Index of frame.
+      @return  Frame.
+    */
+
+    std::shared_ptr<const RecordingFrame> getFrame(size_t i) const;
+
+  private:
+
+    RecordingReader(class RecordingReader &); // forbidden
+    RecordingReader &operator=(const RecordingReader &); // forbidden
+
+    std::shared_ptr<RecordingMapping> mapping;
+    std::vector<RecordingIndexEntry> index;
+    std::vector<uint32_t> absent;
+};
+
+}
+
+#endif
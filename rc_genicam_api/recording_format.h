@@ -0,0 +1,142 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_RECORDING_FORMAT
+#define RC_GENICAM_API_RECORDING_FORMAT
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+  Layout of raw recording files, as written by RecordingWriter. The definitions
+  are internal and shared with the replay GenTL producer, which reads the
+  files without depending on GenApi.
+*/
+
+namespace rcg
+{
+
+const uint32_t REC_MAGIC=0x52474352;       // "RCGR"
+const uint32_t REC_FRAME_MAGIC=0x46474352; // "RCGF"
+const uint32_t REC_INDEX_MAGIC=0x49474352; // "RCGI"
+const uint32_t REC_VERSION=1;
+const uint32_t REC_MAX_PARTS=8;
+const size_t REC_ALIGN=4096;
+const size_t REC_DATA_ALIGN=64;
+
+/**
+  Header at the beginning of the file, which is padded to REC_ALIGN.
+*/
+
+struct RecHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t align;
+  uint64_t reserved[6];
+};
+
+/**
+  Description of one part of a frame. The offset is relative to the data of
+  the frame.
+*/
+
+struct RecPart
+{
+  uint64_t offset;
+  uint64_t size;
+  uint64_t width;
+  uint64_t height;
+  uint64_t xoffset;
+  uint64_t yoffset;
+  uint64_t xpadding;
+  uint64_t pixelformat;
+  uint64_t source_id;
+  uint64_t datatype;
+  uint32_t image_present;
+  uint32_t reserved;
+};
+
+/**
+  Header of a frame. The data follows at the given offset and the next frame
+  starts after record_size bytes.
+*/
+
+struct RecFrame
+{
+  uint32_t magic;
+  uint32_t nparts;
+  uint64_t record_size;
+  uint64_t data_offset;
+  uint64_t timestamp_ns;
+  uint64_t frameid;
+  uint64_t payload_type;
+  uint64_t size_filled;
+  uint64_t ypadding;
+  uint64_t chunk_layout_id;
+  uint32_t bigendian;
+  uint32_t incomplete;
+  uint32_t contains_chunkdata;
+  uint32_t reserved;
+  RecPart part[REC_MAX_PARTS];
+};
+
+/**
+  Trailer at the end of the file, which follows the index.
+*/
+
+struct RecTrailer
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t nframes;
+  uint64_t index_offset;
+  uint64_t reserved;
+};
+
+/**
+  Entry of the index, which has the same layout as RecordingIndexEntry.
+*/
+
+struct RecIndexEntry
+{
+  uint64_t offset;
+  uint64_t timestamp_ns;
+  uint64_t frameid;
+};
+
+}
+
+#endif
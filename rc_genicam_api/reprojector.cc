@@ -0,0 +1,162 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "reprojector.h"
+
+#include "config.h"
+#include "exception.h"
+#include "pixel_formats.h"
+#include "thread_pool.h"
+
+#ifdef _WIN32
+#undef min
+#undef max
+#endif
+
+namespace rcg
+{
+
+Reprojector::Reprojector()
+{
+  f=0;
+  t=0;
+  u=0;
+  v=0;
+  scale=0;
+  offset=0;
+  inv=-1;
+
+  factor.assign(65536, 0.0f);
+}
+
+void Reprojector::setParameters(double _f, double _t, double _u, double _v, double _scale,
+                                double _offset, int _inv)
+{
+  const bool update=(_f != f || _t != t || _scale != scale || _offset != offset || _inv != inv);
+
+  f=_f;
+  t=_t;
+  u=_u;
+  v=_v;
+  scale=_scale;
+  offset=_offset;
+  inv=_inv;
+
+  if (update)
+  {
+    for (int c=0; c<65536; c++)
+    {
+      const double d=scale*c+offset;
+
+      factor[static_cast<size_t>(c)]=0;
+
+      if (d > 0 && c != inv)
+      {
+        factor[static_cast<size_t>(c)]=static_cast<float>(t/d);
+      }
+    }
+  }
+}
+
+void Reprojector::setParameters(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap)
+{
+  setEnum(nodemap, "ChunkComponentSelector", "Disparity", false);
+
+  int _inv=-1;
+
+  if (getBoolean(nodemap, "ChunkScan3dInvalidDataFlag"))
+  {
+    _inv=static_cast<int>(getFloat(nodemap, "ChunkScan3dInvalidDataValue"));
+  }
+
+  setParameters(getFloat(nodemap, "ChunkScan3dFocalLength", 0, 0, true),
+                getFloat(nodemap, "ChunkScan3dBaseline", 0, 0, true),
+                getFloat(nodemap, "ChunkScan3dPrincipalPointU", 0, 0, true),
+                getFloat(nodemap, "ChunkScan3dPrincipalPointV", 0, 0, true),
+                getFloat(nodemap, "ChunkScan3dCoordinateScale", 0, 0, true),
+                getFloat(nodemap, "ChunkScan3dCoordinateOffset"), _inv);
+}
+
+void Reprojector::reprojectRow(float *xyz, const uint8_t *row, bool bigendian, size_t width,
+                               size_t k, float invalid) const
+{
+  const float fy=static_cast<float>(k+0.5-v);
+  const float fz=static_cast<float>(f);
+  const float x0=static_cast<float>(0.5-u);
+
+  // the index of the byte order is selected outside of the loop
+
+  const size_t lo=bigendian ? 1 : 0;
+  const size_t hi=1-lo;
+
+  for (size_t i=0; i<width; i++)
+  {
+    const float q=factor[static_cast<size_t>((row[2*i+hi]<<8)|row[2*i+lo])];
+
+    if (q != 0)
+    {
+      xyz[0]=(static_cast<float>(i)+x0)*q;
+      xyz[1]=fy*q;
+      xyz[2]=fz*q;
+    }
+    else
+    {
+      xyz[0]=xyz[1]=xyz[2]=invalid;
+    }
+
+    xyz+=3;
+  }
+}
+
+void Reprojector::reproject(float *xyz, const Image &disp, float invalid, size_t nthreads) const
+{
+  if (disp.getPixelFormat() != Coord3D_C16)
+  {
+    throw GenTLException("Reprojector::reproject(): Format Coord3D_C16 expected");
+  }
+
+  const size_t width=disp.getWidth();
+  const size_t height=disp.getHeight();
+  const size_t dstep=width*sizeof(uint16_t)+disp.getXPadding();
+  const uint8_t *dps=disp.getPixels();
+  const bool bigendian=disp.isBigEndian();
+
+  ThreadPool::getInstance().parallelFor(height, nthreads, [&](size_t k)
+  {
+    reprojectRow(xyz+3*width*k, dps+k*dstep, bigendian, width, k, invalid);
+  });
+}
+
+}
@@ -0,0 +1,162 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_REPROJECTOR
+#define RC_GENICAM_API_REPROJECTOR
+
+#include "image.h"
+
+#include <GenApi/GenApi.h>
+
+#include <memory>
+#include <vector>
+#include <limits>
+
+namespace rcg
+{
+
+/**
+  Reprojection of disparity images in format Coord3D_C16 into 3D points. The
+  disparity d of a pixel is computed from the 16 bit value c as d=scale*c+offset.
+  The 3D point of the pixel in column i and row k is computed as
+
+    x=(i+0.5-u)*t/d, y=(k+0.5-v)*t/d, z=f*t/d
+
+  with f as focal length in pixels, t as baseline in m and u, v as principal
+  point in pixels, relative to the upper left corner of the image.
+
+  The factor t/d is precomputed for all possible 16 bit values when the
+  parameters are set, so that reprojection is reduced to a table lookup and
+  multiplications. The object should be kept and reused for all images with
+  the same parameters.
+*/
+
+class Reprojector
+{
+  public:
+
+    Reprojector();
+
+    /**
+      Sets the reprojection parameters. The lookup table is only recomputed if
+      f, t, scale, offset or inv changed.
+
+      @param f      Focal length in pixels of the disparity image.
+      @param t      Baseline in m.
+      @param u      Horizontal position of principal point in pixels.
+      @param v      Vertical position of principal point in pixels.
+      @param scale  Disparity scale factor.
+      @param offset Disparity offset.
+      @param inv    16 bit value that marks invalid disparities or -1 if there
+                    is no special value. Disparities <= 0 are always invalid.
+    */
+
+    void setParameters(double f, double t, double u, double v, double scale,
+                       double offset=0, int inv=-1);
+
+    /**
+      Sets the reprojection parameters from the ChunkScan3d parameters of the
+      disparity component. The chunk adapter must have been attached to the
+      nodemap and the chunk data of the current buffer must contain the
+      disparity image.
+
+      NOTE: An exception that is based on std::exception is thrown if the
+      parameters are not available.
+
+      @param nodemap Nodemap with chunk parameters.
+    */
+
+    void setParameters(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap);
+
+    double getFocalLength() const { return f; }
+    double getBaseline() const { return t; }
+    double getPrincipalPointU() const { return u; }
+    double getPrincipalPointV() const { return v; }
+    double getScale() const { return scale; }
+    double getOffset() const { return offset; }
+    int getInvalidValue() const { return inv; }
+
+    /**
+      Returns the factor t/d for the given 16 bit disparity value or 0 if the
+      disparity is invalid.
+
+      @param c 16 bit disparity value.
+      @return  Factor t/d.
+    */
+
+    float getFactor(uint16_t c) const { return factor[c]; }
+
+    /**
+      Reprojects one row of a disparity image.
+
+      @param xyz       Output array of 3*width values.
+      @param row       Pointer to first 16 bit value of row.
+      @param bigendian True if the values are in big endian byte order.
+      @param width     Number of pixels in the row.
+      @param k         Index of row in the image.
+      @param invalid   Value that is stored for x, y and z of invalid pixels.
+    */
+
+    void reprojectRow(float *xyz, const uint8_t *row, bool bigendian, size_t width, size_t k,
+                      float invalid=std::numeric_limits<float>::quiet_NaN()) const;
+
+    /**
+      Reprojects a disparity image.
+
+      NOTE: An exception that is based on std::exception is thrown if the
+      image is not in format Coord3D_C16.
+
+      @param xyz      Output array of 3*width*height values.
+      @param disp     Disparity image.
+      @param invalid  Value that is stored for x, y and z of invalid pixels.
+      @param nthreads Number of threads for processing rows in parallel. 0
+                      means that the number of cores is used.
+    */
+
+    void reproject(float *xyz, const Image &disp,
+                   float invalid=std::numeric_limits<float>::quiet_NaN(),
+                   size_t nthreads=1) const;
+
+  private:
+
+    double f, t, u, v, scale, offset;
+    int inv;
+
+    std::vector<float> factor;
+};
+
+}
+
+#endif
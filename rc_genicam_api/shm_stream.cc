@@ -0,0 +1,688 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "shm_stream.h"
+#include "stream.h"
+
+#include "exception.h"
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+
+namespace rcg
+{
+
+namespace
+{
+
+const uint32_t SHM_MAGIC=0x53474352; // "RCGS"
+const uint32_t SHM_VERSION=2;
+const uint32_t SHM_MAX_PARTS=8;
+const uint32_t SHM_MAX_READERS=16;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "Atomics must be lock free for sharing them between processes");
+
+/**
+  Header at the beginning of the shared memory object.
+*/
+
+struct ShmHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t nslots;
+  uint32_t reserved;
+  uint64_t slot_size;
+  uint64_t slot_stride;
+  uint64_t data_offset;
+  std::atomic<uint64_t> published;
+  std::atomic<uint64_t> dropped;
+  std::atomic<uint64_t> recovered;
+};
+
+/**
+  Description of one part of a buffer. The offset is relative to the data of
+  the slot.
+*/
+
+struct ShmPart
+{
+  uint64_t offset;
+  uint64_t size;
+  uint64_t width;
+  uint64_t height;
+  uint64_t xoffset;
+  uint64_t yoffset;
+  uint64_t xpadding;
+  uint64_t pixelformat;
+  uint64_t source_id;
+  uint64_t datatype;
+  uint32_t image_present;
+  uint32_t reserved;
+};
+
+/**
+  Description of a slot. The sequence number is 0 while the slot is written
+  or empty. Readers enter their process id into a free reader entry while
+  they hold the slot, so that the publisher can recover slots of readers
+  that have died.
+*/
+
+struct ShmSlot
+{
+  std::atomic<uint64_t> seq;
+  std::atomic<int32_t> reader[SHM_MAX_READERS];
+  uint32_t nparts;
+  uint64_t timestamp_ns;
+  uint64_t frameid;
+  uint64_t payload_type;
+  uint64_t size_filled;
+  uint64_t ypadding;
+  uint64_t chunk_layout_id;
+  uint32_t bigendian;
+  uint32_t incomplete;
+  uint32_t contains_chunkdata;
+  uint32_t reserved;
+  ShmPart part[SHM_MAX_PARTS];
+};
+
+inline size_t roundUp(size_t v, size_t a)
+{
+  return (v+a-1)/a*a;
+}
+
+/*
+  Returns true if the slot is held by a living reader. Entries of processes
+  that do not exist anymore are cleared and counted as recovered.
+*/
+
+bool isHeld(ShmHeader *header, ShmSlot *slot)
+{
+  bool ret=false;
+
+  for (uint32_t i=0; i<SHM_MAX_READERS; i++)
+  {
+    int32_t pid=slot->reader[i].load();
+
+    if (pid != 0)
+    {
+      if (kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH)
+      {
+        if (slot->reader[i].compare_exchange_strong(pid, 0))
+        {
+          header->recovered++;
+        }
+      }
+      else
+      {
+        ret=true;
+      }
+    }
+  }
+
+  return ret;
+}
+
+/*
+  Enters the process id into a free reader entry of the slot. The index of
+  the entry is returned or SHM_MAX_READERS if all entries are used.
+*/
+
+uint32_t holdSlot(ShmSlot *slot)
+{
+  const int32_t pid=static_cast<int32_t>(getpid());
+
+  for (uint32_t i=0; i<SHM_MAX_READERS; i++)
+  {
+    int32_t expected=0;
+
+    if (slot->reader[i].compare_exchange_strong(expected, pid))
+    {
+      return i;
+    }
+  }
+
+  return SHM_MAX_READERS;
+}
+
+}
+
+/**
+  Mapping of the shared memory object that is shared by the publisher or
+  subscriber and all frames.
+*/
+
+struct ShmMapping
+{
+  uint8_t *base;
+  size_t size;
+
+  ShmMapping() : base(0), size(0) { }
+
+  ~ShmMapping()
+  {
+    if (base != 0)
+    {
+      munmap(base, size);
+    }
+  }
+
+  ShmHeader *header() const
+  {
+    return reinterpret_cast<ShmHeader *>(base);
+  }
+
+  ShmSlot *slot(uint32_t i) const
+  {
+    return reinterpret_cast<ShmSlot *>(base+sizeof(ShmHeader)+i*sizeof(ShmSlot));
+  }
+
+  uint8_t *data(uint32_t i) const
+  {
+    return base+header()->data_offset+i*header()->slot_stride;
+  }
+};
+
+ShmPublisher::ShmPublisher(const std::string &_name, size_t nslots, size_t slot_size)
+{
+  name=_name;
+  next=0;
+  cb_id=0;
+
+  if (nslots == 0)
+  {
+    throw GenTLException("ShmPublisher::ShmPublisher(): Number of slots must not be 0");
+  }
+
+  // compute layout with page aligned data of all slots
+
+  const size_t page=static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  const size_t data_offset=roundUp(sizeof(ShmHeader)+nslots*sizeof(ShmSlot), page);
+  const size_t slot_stride=roundUp(slot_size, page);
+
+  mapping=std::make_shared<ShmMapping>();
+  mapping->size=data_offset+nslots*slot_stride;
+
+  // create shared memory object and map it
+
+  shm_unlink(name.c_str());
+
+  int fd=shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+
+  if (fd < 0)
+  {
+    throw GenTLException("ShmPublisher::ShmPublisher(): Cannot create shared memory: "+name);
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(mapping->size)) != 0)
+  {
+    ::close(fd);
+    shm_unlink(name.c_str());
+    throw GenTLException("ShmPublisher::ShmPublisher(): Cannot set size of shared memory: "+name);
+  }
+
+  void *p=mmap(0, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+
+  if (p == MAP_FAILED)
+  {
+    shm_unlink(name.c_str());
+    throw GenTLException("ShmPublisher::ShmPublisher(): Cannot map shared memory: "+name);
+  }
+
+  mapping->base=reinterpret_cast<uint8_t *>(p);
+
+  // initialize header and slots, the magic number is written last
+
+  ShmHeader *header=new (mapping->base) ShmHeader();
+
+  header->version=SHM_VERSION;
+  header->nslots=static_cast<uint32_t>(nslots);
+  header->reserved=0;
+  header->slot_size=slot_stride;
+  header->slot_stride=slot_stride;
+  header->data_offset=data_offset;
+  header->published=0;
+  header->dropped=0;
+  header->recovered=0;
+
+  for (uint32_t i=0; i<header->nslots; i++)
+  {
+    ShmSlot *slot=new (mapping->slot(i)) ShmSlot();
+
+    slot->seq=0;
+
+    for (uint32_t k=0; k<SHM_MAX_READERS; k++)
+    {
+      slot->reader[k]=0;
+    }
+
+    slot->nparts=0;
+  }
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  header->magic=SHM_MAGIC;
+}
+
+ShmPublisher::~ShmPublisher()
+{
+  try
+  {
+    disconnect();
+  }
+  catch (...) // do not throw exceptions in destructor
+  { }
+
+  shm_unlink(name.c_str());
+}
+
+bool ShmPublisher::publish(const Buffer *buffer)
+{
+  ShmHeader *header=mapping->header();
+
+  // check that the buffer fits into a slot
+
+  const uint8_t *gbase=reinterpret_cast<const uint8_t *>(buffer->getGlobalBase());
+  const size_t gsize=buffer->getSizeFilled();
+  const uint32_t nparts=std::min(buffer->getNumberOfParts(), SHM_MAX_PARTS);
+
+  size_t total=gsize;
+
+  for (uint32_t i=0; i<nparts; i++)
+  {
+    const uint8_t *base=reinterpret_cast<const uint8_t *>(buffer->getBase(i));
+
+    if (base < gbase || base >= gbase+gsize)
+    {
+      total+=buffer->getSize(i);
+    }
+  }
+
+  if (gbase == 0 || total > header->slot_size)
+  {
+    header->dropped++;
+    return false;
+  }
+
+  // find next slot that is not held by a living reader, the sequence number
+  // is cleared before checking the readers, so that readers that come later
+  // cannot get hold of the slot
+
+  ShmSlot *slot=0;
+  uint32_t si=0;
+
+  for (uint32_t k=0; k<header->nslots && slot == 0; k++)
+  {
+    si=(next+k)%header->nslots;
+
+    ShmSlot *s=mapping->slot(si);
+    uint64_t old=s->seq.exchange(0);
+
+    if (!isHeld(header, s))
+    {
+      slot=s;
+    }
+    else
+    {
+      s->seq.store(old);
+    }
+  }
+
+  if (slot == 0)
+  {
+    header->dropped++;
+    return false;
+  }
+
+  next=(si+1)%header->nslots;
+
+  // copy buffer, parts that are outside of the global buffer are appended
+
+  uint8_t *data=mapping->data(si);
+
+  memcpy(data, gbase, gsize);
+
+  size_t offset=gsize;
+
+  slot->nparts=nparts;
+
+  for (uint32_t i=0; i<nparts; i++)
+  {
+    ShmPart &part=slot->part[i];
+    const uint8_t *base=reinterpret_cast<const uint8_t *>(buffer->getBase(i));
+
+    part.size=buffer->getSize(i);
+
+    if (base >= gbase && base < gbase+gsize)
+    {
+      part.offset=static_cast<uint64_t>(base-gbase);
+      part.size=std::min(static_cast<size_t>(part.size), gsize-static_cast<size_t>(part.offset));
+    }
+    else
+    {
+      memcpy(data+offset, base, part.size);
+      part.offset=offset;
+      offset+=part.size;
+    }
+
+    part.width=buffer->getWidth(i);
+    part.height=buffer->getHeight(i);
+    part.xoffset=buffer->getXOffset(i);
+    part.yoffset=buffer->getYOffset(i);
+    part.xpadding=buffer->getXPadding(i);
+    part.pixelformat=buffer->getPixelFormat(i);
+    part.source_id=buffer->getPartSourceID(i);
+    part.datatype=buffer->getPartDataType(i);
+    part.image_present=buffer->getImagePresent(i) ? 1 : 0;
+  }
+
+  slot->timestamp_ns=buffer->getTimestampNS();
+  slot->frameid=buffer->getFrameID();
+  slot->payload_type=buffer->getPayloadType();
+  slot->size_filled=gsize;
+  slot->ypadding=buffer->getYPadding();
+  slot->chunk_layout_id=buffer->getChunkLayoutID();
+  slot->bigendian=buffer->isBigEndian() ? 1 : 0;
+  slot->incomplete=buffer->getIsIncomplete() ? 1 : 0;
+  slot->contains_chunkdata=buffer->getContainsChunkdata() ? 1 : 0;
+
+  // make slot visible to the readers
+
+  const uint64_t seq=header->published.load()+1;
+
+  slot->seq.store(seq);
+  header->published.store(seq);
+
+  return true;
+}
+
+void ShmPublisher::connect(const std::shared_ptr<Stream> &_stream)
+{
+  disconnect();
+
+  stream=_stream;
+  cb_id=stream->addBufferCallback([this](const std::shared_ptr<const Buffer> &buffer)
+    {
+      publish(buffer.get());
+    });
+}
+
+void ShmPublisher::disconnect()
+{
+  if (stream)
+  {
+    stream->removeBufferCallback(cb_id);
+    stream.reset();
+  }
+}
+
+uint64_t ShmPublisher::getNumPublished() const
+{
+  return mapping->header()->published.load();
+}
+
+uint64_t ShmPublisher::getNumDropped() const
+{
+  return mapping->header()->dropped.load();
+}
+
+uint64_t ShmPublisher::getNumRecovered() const
+{
+  return mapping->header()->recovered.load();
+}
+
+ShmFrame::ShmFrame(const std::shared_ptr<ShmMapping> &_mapping, uint32_t _slot,
+                   uint32_t _entry)
+{
+  mapping=_mapping;
+  slot=_slot;
+  entry=_entry;
+  seq=mapping->slot(slot)->seq.load();
+}
+
+ShmFrame::~ShmFrame()
+{
+  mapping->slot(slot)->reader[entry].store(0);
+}
+
+uint32_t ShmFrame::getNumberOfParts() const
+{
+  return mapping->slot(slot)->nparts;
+}
+
+std::shared_ptr<const Image> ShmFrame::getImage(uint32_t part) const
+{
+  const ShmSlot *s=mapping->slot(slot);
+
+  if (part >= s->nparts || s->part[part].image_present == 0)
+  {
+    throw GenTLException("ShmFrame::getImage(): No image available");
+  }
+
+  const ShmPart &p=s->part[part];
+
+  return std::make_shared<Image>(shared_from_this(), mapping->data(slot)+p.offset,
+                                 s->timestamp_ns, p.width, p.height, p.xoffset, p.yoffset,
+                                 p.xpadding, s->ypadding, s->frameid, p.pixelformat,
+                                 s->bigendian != 0);
+}
+
+bool ShmFrame::getImagePresent(uint32_t part) const
+{
+  const ShmSlot *s=mapping->slot(slot);
+  return part < s->nparts && s->part[part].image_present != 0;
+}
+
+uint64_t ShmFrame::getPixelFormat(uint32_t part) const
+{
+  const ShmSlot *s=mapping->slot(slot);
+  return part < s->nparts ? s->part[part].pixelformat : 0;
+}
+
+uint64_t ShmFrame::getPartSourceID(uint32_t part) const
+{
+  const ShmSlot *s=mapping->slot(slot);
+  return part < s->nparts ? s->part[part].source_id : 0;
+}
+
+size_t ShmFrame::getPartDataType(uint32_t part) const
+{
+  const ShmSlot *s=mapping->slot(slot);
+  return part < s->nparts ? static_cast<size_t>(s->part[part].datatype) : 0;
+}
+
+uint64_t ShmFrame::getTimestampNS() const
+{
+  return mapping->slot(slot)->timestamp_ns;
+}
+
+uint64_t ShmFrame::getFrameID() const
+{
+  return mapping->slot(slot)->frameid;
+}
+
+size_t ShmFrame::getPayloadType() const
+{
+  return static_cast<size_t>(mapping->slot(slot)->payload_type);
+}
+
+bool ShmFrame::getIsIncomplete() const
+{
+  return mapping->slot(slot)->incomplete != 0;
+}
+
+bool ShmFrame::getContainsChunkdata() const
+{
+  return mapping->slot(slot)->contains_chunkdata != 0;
+}
+
+uint64_t ShmFrame::getChunkLayoutID() const
+{
+  return mapping->slot(slot)->chunk_layout_id;
+}
+
+const uint8_t *ShmFrame::getGlobalBase() const
+{
+  return mapping->data(slot);
+}
+
+size_t ShmFrame::getSizeFilled() const
+{
+  return static_cast<size_t>(mapping->slot(slot)->size_filled);
+}
+
+ShmSubscriber::ShmSubscriber(const std::string &name)
+{
+  last=0;
+  skipped=0;
+
+  int fd=shm_open(name.c_str(), O_RDWR, 0);
+
+  if (fd < 0)
+  {
+    throw GenTLException("ShmSubscriber::ShmSubscriber(): Cannot open shared memory: "+name);
+  }
+
+  struct stat st;
+
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmHeader))
+  {
+    ::close(fd);
+    throw GenTLException("ShmSubscriber::ShmSubscriber(): Invalid shared memory: "+name);
+  }
+
+  mapping=std::make_shared<ShmMapping>();
+  mapping->size=static_cast<size_t>(st.st_size);
+
+  void *p=mmap(0, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+
+  if (p == MAP_FAILED)
+  {
+    throw GenTLException("ShmSubscriber::ShmSubscriber(): Cannot map shared memory: "+name);
+  }
+
+  mapping->base=reinterpret_cast<uint8_t *>(p);
+
+  const ShmHeader *header=mapping->header();
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (header->magic != SHM_MAGIC || header->version != SHM_VERSION ||
+      header->data_offset+header->nslots*header->slot_stride > mapping->size)
+  {
+    throw GenTLException("ShmSubscriber::ShmSubscriber(): Invalid shared memory: "+name);
+  }
+
+  // start with the frames that are published from now on
+
+  last=header->published.load();
+}
+
+std::shared_ptr<const ShmFrame> ShmSubscriber::grab(int64_t timeout)
+{
+  ShmHeader *header=mapping->header();
+
+  std::chrono::steady_clock::time_point end=std::chrono::steady_clock::now()+
+    std::chrono::milliseconds(timeout);
+
+  while (true)
+  {
+    if (header->published.load() > last)
+    {
+      // find slot with the oldest frame that is newer than the last one
+
+      uint32_t si=header->nslots;
+      uint64_t seq=0;
+
+      for (uint32_t i=0; i<header->nslots; i++)
+      {
+        uint64_t s=mapping->slot(i)->seq.load();
+
+        if (s > last && (seq == 0 || s < seq))
+        {
+          si=i;
+          seq=s;
+        }
+      }
+
+      // hold slot and check that it has not been overwritten in the meantime
+
+      if (si < header->nslots)
+      {
+        ShmSlot *slot=mapping->slot(si);
+        uint32_t entry=holdSlot(slot);
+
+        if (entry < SHM_MAX_READERS)
+        {
+          if (slot->seq.load() == seq)
+          {
+            skipped+=seq-last-1;
+            last=seq;
+
+            return std::make_shared<ShmFrame>(mapping, si, entry);
+          }
+
+          slot->reader[entry].store(0);
+          continue;
+        }
+      }
+    }
+
+    if (timeout >= 0 && std::chrono::steady_clock::now() >= end)
+    {
+      break;
+    }
+
+    // the publisher does not signal new frames, so that it never depends on
+    // readers, therefore readers poll
+
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  }
+
+  return std::shared_ptr<const ShmFrame>();
+}
+
+}
@@ -0,0 +1,289 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_SHM_STREAM
+#define RC_GENICAM_API_SHM_STREAM
+
+#include "image.h"
+
+#include <memory>
+#include <string>
+
+namespace rcg
+{
+
+class Stream;
+struct ShmMapping;
+
+/**
+  The publisher writes complete buffers, including meta data, part layout
+  and chunk data, into a ring of slots in a named POSIX shared memory object.
+  Several processes can then read the buffers with ShmSubscriber, while only
+  the publishing process opens the device.
+
+  Readers hold slots while they access them. The publisher skips slots that
+  are held and drops a buffer if all slots are held or if the buffer is
+  larger than a slot.
+
+  Readers register their process id in the slot that they hold. If a reader
+  process dies while holding a slot, the publisher recovers the slot as soon
+  as it finds that the process does not exist anymore. Up to 16 frames can
+  hold the same slot at the same time. Since recovery is based on process
+  ids, a slot of a dead reader is only released after the process that
+  reused its id has terminated as well, which is rare in practice.
+
+  NOTE: This class is only available under Linux. A GenTLException is thrown
+  in case of a severe error.
+*/
+
+class ShmPublisher
+{
+  public:
+
+    /**
+      Creates or replaces the shared memory object.
+
+      @param name      Name of the shared memory object, e.g. "/rcg_camera".
+      @param nslots    Number of slots of the ring.
+      @param slot_size Maximum size of a buffer in bytes.
+    */
+
+    ShmPublisher(const std::string &name, size_t nslots, size_t slot_size);
+
+    /**
+      Disconnects from the stream and removes the shared memory object.
+      Readers that have mapped it can continue to read the last buffers.
+    */
+
+    ~ShmPublisher();
+
+    /**
+      Copies the given buffer into the next free slot.
+
+      @param buffer Buffer.
+      @return       False if the buffer has been dropped.
+    */
+
+    bool publish(const Buffer *buffer);
+
+    /**
+      Registers a callback at the given stream, so that all buffers that are
+      received by the acquisition thread of the stream are published (see
+      Stream::startAcquisitionThread()). An existing connection is removed.
+
+      @param stream Stream.
+    */
+
+    void connect(const std::shared_ptr<Stream> &stream);
+
+    /**
+      Removes the callback from the stream.
+    */
+
+    void disconnect();
+
+    /**
+      Returns the number of published buffers.
+
+      @return Number of published buffers.
+    */
+
+    uint64_t getNumPublished() const;
+
+    /**
+      Returns the number of dropped buffers.
+
+      @return Number of dropped buffers.
+    */
+
+    uint64_t getNumDropped() const;
+
+    /**
+      Returns the number of reader entries that have been recovered, because
+      the reader process died while holding a slot.
+
+      @return Number of recovered reader entries.
+    */
+
+    uint64_t getNumRecovered() const;
+
+  private:
+
+    ShmPublisher(class ShmPublisher &); // forbidden
+    ShmPublisher &operator=(const ShmPublisher &); // forbidden
+
+    std::string name;
+    std::shared_ptr<ShmMapping> mapping;
+    uint32_t next;
+
+    std::shared_ptr<Stream> stream;
+    int cb_id;
+};
+
+/**
+  A frame that is held by a subscriber. The slot is released again when the
+  last reference to the frame and the images that have been created from it
+  are destroyed.
+*/
+
+class ShmFrame : public std::enable_shared_from_this<ShmFrame>
+{
+  public:
+
+    ShmFrame(const std::shared_ptr<ShmMapping> &mapping, uint32_t slot, uint32_t entry);
+    ~ShmFrame();
+
+    /**
+      Returns the sequence number that the publisher has given to the frame.
+
+      @return Sequence number, starting at 1.
+    */
+
+    uint64_t getSequence() const { return seq; }
+
+    /**
+      Returns the number of parts of the frame. See
+      Buffer::getNumberOfParts().
+
+      @return Number of parts.
+    */
+
+    uint32_t getNumberOfParts() const;
+
+    /**
+      Returns a view onto the given part of the frame without copying. The
+      view keeps the frame and therefore the slot.
+
+      NOTE: A GenTLException is thrown if the part does not contain an image.
+
+      @param part Part number.
+      @return     Image.
+    */
+
+    std::shared_ptr<const Image> getImage(uint32_t part) const;
+
+    bool getImagePresent(uint32_t part) const;
+    uint64_t getPixelFormat(uint32_t part) const;
+    uint64_t getPartSourceID(uint32_t part) const;
+    size_t getPartDataType(uint32_t part) const;
+
+    uint64_t getTimestampNS() const;
+    uint64_t getFrameID() const;
+    size_t getPayloadType() const;
+    bool getIsIncomplete() const;
+    bool getContainsChunkdata() const;
+    uint64_t getChunkLayoutID() const;
+
+    /**
+      Returns a pointer to the copy of the complete buffer, including chunk
+      data.
+
+      @return Pointer to buffer data.
+    */
+
+    const uint8_t *getGlobalBase() const;
+
+    /**
+      Returns the number of valid bytes of the complete buffer.
+
+      @return Size in bytes.
+    */
+
+    size_t getSizeFilled() const;
+
+  private:
+
+    ShmFrame(class ShmFrame &); // forbidden
+    ShmFrame &operator=(const ShmFrame &); // forbidden
+
+    std::shared_ptr<ShmMapping> mapping;
+    uint32_t slot;
+    uint32_t entry;
+    uint64_t seq;
+};
+
+/**
+  The subscriber maps the shared memory object of a publisher and provides
+  the published frames without copying them.
+
+  NOTE: This class is only available under Linux. A GenTLException is thrown
+  in case of a severe error.
+*/
+
+class ShmSubscriber
+{
+  public:
+
+    /**
+      Maps the shared memory object that has been created by a publisher.
+
+      @param name Name of the shared memory object.
+    */
+
+    ShmSubscriber(const std::string &name);
+
+    /**
+      Waits for the next frame that has been published after the frame that
+      has been returned last. If the subscriber is too slow, then older frames
+      are skipped.
+
+      @param timeout Timeout in ms. A value < 0 sets waiting time to infinite.
+      @return        Frame or empty pointer in case of timeout.
+    */
+
+    std::shared_ptr<const ShmFrame> grab(int64_t timeout=-1);
+
+    /**
+      Returns the number of frames that have been skipped, because they have
+      been overwritten before they could be read.
+
+      @return Number of skipped frames.
+    */
+
+    uint64_t getNumSkipped() const { return skipped; }
+
+  private:
+
+    ShmSubscriber(class ShmSubscriber &); // forbidden
+    ShmSubscriber &operator=(const ShmSubscriber &); // forbidden
+
+    std::shared_ptr<ShmMapping> mapping;
+    uint64_t last;
+    uint64_t skipped;
+};
+
+}
+
+#endif
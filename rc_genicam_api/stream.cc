@@ -42,6 +42,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <chrono>
 
 #ifdef _WIN32
 #undef min
@@ -63,12 +64,28 @@ Stream::Stream(const std::shared_ptr<Device> &_parent,
   stream=0;
   event=0;
   bn=0;
+  bn_max=0;
+  buffer_size=0;
+  buffer_alignment=0;
+
+  generation=0;
+  lease_warning=false;
+
+  acq_running=false;
+
+  queue_head=0;
+  queue_count=0;
+  queue_policy=DROP_OLDEST;
+  queue_dropped=0;
+
+  cb_id=0;
 }
 
 Stream::~Stream()
 {
   try
   {
+    stopAcquisitionThread();
     stopStreaming();
   }
   catch (...) // do not throw exceptions in destructor
@@ -120,6 +137,20 @@ void Stream::open()
 
 void Stream::close()
 {
+  // the acquisition thread must be stopped before locking the stream
+
+  bool stop=false;
+
+  {
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+    stop=(n_open == 1);
+  }
+
+  if (stop)
+  {
+    stopAcquisitionThread();
+  }
+
   std::lock_guard<std::recursive_mutex> lock(mtx);
 
   if (n_open > 0)
@@ -148,14 +179,14 @@ void Stream::close()
   }
 }
 
-void Stream::attachBuffers(bool enable)
+void Stream::attachBuffers(bool enable, bool lazy)
 {
   if (enable)
   {
     if (parent->getHandle() != 0)
     {
       std::shared_ptr<GenApi::CNodeMapRef> rnodemap=parent->getRemoteNodeMap();
-      buffer.setNodemap(rnodemap, parent->getTLType());
+      buffer.setNodemap(rnodemap, parent->getTLType(), lazy);
     }
   }
   else
@@ -164,6 +195,12 @@ void Stream::attachBuffers(bool enable)
   }
 }
 
+void Stream::setBufferAllocator(const std::shared_ptr<BufferAllocator> &_allocator)
+{
+  std::lock_guard<std::recursive_mutex> lock(mtx);
+  allocator=_allocator;
+}
+
 void Stream::startStreaming(int nacquire)
 {
   startStreaming(nacquire, 4);
@@ -171,6 +208,13 @@ void Stream::startStreaming(int nacquire)
 
 void Stream::startStreaming(int nacquire, int min_buffers)
 {
+  startStreaming(nacquire, min_buffers, min_buffers);
+}
+
+void Stream::startStreaming(int nacquire, int min_buffers, int max_buffers)
+{
+  stopAcquisitionThread();
+
   std::lock_guard<std::recursive_mutex> lock(mtx);
 
   buffer.setHandle(0);
@@ -218,18 +262,26 @@ void Stream::startStreaming(int nacquire, int min_buffers)
 
   bool err=false;
 
-  bn=std::max(static_cast<size_t>(min_buffers), getBufAnnounceMin());
-  for (size_t i=0; i<bn; i++)
-  {
-    GenTL::BUFFER_HANDLE pp=0;
+  const size_t nb=std::max(static_cast<size_t>(std::max(min_buffers, 0)), getBufAnnounceMin());
 
-    if (gentl->DSAllocAndAnnounceBuffer(stream, size, 0, &pp) != GenTL::GC_ERR_SUCCESS)
-    {
-      err=true;
-      break;
-    }
+  bn=0;
+  bn_max=std::max(nb, static_cast<size_t>(std::max(max_buffers, 0)));
+  buffer_size=size;
+  lease_warning=false;
+
+  statistics.reset();
+
+  session_allocator=allocator;
+  buffer_alignment=0;
+
+  if (session_allocator)
+  {
+    buffer_alignment=getBufAlignment();
+  }
 
-    if (!err && gentl->DSQueueBuffer(stream, pp) != GenTL::GC_ERR_SUCCESS)
+  for (size_t i=0; i<nb; i++)
+  {
+    if (!announceBuffer())
     {
       err=true;
       break;
@@ -270,14 +322,14 @@ void Stream::startStreaming(int nacquire, int min_buffers)
 
   if (err)
   {
-    gentl->DSFlushQueue(stream, GenTL::ACQ_QUEUE_ALL_DISCARD);
-
-    GenTL::BUFFER_HANDLE pp=0;
-    while (gentl->DSGetBufferID(stream, 0, &pp) == GenTL::GC_ERR_SUCCESS)
     {
-      gentl->DSRevokeBuffer(stream, pp, 0, 0);
+      std::lock_guard<std::mutex> llock(lease_mtx);
+      gentl->DSFlushQueue(stream, GenTL::ACQ_QUEUE_ALL_DISCARD);
+      revokeBuffers();
     }
 
+    bn=0;
+
     // unlock parameters
 
     GenApi::IInteger *pi=dynamic_cast<GenApi::IInteger *>(nmap->_GetNode("TLParamsLocked"));
@@ -293,6 +345,8 @@ void Stream::startStreaming(int nacquire, int min_buffers)
 
 void Stream::stopStreaming()
 {
+  stopAcquisitionThread();
+
   std::lock_guard<std::recursive_mutex> lock(mtx);
 
   if (bn > 0)
@@ -305,18 +359,21 @@ void Stream::stopStreaming()
     stop->Execute();
 
     gentl->DSStopAcquisition(stream, GenTL::ACQ_STOP_FLAGS_DEFAULT);
+    gentl->EventKill(event);
     gentl->GCUnregisterEvent(stream, GenTL::EVENT_NEW_BUFFER);
-    gentl->DSFlushQueue(stream, GenTL::ACQ_QUEUE_ALL_DISCARD);
 
-    // free all buffers
+    // free all buffers, except the ones that are still leased, which are
+    // revoked as soon as they are released
 
-    for (size_t i=0; i<bn; i++)
     {
-      GenTL::BUFFER_HANDLE p=0;
-      if (gentl->DSGetBufferID(stream, 0, &p) == GenTL::GC_ERR_SUCCESS)
-      {
-        gentl->DSRevokeBuffer(stream, p, 0, 0);
-      }
+      std::lock_guard<std::mutex> llock(lease_mtx);
+
+      generation++;
+      orphaned.insert(orphaned.end(), leased.begin(), leased.end());
+      leased.clear();
+
+      gentl->DSFlushQueue(stream, GenTL::ACQ_QUEUE_ALL_DISCARD);
+      revokeBuffers();
     }
 
     event=0;
@@ -352,10 +409,341 @@ int Stream::getAvailableBufferCount()
   return static_cast<int>(ret);
 }
 
-const Buffer *Stream::grab(int64_t _timeout)
+const Buffer *Stream::grab(int64_t timeout)
 {
-  std::lock_guard<std::recursive_mutex> lock(mtx);
+  if (acq_running)
+  {
+    throw GenTLException("Stream::grab(): Acquisition thread is running");
+  }
+
+  std::lock_guard<std::mutex> glock(grab_mtx);
+  std::unique_lock<std::recursive_mutex> lock(mtx);
+
+  void *handle=waitForBuffer(lock, timeout, "Stream::grab()");
+
+  if (handle == 0)
+  {
+    return 0;
+  }
+
+  // return buffer
+
+  buffer.setHandle(handle);
+  statistics.update(&buffer);
+
+  return &buffer;
+}
+
+std::shared_ptr<const Buffer> Stream::grabLeased(int64_t timeout)
+{
+  if (acq_running)
+  {
+    throw GenTLException("Stream::grabLeased(): Acquisition thread is running");
+  }
+
+  return leaseBuffer(timeout, "Stream::grabLeased()");
+}
+
+size_t Stream::getNumLeased()
+{
+  std::lock_guard<std::mutex> llock(lease_mtx);
+  return leased.size();
+}
+
+void Stream::startAcquisitionThread(size_t queue_size, DropPolicy policy)
+{
+  std::lock_guard<std::mutex> alock(acq_mtx);
+
+  if (acq_running)
+  {
+    return;
+  }
+
+  // join thread if it has terminated by itself
+
+  if (acq_thread.joinable())
+  {
+    acq_thread.join();
+  }
+
+  {
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+
+    if (bn == 0 || event == 0)
+    {
+      throw GenTLException("Stream::startAcquisitionThread(): Streaming not started");
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> qlock(queue_mtx);
+
+    queue.clear();
+    queue.resize(queue_size);
+    queue_head=0;
+    queue_count=0;
+    queue_policy=policy;
+    queue_dropped=0;
+  }
+
+  acq_running=true;
+  acq_thread=std::thread(&Stream::runAcquisition, this);
+}
+
+void Stream::stopAcquisitionThread()
+{
+  if (std::this_thread::get_id() == acq_thread.get_id())
+  {
+    throw GenTLException("Stream::stopAcquisitionThread(): Must not be called from callback");
+  }
+
+  std::lock_guard<std::mutex> alock(acq_mtx);
+
+  if (acq_thread.joinable())
+  {
+    // the thread waits for buffers with a small timeout, so that it
+    // terminates quickly
+
+    acq_running=false;
+    acq_thread.join();
+  }
+
+  // release all buffers in the queue outside of the lock
+
+  std::vector<std::shared_ptr<const Buffer> > list;
+
+  {
+    std::lock_guard<std::mutex> qlock(queue_mtx);
+
+    list.swap(queue);
+    queue_head=0;
+    queue_count=0;
+  }
+
+  queue_cond.notify_all();
+}
+
+bool Stream::isAcquisitionThreadRunning()
+{
+  return acq_running;
+}
+
+int Stream::addBufferCallback(const BufferCallback &cb)
+{
+  std::lock_guard<std::mutex> clock(cb_mtx);
+
+  cb_id++;
+  callbacks.push_back(std::pair<int, BufferCallback>(cb_id, cb));
+
+  return cb_id;
+}
+
+void Stream::removeBufferCallback(int id)
+{
+  std::lock_guard<std::mutex> clock(cb_mtx);
+
+  for (size_t i=0; i<callbacks.size(); i++)
+  {
+    if (callbacks[i].first == id)
+    {
+      callbacks.erase(callbacks.begin()+static_cast<long>(i));
+      break;
+    }
+  }
+}
+
+std::shared_ptr<const Buffer> Stream::getNextBuffer(int64_t timeout)
+{
+  std::shared_ptr<const Buffer> ret;
+
+  std::unique_lock<std::mutex> qlock(queue_mtx);
+
+  auto ready=[this]() { return queue_count > 0 || !acq_running; };
+
+  if (timeout < 0)
+  {
+    queue_cond.wait(qlock, ready);
+  }
+  else
+  {
+    queue_cond.wait_for(qlock, std::chrono::milliseconds(timeout), ready);
+  }
+
+  if (queue_count > 0)
+  {
+    ret.swap(queue[queue_head]);
+
+    queue_head=(queue_head+1)%queue.size();
+    queue_count--;
+  }
 
+  return ret;
+}
+
+uint64_t Stream::getNumDropped()
+{
+  std::lock_guard<std::mutex> qlock(queue_mtx);
+  return queue_dropped;
+}
+
+StreamStatisticsSnapshot Stream::getStatistics() const
+{
+  return statistics.getSnapshot();
+}
+
+std::shared_ptr<const Buffer> Stream::leaseBuffer(int64_t timeout, const char *caller)
+{
+  std::lock_guard<std::mutex> glock(grab_mtx);
+  std::unique_lock<std::recursive_mutex> lock(mtx);
+
+  void *handle=waitForBuffer(lock, timeout, caller);
+
+  if (handle == 0)
+  {
+    return std::shared_ptr<const Buffer>();
+  }
+
+  // register lease
+
+  uint32_t gen;
+  size_t nfree;
+
+  {
+    std::lock_guard<std::mutex> llock(lease_mtx);
+
+    leased.push_back(handle);
+
+    gen=generation;
+    nfree=bn-leased.size();
+  }
+
+  // announce an additional buffer if leases starve the acquisition engine
+
+  if (nfree < 2)
+  {
+    if (bn < bn_max)
+    {
+      if (!announceBuffer())
+      {
+        std::cerr << caller << ": Cannot announce additional buffer" << std::endl;
+      }
+    }
+    else if (!lease_warning)
+    {
+      std::cerr << caller << ": Warning: " << bn-nfree << " of " << bn
+                << " buffers are leased, acquisition may run out of buffers" << std::endl;
+
+      lease_warning=true;
+    }
+  }
+
+  // create lease that gives the buffer back when the last copy is released,
+  // it uses the nodemap of the stream if buffers are attached, but only
+  // attaches on request
+
+  Buffer *p=new Buffer(gentl, this);
+  p->shareNodemap(buffer);
+  p->setHandle(handle);
+  statistics.update(p);
+
+  std::shared_ptr<Stream> self=shared_from_this();
+
+  return std::shared_ptr<const Buffer>(p, [self, gen](const Buffer *b)
+    {
+      self->releaseLease(b, gen);
+    });
+}
+
+namespace
+{
+
+/**
+  Information about buffer memory that is provided by an allocator. It is
+  stored as private pointer of the buffer.
+*/
+
+struct BufferMemory
+{
+  std::shared_ptr<BufferAllocator> allocator;
+  size_t size;
+};
+
+}
+
+bool Stream::announceBuffer()
+{
+  GenTL::BUFFER_HANDLE p=0;
+
+  if (session_allocator)
+  {
+    void *mem=session_allocator->allocate(buffer_size, buffer_alignment);
+
+    if (mem == 0)
+    {
+      return false;
+    }
+
+    BufferMemory *bm=new BufferMemory();
+    bm->allocator=session_allocator;
+    bm->size=buffer_size;
+
+    if (gentl->DSAnnounceBuffer(stream, mem, buffer_size, bm, &p) != GenTL::GC_ERR_SUCCESS)
+    {
+      session_allocator->free(mem, buffer_size);
+      delete bm;
+
+      return false;
+    }
+  }
+  else if (gentl->DSAllocAndAnnounceBuffer(stream, buffer_size, 0, &p) != GenTL::GC_ERR_SUCCESS)
+  {
+    return false;
+  }
+
+  bn++;
+
+  return gentl->DSQueueBuffer(stream, p) == GenTL::GC_ERR_SUCCESS;
+}
+
+void Stream::revokeBuffer(void *handle)
+{
+  void *mem=0;
+  void *priv=0;
+
+  if (gentl->DSRevokeBuffer(stream, handle, &mem, &priv) == GenTL::GC_ERR_SUCCESS && priv != 0)
+  {
+    // free memory that has been provided by an allocator
+
+    BufferMemory *bm=static_cast<BufferMemory *>(priv);
+    bm->allocator->free(mem, bm->size);
+    delete bm;
+  }
+}
+
+void Stream::revokeBuffers()
+{
+  // must be called with locked lease_mtx after flushing the queue
+
+  std::vector<void *> list;
+
+  GenTL::BUFFER_HANDLE p=0;
+  for (uint32_t i=0; gentl->DSGetBufferID(stream, i, &p) == GenTL::GC_ERR_SUCCESS; i++)
+  {
+    list.push_back(p);
+  }
+
+  for (size_t i=0; i<list.size(); i++)
+  {
+    if (std::find(orphaned.begin(), orphaned.end(), list[i]) == orphaned.end())
+    {
+      revokeBuffer(list[i]);
+    }
+  }
+}
+
+void *Stream::waitForBuffer(std::unique_lock<std::recursive_mutex> &lock, int64_t _timeout,
+                            const char *caller)
+{
   uint64_t timeout=GENTL_INFINITE;
   if (_timeout >= 0)
   {
@@ -366,7 +754,7 @@ const Buffer *Stream::grab(int64_t _timeout)
 
   if (bn == 0 || event == 0)
   {
-    throw GenTLException("Streaming::grab(): Streaming not started");
+    throw GenTLException(std::string(caller)+": Streaming not started");
   }
 
   // enqueue previously delivered buffer if any
@@ -376,37 +764,151 @@ const Buffer *Stream::grab(int64_t _timeout)
     if (gentl->DSQueueBuffer(stream, buffer.getHandle()) != GenTL::GC_ERR_SUCCESS)
     {
       buffer.setHandle(0);
-      throw GenTLException("Stream::grab()", gentl);
+      throw GenTLException(caller, gentl);
     }
 
     buffer.setHandle(0);
   }
 
-  // wait for event
+  // wait for event without locking the stream, so that other methods can be
+  // called in the meantime, the caller must hold grab_mtx, so that only one
+  // thread waits and sets the buffer handle
+
+  void *ev=event;
+  uint32_t gen=generation;
 
   GenTL::EVENT_NEW_BUFFER_DATA data;
   size_t size=sizeof(GenTL::EVENT_NEW_BUFFER_DATA);
   memset(&data, 0, size);
 
-  GenTL::GC_ERROR err=gentl->EventGetData(event, &data, &size, timeout);
+  lock.unlock();
+  GenTL::GC_ERROR err=gentl->EventGetData(ev, &data, &size, timeout);
+  lock.lock();
 
-  // return 0 in case of abort and timeout and throw exception in case of
-  // another error
+  // return 0 in case of abort and timeout or if streaming has been stopped
+  // in the meantime and throw exception in case of another error
 
-  if (err == GenTL::GC_ERR_ABORT || err == GenTL::GC_ERR_TIMEOUT)
+  if (err == GenTL::GC_ERR_ABORT || err == GenTL::GC_ERR_TIMEOUT || gen != generation ||
+      bn == 0)
   {
     return 0;
   }
   else if (err != GenTL::GC_ERR_SUCCESS)
   {
-    throw GenTLException("Stream::grab()", gentl);
+    throw GenTLException(caller, gentl);
   }
 
-  // return buffer
+  return data.BufferHandle;
+}
+
+void Stream::releaseLease(const Buffer *p, uint32_t gen)
+{
+  void *handle=p->getHandle();
+  delete p;
 
-  buffer.setHandle(data.BufferHandle);
+  // do not throw exceptions as this method is called when releasing a lease
 
-  return &buffer;
+  std::lock_guard<std::mutex> llock(lease_mtx);
+
+  if (gen == generation)
+  {
+    std::vector<void *>::iterator it=std::find(leased.begin(), leased.end(), handle);
+
+    if (it != leased.end())
+    {
+      leased.erase(it);
+      gentl->DSQueueBuffer(stream, handle);
+    }
+  }
+  else
+  {
+    // streaming has been stopped since the buffer was leased
+
+    std::vector<void *>::iterator it=std::find(orphaned.begin(), orphaned.end(), handle);
+
+    if (it != orphaned.end())
+    {
+      orphaned.erase(it);
+      revokeBuffer(handle);
+    }
+  }
+}
+
+void Stream::runAcquisition()
+{
+  while (acq_running)
+  {
+    std::shared_ptr<const Buffer> p;
+
+    try
+    {
+      p=leaseBuffer(100, "Stream::runAcquisition()");
+    }
+    catch (const std::exception &ex)
+    {
+      std::cerr << ex.what() << std::endl;
+      break;
+    }
+
+    if (p)
+    {
+      // pass buffer to all callbacks
+
+      std::vector<std::pair<int, BufferCallback> > cb;
+
+      {
+        std::lock_guard<std::mutex> clock(cb_mtx);
+        cb=callbacks;
+      }
+
+      for (size_t i=0; i<cb.size(); i++)
+      {
+        try
+        {
+          cb[i].second(p);
+        }
+        catch (const std::exception &ex)
+        {
+          std::cerr << "Stream::runAcquisition(): Exception in callback: " << ex.what() << std::endl;
+        }
+      }
+
+      // store buffer in the queue, a dropped buffer is released outside of the
+      // lock
+
+      std::shared_ptr<const Buffer> dropped;
+
+      {
+        std::lock_guard<std::mutex> qlock(queue_mtx);
+
+        if (queue.size() > 0)
+        {
+          if (queue_count < queue.size())
+          {
+            queue[(queue_head+queue_count)%queue.size()]=p;
+            queue_count++;
+          }
+          else if (queue_policy == DROP_OLDEST)
+          {
+            dropped.swap(queue[queue_head]);
+
+            queue[queue_head]=p;
+            queue_head=(queue_head+1)%queue.size();
+            queue_dropped++;
+          }
+          else
+          {
+            queue_dropped++;
+          }
+        }
+      }
+
+      queue_cond.notify_one();
+    }
+  }
+
+  acq_running=false;
+  queue_cond.notify_all();
 }
 
 namespace
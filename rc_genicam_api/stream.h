@@ -38,14 +38,39 @@
 
 #include "device.h"
 #include "buffer.h"
+#include "buffer_allocator.h"
+#include "stream_statistics.h"
 
 #include <mutex>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 
 namespace rcg
 {
 
 class Buffer;
 
+/**
+  Policy of the acquisition thread (see Stream::startAcquisitionThread()) in
+  case the queue of buffers is full.
+*/
+
+enum DropPolicy
+{
+  DROP_OLDEST, // the oldest buffer of the queue is dropped
+  DROP_NEWEST  // the newly received buffer is dropped
+};
+
+/**
+  Callback that is invoked by the acquisition thread for every received
+  buffer.
+*/
+
+typedef std::function<void (const std::shared_ptr<const Buffer> &buffer)> BufferCallback;
+
 /**
   The stream class encapsulates a Genicam stream.
 
@@ -101,11 +126,29 @@ class Stream : public std::enable_shared_from_this<Stream>
       nodemap. This only has an effect if chunks are enabled (i.e.
       ChunkModeActive=true).
 
+      If lazy is true, grabbed buffers are only attached on request (see
+      Buffer::attachChunkData()). This is recommended if mainly the values of
+      Buffer::getChunkData() are used, since it avoids parsing of all chunks
+      by GenApi for each buffer.
+
       @param enable Enables or disables attaching grabbed buffers to the
                     nodemap.
+      @param lazy   Attaches grabbed buffers only on request.
+    */
+
+    void attachBuffers(bool enable, bool lazy=false);
+
+    /**
+      Sets an allocator that provides the memory of the buffers, which are
+      then announced with DSAnnounceBuffer. By default, or if an empty pointer
+      is given, the transport layer allocates the buffers. The allocator is
+      used by the next call of startStreaming(). The stream keeps a reference
+      to the allocator until all buffers are revoked.
+
+      @param allocator Allocator or empty pointer.
     */
 
-    void attachBuffers(bool enable);
+    void setBufferAllocator(const std::shared_ptr<BufferAllocator> &allocator);
 
     /**
       Allocates four buffers, registers internal events and starts streaming of
@@ -126,6 +169,19 @@ class Stream : public std::enable_shared_from_this<Stream>
 
     void startStreaming(int nacquire, int min_buffers);
 
+    /**
+      Allocates the given minimum number of buffers, registers internal events
+      and starts streaming of nacquire buffers. Additional buffers up to the
+      given maximum are announced while streaming if leased buffers (see
+      grabLeased()) would otherwise starve the acquisition engine.
+
+      @param na          Number of buffers to acquire. Set <= 0 for infinity.
+      @param min_buffers Miminum number of buffers to allocate.
+      @param max_buffers Maximum number of buffers to allocate.
+    */
+
+    void startStreaming(int nacquire, int min_buffers, int max_buffers);
+
     /**
       Stops streaming.
     */
@@ -144,6 +200,12 @@ class Stream : public std::enable_shared_from_this<Stream>
       Wait for the next image or data and return it in a buffer object. The
       buffer is valid until the next call to grab.
 
+      NOTE: Calls of grab() and grabLeased() are serialized, i.e. if several
+      threads call them, then only one thread waits for a buffer at a time.
+      Other methods of the stream, like stopStreaming(), can be called while
+      a thread is waiting. The buffer that is returned by grab() is given
+      back by the next call of grab() or grabLeased() of any thread.
+
       @param timeout Timeout in ms. A value < 0 sets waiting time to infinite.
       @return        Pointer to received buffer or 0 in case of an error or
                      interrupt.
@@ -151,6 +213,138 @@ class Stream : public std::enable_shared_from_this<Stream>
 
     const Buffer *grab(int64_t timeout=-1);
 
+    /**
+      Wait for the next image or data and return it as reference counted lease
+      of the buffer. In contrast to grab(), the buffer remains valid as long as
+      a copy of the returned pointer exists. The buffer is given back to the
+      acquisition engine when the last copy is released. This permits holding
+      several buffers at the same time without copying the data, e.g. by
+      creating images with Image(const std::shared_ptr<const Buffer> &, part).
+
+      If too many leases are held, so that less than two buffers remain for
+      the acquisition engine, then additional buffers are announced up to the
+      maximum that is given to startStreaming(). Otherwise, a warning is
+      printed once.
+
+      NOTE: If buffers are attached (see attachBuffers()), leased buffers
+      share the nodemap with the stream, but they are only attached on
+      request, i.e. Buffer::attachChunkData() must be called before chunk
+      values are read through the nodemap. Since all leases share one
+      nodemap, the values are those of the buffer that has been attached
+      last. Buffer::getChunkData() works without attaching.
+
+      Calling this method gives the buffer of the last call to grab() back to
+      the acquisition engine. Leases that are still held when streaming stops
+      are revoked as soon as they are released. All leases must be released
+      before the stream is closed.
+
+      @param timeout Timeout in ms. A value < 0 sets waiting time to infinite.
+      @return        Leased buffer or empty pointer in case of an error or
+                     interrupt.
+    */
+
+    std::shared_ptr<const Buffer> grabLeased(int64_t timeout=-1);
+
+    /**
+      Returns the number of leased buffers of the current streaming session,
+      that have not yet been released.
+
+      @return Number of leased buffers.
+    */
+
+    size_t getNumLeased();
+
+    /**
+      Starts a thread that continuously grabs leased buffers (see
+      grabLeased()), so that acquisition does not stall while the consumer is
+      busy. Every received buffer is first passed to all registered callbacks
+      and then stored in a bounded queue, from which it can be taken by one or
+      more consumer threads with getNextBuffer(). If the queue is full, then
+      the oldest or the newest buffer is dropped, according to the given
+      policy.
+
+      NOTE: Streaming must have been started before. While the thread is
+      running, grab() and grabLeased() must not be called. The number of
+      buffers that is given to startStreaming() should be larger than the
+      queue size.
+
+      @param queue_size Maximum number of buffers in the queue. The queue is
+                        not used if the size is 0, i.e. buffers are only
+                        delivered via callbacks.
+      @param policy     Policy in case the queue is full.
+    */
+
+    void startAcquisitionThread(size_t queue_size=4, DropPolicy policy=DROP_OLDEST);
+
+    /**
+      Stops the acquisition thread if it is running and releases all buffers
+      in the queue. This is also done automatically when streaming stops.
+
+      NOTE: This method must not be called from a callback.
+    */
+
+    void stopAcquisitionThread();
+
+    /**
+      Returns true if the acquisition thread is running.
+
+      @return True if the acquisition thread is running.
+    */
+
+    bool isAcquisitionThreadRunning();
+
+    /**
+      Registers a callback that is invoked by the acquisition thread for every
+      received buffer. The callback may keep a copy of the buffer pointer.
+      Callbacks should return quickly, since acquisition is delayed while they
+      are running.
+
+      @param cb Callback.
+      @return   ID of the callback, which can be used for removing it.
+    */
+
+    int addBufferCallback(const BufferCallback &cb);
+
+    /**
+      Removes a callback.
+
+      @param id ID of the callback as returned by addBufferCallback().
+    */
+
+    void removeBufferCallback(int id);
+
+    /**
+      Takes the next buffer from the queue of the acquisition thread. Buffers
+      are returned in the order in which they have been received. This method
+      can be called concurrently from several consumer threads.
+
+      @param timeout Timeout in ms. A value < 0 sets waiting time to infinite.
+      @return        Leased buffer or empty pointer in case of timeout or if
+                     the acquisition thread is not running.
+    */
+
+    std::shared_ptr<const Buffer> getNextBuffer(int64_t timeout=-1);
+
+    /**
+      Returns the number of buffers that have been dropped by the acquisition
+      thread because the queue was full, since the thread has been started.
+
+      @return Number of dropped buffers.
+    */
+
+    uint64_t getNumDropped();
+
+    /**
+      Returns the statistics of all buffers that have been received by grab(),
+      grabLeased() or the acquisition thread since streaming has been started,
+      like skipped frame IDs and histograms of the latency and the time
+      between buffers (see StreamStatistics).
+
+      @return Statistics.
+    */
+
+    StreamStatisticsSnapshot getStatistics() const;
+
     /**
       Returns some information about the stream.
 
@@ -306,6 +500,15 @@ class Stream : public std::enable_shared_from_this<Stream>
     Stream(class Stream &); // forbidden
     Stream &operator=(const Stream &); // forbidden
 
+    bool announceBuffer();
+    void revokeBuffer(void *handle);
+    void revokeBuffers();
+    void *waitForBuffer(std::unique_lock<std::recursive_mutex> &lock, int64_t timeout,
+                        const char *caller);
+    std::shared_ptr<const Buffer> leaseBuffer(int64_t timeout, const char *caller);
+    void releaseLease(const Buffer *p, uint32_t gen);
+    void runAcquisition();
+
     Buffer buffer;
 
     std::shared_ptr<Device> parent;
@@ -313,11 +516,42 @@ class Stream : public std::enable_shared_from_this<Stream>
     std::string id;
 
     std::recursive_mutex mtx;
+    std::mutex grab_mtx;
 
     int n_open;
     void *stream;
     void *event;
     size_t bn;
+    size_t bn_max;
+    size_t buffer_size;
+    size_t buffer_alignment;
+
+    std::shared_ptr<BufferAllocator> allocator;
+    std::shared_ptr<BufferAllocator> session_allocator;
+
+    std::mutex lease_mtx;
+    std::vector<void *> leased;
+    std::vector<void *> orphaned;
+    uint32_t generation;
+    bool lease_warning;
+
+    std::mutex acq_mtx;
+    std::thread acq_thread;
+    std::atomic_bool acq_running;
+
+    std::mutex queue_mtx;
+    std::condition_variable queue_cond;
+    std::vector<std::shared_ptr<const Buffer> > queue;
+    size_t queue_head;
+    size_t queue_count;
+    DropPolicy queue_policy;
+    uint64_t queue_dropped;
+
+    std::mutex cb_mtx;
+    std::vector<std::pair<int, BufferCallback> > callbacks;
+    int cb_id;
+
+    StreamStatistics statistics;
 
     std::shared_ptr<CPort> cport;
     std::shared_ptr<GenApi::CNodeMapRef> nodemap;
@@ -0,0 +1,289 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stream_statistics.h"
+#include "buffer.h"
+
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+namespace rcg
+{
+
+namespace
+{
+
+/*
+  Returns the index of the highest bit that is set, v must not be 0.
+*/
+
+inline int highestBit(uint64_t v)
+{
+  int ret=0;
+
+  for (int s=32; s > 0; s/=2)
+  {
+    if (v >= (static_cast<uint64_t>(1) << s))
+    {
+      v>>=s;
+      ret+=s;
+    }
+  }
+
+  return ret;
+}
+
+/*
+  Atomically lowers or raises the stored value.
+*/
+
+inline void storeMin(std::atomic<uint64_t> &a, uint64_t v)
+{
+  uint64_t cur=a.load(std::memory_order_relaxed);
+  while (v < cur && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed)) { }
+}
+
+inline void storeMax(std::atomic<uint64_t> &a, uint64_t v)
+{
+  uint64_t cur=a.load(std::memory_order_relaxed);
+  while (v > cur && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed)) { }
+}
+
+}
+
+Histogram::Histogram()
+{
+  reset();
+}
+
+void Histogram::reset()
+{
+  for (size_t i=0; i<BUCKETS; i++)
+  {
+    bucket[i].store(0, std::memory_order_relaxed);
+  }
+
+  count.store(0, std::memory_order_relaxed);
+  sum.store(0, std::memory_order_relaxed);
+  vmin.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+  vmax.store(0, std::memory_order_relaxed);
+}
+
+void Histogram::add(uint64_t ns)
+{
+  ns=std::min(ns, (static_cast<uint64_t>(1) << MAX_BITS)-1);
+
+  // values below 2^SUB_BITS are counted exactly, above, each power of two is
+  // split into 2^SUB_BITS buckets
+
+  size_t i=static_cast<size_t>(ns);
+
+  if (ns >= (static_cast<uint64_t>(1) << SUB_BITS))
+  {
+    int shift=highestBit(ns)-SUB_BITS;
+    i=(static_cast<size_t>(shift+1) << SUB_BITS)+
+      static_cast<size_t>((ns >> shift)-(static_cast<uint64_t>(1) << SUB_BITS));
+  }
+
+  bucket[i].fetch_add(1, std::memory_order_relaxed);
+  sum.fetch_add(ns, std::memory_order_relaxed);
+  storeMin(vmin, ns);
+  storeMax(vmax, ns);
+  count.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t Histogram::getPercentile(double p) const
+{
+  uint64_t n=count.load(std::memory_order_acquire);
+
+  if (n == 0)
+  {
+    return 0;
+  }
+
+  uint64_t target=static_cast<uint64_t>(p*n+0.5);
+  target=std::max(static_cast<uint64_t>(1), std::min(target, n));
+
+  uint64_t c=0;
+  for (size_t i=0; i<BUCKETS; i++)
+  {
+    c+=bucket[i].load(std::memory_order_relaxed);
+
+    if (c >= target)
+    {
+      // return center of bucket, but not outside of recorded range
+
+      uint64_t ret=i;
+
+      if (i >= (static_cast<size_t>(1) << SUB_BITS))
+      {
+        int shift=static_cast<int>(i >> SUB_BITS)-1;
+        uint64_t sub=(i & ((static_cast<size_t>(1) << SUB_BITS)-1))+
+          (static_cast<uint64_t>(1) << SUB_BITS);
+
+        ret=(sub << shift)+((static_cast<uint64_t>(1) << shift) >> 1);
+      }
+
+      ret=std::max(ret, vmin.load(std::memory_order_relaxed));
+      ret=std::min(ret, vmax.load(std::memory_order_relaxed));
+
+      return ret;
+    }
+  }
+
+  return vmax.load(std::memory_order_relaxed);
+}
+
+HistogramSnapshot Histogram::getSnapshot() const
+{
+  HistogramSnapshot ret;
+
+  ret.count=count.load(std::memory_order_acquire);
+  ret.min=0;
+  ret.max=0;
+  ret.mean=0;
+
+  if (ret.count > 0)
+  {
+    ret.min=vmin.load(std::memory_order_relaxed)/1.0e6;
+    ret.max=vmax.load(std::memory_order_relaxed)/1.0e6;
+    ret.mean=sum.load(std::memory_order_relaxed)/1.0e6/ret.count;
+  }
+
+  ret.p50=getPercentile(0.5)/1.0e6;
+  ret.p90=getPercentile(0.9)/1.0e6;
+  ret.p99=getPercentile(0.99)/1.0e6;
+  ret.p999=getPercentile(0.999)/1.0e6;
+
+  return ret;
+}
+
+StreamStatistics::StreamStatistics()
+{
+  reset();
+}
+
+void StreamStatistics::reset()
+{
+  received.store(0);
+  incomplete.store(0);
+  lost.store(0);
+  restarted.store(0);
+
+  latency.reset();
+  interval.reset();
+  jitter.reset();
+
+  has_last=false;
+  last_host_ns=0;
+  last_device_ns=0;
+  last_frameid=0;
+}
+
+void StreamStatistics::update(uint64_t host_ns, uint64_t device_ns, uint64_t frameid,
+                              bool is_incomplete)
+{
+  received.fetch_add(1, std::memory_order_relaxed);
+
+  if (is_incomplete)
+  {
+    incomplete.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  if (device_ns > 0 && host_ns >= device_ns)
+  {
+    latency.add(host_ns-device_ns);
+  }
+
+  if (has_last)
+  {
+    // detect skipped frame IDs
+
+    if (frameid > last_frameid+1)
+    {
+      lost.fetch_add(frameid-last_frameid-1, std::memory_order_relaxed);
+    }
+    else if (frameid <= last_frameid)
+    {
+      restarted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // inter-arrival time on the host and its deviation from the device clock
+
+    if (host_ns >= last_host_ns)
+    {
+      uint64_t dt=host_ns-last_host_ns;
+      interval.add(dt);
+
+      if (last_device_ns > 0 && device_ns >= last_device_ns)
+      {
+        uint64_t ddt=device_ns-last_device_ns;
+        jitter.add(dt > ddt ? dt-ddt : ddt-dt);
+      }
+    }
+  }
+
+  has_last=true;
+  last_host_ns=host_ns;
+  last_device_ns=device_ns;
+  last_frameid=frameid;
+}
+
+void StreamStatistics::update(const Buffer *buffer)
+{
+  uint64_t host_ns=static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count());
+
+  update(host_ns, buffer->getTimestampNS(), buffer->getFrameID(), buffer->getIsIncomplete());
+}
+
+StreamStatisticsSnapshot StreamStatistics::getSnapshot() const
+{
+  StreamStatisticsSnapshot ret;
+
+  ret.received=received.load(std::memory_order_relaxed);
+  ret.incomplete=incomplete.load(std::memory_order_relaxed);
+  ret.lost=lost.load(std::memory_order_relaxed);
+  ret.restarted=restarted.load(std::memory_order_relaxed);
+
+  ret.latency=latency.getSnapshot();
+  ret.interval=interval.getSnapshot();
+  ret.jitter=jitter.getSnapshot();
+
+  return ret;
+}
+
+}
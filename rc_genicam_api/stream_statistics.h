@@ -0,0 +1,234 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_STREAM_STATISTICS
+#define RC_GENICAM_API_STREAM_STATISTICS
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace rcg
+{
+
+class Buffer;
+
+/**
+  Summary of the values that have been recorded in a histogram. All values
+  are given in ms.
+*/
+
+struct HistogramSnapshot
+{
+  uint64_t count;  // number of recorded values
+  double min;      // minimum value
+  double max;      // maximum value
+  double mean;     // mean value
+  double p50;      // median
+  double p90;      // 90 % percentile
+  double p99;      // 99 % percentile
+  double p999;     // 99.9 % percentile
+};
+
+/**
+  Histogram of durations in nano seconds in the style of HDR histograms. The
+  bucket width grows with the magnitude of the values, so that the relative
+  error of all reported values is below 2 %, while the number of buckets stays
+  small. Values are recorded with atomic operations, so that recording and
+  reading can happen concurrently without locking.
+*/
+
+class Histogram
+{
+  public:
+
+    Histogram();
+
+    /**
+      Removes all recorded values.
+    */
+
+    void reset();
+
+    /**
+      Records a duration. Durations of more than about 73 minutes are counted
+      as 73 minutes.
+
+      @param ns Duration in nano seconds.
+    */
+
+    void add(uint64_t ns);
+
+    /**
+      Returns the number of recorded values.
+
+      @return Count.
+    */
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+
+    /**
+      Returns the value below which the given fraction of recorded values lie.
+
+      @param p Fraction between 0 and 1.
+      @return  Value in ns or 0 if no values have been recorded.
+    */
+
+    uint64_t getPercentile(double p) const;
+
+    /**
+      Returns a summary of all recorded values.
+
+      @return Snapshot.
+    */
+
+    HistogramSnapshot getSnapshot() const;
+
+  private:
+
+    Histogram(class Histogram &); // forbidden
+    Histogram &operator=(const Histogram &); // forbidden
+
+    static const int SUB_BITS=6;
+    static const int MAX_BITS=42;
+    static const size_t BUCKETS=(MAX_BITS-SUB_BITS+1) << SUB_BITS;
+
+    std::atomic<uint64_t> bucket[BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> vmin;
+    std::atomic<uint64_t> vmax;
+};
+
+/**
+  Summary of the statistics of a stream.
+*/
+
+struct StreamStatisticsSnapshot
+{
+  uint64_t received;           // number of received buffers
+  uint64_t incomplete;         // number of incomplete buffers
+  uint64_t lost;               // number of frame IDs that have been skipped
+  uint64_t restarted;          // number of times the frame ID went backwards,
+                               // e.g. due to a wrap around or a device restart
+  HistogramSnapshot latency;   // time between the device timestamp and
+                               // receiving the buffer on the host
+  HistogramSnapshot interval;  // time between receiving consecutive buffers
+                               // on the host
+  HistogramSnapshot jitter;    // absolute difference between the interval on
+                               // the host and the difference of the device
+                               // timestamps of consecutive buffers
+};
+
+/**
+  Collects statistics about the buffers of a stream, i.e. the number of
+  incomplete buffers, skipped frame IDs as well as histograms of the latency,
+  the inter-arrival time and its jitter. The statistics of a stream are
+  updated by Stream::grab(), Stream::grabLeased() and the acquisition thread
+  and can be queried by Stream::getStatistics().
+
+  NOTE: The latency is computed by comparing the device timestamp with the
+  system clock of the host. It is only meaningful if both clocks are
+  synchronized, e.g. by PTP. Buffers with a device timestamp in the future
+  are not counted in the latency histogram.
+
+  The update methods must not be called concurrently, while snapshots can be
+  taken at any time without locking.
+*/
+
+class StreamStatistics
+{
+  public:
+
+    StreamStatistics();
+
+    /**
+      Removes all recorded information.
+    */
+
+    void reset();
+
+    /**
+      Records a received buffer.
+
+      @param host_ns       Time of receiving the buffer on the host in ns
+                           since 1.1.1970 (system clock).
+      @param device_ns     Timestamp of the buffer in ns as given by the
+                           device.
+      @param frameid       Frame ID of the buffer.
+      @param is_incomplete True if the buffer is incomplete.
+    */
+
+    void update(uint64_t host_ns, uint64_t device_ns, uint64_t frameid, bool is_incomplete);
+
+    /**
+      Records a received buffer with the current time as time of receiving.
+
+      @param buffer Received buffer.
+    */
+
+    void update(const Buffer *buffer);
+
+    /**
+      Returns a summary of the statistics.
+
+      @return Snapshot.
+    */
+
+    StreamStatisticsSnapshot getSnapshot() const;
+
+  private:
+
+    StreamStatistics(class StreamStatistics &); // forbidden
+    StreamStatistics &operator=(const StreamStatistics &); // forbidden
+
+    std::atomic<uint64_t> received;
+    std::atomic<uint64_t> incomplete;
+    std::atomic<uint64_t> lost;
+    std::atomic<uint64_t> restarted;
+
+    Histogram latency;
+    Histogram interval;
+    Histogram jitter;
+
+    bool has_last;
+    uint64_t last_host_ns;
+    uint64_t last_device_ns;
+    uint64_t last_frameid;
+};
+
+}
+
+#endif
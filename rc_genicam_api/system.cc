@@ -36,6 +36,7 @@
 #include "system.h"
 
 #include "gentl_wrapper.h"
+#include "gentl_profile.h"
 #include "exception.h"
 #include "interface.h"
 #include "cport.h"
@@ -52,6 +53,13 @@
 namespace rcg
 {
 
+/*
+  Joins the threads of device searches that are still running in the
+  background after getDevice() returned. Implemented in device.cc.
+*/
+
+void joinPendingDeviceSearches();
+
 System::~System()
 {
   if (n_open > 0 && tl != 0)
@@ -281,6 +289,11 @@ std::vector<std::shared_ptr<System> > System::getSystems()
 
 void System::clearSystems()
 {
+  // background searches must finish before the systems and their producers
+  // are released, this may block up to the timeout of the search
+
+  joinPendingDeviceSearches();
+
   std::lock_guard<std::recursive_mutex> lock(system_mtx);
 
   // clear all interfaces explicitly as part of ENUM-WORKAROUND
@@ -292,11 +305,36 @@ void System::clearSystems()
   system_list.clear();
 }
 
+void System::setProfiling(bool enable)
+{
+  setGenTLProfiling(enable);
+}
+
 const std::string &System::getFilename() const
 {
   return filename;
 }
 
+std::string System::getProfilingReport() const
+{
+  return gentl->getProfilingReport();
+}
+
+uint64_t System::getProfilingCount(const std::string &function) const
+{
+  std::vector<GenTLProfile::Function> list=gentl->getProfilingSnapshot();
+
+  for (size_t i=0; i<list.size(); i++)
+  {
+    if (list[i].name == function)
+    {
+      return list[i].counter.count;
+    }
+  }
+
+  return 0;
+}
+
 void System::open()
 {
   std::lock_guard<std::recursive_mutex> lock(mtx);
@@ -103,11 +103,32 @@ class System : public std::enable_shared_from_this<System>
 
     /**
       Clears the internal list of systems. This may be called before exit so
-      that all resources are cleaned before leaving the main function.
+      that all resources are cleaned before leaving the main function. Device
+      searches of getDevice() that are still running in the background are
+      joined first.
     */
 
     static void clearSystems();
 
+    /**
+      Enables or disables profiling of all calls into the GenTL producers. If
+      enabled, the number of calls and the time spent in each GenTL function
+      are recorded per function and handle. A report, ranked by the total time
+      per function, is printed on std::cerr when a producer is unloaded, e.g.
+      at exit or by clearSystems().
+
+      By default, profiling is enabled if the environment variable
+      RCG_GENTL_PROFILE is set to a value other than 0.
+
+      NOTE: This function only affects producers that are loaded afterwards,
+      i.e. it must be called before the first call to getSystems() or after
+      calling clearSystems().
+
+      @param enable True for enabling profiling.
+    */
+
+    static void setProfiling(bool enable);
+
     /**
       Get file name from which this system was created.
 
@@ -116,6 +137,27 @@ class System : public std::enable_shared_from_this<System>
 
     const std::string &getFilename() const;
 
+    /**
+      Returns the profiling report of all calls into the GenTL producer of
+      this system so far (see setProfiling()).
+
+      @return Report or empty string if profiling was not enabled when the
+              producer was loaded.
+    */
+
+    std::string getProfilingReport() const;
+
+    /**
+      Returns the number of calls of a GenTL function of the producer of this
+      system so far (see setProfiling()).
+
+      @param function Name of the GenTL function, e.g. "DSGetBufferInfo".
+      @return         Number of calls or 0 if profiling was not enabled when the
+                      producer was loaded.
+    */
+
+    uint64_t getProfilingCount(const std::string &function) const;
+
     /**
       Opens the system for working with it. The system may be opened multiple
       times. However, for each open(), the close() method must be called as
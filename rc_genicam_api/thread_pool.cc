@@ -0,0 +1,227 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "thread_pool.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#undef min
+#undef max
+#endif
+
+namespace rcg
+{
+
+ThreadPool &ThreadPool::getInstance()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+ThreadPool::ThreadPool()
+{
+  stop=false;
+
+  job=0;
+  job_id=0;
+  job_n=0;
+  job_next=0;
+  job_workers=0;
+  job_active=0;
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stop=true;
+  }
+
+  work_cond.notify_all();
+
+  for (size_t i=0; i<worker.size(); i++)
+  {
+    worker[i].join();
+  }
+}
+
+size_t ThreadPool::getNumThreads(size_t nthreads)
+{
+  if (nthreads == 0)
+  {
+    nthreads=std::thread::hardware_concurrency();
+  }
+
+  return std::max(static_cast<size_t>(1), nthreads);
+}
+
+void ThreadPool::parallelFor(size_t n, size_t nthreads,
+                             const std::function<void (size_t)> &fn)
+{
+  nthreads=std::min(getNumThreads(nthreads), n);
+
+  // process sequentially if only one thread is requested or if the pool is
+  // busy, e.g. because of a nested call
+
+  std::unique_lock<std::mutex> call_lock(call_mtx, std::defer_lock);
+
+  if (nthreads <= 1 || !call_lock.try_lock())
+  {
+    for (size_t i=0; i<n; i++)
+    {
+      fn(i);
+    }
+
+    return;
+  }
+
+  // start the job, with additional threads if needed
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    while (worker.size()+1 < nthreads)
+    {
+      worker.push_back(std::thread(&ThreadPool::runWorker, this, worker.size()));
+    }
+
+    job=&fn;
+    job_id++;
+    job_n=n;
+    job_next=0;
+    job_workers=nthreads-1;
+    job_active=nthreads-1;
+    job_exception=std::exception_ptr();
+  }
+
+  work_cond.notify_all();
+
+  // take part in processing and wait until all workers are finished
+
+  process();
+
+  std::exception_ptr ex;
+
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+
+    while (job_active > 0)
+    {
+      done_cond.wait(lock);
+    }
+
+    job=0;
+    ex=job_exception;
+    job_exception=std::exception_ptr();
+  }
+
+  if (ex)
+  {
+    std::rethrow_exception(ex);
+  }
+}
+
+void ThreadPool::runWorker(size_t id)
+{
+  uint64_t last_id=0;
+
+  std::unique_lock<std::mutex> lock(mtx);
+
+  while (true)
+  {
+    while (!stop && (job_id == last_id || id >= job_workers))
+    {
+      if (job_id != last_id)
+      {
+        last_id=job_id; // job does not need this worker
+      }
+
+      work_cond.wait(lock);
+    }
+
+    if (stop)
+    {
+      break;
+    }
+
+    last_id=job_id;
+
+    lock.unlock();
+    process();
+    lock.lock();
+
+    job_active--;
+
+    if (job_active == 0)
+    {
+      done_cond.notify_all();
+    }
+  }
+}
+
+void ThreadPool::process()
+{
+  std::unique_lock<std::mutex> lock(mtx);
+
+  while (job_next < job_n)
+  {
+    size_t i=job_next++;
+
+    lock.unlock();
+
+    try
+    {
+      (*job)(i);
+    }
+    catch (...)
+    {
+      lock.lock();
+
+      if (!job_exception)
+      {
+        job_exception=std::current_exception();
+      }
+
+      job_next=job_n; // skip remaining work
+
+      continue;
+    }
+
+    lock.lock();
+  }
+}
+
+}
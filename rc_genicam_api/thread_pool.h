@@ -0,0 +1,127 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_THREAD_POOL
+#define RC_GENICAM_API_THREAD_POOL
+
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <exception>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rcg
+{
+
+/**
+  Pool of worker threads that is owned by the library and used for
+  parallelizing internal work, like image conversion. The threads are created
+  on demand and are kept until the program terminates.
+*/
+
+class ThreadPool
+{
+  public:
+
+    /**
+      Returns the thread pool of the library.
+    */
+
+    static ThreadPool &getInstance();
+
+    ~ThreadPool();
+
+    /**
+      Returns the number of threads that should be used for a given request.
+
+      @param nthreads Requested number of threads. 0 means that the number of
+                      cores should be used.
+      @return         Number of threads, which is at least 1.
+    */
+
+    static size_t getNumThreads(size_t nthreads);
+
+    /**
+      Calls the given function for all indices from 0 to n-1, using the given
+      number of threads. The calling thread takes part in the processing. The
+      function returns after all calls are finished. An exception that is
+      thrown by the function is passed to the caller.
+
+      If the pool is currently used by another thread or if the function is
+      called from within a parallel loop, all calls are done sequentially by
+      the calling thread.
+
+      @param n        Number of indices.
+      @param nthreads Number of threads, including the calling thread. 0 means
+                      that the number of cores should be used.
+      @param fn       Function that is called with each index.
+    */
+
+    void parallelFor(size_t n, size_t nthreads, const std::function<void (size_t)> &fn);
+
+  private:
+
+    ThreadPool();
+
+    ThreadPool(class ThreadPool &); // forbidden
+    ThreadPool &operator=(const ThreadPool &); // forbidden
+
+    void runWorker(size_t id);
+    void process();
+
+    std::mutex call_mtx;
+
+    std::mutex mtx;
+    std::condition_variable work_cond;
+    std::condition_variable done_cond;
+    std::vector<std::thread> worker;
+    bool stop;
+
+    const std::function<void (size_t)> *job;
+    uint64_t job_id;
+    size_t job_n;
+    size_t job_next;
+    size_t job_workers;
+    size_t job_active;
+    std::exception_ptr job_exception;
+};
+
+}
+
+#endif
@@ -0,0 +1,3623 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "replay_source.h"
+
+#include <rc_genicam_api/pixel_formats.h>
+
+#include <GenTL/GenTL_v1_6.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
+#include <cstring>
+
+#include <dlfcn.h>
+
+/*
+  GenTL producer that presents one virtual device, which delivers frames from
+  a raw recording file or synthetic frames of a stereo camera at a
+  configurable rate. It is configured by environment variables that are read
+  when the library is initialized:
+
+  RCG_REPLAY_FILE        Recording file as written by RecordingWriter. If not
+                         given, synthetic frames are generated.
+  RCG_REPLAY_LOOP        0 for stopping at the end of the recording, 1 for
+                         replaying it in an endless loop (default).
+  RCG_REPLAY_RATE        Initial value of AcquisitionFrameRate in Hz. The
+                         default is the rate of the recording or 25 Hz. A rate
+                         of 0 delivers frames as fast as buffers are queued.
+  RCG_REPLAY_WIDTH       Width of synthetic images (default 640).
+  RCG_REPLAY_HEIGHT      Height of synthetic images (default 480).
+  RCG_REPLAY_PIXELFORMAT Format of synthetic intensity images, i.e. Mono8
+                         (default), Mono16, RGB8 or YCbCr411_8.
+*/
+
+namespace rcg
+{
+
+namespace
+{
+
+const char *REPLAY_VENDOR="Roboception";
+const char *REPLAY_MODEL="Replay";
+const char *REPLAY_VERSION="1.0";
+const char *REPLAY_ID="replay";
+const char *REPLAY_TLTYPE="Custom";
+
+const uint64_t REPLAY_XML_ADDRESS=0x100000;
+const size_t REPLAY_STRING_LENGTH=64;
+const size_t REPLAY_BUFFER_ALIGN=64;
+
+// size of the FileAccessBuffer register and maximum size of a file
+
+const size_t REPLAY_FILE_BUFFER_SIZE=0x10000;
+const size_t REPLAY_FILE_SIZE_MAX=64*1024*1024;
+
+// registers of the remote device
+
+enum ReplayRegister
+{
+  REG_WIDTH=0x1000,
+  REG_HEIGHT=0x1004,
+  REG_PIXELFORMAT=0x1008,
+  REG_ACQ_MODE=0x100c,
+  REG_ACQ_START=0x1010,
+  REG_ACQ_STOP=0x1014,
+  REG_TL_PARAMS_LOCKED=0x1018,
+  REG_MULTIPART=0x101c,
+  REG_COMP_SELECTOR=0x1020,
+  REG_COMP_ENABLE=0x1024,
+  REG_PAYLOAD_SIZE=0x1040,
+  REG_FRAME_RATE=0x1048,
+  REG_BASELINE=0x1050,
+  REG_FOCAL_LENGTH_FACTOR=0x1058,
+  REG_COORDINATE_SCALE=0x1060,
+  REG_NUM_FRAMES=0x1068,
+  REG_CHUNK_MODE=0x1070,
+  REG_CHUNK_COMP_SELECTOR=0x1074,
+  REG_FILE_SELECTOR=0x1078,
+  REG_FILE_OPERATION_SELECTOR=0x107c,
+  REG_FILE_OPERATION_EXECUTE=0x1080,
+  REG_FILE_OPEN_MODE=0x1084,
+  REG_FILE_OPERATION_STATUS=0x1088,
+  REG_FILE_ACCESS_OFFSET=0x1090,
+  REG_FILE_ACCESS_LENGTH=0x1098,
+  REG_FILE_OPERATION_RESULT=0x10a0,
+  REG_FILE_SIZE=0x10a8,
+  REG_FILE_ACCESS_BUFFER=0x10000
+};
+
+// values of the enumerations of the file access
+
+enum ReplayFileOperation
+{
+  FILE_OP_OPEN=0, FILE_OP_CLOSE=1, FILE_OP_READ=2, FILE_OP_WRITE=3, FILE_OP_DELETE=4
+};
+
+enum ReplayFileOpenMode
+{
+  FILE_MODE_READ=0, FILE_MODE_WRITE=1, FILE_MODE_READWRITE=2
+};
+
+enum ReplayFileStatus
+{
+  FILE_STATUS_SUCCESS=0, FILE_STATUS_FAILURE=1
+};
+
+const char *component_name[RC_COUNT]={ "Intensity", "Disparity", "Confidence", "Error" };
+
+/*
+  Configuration from environment variables.
+*/
+
+struct ReplayConfig
+{
+  std::string file;
+  bool loop;
+  double rate;          // negative if not given
+  size_t width;
+  size_t height;
+  uint64_t pixelformat;
+};
+
+const char *getFormatName(uint64_t format)
+{
+  if (format == Error8)
+  {
+    return "Error8";
+  }
+
+  return GetPixelFormatName(static_cast<PfncFormat>(format));
+}
+
+bool isSymbolic(const std::string &s)
+{
+  if (s.size() == 0 || !(isalpha(s[0]) || s[0] == '_'))
+  {
+    return false;
+  }
+
+  for (size_t i=1; i<s.size(); i++)
+  {
+    if (!(isalnum(s[i]) || s[i] == '_'))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+ReplayConfig readConfig()
+{
+  ReplayConfig config;
+
+  const char *s=std::getenv("RCG_REPLAY_FILE");
+  config.file=(s != 0 ? s : "");
+
+  s=std::getenv("RCG_REPLAY_LOOP");
+  config.loop=(s == 0 || std::atoi(s) != 0);
+
+  s=std::getenv("RCG_REPLAY_RATE");
+  config.rate=(s != 0 ? std::max(0.0, std::atof(s)) : -1);
+
+  s=std::getenv("RCG_REPLAY_WIDTH");
+  config.width=(s != 0 ? static_cast<size_t>(std::atoi(s)) : 640);
+
+  s=std::getenv("RCG_REPLAY_HEIGHT");
+  config.height=(s != 0 ? static_cast<size_t>(std::atoi(s)) : 480);
+
+  config.pixelformat=Mono8;
+
+  s=std::getenv("RCG_REPLAY_PIXELFORMAT");
+  if (s != 0)
+  {
+    const uint64_t format[]={ Mono8, Mono16, RGB8, YCbCr411_8 };
+
+    for (size_t i=0; i<sizeof(format)/sizeof(format[0]); i++)
+    {
+      if (std::string(s) == getFormatName(format[i]))
+      {
+        config.pixelformat=format[i];
+      }
+    }
+  }
+
+  config.width=std::max(static_cast<size_t>(4), config.width&~static_cast<size_t>(3));
+  config.height=std::max(static_cast<size_t>(1), config.height);
+
+  return config;
+}
+
+/*
+  Error handling. The last error is stored per thread.
+*/
+
+struct ReplayError
+{
+  GenTL::GC_ERROR code;
+  std::string text;
+};
+
+thread_local ReplayError last_error={ GenTL::GC_ERR_SUCCESS, "" };
+
+GenTL::GC_ERROR setError(GenTL::GC_ERROR code, const std::string &text)
+{
+  last_error.code=code;
+  last_error.text=text;
+
+  return code;
+}
+
+/*
+  Returning information according to the GenTL conventions. If the buffer is
+  0, only the required size is returned.
+*/
+
+GenTL::GC_ERROR returnData(GenTL::INFO_DATATYPE *type, void *buffer, size_t *size,
+                           GenTL::INFO_DATATYPE t, const void *value, size_t value_size)
+{
+  if (size == 0)
+  {
+    return setError(GenTL::GC_ERR_INVALID_PARAMETER, "Size must not be NULL");
+  }
+
+  if (type != 0)
+  {
+    *type=t;
+  }
+
+  if (buffer != 0)
+  {
+    if (*size < value_size)
+    {
+      *size=value_size;
+      return setError(GenTL::GC_ERR_BUFFER_TOO_SMALL, "Buffer too small");
+    }
+
+    memcpy(buffer, value, value_size);
+  }
+
+  *size=value_size;
+
+  return GenTL::GC_ERR_SUCCESS;
+}
+
+GenTL::GC_ERROR returnString(GenTL::INFO_DATATYPE *type, void *buffer, size_t *size,
+                             const std::string &value)
+{
+  return returnData(type, buffer, size, GenTL::INFO_DATATYPE_STRING, value.c_str(),
+                    value.size()+1);
+}
+
+template<class T> GenTL::GC_ERROR returnValue(GenTL::INFO_DATATYPE *type, void *buffer,
+                                              size_t *size, GenTL::INFO_DATATYPE t, T value)
+{
+  return returnData(type, buffer, size, t, &value, sizeof(T));
+}
+
+GenTL::GC_ERROR returnBool(GenTL::INFO_DATATYPE *type, void *buffer, size_t *size, bool value)
+{
+  return returnValue<bool8_t>(type, buffer, size, GenTL::INFO_DATATYPE_BOOL8, value);
+}
+
+GenTL::GC_ERROR returnSize(GenTL::INFO_DATATYPE *type, void *buffer, size_t *size, size_t value)
+{
+  return returnValue<size_t>(type, buffer, size, GenTL::INFO_DATATYPE_SIZET, value);
+}
+
+GenTL::GC_ERROR returnUInt64(GenTL::INFO_DATATYPE *type, void *buffer, size_t *size,
+                             uint64_t value)
+{
+  return returnValue<uint64_t>(type, buffer, size, GenTL::INFO_DATATYPE_UINT64, value);
+}
+
+GenTL::GC_ERROR notImplemented()
+{
+  return setError(GenTL::GC_ERR_NOT_IMPLEMENTED, "Information not implemented");
+}
+
+/*
+  Returns a GUID, which is derived from the given text, so that GenApi caches
+  different XML files under different GUIDs.
+*/
+
+std::string createGUID(const std::string &text)
+{
+  uint64_t h[2]={ 14695981039346656037ull, 1099511628211ull };
+
+  for (size_t i=0; i<text.size(); i++)
+  {
+    h[0]=(h[0]^static_cast<uint8_t>(text[i]))*1099511628211ull;
+    h[1]=(h[1]^static_cast<uint8_t>(text[i]))*14029467366897019727ull;
+  }
+
+  std::ostringstream out;
+  out << std::hex;
+
+  for (int i=0; i<32; i++)
+  {
+    if (i == 8 || i == 12 || i == 16 || i == 20)
+    {
+      out << '-';
+    }
+
+    out << ((h[i/16]>>(4*(i%16)))&0xf);
+  }
+
+  return out.str();
+}
+
+/*
+  Base class of all objects that are given to the consumer as handle.
+*/
+
+class ReplayHandle
+{
+  public:
+
+    virtual ~ReplayHandle() { }
+};
+
+/*
+  The global lock protects all objects, except streams and events, which have
+  their own locks, so that waiting for buffers does not block other calls.
+*/
+
+std::mutex api_mtx;
+bool initialized=false;
+ReplayConfig config;
+
+std::map<void *, std::weak_ptr<ReplayHandle> > registry;
+
+void registerHandle(const std::shared_ptr<ReplayHandle> &p)
+{
+  registry[p.get()]=p;
+}
+
+void unregisterHandle(void *p)
+{
+  registry.erase(p);
+}
+
+template<class T> std::shared_ptr<T> lookup(void *h)
+{
+  std::map<void *, std::weak_ptr<ReplayHandle> >::iterator it=registry.find(h);
+
+  if (it != registry.end())
+  {
+    return std::dynamic_pointer_cast<T>(it->second.lock());
+  }
+
+  return std::shared_ptr<T>();
+}
+
+/*
+  Event with its own queue of data.
+*/
+
+class ReplayEvent : public ReplayHandle
+{
+  public:
+
+    ReplayEvent(GenTL::EVENT_TYPE _type, size_t _size_max)
+    {
+      type=_type;
+      size_max=_size_max;
+      fired=0;
+      kills=0;
+    }
+
+    GenTL::EVENT_TYPE getType() const { return type; }
+    size_t getSizeMax() const { return size_max; }
+
+    void push(const GenTL::EVENT_NEW_BUFFER_DATA &data)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      queue.push_back(data);
+      fired++;
+      cond.notify_one();
+    }
+
+    GenTL::GC_ERROR get(void *buffer, size_t *size, uint64_t timeout)
+    {
+      if (size == 0 || (buffer != 0 && *size < size_max))
+      {
+        return setError(GenTL::GC_ERR_INVALID_PARAMETER, "Event buffer too small");
+      }
+
+      std::unique_lock<std::mutex> lock(mtx);
+
+      std::function<bool ()> ready=[this] { return kills > 0 || queue.size() > 0; };
+
+      // very large timeouts, e.g. from negative values, are treated as infinite
+
+      if (timeout >= 1000000000ull)
+      {
+        cond.wait(lock, ready);
+      }
+      else if (!cond.wait_for(lock, std::chrono::milliseconds(timeout), ready))
+      {
+        return setError(GenTL::GC_ERR_TIMEOUT, "Timeout");
+      }
+
+      if (kills > 0)
+      {
+        kills--;
+        return setError(GenTL::GC_ERR_ABORT, "Event has been killed");
+      }
+
+      if (buffer != 0)
+      {
+        memcpy(buffer, &queue.front(), sizeof(GenTL::EVENT_NEW_BUFFER_DATA));
+      }
+
+      *size=sizeof(GenTL::EVENT_NEW_BUFFER_DATA);
+      queue.pop_front();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    std::vector<GenTL::EVENT_NEW_BUFFER_DATA> flush()
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      std::vector<GenTL::EVENT_NEW_BUFFER_DATA> ret(queue.begin(), queue.end());
+      queue.clear();
+      return ret;
+    }
+
+    void remove(void *buffer)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      for (std::deque<GenTL::EVENT_NEW_BUFFER_DATA>::iterator it=queue.begin(); it!=queue.end(); )
+      {
+        if (it->BufferHandle == buffer)
+        {
+          it=queue.erase(it);
+        }
+        else
+        {
+          ++it;
+        }
+      }
+    }
+
+    void kill()
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      kills++;
+      cond.notify_all();
+    }
+
+    size_t getNumInQueue()
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      return queue.size();
+    }
+
+    uint64_t getNumFired()
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      return fired;
+    }
+
+  private:
+
+    ReplayEvent(class ReplayEvent &); // forbidden
+    ReplayEvent &operator=(const ReplayEvent &); // forbidden
+
+    GenTL::EVENT_TYPE type;
+    size_t size_max;
+
+    std::mutex mtx;
+    std::condition_variable cond;
+    std::deque<GenTL::EVENT_NEW_BUFFER_DATA> queue;
+    uint64_t fired;
+    int kills;
+};
+
+/*
+  Base class of all modules, which provides a port with string registers, the
+  XML description and module specific registers.
+*/
+
+class ReplayModule : public ReplayHandle
+{
+  public:
+
+    ReplayModule(const std::string &_module, const std::string &_id, const std::string &_portname)
+    {
+      module=_module;
+      id=_id;
+      portname=_portname;
+    }
+
+    const std::string &getID() const { return id; }
+
+    GenTL::GC_ERROR readPort(uint64_t address, void *buffer, size_t *size)
+    {
+      if (buffer == 0 || size == 0)
+      {
+        return setError(GenTL::GC_ERR_INVALID_PARAMETER, "Buffer and size must not be NULL");
+      }
+
+      uint8_t *p=static_cast<uint8_t *>(buffer);
+
+      if (address >= REPLAY_XML_ADDRESS)
+      {
+        if (address+*size > REPLAY_XML_ADDRESS+xml.size())
+        {
+          return setError(GenTL::GC_ERR_INVALID_ADDRESS, "Invalid address");
+        }
+
+        memcpy(p, xml.data()+(address-REPLAY_XML_ADDRESS), *size);
+        return GenTL::GC_ERR_SUCCESS;
+      }
+
+      if (address < strings.size()*REPLAY_STRING_LENGTH)
+      {
+        if (address+*size > strings.size()*REPLAY_STRING_LENGTH)
+        {
+          return setError(GenTL::GC_ERR_INVALID_ADDRESS, "Invalid address");
+        }
+
+        for (size_t i=0; i<*size; i++)
+        {
+          const std::string &s=strings[(address+i)/REPLAY_STRING_LENGTH].second;
+          const size_t k=(address+i)%REPLAY_STRING_LENGTH;
+          p[i]=(k < s.size() && k+1 < REPLAY_STRING_LENGTH ? s[k] : 0);
+        }
+
+        return GenTL::GC_ERR_SUCCESS;
+      }
+
+      return readRegister(address, p, *size);
+    }
+
+    GenTL::GC_ERROR writePort(uint64_t address, const void *buffer, size_t *size)
+    {
+      if (buffer == 0 || size == 0)
+      {
+        return setError(GenTL::GC_ERR_INVALID_PARAMETER, "Buffer and size must not be NULL");
+      }
+
+      if (address >= REPLAY_XML_ADDRESS || address < strings.size()*REPLAY_STRING_LENGTH)
+      {
+        return setError(GenTL::GC_ERR_ACCESS_DENIED, "Register is read only");
+      }
+
+      return writeRegister(address, static_cast<const uint8_t *>(buffer), *size);
+    }
+
+    std::string getXMLName() const
+    {
+      return std::string(REPLAY_MODEL)+"_"+module+".xml";
+    }
+
+    std::string getURL() const
+    {
+      std::ostringstream out;
+      out << "Local:" << getXMLName() << ';' << std::hex << REPLAY_XML_ADDRESS << ';' << xml.size();
+      return out.str();
+    }
+
+    GenTL::GC_ERROR getPortInfo(GenTL::PORT_INFO_CMD cmd, GenTL::INFO_DATATYPE *type,
+                                void *buffer, size_t *size)
+    {
+      switch (cmd)
+      {
+        case GenTL::PORT_INFO_ID:
+          return returnString(type, buffer, size, id);
+
+        case GenTL::PORT_INFO_VENDOR:
+          return returnString(type, buffer, size, REPLAY_VENDOR);
+
+        case GenTL::PORT_INFO_MODEL:
+          return returnString(type, buffer, size, REPLAY_MODEL);
+
+        case GenTL::PORT_INFO_TLTYPE:
+          return returnString(type, buffer, size, REPLAY_TLTYPE);
+
+        case GenTL::PORT_INFO_MODULE:
+          return returnString(type, buffer, size, module);
+
+        case GenTL::PORT_INFO_LITTLE_ENDIAN:
+        case GenTL::PORT_INFO_ACCESS_READ:
+        case GenTL::PORT_INFO_ACCESS_WRITE:
+          return returnBool(type, buffer, size, true);
+
+        case GenTL::PORT_INFO_BIG_ENDIAN:
+        case GenTL::PORT_INFO_ACCESS_NA:
+        case GenTL::PORT_INFO_ACCESS_NI:
+          return returnBool(type, buffer, size, false);
+
+        case GenTL::PORT_INFO_VERSION:
+          return returnString(type, buffer, size, REPLAY_VERSION);
+
+        case GenTL::PORT_INFO_PORTNAME:
+          return returnString(type, buffer, size, portname);
+
+        default:
+          return notImplemented();
+      }
+    }
+
+    GenTL::GC_ERROR getURLInfo(uint32_t index, GenTL::URL_INFO_CMD cmd, GenTL::INFO_DATATYPE *type,
+                               void *buffer, size_t *size)
+    {
+      if (index != 0)
+      {
+        return setError(GenTL::GC_ERR_INVALID_INDEX, "Invalid URL index");
+      }
+
+      switch (cmd)
+      {
+        case GenTL::URL_INFO_URL:
+          return returnString(type, buffer, size, getURL());
+
+        case GenTL::URL_INFO_SCHEMA_VER_MAJOR:
+        case GenTL::URL_INFO_SCHEMA_VER_MINOR:
+          return returnValue<int32_t>(type, buffer, size, GenTL::INFO_DATATYPE_INT32, 1);
+
+        // the XML file is generated and depends e.g. on the recording, thus
+        // no file version is reported, which keeps consumers from caching it
+        // under the same version
+
+        case GenTL::URL_INFO_FILE_VER_MAJOR:
+        case GenTL::URL_INFO_FILE_VER_MINOR:
+        case GenTL::URL_INFO_FILE_VER_SUBMINOR:
+          return setError(GenTL::GC_ERR_NOT_AVAILABLE, "File version not available");
+
+        case GenTL::URL_INFO_FILE_REGISTER_ADDRESS:
+          return returnUInt64(type, buffer, size, REPLAY_XML_ADDRESS);
+
+        case GenTL::URL_INFO_FILE_SIZE:
+          return returnUInt64(type, buffer, size, xml.size());
+
+        case GenTL::URL_INFO_SCHEME:
+          return returnValue<int32_t>(type, buffer, size, GenTL::INFO_DATATYPE_INT32,
+                                      GenTL::URL_SCHEME_LOCAL);
+
+        case GenTL::URL_INFO_FILENAME:
+          return returnString(type, buffer, size, getXMLName());
+
+        default:
+          return notImplemented();
+      }
+    }
+
+  protected:
+
+    virtual GenTL::GC_ERROR readRegister(uint64_t, uint8_t *, size_t)
+    {
+      return setError(GenTL::GC_ERR_INVALID_ADDRESS, "Invalid address");
+    }
+
+    virtual GenTL::GC_ERROR writeRegister(uint64_t, const uint8_t *, size_t)
+    {
+      return setError(GenTL::GC_ERR_INVALID_ADDRESS, "Invalid address");
+    }
+
+    void addString(const std::string &name, const std::string &value)
+    {
+      strings.push_back(std::make_pair(name, value));
+    }
+
+    /*
+      Creates the XML description with all string registers and the given
+      additional nodes and features of the root category.
+    */
+
+    void createXML(const std::string &nodes, const std::vector<std::string> &features)
+    {
+      std::ostringstream out;
+
+      out << "  <Category Name=\"Root\" NameSpace=\"Standard\">\n";
+
+      for (size_t i=0; i<strings.size(); i++)
+      {
+        out << "    <pFeature>" << strings[i].first << "</pFeature>\n";
+      }
+
+      for (size_t i=0; i<features.size(); i++)
+      {
+        out << "    <pFeature>" << features[i] << "</pFeature>\n";
+      }
+
+      out << "  </Category>\n";
+
+      for (size_t i=0; i<strings.size(); i++)
+      {
+        out << "  <StringReg Name=\"" << strings[i].first << "\" NameSpace=\"Standard\">\n"
+            << "    <Address>0x" << std::hex << i*REPLAY_STRING_LENGTH << std::dec << "</Address>\n"
+            << "    <Length>" << REPLAY_STRING_LENGTH << "</Length>\n"
+            << "    <AccessMode>RO</AccessMode>\n"
+            << "    <pPort>" << portname << "</pPort>\n"
+            << "  </StringReg>\n";
+      }
+
+      out << nodes;
+      out << "  <Port Name=\"" << portname << "\" NameSpace=\"Standard\"/>\n";
+
+      const std::string body=out.str();
+
+      std::ostringstream doc;
+
+      doc << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+          << "<RegisterDescription ModelName=\"" << REPLAY_MODEL << "_" << module << "\""
+          << " VendorName=\"" << REPLAY_VENDOR << "\""
+          << " StandardNameSpace=\"None\""
+          << " SchemaMajorVersion=\"1\" SchemaMinorVersion=\"1\" SchemaSubMinorVersion=\"0\""
+          << " MajorVersion=\"1\" MinorVersion=\"0\" SubMinorVersion=\"0\""
+          << " ProductGuid=\"" << createGUID(module) << "\""
+          << " VersionGuid=\"" << createGUID(body) << "\""
+          << " xmlns=\"http://www.genicam.org/GenApi/Version_1_1\""
+          << " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\""
+          << " xsi:schemaLocation=\"http://www.genicam.org/GenApi/Version_1_1"
+          << " http://www.genicam.org/GenApi/GenApiSchema_Version_1_1.xsd\">\n"
+          << body
+          << "</RegisterDescription>\n";
+
+      xml=doc.str();
+    }
+
+  private:
+
+    ReplayModule(class ReplayModule &); // forbidden
+    ReplayModule &operator=(const ReplayModule &); // forbidden
+
+    std::string module;
+    std::string id;
+    std::string portname;
+
+    std::vector<std::pair<std::string, std::string> > strings;
+    std::string xml;
+};
+
+/*
+  Remote device with the features that are needed for streaming and for
+  computing point clouds.
+*/
+
+class ReplayRemoteDevice : public ReplayModule
+{
+  public:
+
+    ReplayRemoteDevice(const std::shared_ptr<ReplayRecordingSource> &_recording, bool _readonly) :
+      ReplayModule("Device", REPLAY_ID, "Device")
+    {
+      recording=_recording;
+      readonly=_readonly;
+
+      width=static_cast<uint32_t>(config.width);
+      height=static_cast<uint32_t>(config.height);
+      pixelformat=static_cast<uint32_t>(config.pixelformat);
+      multipart=0;
+      selector=0;
+      chunk_mode=0;
+      chunk_selector=0;
+
+      file_selector=0;
+      file_operation=FILE_OP_OPEN;
+      file_mode=FILE_MODE_READ;
+      file_status=FILE_STATUS_SUCCESS;
+      file_offset=0;
+      file_length=0;
+      file_result=0;
+      file_open=false;
+      file_buffer.resize(REPLAY_FILE_BUFFER_SIZE);
+
+      for (int i=0; i<RC_COUNT; i++)
+      {
+        enable[i]=(i == RC_INTENSITY);
+      }
+
+      locked=0;
+      acquiring=false;
+
+      double r=25;
+
+      if (recording)
+      {
+        const ReplayFrame &first=recording->getFirstFrame();
+
+        if (first.part.size() > 0)
+        {
+          width=static_cast<uint32_t>(first.part[0].width);
+          height=static_cast<uint32_t>(first.part[0].height);
+          pixelformat=static_cast<uint32_t>(first.part[0].pixelformat);
+        }
+
+        r=recording->getRate();
+        source=recording;
+      }
+
+      if (config.rate >= 0)
+      {
+        r=config.rate;
+      }
+
+      rate.store(r);
+
+      addString("DeviceVendorName", REPLAY_VENDOR);
+      addString("DeviceModelName", REPLAY_MODEL);
+      addString("DeviceVersion", REPLAY_VERSION);
+      addString("DeviceSerialNumber", REPLAY_ID);
+      addString("DeviceID", REPLAY_ID);
+
+      createXML(createNodes(), { "Width", "Height", "PixelFormat", "PayloadSize",
+        "AcquisitionMode", "AcquisitionStart", "AcquisitionStop", "AcquisitionFrameRate",
+        "AcquisitionMultiPartMode", "ComponentSelector", "ComponentEnable", "TLParamsLocked",
+        "Baseline", "FocalLengthFactor", "Scan3dOutputMode", "Scan3dCoordinateScale",
+        "Scan3dCoordinateOffset", "Scan3dInvalidDataFlag", "Scan3dInvalidDataValue",
+        "ChunkDataControl", "FileAccessControl", "ReplayNumFrames" });
+    }
+
+    /*
+      Returns the source of frames according to the current settings. Must be
+      called with locked api_mtx.
+    */
+
+    std::shared_ptr<ReplaySource> getSource()
+    {
+      if (!recording)
+      {
+        bool changed=!source || width != source_width || height != source_height ||
+          pixelformat != source_pixelformat || multipart != source_multipart ||
+          chunk_mode != source_chunk_mode;
+
+        for (int i=0; i<RC_COUNT; i++)
+        {
+          changed=changed || enable[i] != source_enable[i];
+        }
+
+        if (changed)
+        {
+          source.reset();
+          source=std::make_shared<ReplaySyntheticSource>(width, height, pixelformat, enable,
+                                                         multipart != 0, rate.load(),
+                                                         chunk_mode != 0);
+
+          source_width=width;
+          source_height=height;
+          source_pixelformat=pixelformat;
+          source_multipart=multipart;
+          source_chunk_mode=chunk_mode;
+
+          for (int i=0; i<RC_COUNT; i++)
+          {
+            source_enable[i]=enable[i];
+          }
+        }
+      }
+
+      return source;
+    }
+
+    double getRate() const { return rate.load(); }
+    bool isAcquiring() const { return acquiring.load(); }
+
+  protected:
+
+    GenTL::GC_ERROR readRegister(uint64_t address, uint8_t *p, size_t size)
+    {
+      if (address >= REG_FILE_ACCESS_BUFFER &&
+          address < REG_FILE_ACCESS_BUFFER+REPLAY_FILE_BUFFER_SIZE)
+      {
+        if (size > REG_FILE_ACCESS_BUFFER+REPLAY_FILE_BUFFER_SIZE-address)
+        {
+          return setError(GenTL::GC_ERR_INVALID_ADDRESS, "Invalid address or size");
+        }
+
+        memcpy(p, file_buffer.data()+(address-REG_FILE_ACCESS_BUFFER), size);
+
+        return GenTL::GC_ERR_SUCCESS;
+      }
+
+      if (size == 4)
+      {
+        uint32_t v=0;
+
+        switch (address)
+        {
+          case REG_WIDTH: v=width; break;
+          case REG_HEIGHT: v=height; break;
+          case REG_PIXELFORMAT: v=pixelformat; break;
+          case REG_ACQ_MODE: v=0; break;
+          case REG_ACQ_START: v=0; break;
+          case REG_ACQ_STOP: v=0; break;
+          case REG_TL_PARAMS_LOCKED: v=locked; break;
+          case REG_MULTIPART: v=multipart; break;
+          case REG_COMP_SELECTOR: v=selector; break;
+          case REG_CHUNK_MODE: v=chunk_mode; break;
+          case REG_CHUNK_COMP_SELECTOR: v=chunk_selector; break;
+          case REG_FILE_SELECTOR: v=file_selector; break;
+          case REG_FILE_OPERATION_SELECTOR: v=file_operation; break;
+          case REG_FILE_OPERATION_EXECUTE: v=0; break;
+          case REG_FILE_OPEN_MODE: v=file_mode; break;
+          case REG_FILE_OPERATION_STATUS: v=file_status; break;
+
+          default:
+            if (address >= REG_COMP_ENABLE && address < REG_COMP_ENABLE+4*RC_COUNT &&
+                (address&0x3) == 0)
+            {
+              v=(enable[(address-REG_COMP_ENABLE)/4] ? 1 : 0);
+            }
+            else
+            {
+              return setError(GenTL::GC_ERR_INVALID_ADDRESS, "Invalid address");
+            }
+            break;
+        }
+
+        memcpy(p, &v, sizeof(v));
+
+        return GenTL::GC_ERR_SUCCESS;
+      }
+      else if (size == 8)
+      {
+        uint64_t v=0;
+        double d=0;
+
+        switch (address)
+        {
+          case REG_PAYLOAD_SIZE:
+            try
+            {
+              v=getSource()->getPayloadSize();
+            }
+            catch (const std::exception &ex)
+            {
+              return setError(GenTL::GC_ERR_INVALID_PARAMETER, ex.what());
+            }
+            memcpy(p, &v, sizeof(v));
+            break;
+
+          case REG_NUM_FRAMES:
+            v=(recording ? recording->getNumFrames() : 0);
+            memcpy(p, &v, sizeof(v));
+            break;
+
+          case REG_FILE_ACCESS_OFFSET: memcpy(p, &file_offset, sizeof(v)); break;
+          case REG_FILE_ACCESS_LENGTH: memcpy(p, &file_length, sizeof(v)); break;
+          case REG_FILE_OPERATION_RESULT: memcpy(p, &file_result, sizeof(v)); break;
+
+          case REG_FILE_SIZE:
+            v=file_data.size();
+            memcpy(p, &v, sizeof(v));
+            break;
+
+          case REG_FRAME_RATE: d=rate.load(); memcpy(p, &d, sizeof(d)); break;
+          case REG_BASELINE: d=0.065; memcpy(p, &d, sizeof(d)); break;
+          case REG_FOCAL_LENGTH_FACTOR: d=0.8; memcpy(p, &d, sizeof(d)); break;
+          case REG_COORDINATE_SCALE: d=0.0625; memcpy(p, &d, sizeof(d)); break;
+
+          default:
+            return setError(GenTL::GC_ERR_INVALID_ADDRESS, "Invalid address");
+        }
+
+        return GenTL::GC_ERR_SUCCESS;
+      }
+
+      return setError(GenTL::GC_ERR_INVALID_ADDRESS, "Invalid address or size");
+    }
+
+    GenTL::GC_ERROR writeRegister(uint64_t address, const uint8_t *p, size_t size)
+    {
+      if (readonly)
+      {
+        return setError(GenTL::GC_ERR_ACCESS_DENIED, "Device is opened read only");
+      }
+
+      if (address >= REG_FILE_ACCESS_BUFFER &&
+          address < REG_FILE_ACCESS_BUFFER+REPLAY_FILE_BUFFER_SIZE)
+      {
+        if (size > REG_FILE_ACCESS_BUFFER+REPLAY_FILE_BUFFER_SIZE-address)
+        {
+          return setError(GenTL::GC_ERR_INVALID_ADDRESS, "Invalid address or size");
+        }
+
+        memcpy(file_buffer.data()+(address-REG_FILE_ACCESS_BUFFER), p, size);
+
+        return GenTL::GC_ERR_SUCCESS;
+      }
+
+      if (size == 4)
+      {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+
+        // image parameters are fixed while streaming or for recordings
+
+        if ((address == REG_WIDTH || address == REG_HEIGHT || address == REG_PIXELFORMAT ||
+             address == REG_MULTIPART || address == REG_CHUNK_MODE) && (locked || recording))
+        {
+          return setError(GenTL::GC_ERR_ACCESS_DENIED, "Parameter cannot be changed");
+        }
+
+        switch (address)
+        {
+          case REG_WIDTH:
+            if (v < 4 || v > 8192 || (v&0x3) != 0)
+            {
+              return setError(GenTL::GC_ERR_INVALID_VALUE, "Invalid width");
+            }
+            width=v;
+            break;
+
+          case REG_HEIGHT:
+            if (v < 1 || v > 8192)
+            {
+              return setError(GenTL::GC_ERR_INVALID_VALUE, "Invalid height");
+            }
+            height=v;
+            break;
+
+          case REG_PIXELFORMAT:
+            if (!ReplaySyntheticSource::isFormatSupported(v))
+            {
+              return setError(GenTL::GC_ERR_INVALID_VALUE, "Pixel format not supported");
+            }
+            pixelformat=v;
+            break;
+
+          case REG_ACQ_MODE:
+            break;
+
+          case REG_ACQ_START:
+            acquiring.store(true);
+            break;
+
+          case REG_ACQ_STOP:
+            acquiring.store(false);
+            break;
+
+          case REG_TL_PARAMS_LOCKED:
+            locked=(v != 0 ? 1 : 0);
+            break;
+
+          case REG_MULTIPART:
+            multipart=(v != 0 ? 1 : 0);
+            break;
+
+          case REG_COMP_SELECTOR:
+            if (v >= RC_COUNT)
+            {
+              return setError(GenTL::GC_ERR_INVALID_VALUE, "Invalid component");
+            }
+            selector=v;
+            break;
+
+          case REG_CHUNK_MODE:
+            chunk_mode=(v != 0 ? 1 : 0);
+            break;
+
+          case REG_CHUNK_COMP_SELECTOR:
+            if (v >= RC_COUNT)
+            {
+              return setError(GenTL::GC_ERR_INVALID_VALUE, "Invalid component");
+            }
+            chunk_selector=v;
+            break;
+
+          case REG_FILE_SELECTOR:
+            if (v != 0)
+            {
+              return setError(GenTL::GC_ERR_INVALID_VALUE, "Invalid file");
+            }
+            file_selector=v;
+            break;
+
+          case REG_FILE_OPERATION_SELECTOR:
+            if (v > FILE_OP_DELETE)
+            {
+              return setError(GenTL::GC_ERR_INVALID_VALUE, "Invalid file operation");
+            }
+            file_operation=v;
+            break;
+
+          case REG_FILE_OPERATION_EXECUTE:
+            executeFileOperation();
+            break;
+
+          case REG_FILE_OPEN_MODE:
+            if (v > FILE_MODE_READWRITE)
+            {
+              return setError(GenTL::GC_ERR_INVALID_VALUE, "Invalid file open mode");
+            }
+            file_mode=v;
+            break;
+
+          default:
+            if (address >= REG_COMP_ENABLE && address < REG_COMP_ENABLE+4*RC_COUNT &&
+                (address&0x3) == 0)
+            {
+              if (locked && !recording)
+              {
+                return setError(GenTL::GC_ERR_ACCESS_DENIED, "Parameter cannot be changed");
+              }
+
+              enable[(address-REG_COMP_ENABLE)/4]=(v != 0);
+            }
+            else
+            {
+              return setError(GenTL::GC_ERR_INVALID_ADDRESS, "Invalid address");
+            }
+            break;
+        }
+
+        return GenTL::GC_ERR_SUCCESS;
+      }
+      else if (size == 8 &&
+               (address == REG_FILE_ACCESS_OFFSET || address == REG_FILE_ACCESS_LENGTH))
+      {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+
+        if (address == REG_FILE_ACCESS_OFFSET)
+        {
+          if (v > REPLAY_FILE_SIZE_MAX)
+          {
+            return setError(GenTL::GC_ERR_INVALID_VALUE, "Invalid file access offset");
+          }
+
+          file_offset=v;
+        }
+        else
+        {
+          if (v > REPLAY_FILE_BUFFER_SIZE)
+          {
+            return setError(GenTL::GC_ERR_INVALID_VALUE, "Invalid file access length");
+          }
+
+          file_length=v;
+        }
+
+        return GenTL::GC_ERR_SUCCESS;
+      }
+      else if (size == 8 && address == REG_FRAME_RATE)
+      {
+        double d;
+        memcpy(&d, p, sizeof(d));
+
+        if (!(d >= 0 && d <= 1000))
+        {
+          return setError(GenTL::GC_ERR_INVALID_VALUE, "Invalid frame rate");
+        }
+
+        rate.store(d);
+
+        return GenTL::GC_ERR_SUCCESS;
+      }
+
+      return setError(GenTL::GC_ERR_ACCESS_DENIED, "Register is read only");
+    }
+
+  private:
+
+    /*
+      Executes the selected file operation on the file, which is only kept in
+      memory as long as the device is open. Opening a file for writing
+      truncates it. The result of read and write operations is the number of
+      transferred bytes.
+    */
+
+    void executeFileOperation()
+    {
+      bool ok=false;
+      file_result=0;
+
+      switch (file_operation)
+      {
+        case FILE_OP_OPEN:
+          if (!file_open)
+          {
+            if (file_mode == FILE_MODE_WRITE)
+            {
+              file_data.clear();
+            }
+
+            file_open=true;
+            ok=true;
+          }
+          break;
+
+        case FILE_OP_CLOSE:
+          ok=file_open;
+          file_open=false;
+          break;
+
+        case FILE_OP_READ:
+          if (file_open && file_mode != FILE_MODE_WRITE && file_offset <= file_data.size())
+          {
+            file_result=std::min(file_length, static_cast<uint64_t>(file_data.size()-file_offset));
+            memcpy(file_buffer.data(), file_data.data()+file_offset,
+                   static_cast<size_t>(file_result));
+            ok=true;
+          }
+          break;
+
+        case FILE_OP_WRITE:
+          if (file_open && file_mode != FILE_MODE_READ && file_offset <= file_data.size() &&
+              file_offset+file_length <= REPLAY_FILE_SIZE_MAX)
+          {
+            if (file_offset+file_length > file_data.size())
+            {
+              file_data.resize(static_cast<size_t>(file_offset+file_length));
+            }
+
+            memcpy(file_data.data()+file_offset, file_buffer.data(),
+                   static_cast<size_t>(file_length));
+            file_result=file_length;
+            ok=true;
+          }
+          break;
+
+        case FILE_OP_DELETE:
+          if (!file_open)
+          {
+            file_data.clear();
+            ok=true;
+          }
+          break;
+      }
+
+      file_status=(ok ? FILE_STATUS_SUCCESS : FILE_STATUS_FAILURE);
+    }
+
+    std::string createNodes() const
+    {
+      std::ostringstream out;
+
+      const char *size_access=(recording ? "RO" : "RW");
+
+      // formats that can be generated and the format of the recording
+
+      std::vector<uint64_t> format;
+      format.push_back(Mono8);
+      format.push_back(Mono16);
+      format.push_back(RGB8);
+      format.push_back(YCbCr411_8);
+
+      if (recording && std::find(format.begin(), format.end(), pixelformat) == format.end())
+      {
+        format.push_back(pixelformat);
+      }
+
+      out << "  <Integer Name=\"Width\" NameSpace=\"Standard\">\n"
+          << "    <pIsLocked>TLParamsLocked</pIsLocked>\n"
+          << "    <pValue>WidthReg</pValue>\n"
+          << "    <Min>4</Min>\n"
+          << "    <Max>8192</Max>\n"
+          << "    <Inc>4</Inc>\n"
+          << "  </Integer>\n"
+          << intReg("WidthReg", REG_WIDTH, 4, size_access)
+          << "  <Integer Name=\"Height\" NameSpace=\"Standard\">\n"
+          << "    <pIsLocked>TLParamsLocked</pIsLocked>\n"
+          << "    <pValue>HeightReg</pValue>\n"
+          << "    <Min>1</Min>\n"
+          << "    <Max>8192</Max>\n"
+          << "  </Integer>\n"
+          << intReg("HeightReg", REG_HEIGHT, 4, size_access)
+          << "  <Enumeration Name=\"PixelFormat\" NameSpace=\"Standard\">\n"
+          << "    <pIsLocked>TLParamsLocked</pIsLocked>\n";
+
+      for (size_t i=0; i<format.size(); i++)
+      {
+        std::string name=getFormatName(format[i]);
+
+        if (!isSymbolic(name))
+        {
+          name="Recorded";
+        }
+
+        out << "    <EnumEntry Name=\"" << name << "\" NameSpace=\"Standard\">\n"
+            << "      <Value>0x" << std::hex << format[i] << std::dec << "</Value>\n"
+            << "    </EnumEntry>\n";
+      }
+
+      out << "    <pValue>PixelFormatReg</pValue>\n"
+          << "  </Enumeration>\n"
+          << intReg("PixelFormatReg", REG_PIXELFORMAT, 4, size_access)
+          << intReg("PayloadSize", REG_PAYLOAD_SIZE, 8, "RO")
+          << "  <Enumeration Name=\"AcquisitionMode\" NameSpace=\"Standard\">\n"
+          << "    <EnumEntry Name=\"Continuous\" NameSpace=\"Standard\">\n"
+          << "      <Value>0</Value>\n"
+          << "    </EnumEntry>\n"
+          << "    <pValue>AcquisitionModeReg</pValue>\n"
+          << "  </Enumeration>\n"
+          << intReg("AcquisitionModeReg", REG_ACQ_MODE, 4, "RW")
+          << "  <Command Name=\"AcquisitionStart\" NameSpace=\"Standard\">\n"
+          << "    <pValue>AcquisitionStartReg</pValue>\n"
+          << "    <CommandValue>1</CommandValue>\n"
+          << "  </Command>\n"
+          << intReg("AcquisitionStartReg", REG_ACQ_START, 4, "RW")
+          << "  <Command Name=\"AcquisitionStop\" NameSpace=\"Standard\">\n"
+          << "    <pValue>AcquisitionStopReg</pValue>\n"
+          << "    <CommandValue>1</CommandValue>\n"
+          << "  </Command>\n"
+          << intReg("AcquisitionStopReg", REG_ACQ_STOP, 4, "RW")
+          << "  <Float Name=\"AcquisitionFrameRate\" NameSpace=\"Standard\">\n"
+          << "    <pValue>AcquisitionFrameRateReg</pValue>\n"
+          << "    <Min>0</Min>\n"
+          << "    <Max>1000</Max>\n"
+          << "    <Unit>Hz</Unit>\n"
+          << "  </Float>\n"
+          << floatReg("AcquisitionFrameRateReg", REG_FRAME_RATE, "RW")
+          << "  <Enumeration Name=\"AcquisitionMultiPartMode\" NameSpace=\"Standard\">\n"
+          << "    <pIsLocked>TLParamsLocked</pIsLocked>\n"
+          << "    <EnumEntry Name=\"SingleComponent\" NameSpace=\"Standard\">\n"
+          << "      <Value>0</Value>\n"
+          << "    </EnumEntry>\n"
+          << "    <EnumEntry Name=\"SynchronizedComponents\" NameSpace=\"Standard\">\n"
+          << "      <Value>1</Value>\n"
+          << "    </EnumEntry>\n"
+          << "    <pValue>MultiPartModeReg</pValue>\n"
+          << "  </Enumeration>\n"
+          << intReg("MultiPartModeReg", REG_MULTIPART, 4, size_access)
+          << "  <Enumeration Name=\"ComponentSelector\" NameSpace=\"Standard\">\n";
+
+      for (int i=0; i<RC_COUNT; i++)
+      {
+        out << "    <EnumEntry Name=\"" << component_name[i] << "\" NameSpace=\"Standard\">\n"
+            << "      <Value>" << i << "</Value>\n"
+            << "    </EnumEntry>\n";
+      }
+
+      out << "    <pValue>ComponentSelectorReg</pValue>\n"
+          << "    <pSelected>ComponentEnable</pSelected>\n"
+          << "  </Enumeration>\n"
+          << intReg("ComponentSelectorReg", REG_COMP_SELECTOR, 4, "RW")
+          << "  <Boolean Name=\"ComponentEnable\" NameSpace=\"Standard\">\n"
+          << "    <pIsLocked>TLParamsLocked</pIsLocked>\n"
+          << "    <pValue>ComponentEnableReg</pValue>\n"
+          << "    <OnValue>1</OnValue>\n"
+          << "    <OffValue>0</OffValue>\n"
+          << "  </Boolean>\n"
+          << "  <IntReg Name=\"ComponentEnableReg\" NameSpace=\"Custom\">\n"
+          << "    <Address>0x" << std::hex << REG_COMP_ENABLE << std::dec << "</Address>\n"
+          << "    <pIndex Offset=\"4\">ComponentSelectorReg</pIndex>\n"
+          << "    <Length>4</Length>\n"
+          << "    <AccessMode>RW</AccessMode>\n"
+          << "    <pPort>Device</pPort>\n"
+          << "    <Cachable>NoCache</Cachable>\n"
+          << "    <Sign>Unsigned</Sign>\n"
+          << "    <Endianess>LittleEndian</Endianess>\n"
+          << "  </IntReg>\n"
+          << "  <Integer Name=\"TLParamsLocked\" NameSpace=\"Standard\">\n"
+          << "    <Visibility>Invisible</Visibility>\n"
+          << "    <pValue>TLParamsLockedReg</pValue>\n"
+          << "    <Min>0</Min>\n"
+          << "    <Max>1</Max>\n"
+          << "  </Integer>\n"
+          << intReg("TLParamsLockedReg", REG_TL_PARAMS_LOCKED, 4, "RW")
+          << floatReg("Baseline", REG_BASELINE, "RO")
+          << floatReg("FocalLengthFactor", REG_FOCAL_LENGTH_FACTOR, "RO")
+          << "  <Enumeration Name=\"Scan3dOutputMode\" NameSpace=\"Standard\">\n"
+          << "    <EnumEntry Name=\"DisparityC\" NameSpace=\"Standard\">\n"
+          << "      <Value>0</Value>\n"
+          << "    </EnumEntry>\n"
+          << "    <Value>0</Value>\n"
+          << "  </Enumeration>\n"
+          << floatReg("Scan3dCoordinateScale", REG_COORDINATE_SCALE, "RO")
+          << "  <Float Name=\"Scan3dCoordinateOffset\" NameSpace=\"Standard\">\n"
+          << "    <Value>0</Value>\n"
+          << "  </Float>\n"
+          << "  <Boolean Name=\"Scan3dInvalidDataFlag\" NameSpace=\"Standard\">\n"
+          << "    <Value>true</Value>\n"
+          << "  </Boolean>\n"
+          << "  <Float Name=\"Scan3dInvalidDataValue\" NameSpace=\"Standard\">\n"
+          << "    <Value>0</Value>\n"
+          << "  </Float>\n"
+          << intReg("ReplayNumFrames", REG_NUM_FRAMES, 8, "RO")
+          << createChunkNodes()
+          << createFileNodes();
+
+      return out.str();
+    }
+
+    /*
+      Creates the features for chunk data of synthetic frames. The values are
+      read from the chunk with the ID RC_CHUNK_ID. Width, height and pixel
+      format depend on ChunkComponentSelector.
+    */
+
+    std::string createChunkNodes() const
+    {
+      std::ostringstream out;
+
+      out << "  <Category Name=\"ChunkDataControl\" NameSpace=\"Standard\">\n"
+          << "    <pFeature>ChunkModeActive</pFeature>\n"
+          << "    <pFeature>ChunkComponentSelector</pFeature>\n"
+          << "    <pFeature>ChunkWidth</pFeature>\n"
+          << "    <pFeature>ChunkHeight</pFeature>\n"
+          << "    <pFeature>ChunkPixelFormat</pFeature>\n"
+          << "    <pFeature>ChunkExposureTime</pFeature>\n"
+          << "    <pFeature>ChunkGain</pFeature>\n"
+          << "    <pFeature>ChunkScan3dFocalLength</pFeature>\n"
+          << "    <pFeature>ChunkScan3dBaseline</pFeature>\n"
+          << "    <pFeature>ChunkScan3dPrincipalPointU</pFeature>\n"
+          << "    <pFeature>ChunkScan3dPrincipalPointV</pFeature>\n"
+          << "    <pFeature>ChunkScan3dCoordinateScale</pFeature>\n"
+          << "    <pFeature>ChunkScan3dCoordinateOffset</pFeature>\n"
+          << "    <pFeature>ChunkScan3dInvalidDataFlag</pFeature>\n"
+          << "    <pFeature>ChunkScan3dInvalidDataValue</pFeature>\n"
+          << "    <pFeature>ChunkLineStatusAll</pFeature>\n"
+          << "  </Category>\n"
+          << "  <Boolean Name=\"ChunkModeActive\" NameSpace=\"Standard\">\n"
+          << "    <pIsLocked>TLParamsLocked</pIsLocked>\n"
+          << "    <pValue>ChunkModeActiveReg</pValue>\n"
+          << "    <OnValue>1</OnValue>\n"
+          << "    <OffValue>0</OffValue>\n"
+          << "  </Boolean>\n"
+          << intReg("ChunkModeActiveReg", REG_CHUNK_MODE, 4, recording ? "RO" : "RW")
+          << "  <Enumeration Name=\"ChunkComponentSelector\" NameSpace=\"Standard\">\n";
+
+      for (int i=0; i<RC_COUNT; i++)
+      {
+        out << "    <EnumEntry Name=\"" << component_name[i] << "\" NameSpace=\"Standard\">\n"
+            << "      <Value>" << i << "</Value>\n"
+            << "    </EnumEntry>\n";
+      }
+
+      out << "    <pValue>ChunkComponentSelectorReg</pValue>\n"
+          << "    <pSelected>ChunkWidth</pSelected>\n"
+          << "    <pSelected>ChunkHeight</pSelected>\n"
+          << "    <pSelected>ChunkPixelFormat</pSelected>\n"
+          << "  </Enumeration>\n"
+          << intReg("ChunkComponentSelectorReg", REG_CHUNK_COMP_SELECTOR, 4, "RW")
+          << chunkReg("IntReg", "ChunkWidth", RC_CHUNK_WIDTH, 4, true)
+          << chunkReg("IntReg", "ChunkHeight", RC_CHUNK_HEIGHT, 4, true)
+          << chunkReg("IntReg", "ChunkPixelFormat", RC_CHUNK_PIXELFORMAT, 4, true)
+          << chunkReg("FloatReg", "ChunkExposureTime", RC_CHUNK_EXPOSURE_TIME, 8, false)
+          << chunkReg("FloatReg", "ChunkGain", RC_CHUNK_GAIN, 8, false)
+          << chunkReg("FloatReg", "ChunkScan3dFocalLength", RC_CHUNK_FOCAL_LENGTH, 8, false)
+          << chunkReg("FloatReg", "ChunkScan3dBaseline", RC_CHUNK_BASELINE, 8, false)
+          << chunkReg("FloatReg", "ChunkScan3dPrincipalPointU", RC_CHUNK_PRINCIPAL_POINT_U, 8,
+                      false)
+          << chunkReg("FloatReg", "ChunkScan3dPrincipalPointV", RC_CHUNK_PRINCIPAL_POINT_V, 8,
+                      false)
+          << chunkReg("FloatReg", "ChunkScan3dCoordinateScale", RC_CHUNK_COORDINATE_SCALE, 8,
+                      false)
+          << chunkReg("FloatReg", "ChunkScan3dCoordinateOffset", RC_CHUNK_COORDINATE_OFFSET, 8,
+                      false)
+          << "  <Boolean Name=\"ChunkScan3dInvalidDataFlag\" NameSpace=\"Standard\">\n"
+          << "    <pValue>ChunkScan3dInvalidDataFlagReg</pValue>\n"
+          << "    <OnValue>1</OnValue>\n"
+          << "    <OffValue>0</OffValue>\n"
+          << "  </Boolean>\n"
+          << chunkReg("IntReg", "ChunkScan3dInvalidDataFlagReg", RC_CHUNK_INVALID_DATA_FLAG, 4,
+                      false)
+          << chunkReg("FloatReg", "ChunkScan3dInvalidDataValue", RC_CHUNK_INVALID_DATA_VALUE, 8,
+                      false)
+          << chunkReg("IntReg", "ChunkLineStatusAll", RC_CHUNK_LINE_STATUS_ALL, 4, false)
+          << "  <Port Name=\"ChunkPort\" NameSpace=\"Custom\">\n"
+          << "    <ChunkID>" << std::hex << RC_CHUNK_ID << std::dec << "</ChunkID>\n"
+          << "  </Port>\n";
+
+      return out.str();
+    }
+
+    /*
+      Creates the features of the file access with one file, which can be
+      used with the file protocol adapter of GenApi, e.g. for measuring the
+      throughput of loadFile() and saveFile() of the library.
+    */
+
+    std::string createFileNodes() const
+    {
+      std::ostringstream out;
+
+      const char *access=(readonly ? "RO" : "RW");
+
+      out << "  <Category Name=\"FileAccessControl\" NameSpace=\"Standard\">\n"
+          << "    <pFeature>FileSelector</pFeature>\n"
+          << "    <pFeature>FileOperationSelector</pFeature>\n"
+          << "    <pFeature>FileOperationExecute</pFeature>\n"
+          << "    <pFeature>FileOpenMode</pFeature>\n"
+          << "    <pFeature>FileAccessBuffer</pFeature>\n"
+          << "    <pFeature>FileAccessOffset</pFeature>\n"
+          << "    <pFeature>FileAccessLength</pFeature>\n"
+          << "    <pFeature>FileOperationStatus</pFeature>\n"
+          << "    <pFeature>FileOperationResult</pFeature>\n"
+          << "    <pFeature>FileSize</pFeature>\n"
+          << "  </Category>\n"
+          << "  <Enumeration Name=\"FileSelector\" NameSpace=\"Standard\">\n"
+          << "    <EnumEntry Name=\"UserData\" NameSpace=\"Standard\">\n"
+          << "      <Value>0</Value>\n"
+          << "    </EnumEntry>\n"
+          << "    <pValue>FileSelectorReg</pValue>\n"
+          << "    <pSelected>FileOperationSelector</pSelected>\n"
+          << "    <pSelected>FileOperationExecute</pSelected>\n"
+          << "    <pSelected>FileOpenMode</pSelected>\n"
+          << "    <pSelected>FileAccessBuffer</pSelected>\n"
+          << "    <pSelected>FileAccessOffset</pSelected>\n"
+          << "    <pSelected>FileAccessLength</pSelected>\n"
+          << "    <pSelected>FileOperationStatus</pSelected>\n"
+          << "    <pSelected>FileOperationResult</pSelected>\n"
+          << "    <pSelected>FileSize</pSelected>\n"
+          << "  </Enumeration>\n"
+          << intReg("FileSelectorReg", REG_FILE_SELECTOR, 4, "RW")
+          << "  <Enumeration Name=\"FileOperationSelector\" NameSpace=\"Standard\">\n";
+
+      const char *operation[]={ "Open", "Close", "Read", "Write", "Delete" };
+
+      for (int i=0; i<=FILE_OP_DELETE; i++)
+      {
+        out << "    <EnumEntry Name=\"" << operation[i] << "\" NameSpace=\"Standard\">\n"
+            << "      <Value>" << i << "</Value>\n"
+            << "    </EnumEntry>\n";
+      }
+
+      out << "    <pValue>FileOperationSelectorReg</pValue>\n"
+          << "    <pSelected>FileOperationExecute</pSelected>\n"
+          << "    <pSelected>FileOpenMode</pSelected>\n"
+          << "    <pSelected>FileAccessBuffer</pSelected>\n"
+          << "    <pSelected>FileAccessOffset</pSelected>\n"
+          << "    <pSelected>FileAccessLength</pSelected>\n"
+          << "    <pSelected>FileOperationStatus</pSelected>\n"
+          << "    <pSelected>FileOperationResult</pSelected>\n"
+          << "  </Enumeration>\n"
+          << intReg("FileOperationSelectorReg", REG_FILE_OPERATION_SELECTOR, 4, "RW")
+          << "  <Command Name=\"FileOperationExecute\" NameSpace=\"Standard\">\n"
+          << "    <pValue>FileOperationExecuteReg</pValue>\n"
+          << "    <CommandValue>1</CommandValue>\n"
+          << "  </Command>\n"
+          << intReg("FileOperationExecuteReg", REG_FILE_OPERATION_EXECUTE, 4, access)
+          << "  <Enumeration Name=\"FileOpenMode\" NameSpace=\"Standard\">\n"
+          << "    <EnumEntry Name=\"Read\" NameSpace=\"Standard\">\n"
+          << "      <Value>" << FILE_MODE_READ << "</Value>\n"
+          << "    </EnumEntry>\n"
+          << "    <EnumEntry Name=\"Write\" NameSpace=\"Standard\">\n"
+          << "      <Value>" << FILE_MODE_WRITE << "</Value>\n"
+          << "    </EnumEntry>\n"
+          << "    <EnumEntry Name=\"ReadWrite\" NameSpace=\"Standard\">\n"
+          << "      <Value>" << FILE_MODE_READWRITE << "</Value>\n"
+          << "    </EnumEntry>\n"
+          << "    <pValue>FileOpenModeReg</pValue>\n"
+          << "  </Enumeration>\n"
+          << intReg("FileOpenModeReg", REG_FILE_OPEN_MODE, 4, "RW")
+          << "  <Register Name=\"FileAccessBuffer\" NameSpace=\"Standard\">\n"
+          << "    <Address>0x" << std::hex << REG_FILE_ACCESS_BUFFER << std::dec << "</Address>\n"
+          << "    <Length>" << REPLAY_FILE_BUFFER_SIZE << "</Length>\n"
+          << "    <AccessMode>" << access << "</AccessMode>\n"
+          << "    <pPort>Device</pPort>\n"
+          << "    <Cachable>NoCache</Cachable>\n"
+          << "  </Register>\n"
+          << "  <Integer Name=\"FileAccessOffset\" NameSpace=\"Standard\">\n"
+          << "    <pValue>FileAccessOffsetReg</pValue>\n"
+          << "    <Min>0</Min>\n"
+          << "    <Max>" << REPLAY_FILE_SIZE_MAX << "</Max>\n"
+          << "  </Integer>\n"
+          << intReg("FileAccessOffsetReg", REG_FILE_ACCESS_OFFSET, 8, access)
+          << "  <Integer Name=\"FileAccessLength\" NameSpace=\"Standard\">\n"
+          << "    <pValue>FileAccessLengthReg</pValue>\n"
+          << "    <Min>0</Min>\n"
+          << "    <Max>" << REPLAY_FILE_BUFFER_SIZE << "</Max>\n"
+          << "  </Integer>\n"
+          << intReg("FileAccessLengthReg", REG_FILE_ACCESS_LENGTH, 8, access)
+          << "  <Enumeration Name=\"FileOperationStatus\" NameSpace=\"Standard\">\n"
+          << "    <EnumEntry Name=\"Success\" NameSpace=\"Standard\">\n"
+          << "      <Value>" << FILE_STATUS_SUCCESS << "</Value>\n"
+          << "    </EnumEntry>\n"
+          << "    <EnumEntry Name=\"Failure\" NameSpace=\"Standard\">\n"
+          << "      <Value>" << FILE_STATUS_FAILURE << "</Value>\n"
+          << "    </EnumEntry>\n"
+          << "    <pValue>FileOperationStatusReg</pValue>\n"
+          << "  </Enumeration>\n"
+          << intReg("FileOperationStatusReg", REG_FILE_OPERATION_STATUS, 4, "RO")
+          << intReg("FileOperationResult", REG_FILE_OPERATION_RESULT, 8, "RO")
+          << intReg("FileSize", REG_FILE_SIZE, 8, "RO");
+
+      return out.str();
+    }
+
+    static std::string intReg(const char *name, uint64_t address, int length, const char *access)
+    {
+      std::ostringstream out;
+
+      out << "  <IntReg Name=\"" << name << "\" NameSpace=\"Custom\">\n"
+          << "    <Address>0x" << std::hex << address << std::dec << "</Address>\n"
+          << "    <Length>" << length << "</Length>\n"
+          << "    <AccessMode>" << access << "</AccessMode>\n"
+          << "    <pPort>Device</pPort>\n"
+          << "    <Cachable>NoCache</Cachable>\n"
+          << "    <Sign>Unsigned</Sign>\n"
+          << "    <Endianess>LittleEndian</Endianess>\n"
+          << "  </IntReg>\n";
+
+      return out.str();
+    }
+
+    static std::string floatReg(const char *name, uint64_t address, const char *access)
+    {
+      std::ostringstream out;
+
+      out << "  <FloatReg Name=\"" << name << "\" NameSpace=\"Custom\">\n"
+          << "    <Address>0x" << std::hex << address << std::dec << "</Address>\n"
+          << "    <Length>8</Length>\n"
+          << "    <AccessMode>" << access << "</AccessMode>\n"
+          << "    <pPort>Device</pPort>\n"
+          << "    <Cachable>NoCache</Cachable>\n"
+          << "    <Endianess>LittleEndian</Endianess>\n"
+          << "  </FloatReg>\n";
+
+      return out.str();
+    }
+
+    static std::string chunkReg(const char *type, const char *name, uint64_t address,
+                                int length, bool per_component)
+    {
+      std::ostringstream out;
+
+      out << "  <" << type << " Name=\"" << name << "\" NameSpace=\"Standard\">\n"
+          << "    <Address>0x" << std::hex << address << std::dec << "</Address>\n";
+
+      if (per_component)
+      {
+        out << "    <pIndex Offset=\"" << RC_CHUNK_COMPONENT_SIZE << "\">"
+            << "ChunkComponentSelectorReg</pIndex>\n";
+      }
+
+      out << "    <Length>" << length << "</Length>\n"
+          << "    <AccessMode>RO</AccessMode>\n"
+          << "    <pPort>ChunkPort</pPort>\n"
+          << "    <Cachable>NoCache</Cachable>\n";
+
+      if (std::string(type) == "IntReg")
+      {
+        out << "    <Sign>Unsigned</Sign>\n";
+      }
+
+      out << "    <Endianess>LittleEndian</Endianess>\n"
+          << "  </" << type << ">\n";
+
+      return out.str();
+    }
+
+    std::shared_ptr<ReplayRecordingSource> recording;
+    std::shared_ptr<ReplaySource> source;
+    bool readonly;
+
+    uint32_t width, source_width;
+    uint32_t height, source_height;
+    uint32_t pixelformat, source_pixelformat;
+    uint32_t multipart, source_multipart;
+    uint32_t chunk_mode, source_chunk_mode;
+    uint32_t selector;
+    uint32_t chunk_selector;
+    bool enable[RC_COUNT], source_enable[RC_COUNT];
+    uint32_t locked;
+
+    uint32_t file_selector;
+    uint32_t file_operation;
+    uint32_t file_mode;
+    uint32_t file_status;
+    uint64_t file_offset;
+    uint64_t file_length;
+    uint64_t file_result;
+    bool file_open;
+    std::vector<uint8_t> file_data;
+    std::vector<uint8_t> file_buffer;
+
+    std::atomic<double> rate;
+    std::atomic<bool> acquiring;
+};
+
+/*
+  Buffer that has been announced to a stream.
+*/
+
+enum ReplayBufferState
+{
+  BS_ANNOUNCED, BS_QUEUED, BS_ACQUIRING, BS_OUTPUT
+};
+
+struct ReplayBuffer
+{
+  uint8_t *base;
+  size_t size;
+  void *user;
+  bool allocated;
+
+  ReplayBufferState state;
+  bool new_data;
+  bool larger;
+  size_t filled;
+  ReplayFrame frame;
+};
+
+/*
+  Data stream with a thread that fills queued buffers.
+*/
+
+class ReplayDevice;
+
+class ReplayStream : public ReplayModule
+{
+  public:
+
+    ReplayStream(ReplayDevice *_parent, ReplayRemoteDevice *_remote) :
+      ReplayModule("TLDataStream", "stream0", "TLPort")
+    {
+      parent=_parent;
+      remote=_remote;
+      running=false;
+      source_n=0;
+      num_to_acquire=0;
+      acquired=0;
+      delivered=0;
+      underrun=0;
+      started=0;
+
+      addString("StreamID", getID());
+      addString("StreamType", REPLAY_TLTYPE);
+      createXML("", std::vector<std::string>());
+    }
+
+    ~ReplayStream()
+    {
+      stop();
+
+      for (size_t i=0; i<buffer.size(); i++)
+      {
+        if (buffer[i]->allocated)
+        {
+          free(buffer[i]->base);
+        }
+      }
+    }
+
+    ReplayDevice *getParent() { return parent; }
+
+    GenTL::GC_ERROR announce(void *mem, size_t size, void *user, GenTL::BUFFER_HANDLE *handle)
+    {
+      if (handle == 0 || size == 0)
+      {
+        return setError(GenTL::GC_ERR_INVALID_PARAMETER, "Invalid parameter");
+      }
+
+      std::unique_ptr<ReplayBuffer> b(new ReplayBuffer());
+
+      b->allocated=false;
+
+      if (mem == 0)
+      {
+        if (posix_memalign(&mem, REPLAY_BUFFER_ALIGN, size) != 0)
+        {
+          return setError(GenTL::GC_ERR_OUT_OF_MEMORY, "Cannot allocate buffer");
+        }
+
+        b->allocated=true;
+      }
+
+      b->base=static_cast<uint8_t *>(mem);
+      b->size=size;
+      b->user=user;
+      b->state=BS_ANNOUNCED;
+      b->new_data=false;
+      b->larger=false;
+      b->filled=0;
+      b->frame.data=0;
+      b->frame.size=0;
+
+      std::lock_guard<std::mutex> lock(mtx);
+
+      *handle=b.get();
+      buffer.push_back(std::move(b));
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR revoke(GenTL::BUFFER_HANDLE handle, void **mem, void **user)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      for (size_t i=0; i<buffer.size(); i++)
+      {
+        ReplayBuffer *b=buffer[i].get();
+
+        if (b == handle)
+        {
+          if (b->state == BS_QUEUED || b->state == BS_ACQUIRING)
+          {
+            return setError(GenTL::GC_ERR_BUSY, "Buffer is queued");
+          }
+
+          removeOutput(b);
+
+          if (mem != 0) *mem=(b->allocated ? 0 : b->base);
+          if (user != 0) *user=b->user;
+
+          if (b->allocated)
+          {
+            free(b->base);
+          }
+
+          buffer.erase(buffer.begin()+static_cast<long>(i));
+
+          return GenTL::GC_ERR_SUCCESS;
+        }
+      }
+
+      return setError(GenTL::GC_ERR_INVALID_HANDLE, "Invalid buffer handle");
+    }
+
+    GenTL::GC_ERROR getBufferID(uint32_t index, GenTL::BUFFER_HANDLE *handle)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      if (handle == 0)
+      {
+        return setError(GenTL::GC_ERR_INVALID_PARAMETER, "Invalid parameter");
+      }
+
+      if (index >= buffer.size())
+      {
+        return setError(GenTL::GC_ERR_INVALID_INDEX, "Invalid buffer index");
+      }
+
+      *handle=buffer[index].get();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR queue(GenTL::BUFFER_HANDLE handle)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      ReplayBuffer *b=find(handle);
+
+      if (b == 0)
+      {
+        return setError(GenTL::GC_ERR_INVALID_HANDLE, "Invalid buffer handle");
+      }
+
+      if (b->state == BS_QUEUED || b->state == BS_ACQUIRING)
+      {
+        return setError(GenTL::GC_ERR_RESOURCE_IN_USE, "Buffer is already queued");
+      }
+
+      removeOutput(b);
+
+      b->state=BS_QUEUED;
+      b->new_data=false;
+      input.push_back(b);
+
+      cond.notify_all();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR flush(GenTL::ACQ_QUEUE_TYPE op)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      switch (op)
+      {
+        case GenTL::ACQ_QUEUE_INPUT_TO_OUTPUT:
+          while (input.size() > 0)
+          {
+            ReplayBuffer *b=input.front();
+            input.pop_front();
+
+            b->state=BS_OUTPUT;
+            b->new_data=false;
+            deliver(b);
+          }
+          break;
+
+        case GenTL::ACQ_QUEUE_OUTPUT_DISCARD:
+          discardOutput();
+          break;
+
+        case GenTL::ACQ_QUEUE_ALL_TO_INPUT:
+          discardOutput();
+          input.clear();
+
+          for (size_t i=0; i<buffer.size(); i++)
+          {
+            if (buffer[i]->state != BS_ACQUIRING)
+            {
+              buffer[i]->state=BS_QUEUED;
+              buffer[i]->new_data=false;
+              input.push_back(buffer[i].get());
+            }
+          }
+          break;
+
+        case GenTL::ACQ_QUEUE_UNQUEUED_TO_INPUT:
+          for (size_t i=0; i<buffer.size(); i++)
+          {
+            if (buffer[i]->state == BS_ANNOUNCED)
+            {
+              buffer[i]->state=BS_QUEUED;
+              input.push_back(buffer[i].get());
+            }
+          }
+          break;
+
+        case GenTL::ACQ_QUEUE_ALL_DISCARD:
+          discardOutput();
+
+          while (input.size() > 0)
+          {
+            input.front()->state=BS_ANNOUNCED;
+            input.pop_front();
+          }
+          break;
+
+        default:
+          return setError(GenTL::GC_ERR_INVALID_PARAMETER, "Unknown flush operation");
+      }
+
+      cond.notify_all();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR start(uint64_t n)
+    {
+      std::shared_ptr<ReplaySource> s;
+
+      try
+      {
+        s=remote->getSource();
+      }
+      catch (const std::exception &ex)
+      {
+        return setError(GenTL::GC_ERR_INVALID_PARAMETER, ex.what());
+      }
+
+      std::lock_guard<std::mutex> lock(mtx);
+
+      if (running)
+      {
+        return setError(GenTL::GC_ERR_RESOURCE_IN_USE, "Acquisition is already running");
+      }
+
+      source=s;
+      num_to_acquire=n;
+      acquired=0;
+      delivered=0;
+      underrun=0;
+      started=0;
+      running=true;
+
+      thread=std::thread(&ReplayStream::run, this);
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR stop()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        if (!running && !thread.joinable())
+        {
+          return setError(GenTL::GC_ERR_RESOURCE_IN_USE, "Acquisition is not running");
+        }
+
+        running=false;
+        cond.notify_all();
+      }
+
+      thread.join();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR registerEvent(GenTL::EVENT_HANDLE *handle)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      if (event)
+      {
+        return setError(GenTL::GC_ERR_RESOURCE_IN_USE, "Event is already registered");
+      }
+
+      event=std::make_shared<ReplayEvent>(GenTL::EVENT_NEW_BUFFER,
+                                          sizeof(GenTL::EVENT_NEW_BUFFER_DATA));
+      registerHandle(event);
+
+      // buffers that have been filled before are delivered now
+
+      while (output.size() > 0)
+      {
+        ReplayBuffer *b=output.front();
+        output.pop_front();
+        deliver(b);
+      }
+
+      *handle=event.get();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR unregisterEvent()
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      if (!event)
+      {
+        return setError(GenTL::GC_ERR_INVALID_ID, "Event is not registered");
+      }
+
+      std::vector<GenTL::EVENT_NEW_BUFFER_DATA> list=event->flush();
+
+      for (size_t i=0; i<list.size(); i++)
+      {
+        output.push_back(static_cast<ReplayBuffer *>(list[i].BufferHandle));
+      }
+
+      event->kill();
+      unregisterHandle(event.get());
+      event.reset();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR getInfo(GenTL::STREAM_INFO_CMD cmd, GenTL::INFO_DATATYPE *type, void *data,
+                            size_t *size)
+    {
+      if (cmd == GenTL::STREAM_INFO_PAYLOAD_SIZE)
+      {
+        try
+        {
+          return returnSize(type, data, size, remote->getSource()->getPayloadSize());
+        }
+        catch (const std::exception &ex)
+        {
+          return setError(GenTL::GC_ERR_INVALID_PARAMETER, ex.what());
+        }
+      }
+
+      std::lock_guard<std::mutex> lock(mtx);
+
+      switch (cmd)
+      {
+        case GenTL::STREAM_INFO_ID:
+          return returnString(type, data, size, getID());
+
+        case GenTL::STREAM_INFO_NUM_DELIVERED:
+          return returnUInt64(type, data, size, delivered);
+
+        case GenTL::STREAM_INFO_NUM_UNDERRUN:
+          return returnUInt64(type, data, size, underrun);
+
+        case GenTL::STREAM_INFO_NUM_ANNOUNCED:
+          return returnSize(type, data, size, buffer.size());
+
+        case GenTL::STREAM_INFO_NUM_QUEUED:
+          return returnSize(type, data, size, input.size());
+
+        case GenTL::STREAM_INFO_NUM_AWAIT_DELIVERY:
+          return returnSize(type, data, size, output.size()+(event ? event->getNumInQueue() : 0));
+
+        case GenTL::STREAM_INFO_NUM_STARTED:
+          return returnUInt64(type, data, size, started);
+
+        case GenTL::STREAM_INFO_IS_GRABBING:
+          return returnBool(type, data, size, running);
+
+        case GenTL::STREAM_INFO_DEFINES_PAYLOADSIZE:
+          return returnBool(type, data, size, true);
+
+        case GenTL::STREAM_INFO_TLTYPE:
+          return returnString(type, data, size, REPLAY_TLTYPE);
+
+        case GenTL::STREAM_INFO_NUM_CHUNKS_MAX:
+          return returnSize(type, data, size, 1);
+
+        case GenTL::STREAM_INFO_BUF_ANNOUNCE_MIN:
+          return returnSize(type, data, size, 1);
+
+        case GenTL::STREAM_INFO_BUF_ALIGNMENT:
+          return returnSize(type, data, size, REPLAY_BUFFER_ALIGN);
+
+        default:
+          return notImplemented();
+      }
+    }
+
+    GenTL::GC_ERROR getBufferInfo(GenTL::BUFFER_HANDLE handle, GenTL::BUFFER_INFO_CMD cmd,
+                                  GenTL::INFO_DATATYPE *type, void *data, size_t *size)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      ReplayBuffer *b=find(handle);
+
+      if (b == 0)
+      {
+        return setError(GenTL::GC_ERR_INVALID_HANDLE, "Invalid buffer handle");
+      }
+
+      const ReplayFrame &f=b->frame;
+      const bool multipart=(f.payload_type == GenTL::PAYLOAD_TYPE_MULTI_PART);
+
+      ReplayPart p;
+      memset(&p, 0, sizeof(p));
+
+      if (!multipart && f.part.size() > 0)
+      {
+        p=f.part[0];
+      }
+
+      switch (cmd)
+      {
+        case GenTL::BUFFER_INFO_BASE:
+          return returnValue<void *>(type, data, size, GenTL::INFO_DATATYPE_PTR, b->base);
+
+        case GenTL::BUFFER_INFO_SIZE:
+          return returnSize(type, data, size, b->size);
+
+        case GenTL::BUFFER_INFO_USER_PTR:
+          return returnValue<void *>(type, data, size, GenTL::INFO_DATATYPE_PTR, b->user);
+
+        case GenTL::BUFFER_INFO_TIMESTAMP:
+        case GenTL::BUFFER_INFO_TIMESTAMP_NS:
+          return returnUInt64(type, data, size, f.timestamp_ns);
+
+        case GenTL::BUFFER_INFO_NEW_DATA:
+          return returnBool(type, data, size, b->new_data);
+
+        case GenTL::BUFFER_INFO_IS_QUEUED:
+          return returnBool(type, data, size, b->state == BS_QUEUED);
+
+        case GenTL::BUFFER_INFO_IS_ACQUIRING:
+          return returnBool(type, data, size, b->state == BS_ACQUIRING);
+
+        case GenTL::BUFFER_INFO_IS_INCOMPLETE:
+          return returnBool(type, data, size, f.incomplete || b->larger);
+
+        case GenTL::BUFFER_INFO_TLTYPE:
+          return returnString(type, data, size, REPLAY_TLTYPE);
+
+        case GenTL::BUFFER_INFO_SIZE_FILLED:
+          return returnSize(type, data, size, b->filled);
+
+        case GenTL::BUFFER_INFO_WIDTH:
+          return returnSize(type, data, size, p.width);
+
+        case GenTL::BUFFER_INFO_HEIGHT:
+        case GenTL::BUFFER_INFO_DELIVERED_IMAGEHEIGHT:
+          return returnSize(type, data, size, p.height);
+
+        case GenTL::BUFFER_INFO_XOFFSET:
+          return returnSize(type, data, size, p.xoffset);
+
+        case GenTL::BUFFER_INFO_YOFFSET:
+          return returnSize(type, data, size, p.yoffset);
+
+        case GenTL::BUFFER_INFO_XPADDING:
+          return returnSize(type, data, size, p.xpadding);
+
+        case GenTL::BUFFER_INFO_YPADDING:
+          return returnSize(type, data, size, f.ypadding);
+
+        case GenTL::BUFFER_INFO_FRAMEID:
+          return returnUInt64(type, data, size, f.frameid);
+
+        case GenTL::BUFFER_INFO_IMAGEPRESENT:
+          return returnBool(type, data, size, !multipart && f.part.size() > 0 &&
+                            p.image_present);
+
+        case GenTL::BUFFER_INFO_IMAGEOFFSET:
+          return returnSize(type, data, size, p.offset);
+
+        case GenTL::BUFFER_INFO_PAYLOADTYPE:
+          return returnSize(type, data, size, static_cast<size_t>(f.payload_type));
+
+        case GenTL::BUFFER_INFO_PIXELFORMAT:
+          return returnUInt64(type, data, size, p.pixelformat);
+
+        case GenTL::BUFFER_INFO_PIXELFORMAT_NAMESPACE:
+          return returnUInt64(type, data, size, GenTL::PIXELFORMAT_NAMESPACE_PFNC_32BIT);
+
+        case GenTL::BUFFER_INFO_DELIVERED_CHUNKPAYLOADSIZE:
+          {
+            size_t n=0;
+            for (size_t i=0; i<f.chunk.size(); i++)
+            {
+              n+=f.chunk[i].length;
+            }
+
+            return returnSize(type, data, size, n);
+          }
+
+        case GenTL::BUFFER_INFO_CHUNKLAYOUTID:
+          return returnUInt64(type, data, size, f.chunk_layout_id);
+
+        case GenTL::BUFFER_INFO_PIXEL_ENDIANNESS:
+          return returnValue<int32_t>(type, data, size, GenTL::INFO_DATATYPE_INT32,
+                                      f.bigendian ? GenTL::PIXELENDIANNESS_BIG :
+                                                    GenTL::PIXELENDIANNESS_LITTLE);
+
+        case GenTL::BUFFER_INFO_DATA_SIZE:
+          return returnSize(type, data, size, f.size);
+
+        case GenTL::BUFFER_INFO_DATA_LARGER_THAN_BUFFER:
+          return returnBool(type, data, size, b->larger);
+
+        case GenTL::BUFFER_INFO_CONTAINS_CHUNKDATA:
+          return returnBool(type, data, size, f.contains_chunkdata);
+
+        default:
+          return notImplemented();
+      }
+    }
+
+    GenTL::GC_ERROR getBufferChunkData(GenTL::BUFFER_HANDLE handle, GenTL::SINGLE_CHUNK_DATA *list,
+                                       size_t *n)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      ReplayBuffer *b=find(handle);
+
+      if (b == 0 || n == 0)
+      {
+        return setError(GenTL::GC_ERR_INVALID_HANDLE, "Invalid buffer handle");
+      }
+
+      const std::vector<ReplayChunk> &chunk=b->frame.chunk;
+
+      if (chunk.size() == 0)
+      {
+        *n=0;
+        return setError(GenTL::GC_ERR_NO_DATA, "Buffer does not contain chunk data");
+      }
+
+      if (list == 0)
+      {
+        *n=chunk.size();
+        return GenTL::GC_ERR_SUCCESS;
+      }
+
+      if (*n < chunk.size())
+      {
+        *n=chunk.size();
+        return setError(GenTL::GC_ERR_BUFFER_TOO_SMALL, "Chunk list is too small");
+      }
+
+      for (size_t i=0; i<chunk.size(); i++)
+      {
+        list[i].ChunkID=chunk[i].id;
+        list[i].ChunkOffset=static_cast<ptrdiff_t>(chunk[i].offset);
+        list[i].ChunkLength=chunk[i].length;
+      }
+
+      *n=chunk.size();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR getNumBufferParts(GenTL::BUFFER_HANDLE handle, uint32_t *n)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      ReplayBuffer *b=find(handle);
+
+      if (b == 0 || n == 0)
+      {
+        return setError(GenTL::GC_ERR_INVALID_HANDLE, "Invalid buffer handle");
+      }
+
+      *n=0;
+
+      if (b->frame.payload_type == GenTL::PAYLOAD_TYPE_MULTI_PART)
+      {
+        *n=static_cast<uint32_t>(b->frame.part.size());
+      }
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR getBufferPartInfo(GenTL::BUFFER_HANDLE handle, uint32_t i,
+                                      GenTL::BUFFER_PART_INFO_CMD cmd, GenTL::INFO_DATATYPE *type,
+                                      void *data, size_t *size)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      ReplayBuffer *b=find(handle);
+
+      if (b == 0)
+      {
+        return setError(GenTL::GC_ERR_INVALID_HANDLE, "Invalid buffer handle");
+      }
+
+      if (b->frame.payload_type != GenTL::PAYLOAD_TYPE_MULTI_PART || i >= b->frame.part.size())
+      {
+        return setError(GenTL::GC_ERR_INVALID_INDEX, "Invalid part index");
+      }
+
+      const ReplayPart &p=b->frame.part[i];
+
+      switch (cmd)
+      {
+        case GenTL::BUFFER_PART_INFO_BASE:
+          return returnValue<void *>(type, data, size, GenTL::INFO_DATATYPE_PTR,
+                                     b->base+p.offset);
+
+        case GenTL::BUFFER_PART_INFO_DATA_SIZE:
+          return returnSize(type, data, size, p.size);
+
+        case GenTL::BUFFER_PART_INFO_DATA_TYPE:
+          return returnSize(type, data, size, static_cast<size_t>(p.datatype));
+
+        case GenTL::BUFFER_PART_INFO_DATA_FORMAT:
+          return returnUInt64(type, data, size, p.pixelformat);
+
+        case GenTL::BUFFER_PART_INFO_DATA_FORMAT_NAMESPACE:
+          return returnUInt64(type, data, size, GenTL::PIXELFORMAT_NAMESPACE_PFNC_32BIT);
+
+        case GenTL::BUFFER_PART_INFO_WIDTH:
+          return returnSize(type, data, size, p.width);
+
+        case GenTL::BUFFER_PART_INFO_HEIGHT:
+        case GenTL::BUFFER_PART_INFO_DELIVERED_IMAGEHEIGHT:
+          return returnSize(type, data, size, p.height);
+
+        case GenTL::BUFFER_PART_INFO_XOFFSET:
+          return returnSize(type, data, size, p.xoffset);
+
+        case GenTL::BUFFER_PART_INFO_YOFFSET:
+          return returnSize(type, data, size, p.yoffset);
+
+        case GenTL::BUFFER_PART_INFO_XPADDING:
+          return returnSize(type, data, size, p.xpadding);
+
+        case GenTL::BUFFER_PART_INFO_SOURCE_ID:
+          return returnUInt64(type, data, size, p.source_id);
+
+        case GenTL::BUFFER_PART_INFO_REGION_ID:
+        case GenTL::BUFFER_PART_INFO_DATA_PURPOSE_ID:
+          return returnUInt64(type, data, size, 0);
+
+        default:
+          return notImplemented();
+      }
+    }
+
+  private:
+
+    ReplayBuffer *find(GenTL::BUFFER_HANDLE handle)
+    {
+      for (size_t i=0; i<buffer.size(); i++)
+      {
+        if (buffer[i].get() == handle)
+        {
+          return buffer[i].get();
+        }
+      }
+
+      return 0;
+    }
+
+    // the following methods must be called with locked mtx
+
+    void deliver(ReplayBuffer *b)
+    {
+      if (event)
+      {
+        GenTL::EVENT_NEW_BUFFER_DATA data;
+        data.BufferHandle=b;
+        data.pUserPointer=b->user;
+        event->push(data);
+      }
+      else
+      {
+        output.push_back(b);
+      }
+    }
+
+    void removeOutput(ReplayBuffer *b)
+    {
+      output.erase(std::remove(output.begin(), output.end(), b), output.end());
+
+      if (event)
+      {
+        event->remove(b);
+      }
+    }
+
+    void discardOutput()
+    {
+      while (output.size() > 0)
+      {
+        output.front()->state=BS_ANNOUNCED;
+        output.pop_front();
+      }
+
+      if (event)
+      {
+        std::vector<GenTL::EVENT_NEW_BUFFER_DATA> list=event->flush();
+
+        for (size_t i=0; i<list.size(); i++)
+        {
+          static_cast<ReplayBuffer *>(list[i].BufferHandle)->state=BS_ANNOUNCED;
+        }
+      }
+    }
+
+    void run()
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+
+      std::chrono::steady_clock::time_point t0;
+      uint64_t ts0=0;
+      double r0=-1;
+
+      while (running && (num_to_acquire == GENTL_INFINITE || acquired < num_to_acquire))
+      {
+        // wait until the device has been started
+
+        if (!remote->isAcquiring())
+        {
+          cond.wait_for(lock, std::chrono::milliseconds(1));
+          r0=-1;
+          continue;
+        }
+
+        ReplayFrame frame;
+
+        if (!source->getFrame(frame, source_n))
+        {
+          break;
+        }
+
+        const double r=remote->getRate();
+
+        if (r > 0)
+        {
+          // frames are delivered according to their timestamps, scaled by
+          // the requested rate
+
+          if (r != r0)
+          {
+            t0=std::chrono::steady_clock::now();
+            ts0=frame.timestamp_ns;
+            r0=r;
+          }
+
+          double dt=0;
+          if (frame.timestamp_ns > ts0)
+          {
+            dt=static_cast<double>(frame.timestamp_ns-ts0)*source->getRate()/r;
+          }
+
+          if (cond.wait_until(lock, t0+std::chrono::nanoseconds(static_cast<int64_t>(dt)),
+                              [this] { return !running; }))
+          {
+            break;
+          }
+
+          if (input.size() == 0)
+          {
+            // frame is lost if no buffer is available in time
+
+            underrun++;
+            source_n++;
+            continue;
+          }
+        }
+        else
+        {
+          r0=r;
+
+          cond.wait(lock, [this] { return !running || input.size() > 0; });
+
+          if (!running)
+          {
+            break;
+          }
+        }
+
+        ReplayBuffer *b=input.front();
+        input.pop_front();
+
+        b->state=BS_ACQUIRING;
+        started++;
+        source_n++;
+
+        // copy without lock
+
+        lock.unlock();
+
+        const size_t n=std::min(frame.size, b->size);
+        memcpy(b->base, frame.data, n);
+
+        lock.lock();
+
+        b->frame=frame;
+        b->frame.data=0;
+        b->filled=n;
+        b->larger=(frame.size > b->size);
+        b->new_data=true;
+        b->state=BS_OUTPUT;
+
+        delivered++;
+        acquired++;
+
+        deliver(b);
+      }
+
+      // wait until acquisition is stopped
+
+      cond.wait(lock, [this] { return !running; });
+    }
+
+    ReplayDevice *parent;
+    ReplayRemoteDevice *remote;
+
+    std::mutex mtx;
+    std::condition_variable cond;
+
+    std::vector<std::unique_ptr<ReplayBuffer> > buffer;
+    std::deque<ReplayBuffer *> input;
+    std::deque<ReplayBuffer *> output;
+    std::shared_ptr<ReplayEvent> event;
+
+    std::thread thread;
+    bool running;
+    std::shared_ptr<ReplaySource> source;
+    uint64_t source_n;
+    uint64_t num_to_acquire;
+    uint64_t acquired;
+
+    uint64_t delivered;
+    uint64_t underrun;
+    uint64_t started;
+};
+
+/*
+  Device module, which owns the remote device and the data stream.
+*/
+
+class ReplayInterface;
+
+class ReplayDevice : public ReplayModule
+{
+  public:
+
+    ReplayDevice(ReplayInterface *_parent, const std::shared_ptr<ReplayRecordingSource> &recording,
+                 bool readonly) : ReplayModule("TLDevice", REPLAY_ID, "TLPort")
+    {
+      parent=_parent;
+      remote=std::make_shared<ReplayRemoteDevice>(recording, readonly);
+      registerHandle(remote);
+
+      addString("DeviceID", REPLAY_ID);
+      addString("DeviceVendorName", REPLAY_VENDOR);
+      addString("DeviceModelName", REPLAY_MODEL);
+      addString("DeviceType", REPLAY_TLTYPE);
+      createXML("", std::vector<std::string>());
+    }
+
+    ~ReplayDevice()
+    {
+      closeStream();
+      unregisterHandle(remote.get());
+    }
+
+    ReplayInterface *getParent() { return parent; }
+    const std::shared_ptr<ReplayRemoteDevice> &getRemote() { return remote; }
+
+    GenTL::GC_ERROR openStream(const char *sid, GenTL::DS_HANDLE *handle)
+    {
+      if (sid == 0 || handle == 0 || getStreamID() != sid)
+      {
+        return setError(GenTL::GC_ERR_INVALID_ID, "Invalid stream ID");
+      }
+
+      if (stream)
+      {
+        return setError(GenTL::GC_ERR_RESOURCE_IN_USE, "Stream is already open");
+      }
+
+      stream=std::make_shared<ReplayStream>(this, remote.get());
+      registerHandle(stream);
+
+      *handle=stream.get();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    void closeStream()
+    {
+      if (stream)
+      {
+        stream->stop();
+        stream->unregisterEvent();
+        unregisterHandle(stream.get());
+        stream.reset();
+      }
+    }
+
+    GenTL::GC_ERROR registerEvent(GenTL::EVENT_HANDLE *handle)
+    {
+      if (event)
+      {
+        return setError(GenTL::GC_ERR_RESOURCE_IN_USE, "Event is already registered");
+      }
+
+      // module events are never fired
+
+      event=std::make_shared<ReplayEvent>(GenTL::EVENT_MODULE, 64);
+      registerHandle(event);
+
+      *handle=event.get();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    GenTL::GC_ERROR unregisterEvent()
+    {
+      if (!event)
+      {
+        return setError(GenTL::GC_ERR_INVALID_ID, "Event is not registered");
+      }
+
+      event->kill();
+      unregisterHandle(event.get());
+      event.reset();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    static std::string getStreamID() { return "stream0"; }
+
+  private:
+
+    ReplayInterface *parent;
+    std::shared_ptr<ReplayRemoteDevice> remote;
+    std::shared_ptr<ReplayStream> stream;
+    std::shared_ptr<ReplayEvent> event;
+};
+
+GenTL::GC_ERROR getDeviceInfo(GenTL::DEVICE_INFO_CMD cmd, GenTL::INFO_DATATYPE *type, void *data,
+                              size_t *size, bool open)
+{
+  switch (cmd)
+  {
+    case GenTL::DEVICE_INFO_ID:
+    case GenTL::DEVICE_INFO_SERIAL_NUMBER:
+      return returnString(type, data, size, REPLAY_ID);
+
+    case GenTL::DEVICE_INFO_VENDOR:
+      return returnString(type, data, size, REPLAY_VENDOR);
+
+    case GenTL::DEVICE_INFO_MODEL:
+      return returnString(type, data, size, REPLAY_MODEL);
+
+    case GenTL::DEVICE_INFO_TLTYPE:
+      return returnString(type, data, size, REPLAY_TLTYPE);
+
+    case GenTL::DEVICE_INFO_DISPLAYNAME:
+      if (config.file.size() > 0)
+      {
+        return returnString(type, data, size, "Replay of "+config.file);
+      }
+
+      return returnString(type, data, size, "Replay of synthetic data");
+
+    case GenTL::DEVICE_INFO_ACCESS_STATUS:
+      return returnValue<int32_t>(type, data, size, GenTL::INFO_DATATYPE_INT32,
+                                  open ? GenTL::DEVICE_ACCESS_STATUS_OPEN_READWRITE :
+                                         GenTL::DEVICE_ACCESS_STATUS_READWRITE);
+
+    case GenTL::DEVICE_INFO_USER_DEFINED_NAME:
+      return returnString(type, data, size, "");
+
+    case GenTL::DEVICE_INFO_VERSION:
+      return returnString(type, data, size, REPLAY_VERSION);
+
+    case GenTL::DEVICE_INFO_TIMESTAMP_FREQUENCY:
+      return returnUInt64(type, data, size, 1000000000ull);
+
+    default:
+      return notImplemented();
+  }
+}
+
+/*
+  Interface module with exactly one device.
+*/
+
+class ReplaySystem;
+
+class ReplayInterface : public ReplayModule
+{
+  public:
+
+    ReplayInterface(ReplaySystem *_parent) : ReplayModule("TLInterface", REPLAY_ID, "TLPort")
+    {
+      parent=_parent;
+
+      addString("InterfaceID", REPLAY_ID);
+      addString("InterfaceType", REPLAY_TLTYPE);
+      createXML("", std::vector<std::string>());
+    }
+
+    ~ReplayInterface()
+    {
+      closeDevice();
+    }
+
+    ReplaySystem *getParent() { return parent; }
+    bool isDeviceOpen() const { return static_cast<bool>(device); }
+
+    GenTL::GC_ERROR openDevice(const char *did, GenTL::DEVICE_ACCESS_FLAGS flags,
+                               GenTL::DEV_HANDLE *handle)
+    {
+      if (did == 0 || handle == 0 || std::string(did) != REPLAY_ID)
+      {
+        return setError(GenTL::GC_ERR_INVALID_ID, "Invalid device ID");
+      }
+
+      if (device)
+      {
+        return setError(GenTL::GC_ERR_RESOURCE_IN_USE, "Device is already open");
+      }
+
+      std::shared_ptr<ReplayRecordingSource> recording;
+
+      if (config.file.size() > 0)
+      {
+        try
+        {
+          recording=std::make_shared<ReplayRecordingSource>(config.file, config.loop);
+        }
+        catch (const std::exception &ex)
+        {
+          return setError(GenTL::GC_ERR_IO, ex.what());
+        }
+      }
+
+      device=std::make_shared<ReplayDevice>(this, recording,
+                                            flags == GenTL::DEVICE_ACCESS_READONLY);
+      registerHandle(device);
+
+      *handle=device.get();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    void closeDevice()
+    {
+      if (device)
+      {
+        unregisterHandle(device.get());
+        device.reset();
+      }
+    }
+
+  private:
+
+    ReplaySystem *parent;
+    std::shared_ptr<ReplayDevice> device;
+};
+
+GenTL::GC_ERROR getInterfaceInfo(GenTL::INTERFACE_INFO_CMD cmd, GenTL::INFO_DATATYPE *type,
+                                 void *data, size_t *size)
+{
+  switch (cmd)
+  {
+    case GenTL::INTERFACE_INFO_ID:
+      return returnString(type, data, size, REPLAY_ID);
+
+    case GenTL::INTERFACE_INFO_DISPLAYNAME:
+      return returnString(type, data, size, "Replay interface");
+
+    case GenTL::INTERFACE_INFO_TLTYPE:
+      return returnString(type, data, size, REPLAY_TLTYPE);
+
+    default:
+      return notImplemented();
+  }
+}
+
+/*
+  System module with exactly one interface.
+*/
+
+class ReplaySystem : public ReplayModule
+{
+  public:
+
+    ReplaySystem() : ReplayModule("TLSystem", REPLAY_ID, "TLPort")
+    {
+      addString("TLVendorName", REPLAY_VENDOR);
+      addString("TLModelName", REPLAY_MODEL);
+      addString("TLID", REPLAY_ID);
+      addString("TLVersion", REPLAY_VERSION);
+      addString("TLType", REPLAY_TLTYPE);
+      createXML("", std::vector<std::string>());
+    }
+
+    ~ReplaySystem()
+    {
+      closeInterface();
+    }
+
+    GenTL::GC_ERROR openInterface(const char *iid, GenTL::IF_HANDLE *handle)
+    {
+      if (iid == 0 || handle == 0 || std::string(iid) != REPLAY_ID)
+      {
+        return setError(GenTL::GC_ERR_INVALID_ID, "Invalid interface ID");
+      }
+
+      if (interf)
+      {
+        return setError(GenTL::GC_ERR_RESOURCE_IN_USE, "Interface is already open");
+      }
+
+      interf=std::make_shared<ReplayInterface>(this);
+      registerHandle(interf);
+
+      *handle=interf.get();
+
+      return GenTL::GC_ERR_SUCCESS;
+    }
+
+    void closeInterface()
+    {
+      if (interf)
+      {
+        unregisterHandle(interf.get());
+        interf.reset();
+      }
+    }
+
+  private:
+
+    std::shared_ptr<ReplayInterface> interf;
+};
+
+std::shared_ptr<ReplaySystem> tl;
+
+std::string getLibraryPath()
+{
+  Dl_info info;
+
+  if (dladdr(reinterpret_cast<void *>(&getLibraryPath), &info) != 0 && info.dli_fname != 0)
+  {
+    return info.dli_fname;
+  }
+
+  return "";
+}
+
+GenTL::GC_ERROR getTLInfo(GenTL::TL_INFO_CMD cmd, GenTL::INFO_DATATYPE *type, void *data,
+                          size_t *size)
+{
+  switch (cmd)
+  {
+    case GenTL::TL_INFO_ID:
+      return returnString(type, data, size, REPLAY_ID);
+
+    case GenTL::TL_INFO_VENDOR:
+      return returnString(type, data, size, REPLAY_VENDOR);
+
+    case GenTL::TL_INFO_MODEL:
+      return returnString(type, data, size, REPLAY_MODEL);
+
+    case GenTL::TL_INFO_VERSION:
+      return returnString(type, data, size, REPLAY_VERSION);
+
+    case GenTL::TL_INFO_TLTYPE:
+      return returnString(type, data, size, REPLAY_TLTYPE);
+
+    case GenTL::TL_INFO_NAME:
+      {
+        std::string name=getLibraryPath();
+        size_t i=name.rfind('/');
+
+        if (i != std::string::npos)
+        {
+          name=name.substr(i+1);
+        }
+
+        return returnString(type, data, size, name);
+      }
+
+    case GenTL::TL_INFO_PATHNAME:
+      return returnString(type, data, size, getLibraryPath());
+
+    case GenTL::TL_INFO_DISPLAYNAME:
+      return returnString(type, data, size, "Replay of recorded or synthetic data");
+
+    case GenTL::TL_INFO_CHAR_ENCODING:
+      return returnValue<int32_t>(type, data, size, GenTL::INFO_DATATYPE_INT32,
+                                  GenTL::TL_CHAR_ENCODING_ASCII);
+
+    case GenTL::TL_INFO_GENTL_VER_MAJOR:
+      return returnValue<uint32_t>(type, data, size, GenTL::INFO_DATATYPE_UINT32, 1);
+
+    case GenTL::TL_INFO_GENTL_VER_MINOR:
+      return returnValue<uint32_t>(type, data, size, GenTL::INFO_DATATYPE_UINT32, 5);
+
+    default:
+      return notImplemented();
+  }
+}
+
+GenTL::GC_ERROR returnID(char *id, size_t *size, const std::string &value)
+{
+  return returnData(0, id, size, GenTL::INFO_DATATYPE_STRING, value.c_str(), value.size()+1);
+}
+
+GenTL::GC_ERROR notInitialized()
+{
+  return setError(GenTL::GC_ERR_NOT_INITIALIZED, "Library is not initialized");
+}
+
+GenTL::GC_ERROR invalidHandle()
+{
+  return setError(GenTL::GC_ERR_INVALID_HANDLE, "Invalid handle");
+}
+
+}
+
+}
+
+/*
+  Exported functions of the GenTL interface.
+*/
+
+using namespace rcg;
+
+namespace GenTL
+{
+
+#define REPLAY_LOCK std::lock_guard<std::mutex> lock(api_mtx); \
+  if (!initialized) return notInitialized();
+
+GC_API GCGetInfo(TL_INFO_CMD iInfoCmd, INFO_DATATYPE *piType, void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  return getTLInfo(iInfoCmd, piType, pBuffer, piSize);
+}
+
+GC_API GCGetLastError(GC_ERROR *piErrorCode, char *sErrText, size_t *piSize)
+{
+  if (piErrorCode != 0)
+  {
+    *piErrorCode=last_error.code;
+  }
+
+  return returnData(0, sErrText, piSize, INFO_DATATYPE_STRING, last_error.text.c_str(),
+                    last_error.text.size()+1);
+}
+
+GC_API GCInitLib()
+{
+  std::lock_guard<std::mutex> lock(api_mtx);
+
+  if (initialized)
+  {
+    return setError(GC_ERR_RESOURCE_IN_USE, "Library is already initialized");
+  }
+
+  config=readConfig();
+  initialized=true;
+
+  return GC_ERR_SUCCESS;
+}
+
+GC_API GCCloseLib()
+{
+  REPLAY_LOCK
+
+  if (tl)
+  {
+    unregisterHandle(tl.get());
+    tl.reset();
+  }
+
+  registry.clear();
+  initialized=false;
+
+  return GC_ERR_SUCCESS;
+}
+
+GC_API GCReadPort(PORT_HANDLE hPort, uint64_t iAddress, void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayModule> p=lookup<ReplayModule>(hPort);
+  if (!p) return invalidHandle();
+  return p->readPort(iAddress, pBuffer, piSize);
+}
+
+GC_API GCWritePort(PORT_HANDLE hPort, uint64_t iAddress, const void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayModule> p=lookup<ReplayModule>(hPort);
+  if (!p) return invalidHandle();
+  return p->writePort(iAddress, pBuffer, piSize);
+}
+
+GC_API GCGetPortURL(PORT_HANDLE hPort, char *sURL, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayModule> p=lookup<ReplayModule>(hPort);
+  if (!p) return invalidHandle();
+  return returnID(sURL, piSize, p->getURL());
+}
+
+GC_API GCGetPortInfo(PORT_HANDLE hPort, PORT_INFO_CMD iInfoCmd, INFO_DATATYPE *piType,
+                     void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayModule> p=lookup<ReplayModule>(hPort);
+  if (!p) return invalidHandle();
+  return p->getPortInfo(iInfoCmd, piType, pBuffer, piSize);
+}
+
+GC_API GCRegisterEvent(EVENTSRC_HANDLE hEventSrc, EVENT_TYPE iEventID, EVENT_HANDLE *phEvent)
+{
+  REPLAY_LOCK
+
+  if (phEvent == 0)
+  {
+    return setError(GC_ERR_INVALID_PARAMETER, "Event handle must not be NULL");
+  }
+
+  std::shared_ptr<ReplayStream> stream=lookup<ReplayStream>(hEventSrc);
+  if (stream && iEventID == EVENT_NEW_BUFFER) return stream->registerEvent(phEvent);
+
+  std::shared_ptr<ReplayDevice> device=lookup<ReplayDevice>(hEventSrc);
+  if (device && iEventID == EVENT_MODULE) return device->registerEvent(phEvent);
+
+  if (!stream && !device && !lookup<ReplayModule>(hEventSrc)) return invalidHandle();
+
+  return setError(GC_ERR_NOT_IMPLEMENTED, "Event type not supported by module");
+}
+
+GC_API GCUnregisterEvent(EVENTSRC_HANDLE hEventSrc, EVENT_TYPE iEventID)
+{
+  REPLAY_LOCK
+
+  std::shared_ptr<ReplayStream> stream=lookup<ReplayStream>(hEventSrc);
+  if (stream && iEventID == EVENT_NEW_BUFFER) return stream->unregisterEvent();
+
+  std::shared_ptr<ReplayDevice> device=lookup<ReplayDevice>(hEventSrc);
+  if (device && iEventID == EVENT_MODULE) return device->unregisterEvent();
+
+  if (!stream && !device && !lookup<ReplayModule>(hEventSrc)) return invalidHandle();
+
+  return setError(GC_ERR_INVALID_ID, "Event is not registered");
+}
+
+GC_API EventGetData(EVENT_HANDLE hEvent, void *pBuffer, size_t *piSize, uint64_t iTimeout)
+{
+  std::shared_ptr<ReplayEvent> event;
+
+  {
+    REPLAY_LOCK
+    event=lookup<ReplayEvent>(hEvent);
+    if (!event) return invalidHandle();
+  }
+
+  // wait without global lock
+
+  return event->get(pBuffer, piSize, iTimeout);
+}
+
+GC_API EventGetDataInfo(EVENT_HANDLE hEvent, const void *pInBuffer, size_t iInSize,
+                        EVENT_DATA_INFO_CMD iInfoCmd, INFO_DATATYPE *piType, void *pOutBuffer,
+                        size_t *piOutSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayEvent> event=lookup<ReplayEvent>(hEvent);
+  if (!event) return invalidHandle();
+
+  if (event->getType() != EVENT_NEW_BUFFER || pInBuffer == 0 ||
+      iInSize < sizeof(EVENT_NEW_BUFFER_DATA))
+  {
+    return setError(GC_ERR_NOT_AVAILABLE, "No event data available");
+  }
+
+  EVENT_NEW_BUFFER_DATA data;
+  memcpy(&data, pInBuffer, sizeof(data));
+
+  switch (iInfoCmd)
+  {
+    case EVENT_DATA_ID:
+      return returnValue<void *>(piType, pOutBuffer, piOutSize, INFO_DATATYPE_PTR,
+                                 data.BufferHandle);
+
+    case EVENT_DATA_VALUE:
+      return returnValue<void *>(piType, pOutBuffer, piOutSize, INFO_DATATYPE_PTR,
+                                 data.pUserPointer);
+
+    default:
+      return notImplemented();
+  }
+}
+
+GC_API EventGetInfo(EVENT_HANDLE hEvent, EVENT_INFO_CMD iInfoCmd, INFO_DATATYPE *piType,
+                    void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayEvent> event=lookup<ReplayEvent>(hEvent);
+  if (!event) return invalidHandle();
+
+  switch (iInfoCmd)
+  {
+    case EVENT_EVENT_TYPE:
+      return returnValue<int32_t>(piType, pBuffer, piSize, INFO_DATATYPE_INT32, event->getType());
+
+    case EVENT_NUM_IN_QUEUE:
+      return returnSize(piType, pBuffer, piSize, event->getNumInQueue());
+
+    case EVENT_NUM_FIRED:
+      return returnUInt64(piType, pBuffer, piSize, event->getNumFired());
+
+    case EVENT_SIZE_MAX:
+      return returnSize(piType, pBuffer, piSize, event->getSizeMax());
+
+    case EVENT_INFO_DATA_SIZE_MAX:
+      return returnSize(piType, pBuffer, piSize, sizeof(void *));
+
+    default:
+      return notImplemented();
+  }
+}
+
+GC_API EventFlush(EVENT_HANDLE hEvent)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayEvent> event=lookup<ReplayEvent>(hEvent);
+  if (!event) return invalidHandle();
+  event->flush();
+  return GC_ERR_SUCCESS;
+}
+
+GC_API EventKill(EVENT_HANDLE hEvent)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayEvent> event=lookup<ReplayEvent>(hEvent);
+  if (!event) return invalidHandle();
+  event->kill();
+  return GC_ERR_SUCCESS;
+}
+
+GC_API TLOpen(TL_HANDLE *phTL)
+{
+  REPLAY_LOCK
+
+  if (phTL == 0)
+  {
+    return setError(GC_ERR_INVALID_PARAMETER, "Handle must not be NULL");
+  }
+
+  if (tl)
+  {
+    return setError(GC_ERR_RESOURCE_IN_USE, "Transport layer is already open");
+  }
+
+  tl=std::make_shared<ReplaySystem>();
+  registerHandle(tl);
+
+  *phTL=tl.get();
+
+  return GC_ERR_SUCCESS;
+}
+
+GC_API TLClose(TL_HANDLE hTL)
+{
+  REPLAY_LOCK
+  if (!tl || hTL != tl.get()) return invalidHandle();
+  unregisterHandle(tl.get());
+  tl.reset();
+  return GC_ERR_SUCCESS;
+}
+
+GC_API TLGetInfo(TL_HANDLE hTL, TL_INFO_CMD iInfoCmd, INFO_DATATYPE *piType, void *pBuffer,
+                 size_t *piSize)
+{
+  REPLAY_LOCK
+  if (!tl || hTL != tl.get()) return invalidHandle();
+  return getTLInfo(iInfoCmd, piType, pBuffer, piSize);
+}
+
+GC_API TLGetNumInterfaces(TL_HANDLE hTL, uint32_t *piNumIfaces)
+{
+  REPLAY_LOCK
+  if (!tl || hTL != tl.get()) return invalidHandle();
+  if (piNumIfaces == 0) return setError(GC_ERR_INVALID_PARAMETER, "Parameter must not be NULL");
+  *piNumIfaces=1;
+  return GC_ERR_SUCCESS;
+}
+
+GC_API TLGetInterfaceID(TL_HANDLE hTL, uint32_t iIndex, char *sID, size_t *piSize)
+{
+  REPLAY_LOCK
+  if (!tl || hTL != tl.get()) return invalidHandle();
+  if (iIndex != 0) return setError(GC_ERR_INVALID_INDEX, "Invalid interface index");
+  return returnID(sID, piSize, REPLAY_ID);
+}
+
+GC_API TLGetInterfaceInfo(TL_HANDLE hTL, const char *sIfaceID, INTERFACE_INFO_CMD iInfoCmd,
+                          INFO_DATATYPE *piType, void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  if (!tl || hTL != tl.get()) return invalidHandle();
+  if (sIfaceID == 0 || std::string(sIfaceID) != REPLAY_ID)
+  {
+    return setError(GC_ERR_INVALID_ID, "Invalid interface ID");
+  }
+  return getInterfaceInfo(iInfoCmd, piType, pBuffer, piSize);
+}
+
+GC_API TLOpenInterface(TL_HANDLE hTL, const char *sIfaceID, IF_HANDLE *phIface)
+{
+  REPLAY_LOCK
+  if (!tl || hTL != tl.get()) return invalidHandle();
+  return tl->openInterface(sIfaceID, phIface);
+}
+
+GC_API TLUpdateInterfaceList(TL_HANDLE hTL, bool8_t *pbChanged, uint64_t)
+{
+  REPLAY_LOCK
+  if (!tl || hTL != tl.get()) return invalidHandle();
+  if (pbChanged != 0) *pbChanged=false;
+  return GC_ERR_SUCCESS;
+}
+
+GC_API IFClose(IF_HANDLE hIface)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayInterface> p=lookup<ReplayInterface>(hIface);
+  if (!p) return invalidHandle();
+  p->getParent()->closeInterface();
+  return GC_ERR_SUCCESS;
+}
+
+GC_API IFGetInfo(IF_HANDLE hIface, INTERFACE_INFO_CMD iInfoCmd, INFO_DATATYPE *piType,
+                 void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayInterface> p=lookup<ReplayInterface>(hIface);
+  if (!p) return invalidHandle();
+  return getInterfaceInfo(iInfoCmd, piType, pBuffer, piSize);
+}
+
+GC_API IFGetNumDevices(IF_HANDLE hIface, uint32_t *piNumDevices)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayInterface> p=lookup<ReplayInterface>(hIface);
+  if (!p) return invalidHandle();
+  if (piNumDevices == 0) return setError(GC_ERR_INVALID_PARAMETER, "Parameter must not be NULL");
+  *piNumDevices=1;
+  return GC_ERR_SUCCESS;
+}
+
+GC_API IFGetDeviceID(IF_HANDLE hIface, uint32_t iIndex, char *sIDeviceID, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayInterface> p=lookup<ReplayInterface>(hIface);
+  if (!p) return invalidHandle();
+  if (iIndex != 0) return setError(GC_ERR_INVALID_INDEX, "Invalid device index");
+  return returnID(sIDeviceID, piSize, REPLAY_ID);
+}
+
+GC_API IFUpdateDeviceList(IF_HANDLE hIface, bool8_t *pbChanged, uint64_t)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayInterface> p=lookup<ReplayInterface>(hIface);
+  if (!p) return invalidHandle();
+  if (pbChanged != 0) *pbChanged=false;
+  return GC_ERR_SUCCESS;
+}
+
+GC_API IFGetDeviceInfo(IF_HANDLE hIface, const char *sDeviceID, DEVICE_INFO_CMD iInfoCmd,
+                       INFO_DATATYPE *piType, void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayInterface> p=lookup<ReplayInterface>(hIface);
+  if (!p) return invalidHandle();
+  if (sDeviceID == 0 || std::string(sDeviceID) != REPLAY_ID)
+  {
+    return setError(GC_ERR_INVALID_ID, "Invalid device ID");
+  }
+  return getDeviceInfo(iInfoCmd, piType, pBuffer, piSize, p->isDeviceOpen());
+}
+
+GC_API IFOpenDevice(IF_HANDLE hIface, const char *sDeviceID, DEVICE_ACCESS_FLAGS iOpenFlag,
+                    DEV_HANDLE *phDevice)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayInterface> p=lookup<ReplayInterface>(hIface);
+  if (!p) return invalidHandle();
+  return p->openDevice(sDeviceID, iOpenFlag, phDevice);
+}
+
+GC_API DevGetPort(DEV_HANDLE hDevice, PORT_HANDLE *phRemoteDevice)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayDevice> p=lookup<ReplayDevice>(hDevice);
+  if (!p) return invalidHandle();
+  if (phRemoteDevice == 0) return setError(GC_ERR_INVALID_PARAMETER, "Parameter must not be NULL");
+  *phRemoteDevice=p->getRemote().get();
+  return GC_ERR_SUCCESS;
+}
+
+GC_API DevGetNumDataStreams(DEV_HANDLE hDevice, uint32_t *piNumDataStreams)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayDevice> p=lookup<ReplayDevice>(hDevice);
+  if (!p) return invalidHandle();
+  if (piNumDataStreams == 0) return setError(GC_ERR_INVALID_PARAMETER, "Parameter must not be NULL");
+  *piNumDataStreams=1;
+  return GC_ERR_SUCCESS;
+}
+
+GC_API DevGetDataStreamID(DEV_HANDLE hDevice, uint32_t iIndex, char *sDataStreamID,
+                          size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayDevice> p=lookup<ReplayDevice>(hDevice);
+  if (!p) return invalidHandle();
+  if (iIndex != 0) return setError(GC_ERR_INVALID_INDEX, "Invalid stream index");
+  return returnID(sDataStreamID, piSize, ReplayDevice::getStreamID());
+}
+
+GC_API DevOpenDataStream(DEV_HANDLE hDevice, const char *sDataStreamID, DS_HANDLE *phDataStream)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayDevice> p=lookup<ReplayDevice>(hDevice);
+  if (!p) return invalidHandle();
+  return p->openStream(sDataStreamID, phDataStream);
+}
+
+GC_API DevGetInfo(DEV_HANDLE hDevice, DEVICE_INFO_CMD iInfoCmd, INFO_DATATYPE *piType,
+                  void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayDevice> p=lookup<ReplayDevice>(hDevice);
+  if (!p) return invalidHandle();
+  return getDeviceInfo(iInfoCmd, piType, pBuffer, piSize, true);
+}
+
+GC_API DevClose(DEV_HANDLE hDevice)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayDevice> p=lookup<ReplayDevice>(hDevice);
+  if (!p) return invalidHandle();
+  p->getParent()->closeDevice();
+  return GC_ERR_SUCCESS;
+}
+
+GC_API DSAnnounceBuffer(DS_HANDLE hDataStream, void *pBuffer, size_t iSize, void *pPrivate,
+                        BUFFER_HANDLE *phBuffer)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  if (pBuffer == 0) return setError(GC_ERR_INVALID_PARAMETER, "Buffer must not be NULL");
+  return p->announce(pBuffer, iSize, pPrivate, phBuffer);
+}
+
+GC_API DSAllocAndAnnounceBuffer(DS_HANDLE hDataStream, size_t iSize, void *pPrivate,
+                                BUFFER_HANDLE *phBuffer)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->announce(0, iSize, pPrivate, phBuffer);
+}
+
+GC_API DSFlushQueue(DS_HANDLE hDataStream, ACQ_QUEUE_TYPE iOperation)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->flush(iOperation);
+}
+
+GC_API DSStartAcquisition(DS_HANDLE hDataStream, ACQ_START_FLAGS, uint64_t iNumToAcquire)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->start(iNumToAcquire);
+}
+
+GC_API DSStopAcquisition(DS_HANDLE hDataStream, ACQ_STOP_FLAGS)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->stop();
+}
+
+GC_API DSGetInfo(DS_HANDLE hDataStream, STREAM_INFO_CMD iInfoCmd, INFO_DATATYPE *piType,
+                 void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->getInfo(iInfoCmd, piType, pBuffer, piSize);
+}
+
+GC_API DSGetBufferID(DS_HANDLE hDataStream, uint32_t iIndex, BUFFER_HANDLE *phBuffer)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->getBufferID(iIndex, phBuffer);
+}
+
+GC_API DSClose(DS_HANDLE hDataStream)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  p->getParent()->closeStream();
+  return GC_ERR_SUCCESS;
+}
+
+GC_API DSRevokeBuffer(DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer, void **pBuffer,
+                      void **pPrivate)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->revoke(hBuffer, pBuffer, pPrivate);
+}
+
+GC_API DSQueueBuffer(DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->queue(hBuffer);
+}
+
+GC_API DSGetBufferInfo(DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer, BUFFER_INFO_CMD iInfoCmd,
+                       INFO_DATATYPE *piType, void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->getBufferInfo(hBuffer, iInfoCmd, piType, pBuffer, piSize);
+}
+
+GC_API GCGetNumPortURLs(PORT_HANDLE hPort, uint32_t *piNumURLs)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayModule> p=lookup<ReplayModule>(hPort);
+  if (!p) return invalidHandle();
+  if (piNumURLs == 0) return setError(GC_ERR_INVALID_PARAMETER, "Parameter must not be NULL");
+  *piNumURLs=1;
+  return GC_ERR_SUCCESS;
+}
+
+GC_API GCGetPortURLInfo(PORT_HANDLE hPort, uint32_t iURLIndex, URL_INFO_CMD iInfoCmd,
+                        INFO_DATATYPE *piType, void *pBuffer, size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayModule> p=lookup<ReplayModule>(hPort);
+  if (!p) return invalidHandle();
+  return p->getURLInfo(iURLIndex, iInfoCmd, piType, pBuffer, piSize);
+}
+
+GC_API GCReadPortStacked(PORT_HANDLE hPort, PORT_REGISTER_STACK_ENTRY *pEntries,
+                         size_t *piNumEntries)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayModule> p=lookup<ReplayModule>(hPort);
+  if (!p) return invalidHandle();
+  if (pEntries == 0 || piNumEntries == 0)
+  {
+    return setError(GC_ERR_INVALID_PARAMETER, "Parameter must not be NULL");
+  }
+
+  for (size_t i=0; i<*piNumEntries; i++)
+  {
+    size_t size=pEntries[i].Size;
+    GC_ERROR err=p->readPort(pEntries[i].Address, pEntries[i].pBuffer, &size);
+
+    if (err != GC_ERR_SUCCESS)
+    {
+      *piNumEntries=i;
+      return err;
+    }
+  }
+
+  return GC_ERR_SUCCESS;
+}
+
+GC_API GCWritePortStacked(PORT_HANDLE hPort, PORT_REGISTER_STACK_ENTRY *pEntries,
+                          size_t *piNumEntries)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayModule> p=lookup<ReplayModule>(hPort);
+  if (!p) return invalidHandle();
+  if (pEntries == 0 || piNumEntries == 0)
+  {
+    return setError(GC_ERR_INVALID_PARAMETER, "Parameter must not be NULL");
+  }
+
+  for (size_t i=0; i<*piNumEntries; i++)
+  {
+    size_t size=pEntries[i].Size;
+    GC_ERROR err=p->writePort(pEntries[i].Address, pEntries[i].pBuffer, &size);
+
+    if (err != GC_ERR_SUCCESS)
+    {
+      *piNumEntries=i;
+      return err;
+    }
+  }
+
+  return GC_ERR_SUCCESS;
+}
+
+GC_API DSGetBufferChunkData(DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer,
+                            SINGLE_CHUNK_DATA *pChunkData, size_t *piNumChunks)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->getBufferChunkData(hBuffer, pChunkData, piNumChunks);
+}
+
+GC_API IFGetParentTL(IF_HANDLE hIface, TL_HANDLE *phSystem)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayInterface> p=lookup<ReplayInterface>(hIface);
+  if (!p) return invalidHandle();
+  if (phSystem == 0) return setError(GC_ERR_INVALID_PARAMETER, "Parameter must not be NULL");
+  *phSystem=p->getParent();
+  return GC_ERR_SUCCESS;
+}
+
+GC_API DevGetParentIF(DEV_HANDLE hDevice, IF_HANDLE *phIface)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayDevice> p=lookup<ReplayDevice>(hDevice);
+  if (!p) return invalidHandle();
+  if (phIface == 0) return setError(GC_ERR_INVALID_PARAMETER, "Parameter must not be NULL");
+  *phIface=p->getParent();
+  return GC_ERR_SUCCESS;
+}
+
+GC_API DSGetParentDev(DS_HANDLE hDataStream, DEV_HANDLE *phDevice)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  if (phDevice == 0) return setError(GC_ERR_INVALID_PARAMETER, "Parameter must not be NULL");
+  *phDevice=p->getParent();
+  return GC_ERR_SUCCESS;
+}
+
+GC_API DSGetNumBufferParts(DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer, uint32_t *piNumParts)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->getNumBufferParts(hBuffer, piNumParts);
+}
+
+GC_API DSGetBufferPartInfo(DS_HANDLE hDataStream, BUFFER_HANDLE hBuffer, uint32_t iPartIndex,
+                           BUFFER_PART_INFO_CMD iInfoCmd, INFO_DATATYPE *piType, void *pBuffer,
+                           size_t *piSize)
+{
+  REPLAY_LOCK
+  std::shared_ptr<ReplayStream> p=lookup<ReplayStream>(hDataStream);
+  if (!p) return invalidHandle();
+  return p->getBufferPartInfo(hBuffer, iPartIndex, iInfoCmd, piType, pBuffer, piSize);
+}
+
+}
@@ -0,0 +1,616 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "replay_source.h"
+
+#include <rc_genicam_api/pixel_formats.h>
+
+#include <GenTL/GenTL_v1_6.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace rcg
+{
+
+namespace
+{
+
+// number of different frames that are generated in advance per component
+
+const uint32_t REPLAY_PHASES=4;
+
+// disparities are stored in 1/16 pixel, which must match the scale that is
+// reported by the virtual device
+
+const double REPLAY_DISPARITY_SCALE=0.0625;
+
+inline size_t roundUp(size_t v, size_t a)
+{
+  return (v+a-1)/a*a;
+}
+
+inline uint8_t mono(size_t x, size_t y, uint32_t phase)
+{
+  return static_cast<uint8_t>(((x+8*phase)^y)&0xff);
+}
+
+template<class T> inline void putValue(uint8_t *p, size_t address, T v)
+{
+  memcpy(p+address, &v, sizeof(T));
+}
+
+}
+
+ReplaySyntheticSource::ReplaySyntheticSource(size_t _width, size_t _height, uint64_t _pixelformat,
+                                             const bool component[RC_COUNT], bool _multipart,
+                                             double _rate, bool chunks)
+{
+  if (!isFormatSupported(_pixelformat))
+  {
+    throw std::invalid_argument("ReplaySyntheticSource: Pixel format not supported");
+  }
+
+  if (_width < 4 || _height < 1 || (_pixelformat == YCbCr411_8 && (_width&0x3) != 0))
+  {
+    throw std::invalid_argument("ReplaySyntheticSource: Invalid image size");
+  }
+
+  width=_width;
+  height=_height;
+  pixelformat=_pixelformat;
+  multipart=_multipart;
+
+  rate=_rate;
+  if (rate <= 0)
+  {
+    rate=1000;
+  }
+
+  period_ns=static_cast<uint64_t>(1000000000.0/rate+0.5);
+
+  for (int i=0; i<RC_COUNT; i++)
+  {
+    if (component[i])
+    {
+      comp.push_back(i);
+    }
+  }
+
+  if (comp.size() == 0)
+  {
+    comp.push_back(RC_INTENSITY);
+  }
+
+  // layout of all parts, i.e. one multi-part layout or one single part layout
+  // per component
+
+  if (multipart)
+  {
+    layout.resize(1);
+
+    size_t offset=0;
+    for (size_t i=0; i<comp.size(); i++)
+    {
+      layout[0].push_back(createPart(comp[i], offset));
+      offset=roundUp(offset+layout[0].back().size, REC_DATA_ALIGN);
+    }
+  }
+  else
+  {
+    layout.resize(comp.size());
+
+    for (size_t i=0; i<comp.size(); i++)
+    {
+      layout[i].push_back(createPart(comp[i], 0));
+    }
+  }
+
+  // the chunk is appended after the last part
+
+  chunk.resize(layout.size());
+
+  for (size_t i=0; i<layout.size() && chunks; i++)
+  {
+    const ReplayPart &last=layout[i].back();
+
+    ReplayChunk c;
+    c.id=RC_CHUNK_ID;
+    c.offset=roundUp(last.offset+last.size, REC_DATA_ALIGN);
+    c.length=RC_CHUNK_LENGTH;
+
+    chunk[i].push_back(c);
+  }
+
+  // generate data for all layouts and phases
+
+  payload_size=0;
+  block.resize(layout.size()*REPLAY_PHASES);
+
+  for (size_t i=0; i<layout.size(); i++)
+  {
+    const ReplayPart &last=layout[i].back();
+    size_t size=last.offset+last.size;
+
+    if (chunk[i].size() > 0)
+    {
+      size=chunk[i].back().offset+chunk[i].back().length;
+    }
+
+    payload_size=std::max(payload_size, size);
+
+    for (uint32_t phase=0; phase<REPLAY_PHASES; phase++)
+    {
+      std::vector<uint8_t> &b=block[i*REPLAY_PHASES+phase];
+      b.resize(size, 0);
+
+      for (size_t k=0; k<layout[i].size(); k++)
+      {
+        const int c=(multipart ? comp[k] : comp[i]);
+        fillPart(b.data()+layout[i][k].offset, c, layout[i][k], phase);
+      }
+
+      if (chunk[i].size() > 0)
+      {
+        fillChunk(b.data()+chunk[i].back().offset, phase);
+      }
+    }
+  }
+}
+
+size_t ReplaySyntheticSource::getPayloadSize() const
+{
+  return payload_size;
+}
+
+double ReplaySyntheticSource::getRate() const
+{
+  return rate;
+}
+
+bool ReplaySyntheticSource::getFrame(ReplayFrame &frame, uint64_t n)
+{
+  const uint64_t nl=layout.size();
+  const uint64_t slot=n/nl;
+  const size_t li=static_cast<size_t>(n%nl);
+  const std::vector<uint8_t> &b=block[li*REPLAY_PHASES+slot%REPLAY_PHASES];
+
+  frame.data=b.data();
+  frame.size=b.size();
+  frame.size_filled=b.size();
+  frame.timestamp_ns=(slot+1)*period_ns;
+  frame.frameid=slot+1;
+  frame.payload_type=(multipart ? GenTL::PAYLOAD_TYPE_MULTI_PART : GenTL::PAYLOAD_TYPE_IMAGE);
+  frame.chunk_layout_id=(chunk[li].size() > 0 ? li+1 : 0);
+  frame.ypadding=0;
+  frame.bigendian=false;
+  frame.incomplete=false;
+  frame.contains_chunkdata=(chunk[li].size() > 0);
+  frame.part=layout[li];
+  frame.chunk=chunk[li];
+
+  return true;
+}
+
+bool ReplaySyntheticSource::isFormatSupported(uint64_t pixelformat)
+{
+  return pixelformat == Mono8 || pixelformat == Mono16 || pixelformat == RGB8 ||
+         pixelformat == YCbCr411_8;
+}
+
+ReplayPart ReplaySyntheticSource::createPart(int c, size_t offset) const
+{
+  ReplayPart part;
+
+  part.offset=offset;
+  part.width=width;
+  part.height=height;
+  part.xoffset=0;
+  part.yoffset=0;
+  part.xpadding=0;
+  part.source_id=0;
+  part.image_present=true;
+
+  size_t row=width;
+
+  switch (c)
+  {
+    default:
+    case RC_INTENSITY:
+      part.pixelformat=pixelformat;
+      part.datatype=GenTL::PART_DATATYPE_2D_IMAGE;
+
+      if (pixelformat == Mono16) row=2*width;
+      if (pixelformat == RGB8) row=3*width;
+      if (pixelformat == YCbCr411_8) row=width/4*6;
+      break;
+
+    case RC_DISPARITY:
+      part.pixelformat=Coord3D_C16;
+      part.datatype=GenTL::PART_DATATYPE_3D_IMAGE;
+      row=2*width;
+      break;
+
+    case RC_CONFIDENCE:
+      part.pixelformat=Confidence8;
+      part.datatype=GenTL::PART_DATATYPE_CONFIDENCE_MAP;
+      break;
+
+    case RC_ERROR:
+      part.pixelformat=Error8;
+      part.datatype=GenTL::PART_DATATYPE_CONFIDENCE_MAP;
+      break;
+  }
+
+  part.size=row*height;
+
+  return part;
+}
+
+void ReplaySyntheticSource::fillPart(uint8_t *p, int c, const ReplayPart &part,
+                                     uint32_t phase) const
+{
+  // the left border is invalid in all stereo related images
+
+  const size_t border=width/16;
+
+  for (size_t k=0; k<height; k++)
+  {
+    for (size_t i=0; i<width; i++)
+    {
+      switch (c)
+      {
+        default:
+        case RC_INTENSITY:
+          if (pixelformat == Mono8)
+          {
+            *p++=mono(i, k, phase);
+          }
+          else if (pixelformat == Mono16)
+          {
+            const uint16_t v=static_cast<uint16_t>(mono(i, k, phase)*257);
+            *p++=static_cast<uint8_t>(v&0xff);
+            *p++=static_cast<uint8_t>(v>>8);
+          }
+          else if (pixelformat == RGB8)
+          {
+            *p++=static_cast<uint8_t>((i+8*phase)&0xff);
+            *p++=static_cast<uint8_t>(k&0xff);
+            *p++=static_cast<uint8_t>((i^k)&0xff);
+          }
+          else if ((i&0x3) == 0) // YCbCr411_8, 6 bytes for 4 pixels
+          {
+            *p++=mono(i, k, phase);
+            *p++=mono(i+1, k, phase);
+            *p++=static_cast<uint8_t>(255*i/width);
+            *p++=mono(i+2, k, phase);
+            *p++=mono(i+3, k, phase);
+            *p++=static_cast<uint8_t>(255*k/height);
+          }
+          break;
+
+        case RC_DISPARITY:
+          {
+            uint16_t v=0;
+
+            if (i >= border)
+            {
+              double d=0.02*width+0.05*width*k/height+0.25*phase;
+              v=static_cast<uint16_t>(std::min(65535.0, std::floor(d/REPLAY_DISPARITY_SCALE+0.5)));
+            }
+
+            *p++=static_cast<uint8_t>(v&0xff);
+            *p++=static_cast<uint8_t>(v>>8);
+          }
+          break;
+
+        case RC_CONFIDENCE:
+          *p++=static_cast<uint8_t>(i >= border ? 255-(i&0xf) : 0);
+          break;
+
+        case RC_ERROR:
+          *p++=static_cast<uint8_t>(i >= border ? 2 : 0);
+          break;
+      }
+    }
+
+    p+=part.xpadding;
+  }
+}
+
+void ReplaySyntheticSource::fillChunk(uint8_t *p, uint32_t phase) const
+{
+  memset(p, 0, RC_CHUNK_LENGTH);
+
+  for (int c=0; c<RC_COUNT; c++)
+  {
+    const ReplayPart part=createPart(c, 0);
+    const size_t a=c*RC_CHUNK_COMPONENT_SIZE;
+
+    putValue<uint32_t>(p, a+RC_CHUNK_WIDTH, static_cast<uint32_t>(part.width));
+    putValue<uint32_t>(p, a+RC_CHUNK_HEIGHT, static_cast<uint32_t>(part.height));
+    putValue<uint32_t>(p, a+RC_CHUNK_PIXELFORMAT, static_cast<uint32_t>(part.pixelformat));
+  }
+
+  // the focal length factor and baseline are the same as reported by the
+  // virtual device
+
+  putValue<double>(p, RC_CHUNK_EXPOSURE_TIME, 5000.0+100.0*phase);
+  putValue<double>(p, RC_CHUNK_GAIN, 0.0);
+  putValue<double>(p, RC_CHUNK_FOCAL_LENGTH, 0.8*width);
+  putValue<double>(p, RC_CHUNK_BASELINE, 0.065);
+  putValue<double>(p, RC_CHUNK_PRINCIPAL_POINT_U, 0.5*width);
+  putValue<double>(p, RC_CHUNK_PRINCIPAL_POINT_V, 0.5*height);
+  putValue<double>(p, RC_CHUNK_COORDINATE_SCALE, REPLAY_DISPARITY_SCALE);
+  putValue<double>(p, RC_CHUNK_COORDINATE_OFFSET, 0.0);
+  putValue<double>(p, RC_CHUNK_INVALID_DATA_VALUE, 0.0);
+  putValue<uint32_t>(p, RC_CHUNK_INVALID_DATA_FLAG, 1);
+  putValue<uint32_t>(p, RC_CHUNK_LINE_STATUS_ALL, phase&0x1);
+}
+
+ReplayRecordingSource::ReplayRecordingSource(const std::string &name, bool _loop)
+{
+  base=0;
+  size=0;
+  loop=_loop;
+  payload_size=0;
+  rate=0;
+  span_ns=0;
+  frameid_span=0;
+
+  // map file
+
+  int fd=::open(name.c_str(), O_RDONLY);
+
+  if (fd < 0)
+  {
+    throw std::invalid_argument("Cannot open recording file: "+name);
+  }
+
+  struct stat st;
+
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < REC_ALIGN)
+  {
+    ::close(fd);
+    throw std::invalid_argument("Not a recording file: "+name);
+  }
+
+  size=static_cast<size_t>(st.st_size);
+  void *p=mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+
+  if (p == MAP_FAILED)
+  {
+    throw std::invalid_argument("Cannot map recording file: "+name);
+  }
+
+  base=static_cast<const uint8_t *>(p);
+
+  const RecHeader *header=reinterpret_cast<const RecHeader *>(base);
+
+  if (header->magic != REC_MAGIC || header->version != REC_VERSION || header->align != REC_ALIGN)
+  {
+    munmap(const_cast<uint8_t *>(base), size);
+    throw std::invalid_argument("Not a recording file or unsupported version: "+name);
+  }
+
+  // use index if file has been closed properly, otherwise scan frames
+
+  const RecTrailer *trailer=reinterpret_cast<const RecTrailer *>(base+size-sizeof(RecTrailer));
+
+  // check the number of frames first, so that the size of the index cannot
+  // overflow
+
+  const uint64_t max_frames=(size-sizeof(RecTrailer))/sizeof(RecIndexEntry);
+
+  if (trailer->magic == REC_INDEX_MAGIC && trailer->version == REC_VERSION &&
+      trailer->nframes <= max_frames &&
+      trailer->index_offset == size-sizeof(RecTrailer)-trailer->nframes*sizeof(RecIndexEntry))
+  {
+    const RecIndexEntry *entry=reinterpret_cast<const RecIndexEntry *>(base+trailer->index_offset);
+    index.assign(entry, entry+trailer->nframes);
+  }
+  else
+  {
+    size_t offset=REC_ALIGN;
+    while (offset+sizeof(RecFrame) <= size)
+    {
+      const RecFrame *f=reinterpret_cast<const RecFrame *>(base+offset);
+
+      if (f->magic != REC_FRAME_MAGIC || f->record_size == 0 || f->record_size > size-offset)
+      {
+        break;
+      }
+
+      RecIndexEntry entry;
+      entry.offset=offset;
+      entry.timestamp_ns=f->timestamp_ns;
+      entry.frameid=f->frameid;
+      index.push_back(entry);
+
+      offset+=f->record_size;
+    }
+  }
+
+  // check all frames and determine maximum payload size
+
+  for (size_t i=0; i<index.size(); i++)
+  {
+    const uint64_t offset=index[i].offset;
+    const RecFrame *f=reinterpret_cast<const RecFrame *>(base+offset);
+
+    bool valid=(offset <= size-sizeof(RecFrame) && f->magic == REC_FRAME_MAGIC &&
+                f->nparts <= REC_MAX_PARTS && f->record_size <= size-offset &&
+                f->data_offset <= f->record_size);
+
+    ReplayFrame frame;
+
+    if (valid)
+    {
+      readFrame(frame, offset);
+      valid=(frame.size <= f->record_size-f->data_offset);
+    }
+
+    if (!valid)
+    {
+      munmap(const_cast<uint8_t *>(base), size);
+      throw std::invalid_argument("Recording file is corrupt: "+name);
+    }
+
+    payload_size=std::max(payload_size, frame.size);
+  }
+
+  if (index.size() == 0)
+  {
+    munmap(const_cast<uint8_t *>(base), size);
+    throw std::invalid_argument("Recording file does not contain frames: "+name);
+  }
+
+  readFrame(first, index[0].offset);
+
+  // the time span of the recording is extended by the average time between
+  // different timestamps for replaying it in a loop
+
+  size_t distinct=1;
+  for (size_t i=1; i<index.size(); i++)
+  {
+    if (index[i].timestamp_ns != index[i-1].timestamp_ns)
+    {
+      distinct++;
+    }
+  }
+
+  const uint64_t ts0=index.front().timestamp_ns;
+  const uint64_t ts1=index.back().timestamp_ns;
+
+  if (distinct > 1 && ts1 > ts0)
+  {
+    span_ns=ts1-ts0+(ts1-ts0)/(distinct-1);
+  }
+  else
+  {
+    span_ns=40000000;
+  }
+
+  rate=1000000000.0*distinct/span_ns;
+
+  frameid_span=index.size();
+  if (index.back().frameid >= index.front().frameid)
+  {
+    frameid_span=std::max(frameid_span, index.back().frameid-index.front().frameid+1);
+  }
+}
+
+ReplayRecordingSource::~ReplayRecordingSource()
+{
+  munmap(const_cast<uint8_t *>(base), size);
+}
+
+size_t ReplayRecordingSource::getPayloadSize() const
+{
+  return payload_size;
+}
+
+double ReplayRecordingSource::getRate() const
+{
+  return rate;
+}
+
+bool ReplayRecordingSource::getFrame(ReplayFrame &frame, uint64_t n)
+{
+  const uint64_t nframes=index.size();
+  const uint64_t l=n/nframes;
+
+  if (l > 0 && !loop)
+  {
+    return false;
+  }
+
+  readFrame(frame, index[static_cast<size_t>(n%nframes)].offset);
+
+  frame.timestamp_ns+=l*span_ns;
+  frame.frameid+=l*frameid_span;
+
+  return true;
+}
+
+void ReplayRecordingSource::readFrame(ReplayFrame &frame, uint64_t offset) const
+{
+  const RecFrame *f=reinterpret_cast<const RecFrame *>(base+offset);
+
+  frame.data=base+offset+f->data_offset;
+  frame.size=f->size_filled;
+  frame.size_filled=f->size_filled;
+  frame.timestamp_ns=f->timestamp_ns;
+  frame.frameid=f->frameid;
+  frame.payload_type=f->payload_type;
+  frame.chunk_layout_id=f->chunk_layout_id;
+  frame.ypadding=f->ypadding;
+  frame.bigendian=(f->bigendian != 0);
+  frame.incomplete=(f->incomplete != 0);
+  frame.contains_chunkdata=(f->contains_chunkdata != 0);
+
+  frame.part.resize(std::min(f->nparts, REC_MAX_PARTS));
+  frame.chunk.clear();
+
+  for (size_t i=0; i<frame.part.size(); i++)
+  {
+    const RecPart &rp=f->part[i];
+    ReplayPart &p=frame.part[i];
+
+    p.offset=rp.offset;
+    p.size=rp.size;
+    p.width=rp.width;
+    p.height=rp.height;
+    p.xoffset=rp.xoffset;
+    p.yoffset=rp.yoffset;
+    p.xpadding=rp.xpadding;
+    p.pixelformat=rp.pixelformat;
+    p.source_id=rp.source_id;
+    p.datatype=rp.datatype;
+    p.image_present=(rp.image_present != 0);
+
+    frame.size=std::max(frame.size, static_cast<size_t>(rp.offset+rp.size));
+  }
+}
+
+}
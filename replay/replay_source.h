@@ -0,0 +1,303 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RC_GENICAM_API_REPLAY_SOURCE
+#define RC_GENICAM_API_REPLAY_SOURCE
+
+#include <rc_genicam_api/recording_format.h>
+
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rcg
+{
+
+/**
+  Description of one part of a replayed frame. The offset is relative to the
+  data of the frame.
+*/
+
+struct ReplayPart
+{
+  size_t offset;
+  size_t size;
+  size_t width;
+  size_t height;
+  size_t xoffset;
+  size_t yoffset;
+  size_t xpadding;
+  uint64_t pixelformat;
+  uint64_t source_id;
+  uint64_t datatype;     // GenTL part data type, only used for multi-part frames
+  bool image_present;
+};
+
+/**
+  Description of one chunk of a replayed frame, as reported by
+  DSGetBufferChunkData(). The offset is relative to the data of the frame.
+*/
+
+struct ReplayChunk
+{
+  uint64_t id;
+  size_t offset;
+  size_t length;
+};
+
+/**
+  Replayed frame. The data block contains all parts and is copied as a whole
+  into the buffer of the consumer.
+*/
+
+struct ReplayFrame
+{
+  const uint8_t *data;
+  size_t size;
+  size_t size_filled;
+  uint64_t timestamp_ns;
+  uint64_t frameid;
+  uint64_t payload_type; // GenTL payload type
+  uint64_t chunk_layout_id;
+  size_t ypadding;
+  bool bigendian;
+  bool incomplete;
+  bool contains_chunkdata;
+  std::vector<ReplayPart> part;
+  std::vector<ReplayChunk> chunk; // only known for synthetic frames
+};
+
+/**
+  Interface of all sources of frames for the replay producer.
+*/
+
+class ReplaySource
+{
+  public:
+
+    virtual ~ReplaySource() { }
+
+    /**
+      Returns the size of the largest frame in bytes.
+    */
+
+    virtual size_t getPayloadSize() const=0;
+
+    /**
+      Returns the rate with which the timestamps of the frames advance.
+
+      @return Rate in Hz.
+    */
+
+    virtual double getRate() const=0;
+
+    /**
+      Returns the n-th frame. The data of the frame is valid until the next
+      call or until the source is destroyed.
+
+      @param frame Frame to be filled.
+      @param n     Number of the frame, starting with 0.
+      @return      False if there are no more frames.
+    */
+
+    virtual bool getFrame(ReplayFrame &frame, uint64_t n)=0;
+};
+
+/**
+  Indices of the components that can be generated by ReplaySyntheticSource.
+*/
+
+enum ReplayComponent
+{
+  RC_INTENSITY, RC_DISPARITY, RC_CONFIDENCE, RC_ERROR, RC_COUNT
+};
+
+/**
+  ID and layout of the chunk that ReplaySyntheticSource appends to each
+  frame if chunks are enabled. All values are little endian. Width, height
+  and pixel format are given per component, in blocks of
+  RC_CHUNK_COMPONENT_SIZE bytes.
+*/
+
+const uint64_t RC_CHUNK_ID=0x52430001;
+
+enum ReplayChunkRegister
+{
+  RC_CHUNK_WIDTH=0x00,               // uint32 per component
+  RC_CHUNK_HEIGHT=0x04,              // uint32 per component
+  RC_CHUNK_PIXELFORMAT=0x08,         // uint32 per component
+  RC_CHUNK_COMPONENT_SIZE=0x10,
+  RC_CHUNK_EXPOSURE_TIME=0x40,       // double in us
+  RC_CHUNK_GAIN=0x48,                // double in dB
+  RC_CHUNK_FOCAL_LENGTH=0x50,        // double in pixel
+  RC_CHUNK_BASELINE=0x58,            // double in m
+  RC_CHUNK_PRINCIPAL_POINT_U=0x60,   // double in pixel
+  RC_CHUNK_PRINCIPAL_POINT_V=0x68,   // double in pixel
+  RC_CHUNK_COORDINATE_SCALE=0x70,    // double
+  RC_CHUNK_COORDINATE_OFFSET=0x78,   // double
+  RC_CHUNK_INVALID_DATA_VALUE=0x80,  // double
+  RC_CHUNK_INVALID_DATA_FLAG=0x88,   // uint32
+  RC_CHUNK_LINE_STATUS_ALL=0x8c,     // uint32
+  RC_CHUNK_LENGTH=0x90
+};
+
+/**
+  Source of synthetic frames, like a stereo camera would deliver them. The
+  intensity image contains a moving pattern, the disparity image a tilted
+  plane with an invalid border on the left side. A small number of frames is
+  generated in advance, so that the creation of the data does not affect
+  timing measurements.
+*/
+
+class ReplaySyntheticSource : public ReplaySource
+{
+  public:
+
+    /**
+      Creates the source.
+
+      @param width       Width of all images.
+      @param height      Height of all images.
+      @param pixelformat Format of the intensity image. Supported are Mono8,
+                         Mono16, RGB8 and YCbCr411_8.
+      @param component   Flags for all components that should be generated.
+      @param multipart   True for sending all components of one time slot in
+                         one multi-part buffer. Otherwise, the components are
+                         sent one after the other in single part buffers with
+                         the same timestamp.
+      @param rate        Rate in Hz with which the timestamps advance.
+      @param chunks      True for appending a chunk with the values of
+                         ReplayChunkRegister to every frame.
+    */
+
+    ReplaySyntheticSource(size_t width, size_t height, uint64_t pixelformat,
+                          const bool component[RC_COUNT], bool multipart, double rate,
+                          bool chunks=false);
+
+    size_t getPayloadSize() const;
+    double getRate() const;
+    bool getFrame(ReplayFrame &frame, uint64_t n);
+
+    /**
+      Returns true if the given format is supported for the intensity image.
+    */
+
+    static bool isFormatSupported(uint64_t pixelformat);
+
+  private:
+
+    ReplaySyntheticSource(class ReplaySyntheticSource &); // forbidden
+    ReplaySyntheticSource &operator=(const ReplaySyntheticSource &); // forbidden
+
+    ReplayPart createPart(int comp, size_t offset) const;
+    void fillPart(uint8_t *p, int comp, const ReplayPart &part, uint32_t phase) const;
+    void fillChunk(uint8_t *p, uint32_t phase) const;
+
+    size_t width;
+    size_t height;
+    uint64_t pixelformat;
+    bool multipart;
+    double rate;
+    uint64_t period_ns;
+
+    std::vector<int> comp;
+    std::vector<std::vector<ReplayPart> > layout;
+    std::vector<std::vector<ReplayChunk> > chunk;
+    std::vector<std::vector<uint8_t> > block;
+    size_t payload_size;
+};
+
+/**
+  Source of frames from a raw recording file, see RecordingWriter. The file is
+  memory mapped and can be replayed in a loop, in which case the timestamps
+  and frame IDs continue to increase.
+*/
+
+class ReplayRecordingSource : public ReplaySource
+{
+  public:
+
+    /**
+      Opens the recording file. An std::invalid_argument exception is thrown
+      if the file cannot be opened or is not a valid recording.
+
+      @param name File name.
+      @param loop True for replaying the recording in an endless loop.
+    */
+
+    ReplayRecordingSource(const std::string &name, bool loop);
+    ~ReplayRecordingSource();
+
+    size_t getPayloadSize() const;
+    double getRate() const;
+    bool getFrame(ReplayFrame &frame, uint64_t n);
+
+    /**
+      Returns the number of frames in the file.
+    */
+
+    uint64_t getNumFrames() const { return index.size(); }
+
+    /**
+      Returns information about the first frame, for presenting it as features
+      of the device.
+    */
+
+    const ReplayFrame &getFirstFrame() const { return first; }
+
+  private:
+
+    ReplayRecordingSource(class ReplayRecordingSource &); // forbidden
+    ReplayRecordingSource &operator=(const ReplayRecordingSource &); // forbidden
+
+    void readFrame(ReplayFrame &frame, uint64_t offset) const;
+
+    const uint8_t *base;
+    size_t size;
+    bool loop;
+
+    std::vector<RecIndexEntry> index;
+    size_t payload_size;
+    double rate;
+    uint64_t span_ns;
+    uint64_t frameid_span;
+    ReplayFrame first;
+};
+
+}
+
+#endif
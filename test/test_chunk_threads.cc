@@ -0,0 +1,195 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <rc_genicam_api/system.h>
+#include <rc_genicam_api/device.h>
+#include <rc_genicam_api/stream.h>
+#include <rc_genicam_api/buffer.h>
+#include <rc_genicam_api/config.h>
+
+#include <Base/GCException.h>
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cmath>
+
+/**
+  Several consumer threads take leased buffers with chunk data from the
+  acquisition thread of a stream of the replay producer. All leases share the
+  chunk adapter and chunk decoder of the stream. Each thread decodes the chunk
+  values of two components, attaches the buffers and keeps some of them for a
+  while, so that leases are released in a different order than they are
+  attached. The test checks that all decoded values are consistent.
+*/
+
+namespace
+{
+
+const int NTHREADS=4;
+const int NFRAMES=100;
+
+std::atomic<int> errors(0);
+
+bool checkChunkData(const rcg::Buffer *buffer, const char *component)
+{
+  rcg::ChunkData data;
+
+  if (!buffer->getChunkData(data, component))
+  {
+    std::cerr << "No chunk data for component " << component << std::endl;
+    return false;
+  }
+
+  if (data.width <= 0 || data.height <= 0 ||
+      std::abs(data.scan3d_focal_length-0.8*buffer->getWidth(0)) > 1e-6 ||
+      std::abs(data.scan3d_principal_point_u-0.5*buffer->getWidth(0)) > 1e-6 ||
+      std::abs(data.scan3d_baseline-0.065) > 1e-9)
+  {
+    std::cerr << "Unexpected chunk values for component " << component << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+void runConsumer(const std::shared_ptr<rcg::Stream> &stream, int k)
+{
+  std::vector<std::shared_ptr<const rcg::Buffer> > kept;
+
+  for (int i=0; i<NFRAMES && errors == 0; i++)
+  {
+    std::shared_ptr<const rcg::Buffer> buffer=stream->getNextBuffer(5000);
+
+    if (!buffer)
+    {
+      std::cerr << "Consumer " << k << ": Timeout after " << i << " frames" << std::endl;
+      errors++;
+      break;
+    }
+
+    if (buffer->getIsIncomplete() || !buffer->getContainsChunkdata())
+    {
+      continue;
+    }
+
+    if (!checkChunkData(buffer.get(), "Intensity") || !checkChunkData(buffer.get(), "Disparity"))
+    {
+      errors++;
+    }
+
+    buffer->attachChunkData();
+
+    // keep every second buffer until the next one arrives
+
+    if ((i+k)%2 == 0)
+    {
+      kept.push_back(buffer);
+    }
+
+    if (kept.size() > 1)
+    {
+      kept.erase(kept.begin());
+    }
+  }
+}
+
+}
+
+int main()
+{
+  int ret=0;
+
+  try
+  {
+    std::shared_ptr<rcg::Device> dev=rcg::getDevice("replay");
+
+    if (!dev)
+    {
+      std::cerr << "Replay device not found" << std::endl;
+      return 1;
+    }
+
+    dev->open(rcg::Device::CONTROL);
+
+    std::shared_ptr<GenApi::CNodeMapRef> nodemap=dev->getRemoteNodeMap();
+    rcg::setFloat(nodemap, "AcquisitionFrameRate", 0, true);
+    rcg::setBoolean(nodemap, "ChunkModeActive", true, true);
+
+    std::vector<std::shared_ptr<rcg::Stream> > stream=dev->getStreams();
+
+    stream[0]->open();
+    stream[0]->attachBuffers(true, true);
+    stream[0]->startStreaming(-1, 2*NTHREADS+4);
+    stream[0]->startAcquisitionThread(2*NTHREADS);
+
+    std::vector<std::thread> consumer;
+
+    for (int i=0; i<NTHREADS; i++)
+    {
+      consumer.push_back(std::thread(runConsumer, stream[0], i));
+    }
+
+    for (size_t i=0; i<consumer.size(); i++)
+    {
+      consumer[i].join();
+    }
+
+    stream[0]->stopAcquisitionThread();
+    stream[0]->stopStreaming();
+    stream[0]->close();
+    dev->close();
+
+    if (errors > 0)
+    {
+      ret=1;
+    }
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << ex.what() << std::endl;
+    ret=1;
+  }
+  catch (const GENICAM_NAMESPACE::GenericException &ex)
+  {
+    std::cerr << ex.what() << std::endl;
+    ret=1;
+  }
+
+  rcg::System::clearSystems();
+
+  return ret;
+}
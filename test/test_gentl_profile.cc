@@ -0,0 +1,225 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <rc_genicam_api/gentl_wrapper.h>
+#include <rc_genicam_api/gentl_profile.h>
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <string>
+
+/**
+  Loads the replay producer with profiling enabled, opens the device, reads
+  the XML description, streams a few frames and checks that the calls into the
+  producer have been counted and that the snapshot is ranked by total time.
+*/
+
+namespace
+{
+
+void check(GenTL::GC_ERROR err, const char *name)
+{
+  if (err != GenTL::GC_ERR_SUCCESS)
+  {
+    std::ostringstream out;
+    out << name << " failed with error " << err;
+    throw std::runtime_error(out.str());
+  }
+}
+
+uint64_t getCount(const std::vector<rcg::GenTLProfile::Function> &list, const char *name)
+{
+  for (size_t i=0; i<list.size(); i++)
+  {
+    if (list[i].name == name)
+    {
+      return list[i].counter.count;
+    }
+  }
+
+  return 0;
+}
+
+void run(rcg::GenTLWrapper &gentl)
+{
+  check(gentl.GCInitLib(), "GCInitLib");
+
+  void *tl=0;
+  check(gentl.TLOpen(&tl), "TLOpen");
+
+  bool8_t changed=0;
+  check(gentl.TLUpdateInterfaceList(tl, &changed, 0), "TLUpdateInterfaceList");
+
+  char id[256];
+  size_t size=sizeof(id);
+  check(gentl.TLGetInterfaceID(tl, 0, id, &size), "TLGetInterfaceID");
+
+  void *interf=0;
+  check(gentl.TLOpenInterface(tl, id, &interf), "TLOpenInterface");
+  check(gentl.IFUpdateDeviceList(interf, &changed, 100), "IFUpdateDeviceList");
+
+  size=sizeof(id);
+  check(gentl.IFGetDeviceID(interf, 0, id, &size), "IFGetDeviceID");
+
+  void *dev=0;
+  check(gentl.IFOpenDevice(interf, id, GenTL::DEVICE_ACCESS_CONTROL, &dev), "IFOpenDevice");
+
+  // read the beginning of the XML description
+
+  void *port=0;
+  check(gentl.DevGetPort(dev, &port), "DevGetPort");
+
+  uint64_t address=0;
+  GenTL::INFO_DATATYPE type;
+  size=sizeof(address);
+  check(gentl.GCGetPortURLInfo(port, 0, GenTL::URL_INFO_FILE_REGISTER_ADDRESS, &type, &address,
+                               &size), "GCGetPortURLInfo");
+
+  char xml[64];
+  size=sizeof(xml);
+  check(gentl.GCReadPort(port, address, xml, &size), "GCReadPort");
+
+  // stream a few frames
+
+  size=sizeof(id);
+  check(gentl.DevGetDataStreamID(dev, 0, id, &size), "DevGetDataStreamID");
+
+  void *stream=0;
+  check(gentl.DevOpenDataStream(dev, id, &stream), "DevOpenDataStream");
+
+  size_t payload=0;
+  size=sizeof(payload);
+  check(gentl.DSGetInfo(stream, GenTL::STREAM_INFO_PAYLOAD_SIZE, &type, &payload, &size),
+        "DSGetInfo");
+
+  for (int i=0; i<3; i++)
+  {
+    void *buffer=0;
+    check(gentl.DSAllocAndAnnounceBuffer(stream, payload, 0, &buffer),
+          "DSAllocAndAnnounceBuffer");
+    check(gentl.DSQueueBuffer(stream, buffer), "DSQueueBuffer");
+  }
+
+  void *event=0;
+  check(gentl.GCRegisterEvent(stream, GenTL::EVENT_NEW_BUFFER, &event), "GCRegisterEvent");
+  check(gentl.DSStartAcquisition(stream, GenTL::ACQ_START_FLAGS_DEFAULT, GENTL_INFINITE),
+        "DSStartAcquisition");
+
+  // address of the register of AcquisitionStart of the replay producer
+
+  uint32_t start=1;
+  size=sizeof(start);
+  check(gentl.GCWritePort(port, 0x1010, &start, &size), "GCWritePort");
+
+  for (int i=0; i<5; i++)
+  {
+    GenTL::EVENT_NEW_BUFFER_DATA data;
+    size=sizeof(data);
+    check(gentl.EventGetData(event, &data, &size, 5000), "EventGetData");
+
+    size_t filled=0;
+    size=sizeof(filled);
+    check(gentl.DSGetBufferInfo(stream, data.BufferHandle, GenTL::BUFFER_INFO_SIZE_FILLED, &type,
+                                &filled, &size), "DSGetBufferInfo");
+
+    check(gentl.DSQueueBuffer(stream, data.BufferHandle), "DSQueueBuffer");
+  }
+
+  check(gentl.DSStopAcquisition(stream, GenTL::ACQ_STOP_FLAGS_DEFAULT), "DSStopAcquisition");
+  check(gentl.GCUnregisterEvent(stream, GenTL::EVENT_NEW_BUFFER), "GCUnregisterEvent");
+  check(gentl.DSFlushQueue(stream, GenTL::ACQ_QUEUE_ALL_DISCARD), "DSFlushQueue");
+  check(gentl.DSClose(stream), "DSClose");
+  check(gentl.DevClose(dev), "DevClose");
+  check(gentl.IFClose(interf), "IFClose");
+  check(gentl.TLClose(tl), "TLClose");
+  check(gentl.GCCloseLib(), "GCCloseLib");
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <path to rc_genicam_replay.cti>" << std::endl;
+    return 1;
+  }
+
+  int ret=0;
+
+  try
+  {
+    rcg::setGenTLProfiling(true);
+
+    rcg::GenTLWrapper gentl(argv[1]);
+
+    run(gentl);
+
+    std::vector<rcg::GenTLProfile::Function> list=gentl.getProfilingSnapshot();
+
+    for (const char *name : { "GCReadPort", "DSGetBufferInfo", "EventGetData" })
+    {
+      if (getCount(list, name) == 0)
+      {
+        std::cerr << "No calls of " << name << " counted" << std::endl;
+        ret=1;
+      }
+    }
+
+    for (size_t i=1; i<list.size(); i++)
+    {
+      if (list[i-1].counter.total_ns < list[i].counter.total_ns)
+      {
+        std::cerr << "Functions are not ranked by total time" << std::endl;
+        ret=1;
+      }
+    }
+
+    if (gentl.getProfilingReport().find("DSGetBufferInfo") == std::string::npos)
+    {
+      std::cerr << "Report does not contain DSGetBufferInfo" << std::endl;
+      ret=1;
+    }
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << ex.what() << std::endl;
+    ret=1;
+  }
+
+  return ret;
+}
@@ -0,0 +1,225 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <rc_genicam_api/system.h>
+#include <rc_genicam_api/device.h>
+#include <rc_genicam_api/stream.h>
+#include <rc_genicam_api/buffer.h>
+#include <rc_genicam_api/shm_stream.h>
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <chrono>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+
+/**
+  Several reader processes subscribe to frames of the replay producer that
+  are published via shared memory. The first reader is killed while it holds
+  a slot. The test checks that the publisher recovers the slot and that all
+  other readers receive frames until the end.
+*/
+
+namespace
+{
+
+const int NREADERS=4;
+const int NFRAMES=50;
+
+/**
+  Reads the given number of frames. If crash is true, the process kills
+  itself while holding the third frame.
+*/
+
+int runReader(const std::string &name, bool crash)
+{
+  try
+  {
+    rcg::ShmSubscriber sub(name);
+
+    for (int i=0; i<NFRAMES; i++)
+    {
+      std::shared_ptr<const rcg::ShmFrame> frame=sub.grab(5000);
+
+      if (!frame)
+      {
+        std::cerr << "Reader " << getpid() << ": Timeout after " << i << " frames" << std::endl;
+        return 1;
+      }
+
+      if (crash && i == 2)
+      {
+        kill(getpid(), SIGKILL);
+      }
+    }
+
+    return 0;
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << "Reader " << getpid() << ": " << ex.what() << std::endl;
+  }
+
+  return 1;
+}
+
+}
+
+int main()
+{
+  std::ostringstream out;
+  out << "/rcg_test_shm_" << getpid();
+  const std::string name=out.str();
+
+  int ret=0;
+
+  try
+  {
+    // three slots, so that a slot that is held by a dead reader would block
+    // the ring quickly
+
+    rcg::ShmPublisher pub(name, 3, 16*1024*1024);
+
+    // fork readers before the device is opened and threads are started
+
+    std::vector<pid_t> reader;
+
+    for (int i=0; i<NREADERS; i++)
+    {
+      pid_t pid=fork();
+
+      if (pid == 0)
+      {
+        _exit(runReader(name, i == 0));
+      }
+
+      reader.push_back(pid);
+    }
+
+    // publish frames of the replay producer until all readers have finished
+
+    std::shared_ptr<rcg::Device> dev=rcg::getDevice("replay");
+
+    if (!dev)
+    {
+      std::cerr << "Replay device not found" << std::endl;
+      ret=1;
+    }
+    else
+    {
+      dev->open(rcg::Device::CONTROL);
+
+      std::vector<std::shared_ptr<rcg::Stream> > stream=dev->getStreams();
+
+      stream[0]->open();
+      stream[0]->startStreaming();
+
+      std::chrono::steady_clock::time_point end=std::chrono::steady_clock::now()+
+        std::chrono::seconds(30);
+
+      size_t running=reader.size();
+
+      while (running > 0 && std::chrono::steady_clock::now() < end)
+      {
+        const rcg::Buffer *buffer=stream[0]->grab(1000);
+
+        if (buffer != 0 && !buffer->getIsIncomplete())
+        {
+          pub.publish(buffer);
+        }
+
+        for (size_t i=0; i<reader.size(); i++)
+        {
+          int status;
+
+          if (reader[i] > 0 && waitpid(reader[i], &status, WNOHANG) == reader[i])
+          {
+            bool killed=WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+
+            if ((i == 0 && !killed) || (i > 0 && (!WIFEXITED(status) || WEXITSTATUS(status) != 0)))
+            {
+              std::cerr << "Reader " << i << " failed" << std::endl;
+              ret=1;
+            }
+
+            reader[i]=0;
+            running--;
+          }
+        }
+      }
+
+      stream[0]->stopStreaming();
+      stream[0]->close();
+      dev->close();
+
+      if (running > 0)
+      {
+        std::cerr << "Timeout, " << running << " readers still running" << std::endl;
+        ret=1;
+      }
+    }
+
+    for (size_t i=0; i<reader.size(); i++)
+    {
+      if (reader[i] > 0)
+      {
+        kill(reader[i], SIGKILL);
+        waitpid(reader[i], 0, 0);
+      }
+    }
+
+    std::cout << "Published: " << pub.getNumPublished() << ", dropped: " << pub.getNumDropped()
+              << ", recovered: " << pub.getNumRecovered() << std::endl;
+
+    if (pub.getNumRecovered() == 0)
+    {
+      std::cerr << "The slot of the killed reader has not been recovered" << std::endl;
+      ret=1;
+    }
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << "Exception: " << ex.what() << std::endl;
+    ret=1;
+  }
+
+  rcg::System::clearSystems();
+
+  return ret;
+}
@@ -0,0 +1,1459 @@
+/*
+ * This file is part of the rc_genicam_api package.
+ *
+ * Copyright (c) 2026 Roboception GmbH
+ * All rights reserved
+ *
+ * Author: Heiko Hirschmueller
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <rc_genicam_api/system.h>
+#include <rc_genicam_api/interface.h>
+#include <rc_genicam_api/device.h>
+#include <rc_genicam_api/stream.h>
+#include <rc_genicam_api/buffer.h>
+#include <rc_genicam_api/feature_handle.h>
+#include <rc_genicam_api/config.h>
+#include <rc_genicam_api/nodemap_out.h>
+#include <rc_genicam_api/image.h>
+#include <rc_genicam_api/image_kernels.h>
+#include <rc_genicam_api/imagelist.h>
+#include <rc_genicam_api/image_store.h>
+#include <rc_genicam_api/pointcloud.h>
+#include <rc_genicam_api/thread_pool.h>
+
+#include <rc_genicam_api/pixel_formats.h>
+
+#include <Base/GCException.h>
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <functional>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include <cstdio>
+#include <thread>
+
+#ifdef _WIN32
+#undef min
+#undef max
+#endif
+
+/**
+  Benchmarks for measuring the throughput of the library. The benchmarks are
+  meant for comparing implementations on a specific machine. The results are
+  printed as tables on std out.
+*/
+
+namespace
+{
+
+/**
+  Calls the given function repeatedly for the given time, after one call for
+  warming up, and returns the mean time of one call in seconds.
+*/
+
+double measure(const std::function<void ()> &f, double seconds)
+{
+  f();
+
+  std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+  double t=0;
+  int n=0;
+
+  do
+  {
+    f();
+    n++;
+
+    t=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+  }
+  while (t < seconds || n < 3);
+
+  return t/n;
+}
+
+/**
+  Fills the given array with pseudo random values that are always the same.
+*/
+
+void fillRandom(std::vector<uint8_t> &v)
+{
+  uint32_t s=12345;
+
+  for (size_t i=0; i<v.size(); i++)
+  {
+    s=s*1103515245+12345;
+    v[i]=static_cast<uint8_t>(s>>16);
+  }
+}
+
+/**
+  Parses a size given as <width>x<height>.
+*/
+
+void parseSize(const std::string &s, size_t &width, size_t &height)
+{
+  size_t i=s.find('x');
+
+  if (i == std::string::npos)
+  {
+    throw std::invalid_argument("Expected size as <width>x<height>: "+s);
+  }
+
+  width=static_cast<size_t>(std::stoul(s.substr(0, i)));
+  height=static_cast<size_t>(std::stoul(s.substr(i+1)));
+
+  if (width < 4 || height < 2)
+  {
+    throw std::invalid_argument("Image size is too small: "+s);
+  }
+
+  width&=~static_cast<size_t>(3);
+}
+
+/**
+  Description of one conversion that is measured with all kernel tables.
+*/
+
+struct Conversion
+{
+  const char *name;
+  uint64_t pixelformat;
+  bool rgb;
+  bool mono;
+  size_t raw_bytes_per_4_pixel;
+  std::function<void (const rcg::ImageKernels &k, uint8_t *rgb, uint8_t *mono,
+                      const uint8_t *raw, size_t n)> row;
+};
+
+/**
+  Measures the row kernels of all kernel tables that are available at runtime
+  and convertImage() with the automatically selected table in one thread. The
+  throughput is printed in Mpixel/s.
+*/
+
+int runConvert(int argc, char *argv[], int k)
+{
+  size_t width=1920, height=1200;
+  double seconds=0.5;
+
+  if (k < argc) parseSize(argv[k++], width, height);
+  if (k < argc) seconds=std::stod(argv[k++]);
+
+  std::vector<const rcg::ImageKernels *> kernels=rcg::getSupportedImageKernels();
+
+  std::vector<Conversion> conv=
+  {
+    { "Mono8 -> RGB", Mono8, true, false, 4,
+      [](const rcg::ImageKernels &k, uint8_t *rgb, uint8_t *, const uint8_t *raw, size_t n)
+      { k.monoToRGB(rgb, raw, n); } },
+    { "RGB8 -> Mono", RGB8, false, true, 12,
+      [](const rcg::ImageKernels &k, uint8_t *, uint8_t *mono, const uint8_t *raw, size_t n)
+      { k.rgbToMono(mono, raw, n); } },
+    { "YCbCr411_8 -> RGB", YCbCr411_8, true, false, 6,
+      [](const rcg::ImageKernels &k, uint8_t *rgb, uint8_t *, const uint8_t *raw, size_t n)
+      { k.ycbcr411ToRGB(rgb, raw, n); } },
+    { "YCbCr411_8 -> Mono", YCbCr411_8, false, true, 6,
+      [](const rcg::ImageKernels &k, uint8_t *, uint8_t *mono, const uint8_t *raw, size_t n)
+      { k.ycbcr411ToMono(mono, raw, n); } },
+    { "YCbCr422_8 -> RGB", YCbCr422_8, true, false, 8,
+      [](const rcg::ImageKernels &k, uint8_t *rgb, uint8_t *, const uint8_t *raw, size_t n)
+      { k.ycbcr422ToRGB(rgb, raw, n); } },
+    { "YCbCr422_8 -> Mono", YCbCr422_8, false, true, 8,
+      [](const rcg::ImageKernels &k, uint8_t *, uint8_t *mono, const uint8_t *raw, size_t n)
+      { k.ycbcr422ToMono(mono, raw, n); } },
+    { "BayerRG8 -> RGB", BayerRG8, true, false, 4, 0 },
+    { "BayerRG8 -> RGB+Mono", BayerRG8, true, true, 4, 0 }
+  };
+
+  // header with one column per kernel table and one for convertImage()
+
+  std::cout << "Mpixel/s for " << width << "x" << height << " images" << std::endl;
+  std::cout << std::endl;
+  std::cout << std::left << std::setw(22) << "Conversion" << std::right;
+
+  for (size_t i=0; i<kernels.size(); i++)
+  {
+    std::cout << std::setw(10) << kernels[i]->name;
+  }
+
+  std::cout << std::setw(14) << "convertImage" << std::endl;
+
+  // input image with one additional row at top and bottom and one additional
+  // pixel at the left and right side for the Bayer kernel
+
+  std::vector<uint8_t> raw((3*width+2)*(height+2));
+  std::vector<uint8_t> rgb(3*width*height);
+  std::vector<uint8_t> mono(width*height);
+
+  fillRandom(raw);
+
+  const double mpixel=width*height/1000000.0;
+
+  std::cout << std::fixed << std::setprecision(1);
+
+  for (size_t c=0; c<conv.size(); c++)
+  {
+    const Conversion &cv=conv[c];
+
+    std::cout << std::left << std::setw(22) << cv.name << std::right;
+
+    for (size_t i=0; i<kernels.size(); i++)
+    {
+      const rcg::ImageKernels &kt=*kernels[i];
+      uint8_t *rgb_out=cv.rgb ? rgb.data() : 0;
+      uint8_t *mono_out=cv.mono ? mono.data() : 0;
+
+      double t=measure([&]()
+      {
+        if (cv.row)
+        {
+          const size_t pstep=width/4*cv.raw_bytes_per_4_pixel;
+
+          for (size_t y=0; y<height; y++)
+          {
+            cv.row(kt, rgb_out ? rgb_out+3*y*width : 0, mono_out ? mono_out+y*width : 0,
+                   raw.data()+y*pstep, width);
+          }
+        }
+        else
+        {
+          const size_t lstep=width+2;
+          bool red=true, greenfirst=false;
+
+          for (size_t y=0; y<height; y++)
+          {
+            const uint8_t *r=raw.data()+y*lstep;
+
+            kt.bayerToRGB(rgb_out ? rgb_out+3*y*width : 0, mono_out ? mono_out+y*width : 0,
+                          r, r+lstep, r+2*lstep, red, greenfirst, width);
+
+            red=!red;
+            greenfirst=!greenfirst;
+          }
+        }
+      }, seconds);
+
+      std::cout << std::setw(10) << mpixel/t;
+    }
+
+    double t=measure([&]()
+    {
+      rcg::convertImage(cv.rgb ? rgb.data() : 0, cv.mono ? mono.data() : 0, raw.data(),
+                        cv.pixelformat, width, height, 0, 1);
+    }, seconds);
+
+    std::cout << std::setw(14) << mpixel/t << std::endl;
+  }
+
+  std::cout.unsetf(std::ios::fixed);
+
+  std::cout << std::endl;
+  std::cout << "convertImage() uses: " << rcg::getImageKernels().name << std::endl;
+
+  return 0;
+}
+
+/**
+  Measures convertImage() with 1 to the given number of threads and prints
+  the throughput in Mpixel/s and the speedup relative to one thread.
+*/
+
+int runThreads(int argc, char *argv[], int k)
+{
+  size_t width=1920, height=1200;
+  size_t nthreads=std::max(1u, std::thread::hardware_concurrency());
+  double seconds=0.5;
+
+  if (k < argc) nthreads=static_cast<size_t>(std::max(1l, std::stol(argv[k++])));
+  if (k < argc) parseSize(argv[k++], width, height);
+  if (k < argc) seconds=std::stod(argv[k++]);
+
+  struct Format
+  {
+    const char *name;
+    uint64_t pixelformat;
+    bool rgb;
+    bool mono;
+  };
+
+  std::vector<Format> format=
+  {
+    { "Mono8->RGB", Mono8, true, false },
+    { "RGB8->Mono", RGB8, false, true },
+    { "YCbCr422->RGB", YCbCr422_8, true, false },
+    { "BayerRG8->RGB", BayerRG8, true, false },
+    { "BayerRG8->RGB+Mono", BayerRG8, true, true }
+  };
+
+  std::cout << "Mpixel/s (speedup) of convertImage() for " << width << "x" << height
+            << " images with " << rcg::getImageKernels().name << " kernels" << std::endl;
+  std::cout << std::endl;
+  std::cout << std::setw(7) << "Threads";
+
+  for (size_t f=0; f<format.size(); f++)
+  {
+    std::cout << std::setw(22) << format[f].name;
+  }
+
+  std::cout << std::endl;
+
+  std::vector<uint8_t> raw(3*width*height);
+  std::vector<uint8_t> rgb(3*width*height);
+  std::vector<uint8_t> mono(width*height);
+
+  fillRandom(raw);
+
+  const double mpixel=width*height/1000000.0;
+  std::vector<double> single(format.size(), 0);
+
+  for (size_t n=1; n<=nthreads; n++)
+  {
+    std::cout << std::setw(7) << n;
+
+    for (size_t f=0; f<format.size(); f++)
+    {
+      const Format &fm=format[f];
+
+      double t=measure([&]()
+      {
+        rcg::convertImage(fm.rgb ? rgb.data() : 0, fm.mono ? mono.data() : 0, raw.data(),
+                          fm.pixelformat, width, height, 0, n);
+      }, seconds);
+
+      if (n == 1)
+      {
+        single[f]=t;
+      }
+
+      std::ostringstream out;
+      out << std::fixed << std::setprecision(1) << mpixel/t << " ("
+          << std::setprecision(2) << single[f]/t << ")";
+
+      std::cout << std::setw(22) << out.str();
+    }
+
+    std::cout << std::endl;
+  }
+
+  return 0;
+}
+
+/**
+  Returns the size of the given file in bytes.
+*/
+
+uint64_t getFileSize(const std::string &name)
+{
+  std::ifstream in(name, std::ios::binary | std::ios::ate);
+  return in ? static_cast<uint64_t>(in.tellg()) : 0;
+}
+
+/**
+  Measures the computation of a point cloud in memory and storing it as ascii
+  and binary ply file, based on a synthetic slanted plane with holes.
+*/
+
+int runPointCloud(int argc, char *argv[], int k)
+{
+  size_t width=1280, height=960;
+  size_t nthreads=0;
+  double seconds=2;
+
+  if (k < argc) parseSize(argv[k++], width, height);
+  if (k < argc) nthreads=static_cast<size_t>(std::max(0l, std::stol(argv[k++])));
+  if (k < argc) seconds=std::stod(argv[k++]);
+
+  // synthetic left, disparity, confidence and error images, disparities are
+  // in 1/16 pixel and about 3 % are invalid
+
+  std::vector<uint8_t> left(width*height);
+  std::vector<uint8_t> disp(2*width*height);
+  std::vector<uint8_t> conf(width*height);
+  std::vector<uint8_t> error(width*height);
+
+  fillRandom(left);
+  fillRandom(conf);
+  fillRandom(error);
+
+  for (size_t y=0; y<height; y++)
+  {
+    for (size_t x=0; x<width; x++)
+    {
+      size_t i=y*width+x;
+      uint16_t d=static_cast<uint16_t>(16*(20+40*x/width+10*y/height)+(left[i]&3));
+
+      if (conf[i] < 8)
+      {
+        d=0;
+      }
+
+      disp[2*i]=static_cast<uint8_t>(d&0xff);
+      disp[2*i+1]=static_cast<uint8_t>(d>>8);
+    }
+  }
+
+  std::shared_ptr<const void> owner;
+  std::shared_ptr<const rcg::Image> ileft=std::make_shared<rcg::Image>(owner, left.data(),
+    0, width, height, 0, 0, 0, 0, 1, Mono8, false);
+  std::shared_ptr<const rcg::Image> idisp=std::make_shared<rcg::Image>(owner, disp.data(),
+    0, width, height, 0, 0, 0, 0, 1, Coord3D_C16, false);
+  std::shared_ptr<const rcg::Image> iconf=std::make_shared<rcg::Image>(owner, conf.data(),
+    0, width, height, 0, 0, 0, 0, 1, Confidence8, false);
+  std::shared_ptr<const rcg::Image> ierror=std::make_shared<rcg::Image>(owner, error.data(),
+    0, width, height, 0, 0, 0, 0, 1, Error8, false);
+
+  const double f=0.8, t=0.16, scale=0.0625;
+  const std::string name="gc_benchmark_pointcloud.ply";
+
+  rcg::PointCloud pc;
+
+  double tc=measure([&]()
+  {
+    rcg::computePointCloud(pc, f, t, scale, ileft, idisp, iconf, ierror, nthreads);
+  }, seconds);
+
+  std::cout << "Point cloud from " << width << "x" << height << " disparity image with "
+            << pc.getNumPoints() << " points and " << pc.getNumTriangles() << " triangles, "
+            << rcg::ThreadPool::getNumThreads(nthreads) << " threads" << std::endl;
+  std::cout << std::endl;
+  std::cout << std::left << std::setw(12) << "Output" << std::right << std::setw(12) << "Time [ms]"
+            << std::setw(12) << "Size [MB]" << std::setw(12) << "MB/s" << std::endl;
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << std::left << std::setw(12) << "in-memory" << std::right << std::setw(12) << 1000*tc
+            << std::setw(12) << "-" << std::setw(12) << "-" << std::endl;
+
+  const char *fmtname[]={ "ascii", "binary" };
+  const rcg::PlyFmt fmt[]={ rcg::PLY_ASCII, rcg::PLY_BINARY };
+
+  for (int i=0; i<2; i++)
+  {
+    double ts=measure([&]()
+    {
+      rcg::storePointCloud(name, f, t, scale, ileft, idisp, iconf, ierror, fmt[i], nthreads);
+    }, seconds);
+
+    double mb=getFileSize(name)/1000000.0;
+
+    std::cout << std::left << std::setw(12) << fmtname[i] << std::right << std::setw(12)
+              << 1000*ts << std::setw(12) << mb << std::setw(12) << mb/ts << std::endl;
+  }
+
+  std::cout.unsetf(std::ios::fixed);
+
+  std::remove(name.c_str());
+
+  return 0;
+}
+
+/**
+  Measures adding, finding and removing images of an image list with
+  different depths and prints the mean time per operation in ns.
+*/
+
+int runImageList(int argc, char *argv[], int k)
+{
+  double seconds=0.5;
+
+  if (k < argc) seconds=std::stod(argv[k++]);
+
+  const size_t depth[]={ 25, 100, 250, 500, 1000 };
+  const size_t nops=10000;
+  const uint64_t period=40000000; // 25 Hz
+
+  // images with increasing timestamps as views onto the same pixel
+
+  static const uint8_t pixel=0;
+  std::shared_ptr<const void> owner;
+  std::vector<std::shared_ptr<const rcg::Image> > image;
+
+  for (size_t i=0; i<depth[4]+nops; i++)
+  {
+    image.push_back(std::make_shared<rcg::Image>(owner, &pixel, (i+1)*period, 1, 1, 0, 0, 0,
+                                                 0, i, Mono8, false));
+  }
+
+  // random indices for searching
+
+  std::vector<uint8_t> rnd(4*nops);
+  fillRandom(rnd);
+
+  std::cout << "ns per operation" << std::endl;
+  std::cout << std::endl;
+  std::cout << std::setw(6) << "Depth" << std::setw(10) << "add" << std::setw(10) << "find"
+            << std::setw(16) << "find tolerance" << std::setw(12) << "removeOld" << std::endl;
+
+  std::cout << std::fixed << std::setprecision(1);
+
+  for (size_t d : depth)
+  {
+    std::vector<size_t> idx(nops);
+
+    for (size_t i=0; i<nops; i++)
+    {
+      idx[i]=(rnd[4*i]|(rnd[4*i+1]<<8)|(rnd[4*i+2]<<16))%d;
+    }
+
+    // adding to a full list, which drops the oldest image
+
+    double tadd=0;
+    size_t nadd=0;
+
+    while (tadd < seconds)
+    {
+      rcg::ImageList list(d);
+
+      for (size_t i=0; i<d; i++) list.add(image[i]);
+
+      std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+
+      for (size_t i=0; i<nops; i++) list.add(image[d+i]);
+
+      tadd+=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+      nadd+=nops;
+    }
+
+    // finding exact and approximate timestamps in a full list
+
+    rcg::ImageList list(d);
+    for (size_t i=0; i<d; i++) list.add(image[i]);
+
+    size_t found=0;
+
+    double tfind=measure([&]()
+    {
+      for (size_t i=0; i<nops; i++)
+      {
+        if (list.find((idx[i]+1)*period)) found++;
+      }
+    }, seconds);
+
+    double ttol=measure([&]()
+    {
+      for (size_t i=0; i<nops; i++)
+      {
+        if (list.find((idx[i]+1)*period+1000000, period/2)) found++;
+      }
+    }, seconds);
+
+    // removing the oldest image, one after the other
+
+    double tremove=0;
+    size_t nremove=0;
+
+    while (tremove < seconds)
+    {
+      rcg::ImageList rlist(d);
+      for (size_t i=0; i<d; i++) rlist.add(image[i]);
+
+      std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+
+      for (size_t i=0; i<d; i++) rlist.removeOld(image[i]->getTimestampNS());
+
+      tremove+=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+      nremove+=d;
+    }
+
+    if (found == 0)
+    {
+      std::cerr << "Error: Images not found" << std::endl;
+      return 1;
+    }
+
+    std::cout << std::setw(6) << d << std::setw(10) << 1e9*tadd/nadd
+              << std::setw(10) << 1e9*tfind/nops << std::setw(16) << 1e9*ttol/nops
+              << std::setw(12) << 1e9*tremove/nremove << std::endl;
+  }
+
+  std::cout.unsetf(std::ios::fixed);
+
+  return 0;
+}
+
+/**
+  Creates an image with a smooth gradient and some noise, which compresses
+  similar to camera images.
+*/
+
+void fillGradient(std::vector<uint8_t> &v, size_t width, size_t height, size_t bpp)
+{
+  fillRandom(v);
+
+  for (size_t y=0; y<height; y++)
+  {
+    for (size_t x=0; x<width*bpp; x++)
+    {
+      uint8_t &p=v[y*width*bpp+x];
+      p=static_cast<uint8_t>((x/bpp*127/width+y*127/height+(p&7))&0xff);
+    }
+  }
+}
+
+/**
+  Measures storing Mono8, Mono16 and RGB8 images as PNG with different
+  presets sequentially and with n threads. The throughput is given in MB of
+  raw image data per second.
+*/
+
+int runPng(int argc, char *argv[], int k)
+{
+  size_t width=1920, height=1200;
+  size_t nthreads=rcg::ThreadPool::getNumThreads(0);
+  double seconds=1;
+
+  if (k < argc) parseSize(argv[k++], width, height);
+  if (k < argc) nthreads=static_cast<size_t>(std::max(1l, std::stol(argv[k++])));
+  if (k < argc) seconds=std::stod(argv[k++]);
+
+  struct Format
+  {
+    const char *name;
+    uint64_t pixelformat;
+    size_t bpp;
+  };
+
+  const Format format[]={ { "Mono8", Mono8, 1 }, { "Mono16", Mono16, 2 }, { "RGB8", RGB8, 3 } };
+  const char *preset[]={ "none", "fast", "default" };
+
+  std::vector<size_t> threads;
+  threads.push_back(1);
+
+  if (nthreads > 1)
+  {
+    threads.push_back(nthreads);
+  }
+
+  std::cout << "Storing " << width << "x" << height << " images as PNG" << std::endl;
+  std::cout << std::endl;
+  std::cout << std::left << std::setw(8) << "Format" << std::setw(9) << "Preset" << std::right
+            << std::setw(8) << "Threads" << std::setw(11) << "Time [ms]" << std::setw(9) << "MB/s"
+            << std::setw(11) << "Size [MB]" << std::setw(8) << "Ratio" << std::endl;
+
+  const std::string name="gc_benchmark_png";
+
+  std::cout << std::fixed;
+
+  for (const Format &f : format)
+  {
+    std::vector<uint8_t> pixel(f.bpp*width*height);
+    fillGradient(pixel, width, height, f.bpp);
+
+    std::shared_ptr<const void> owner;
+    rcg::Image image(owner, pixel.data(), 0, width, height, 0, 0, 0, 0, 1, f.pixelformat, false);
+
+    const double mb=pixel.size()/1000000.0;
+
+    for (const char *p : preset)
+    {
+      for (size_t n : threads)
+      {
+        rcg::PngOptions opt=rcg::getPngPreset(p, n);
+        uint64_t bytes=0;
+
+        double t=measure([&]()
+        {
+          std::string full=rcg::storeImage(name, rcg::PNG, image, 0, 0, opt, &bytes);
+          std::remove(full.c_str());
+        }, seconds);
+
+        std::cout << std::left << std::setw(8) << f.name << std::setw(9) << p << std::right
+                  << std::setw(8) << n << std::setprecision(1) << std::setw(11) << 1000*t
+                  << std::setw(9) << mb/t << std::setprecision(2) << std::setw(11)
+                  << bytes/1000000.0 << std::setw(8) << bytes/1000000.0/mb << std::endl;
+      }
+    }
+  }
+
+  std::cout.unsetf(std::ios::fixed);
+
+  return 0;
+}
+
+/**
+  Counts the register transactions of the remote port of a device for
+  printing the nodemap and for loading a parameter file without and with
+  batching of writes. If no parameter file is given, the current streamable
+  parameters are stored into a temporary file and loaded from there.
+*/
+
+int runPort(int argc, char *argv[], int k)
+{
+  std::string id="replay";
+  std::string file;
+
+  if (k < argc) id=argv[k++];
+  if (k < argc) file=argv[k++];
+
+  std::shared_ptr<rcg::Device> dev=rcg::getDevice(id.c_str());
+
+  if (!dev)
+  {
+    std::cerr << "Error: Device not found: " << id << std::endl;
+    return 1;
+  }
+
+  dev->open(rcg::Device::CONTROL);
+
+  std::cout << "Remote port transactions of device " << dev->getID() << std::endl;
+  std::cout << std::endl;
+  std::cout << std::left << std::setw(28) << "Operation" << std::right << std::setw(8) << "Before"
+            << std::setw(8) << "After" << std::setw(8) << "Calls" << std::endl;
+
+  uint64_t before=dev->getNumRemoteTransactions();
+  std::shared_ptr<GenApi::CNodeMapRef> nodemap=dev->getRemoteNodeMap();
+
+  auto print=[&](const char *name)
+  {
+    uint64_t after=dev->getNumRemoteTransactions();
+
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(8) << before
+              << std::setw(8) << after << std::setw(8) << after-before << std::endl;
+
+    before=after;
+  };
+
+  print("open nodemap");
+
+  // the printed nodemap itself is not of interest
+
+  std::ostringstream null;
+  std::streambuf *cout_buf=std::cout.rdbuf(null.rdbuf());
+
+  try
+  {
+    rcg::printNodemap(nodemap, "Root");
+  }
+  catch (...)
+  {
+    std::cout.rdbuf(cout_buf);
+    throw;
+  }
+
+  std::cout.rdbuf(cout_buf);
+
+  print("print nodemap");
+
+  bool remove=false;
+
+  if (file.size() == 0)
+  {
+    file="gc_benchmark_port.txt";
+    remove=true;
+
+    rcg::saveStreamableParameters(nodemap, file.c_str(), true);
+    print("save parameters");
+  }
+
+  rcg::loadStreamableParameters(nodemap, file.c_str(), true);
+  print("load parameters");
+
+  dev->startRemoteBatch();
+  rcg::loadStreamableParameters(nodemap, file.c_str(), true);
+  dev->endRemoteBatch();
+  print("load parameters (batch)");
+
+  if (remove)
+  {
+    std::remove(file.c_str());
+  }
+
+  dev->close();
+
+  return 0;
+}
+
+/**
+  Chunk values that are extracted from each buffer, like gc_stream does for
+  storing the camera parameters.
+*/
+
+struct ChunkValues
+{
+  int64_t width, height, line_status;
+  double f, t, u, v, exposure, gain, scale, offset, invalid_value;
+  bool invalid_flag;
+};
+
+/**
+  Handles of all features of ChunkValues.
+*/
+
+struct ChunkHandles
+{
+  rcg::FeatureHandle<std::string> component;
+  rcg::FeatureHandle<int64_t> width, height, line_status;
+  rcg::FeatureHandle<double> f, t, u, v, exposure, gain, scale, offset, invalid_value;
+  rcg::FeatureHandle<bool> invalid_flag;
+
+  ChunkHandles(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap) :
+    component(nodemap, "ChunkComponentSelector", true),
+    width(nodemap, "ChunkWidth", true),
+    height(nodemap, "ChunkHeight", true),
+    line_status(nodemap, "ChunkLineStatusAll", true),
+    f(nodemap, "ChunkScan3dFocalLength", true),
+    t(nodemap, "ChunkScan3dBaseline", true),
+    u(nodemap, "ChunkScan3dPrincipalPointU", true),
+    v(nodemap, "ChunkScan3dPrincipalPointV", true),
+    exposure(nodemap, "ChunkExposureTime", true),
+    gain(nodemap, "ChunkGain", true),
+    scale(nodemap, "ChunkScan3dCoordinateScale", true),
+    offset(nodemap, "ChunkScan3dCoordinateOffset", true),
+    invalid_value(nodemap, "ChunkScan3dInvalidDataValue", true),
+    invalid_flag(nodemap, "ChunkScan3dInvalidDataFlag", true)
+  { }
+};
+
+/**
+  Measures the extraction of chunk values from each received buffer of a
+  device with chunk data, i.e. through the functions of config.h that look up
+  each feature by name, through feature handles and through
+  Buffer::getChunkData(). The buffers are attached lazily, so that the first
+  two methods include attaching the buffer to the nodemap.
+*/
+
+int runChunk(int argc, char *argv[], int k)
+{
+  std::string id="replay";
+  double seconds=2;
+
+  if (k < argc) id=argv[k++];
+  if (k < argc) seconds=std::stod(argv[k++]);
+
+  std::shared_ptr<rcg::Device> dev=rcg::getDevice(id.c_str());
+
+  if (!dev)
+  {
+    std::cerr << "Error: Device not found: " << id << std::endl;
+    return 1;
+  }
+
+  dev->open(rcg::Device::CONTROL);
+
+  std::shared_ptr<GenApi::CNodeMapRef> nodemap=dev->getRemoteNodeMap();
+
+  // frames are delivered as fast as possible by the replay producer
+
+  if (dev->getID() == "replay")
+  {
+    rcg::setFloat(nodemap, "AcquisitionFrameRate", 0, true);
+  }
+
+  rcg::setBoolean(nodemap, "ChunkModeActive", true, true);
+
+  std::vector<std::shared_ptr<rcg::Stream> > stream=dev->getStreams();
+
+  if (stream.size() == 0)
+  {
+    std::cerr << "Error: Device does not offer streams: " << id << std::endl;
+    dev->close();
+    return 1;
+  }
+
+  stream[0]->open();
+  stream[0]->attachBuffers(true, true);
+  stream[0]->startStreaming();
+
+  ChunkHandles handle(nodemap);
+  const char *component[]={ "Intensity", "Disparity" };
+
+  std::function<void (const rcg::Buffer *, const char *, ChunkValues &)> method[3];
+
+  method[0]=[&nodemap](const rcg::Buffer *buffer, const char *comp, ChunkValues &c)
+  {
+    buffer->attachChunkData();
+
+    rcg::setEnum(nodemap, "ChunkComponentSelector", comp, true);
+    c.width=rcg::getInteger(nodemap, "ChunkWidth");
+    c.height=rcg::getInteger(nodemap, "ChunkHeight");
+    c.line_status=rcg::getInteger(nodemap, "ChunkLineStatusAll");
+    c.f=rcg::getFloat(nodemap, "ChunkScan3dFocalLength");
+    c.t=rcg::getFloat(nodemap, "ChunkScan3dBaseline");
+    c.u=rcg::getFloat(nodemap, "ChunkScan3dPrincipalPointU");
+    c.v=rcg::getFloat(nodemap, "ChunkScan3dPrincipalPointV");
+    c.exposure=rcg::getFloat(nodemap, "ChunkExposureTime");
+    c.gain=rcg::getFloat(nodemap, "ChunkGain");
+    c.scale=rcg::getFloat(nodemap, "ChunkScan3dCoordinateScale");
+    c.offset=rcg::getFloat(nodemap, "ChunkScan3dCoordinateOffset");
+    c.invalid_value=rcg::getFloat(nodemap, "ChunkScan3dInvalidDataValue");
+    c.invalid_flag=rcg::getBoolean(nodemap, "ChunkScan3dInvalidDataFlag");
+  };
+
+  method[1]=[&handle](const rcg::Buffer *buffer, const char *comp, ChunkValues &c)
+  {
+    buffer->attachChunkData();
+
+    handle.component.setValue(comp, true);
+    c.width=handle.width.getValue();
+    c.height=handle.height.getValue();
+    c.line_status=handle.line_status.getValue();
+    c.f=handle.f.getValue();
+    c.t=handle.t.getValue();
+    c.u=handle.u.getValue();
+    c.v=handle.v.getValue();
+    c.exposure=handle.exposure.getValue();
+    c.gain=handle.gain.getValue();
+    c.scale=handle.scale.getValue();
+    c.offset=handle.offset.getValue();
+    c.invalid_value=handle.invalid_value.getValue();
+    c.invalid_flag=handle.invalid_flag.getValue();
+  };
+
+  method[2]=[](const rcg::Buffer *buffer, const char *comp, ChunkValues &c)
+  {
+    rcg::ChunkData data;
+    buffer->getChunkData(data, comp);
+
+    c.width=data.width;
+    c.height=data.height;
+    c.line_status=data.line_status_all;
+    c.f=data.scan3d_focal_length;
+    c.t=data.scan3d_baseline;
+    c.u=data.scan3d_principal_point_u;
+    c.v=data.scan3d_principal_point_v;
+    c.exposure=data.exposure_time;
+    c.gain=data.gain;
+    c.scale=data.scan3d_coordinate_scale;
+    c.offset=data.scan3d_coordinate_offset;
+    c.invalid_value=data.scan3d_invalid_data_value;
+    c.invalid_flag=(data.scan3d_invalid_data_flag == 1);
+  };
+
+  const char *name[]={ "config.h by name", "FeatureHandle", "getChunkData()" };
+
+  std::cout << "Extracting 13 chunk values for " << sizeof(component)/sizeof(component[0])
+            << " components per buffer of device " << dev->getID() << std::endl;
+  std::cout << std::endl;
+  std::cout << std::left << std::setw(18) << "Method" << std::right << std::setw(8) << "Frames"
+            << std::setw(13) << "us / frame" << std::setw(9) << "Speedup" << std::setw(12)
+            << "Focal len." << std::endl;
+
+  std::cout << std::fixed;
+
+  double t0=0;
+
+  for (int m=0; m<3; m++)
+  {
+    ChunkValues c=ChunkValues();
+    double t=0;
+    size_t frames=0;
+
+    auto start=std::chrono::steady_clock::now();
+
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count() < seconds)
+    {
+      const rcg::Buffer *buffer=stream[0]->grab(1000);
+
+      if (buffer != 0 && !buffer->getIsIncomplete() && buffer->getContainsChunkdata())
+      {
+        auto tb=std::chrono::steady_clock::now();
+
+        for (const char *comp : component)
+        {
+          method[m](buffer, comp, c);
+        }
+
+        t+=std::chrono::duration<double>(std::chrono::steady_clock::now()-tb).count();
+        frames++;
+      }
+    }
+
+    if (frames == 0)
+    {
+      std::cerr << "Error: No buffers with chunk data received" << std::endl;
+      break;
+    }
+
+    t/=frames;
+
+    if (m == 0)
+    {
+      t0=t;
+    }
+
+    std::cout << std::left << std::setw(18) << name[m] << std::right << std::setw(8) << frames
+              << std::setprecision(2) << std::setw(13) << 1000000*t << std::setw(9) << t0/t
+              << std::setw(12) << c.f << std::endl;
+  }
+
+  std::cout.unsetf(std::ios::fixed);
+
+  stream[0]->stopStreaming();
+  stream[0]->close();
+  dev->close();
+
+  return 0;
+}
+
+/**
+  Measures the throughput of saveFile() and loadFile() of config.h with
+  different block sizes, which are limited by the FileAccessBuffer register of
+  the device. The content of the given file on the device is overwritten with
+  pseudo random data, which is verified after loading.
+*/
+
+int runFile(int argc, char *argv[], int k)
+{
+  std::string id="replay";
+  std::string name="UserData";
+  size_t mb=4;
+
+  if (k < argc) id=argv[k++];
+  if (k < argc) name=argv[k++];
+  if (k < argc) mb=static_cast<size_t>(std::max(1l, std::stol(argv[k++])));
+
+  std::shared_ptr<rcg::Device> dev=rcg::getDevice(id.c_str());
+
+  if (!dev)
+  {
+    std::cerr << "Error: Device not found: " << id << std::endl;
+    return 1;
+  }
+
+  dev->open(rcg::Device::CONTROL);
+
+  std::shared_ptr<GenApi::CNodeMapRef> nodemap=dev->getRemoteNodeMap();
+
+  std::vector<uint8_t> data(mb*1024*1024);
+  fillRandom(data);
+
+  const std::string content(data.begin(), data.end());
+
+  std::cout << "Transferring " << mb << " MB to and from file " << name
+            << " of device " << dev->getID() << std::endl;
+  std::cout << std::endl;
+  std::cout << std::setw(10) << "Block size" << std::setw(12) << "Save MB/s" << std::setw(12)
+            << "Load MB/s" << std::endl;
+
+  std::cout << std::fixed << std::setprecision(2);
+
+  // block size 0 means the maximum that is supported by the device
+
+  const size_t blocksize[]={ 512, 1024, 4096, 16384, 65536, 0 };
+  int ret=0;
+
+  for (size_t b : blocksize)
+  {
+    double ts=measure([&]()
+    {
+      std::istringstream in(content);
+      rcg::saveFile(nodemap, name.c_str(), in, true, rcg::FileProgressCallback(), b,
+                    content.size());
+    }, 0.5);
+
+    std::ostringstream out;
+
+    double tl=measure([&]()
+    {
+      out.str("");
+      rcg::loadFile(nodemap, name.c_str(), out, true, rcg::FileProgressCallback(), b);
+    }, 0.5);
+
+    if (b > 0)
+    {
+      std::cout << std::setw(10) << b;
+    }
+    else
+    {
+      std::cout << std::setw(10) << "max";
+    }
+
+    std::cout << std::setw(12) << mb/ts << std::setw(12) << mb/tl << std::endl;
+
+    if (out.str() != content)
+    {
+      std::cerr << "Error: Loaded data differs from saved data" << std::endl;
+      ret=1;
+      break;
+    }
+  }
+
+  std::cout.unsetf(std::ios::fixed);
+
+  dev->close();
+
+  return ret;
+}
+
+/**
+  Counts the calls into the GenTL producer per received multi-part buffer for
+  typical ways of reading the information of a buffer, by using the profiling
+  of all GenTL calls. The number of getter calls is given for comparison,
+  since every getter call has been at least one call into the producer before
+  the values were cached in the buffer.
+*/
+
+int runBuffer(int argc, char *argv[], int k)
+{
+  std::string id="replay";
+  size_t n=200;
+
+  if (k < argc) id=argv[k++];
+  if (k < argc) n=static_cast<size_t>(std::max(1l, std::stol(argv[k++])));
+
+  // profiling must be enabled before the producer is loaded
+
+  rcg::System::setProfiling(true);
+
+  std::shared_ptr<rcg::Device> dev=rcg::getDevice(id.c_str());
+
+  if (!dev)
+  {
+    std::cerr << "Error: Device not found: " << id << std::endl;
+    return 1;
+  }
+
+  std::shared_ptr<rcg::System> system=dev->getParent()->getParent();
+
+  dev->open(rcg::Device::CONTROL);
+
+  std::shared_ptr<GenApi::CNodeMapRef> nodemap=dev->getRemoteNodeMap();
+
+  // frames are delivered as fast as possible by the replay producer
+
+  if (dev->getID() == "replay")
+  {
+    rcg::setFloat(nodemap, "AcquisitionFrameRate", 0, true);
+  }
+
+  // enable all components and request them in multi-part buffers if
+  // supported by the device
+
+  std::vector<std::string> component;
+  rcg::getEnum(nodemap, "ComponentSelector", component, false);
+
+  for (size_t i=0; i<component.size(); i++)
+  {
+    rcg::setEnum(nodemap, "ComponentSelector", component[i].c_str(), true);
+    rcg::setBoolean(nodemap, "ComponentEnable", true, false);
+  }
+
+  rcg::setString(nodemap, "AcquisitionMultiPartMode", "SynchronizedComponents");
+
+  std::vector<std::shared_ptr<rcg::Stream> > stream=dev->getStreams();
+
+  if (stream.size() == 0)
+  {
+    std::cerr << "Error: Device does not offer streams: " << id << std::endl;
+    dev->close();
+    return 1;
+  }
+
+  stream[0]->open();
+  stream[0]->startStreaming();
+
+  // each method returns the number of getter calls
+
+  std::function<size_t (const rcg::Buffer *)> method[3];
+
+  method[0]=[](const rcg::Buffer *buffer)
+  {
+    // values that are used by the stream statistics
+
+    buffer->getTimestampNS();
+    buffer->getFrameID();
+    buffer->getIsIncomplete();
+
+    return static_cast<size_t>(3);
+  };
+
+  method[1]=[](const rcg::Buffer *buffer)
+  {
+    // values that are used for creating rcg::Image objects of all parts
+
+    size_t ret=4;
+
+    buffer->getTimestampNS();
+    buffer->getFrameID();
+    buffer->getIsIncomplete();
+
+    uint32_t npart=buffer->getNumberOfParts();
+    for (uint32_t part=0; part<npart; part++)
+    {
+      ret++;
+
+      if (buffer->getImagePresent(part))
+      {
+        buffer->getImagePresent(part);
+        buffer->getTimestampNS();
+        buffer->getWidth(part);
+        buffer->getHeight(part);
+        buffer->getXOffset(part);
+        buffer->getYOffset(part);
+        buffer->getXPadding(part);
+        buffer->getYPadding();
+        buffer->getFrameID();
+        buffer->getPixelFormat(part);
+        buffer->getSizeFilled();
+        buffer->getSize(part);
+        buffer->getBase(part);
+
+        ret+=13;
+      }
+    }
+
+    return ret;
+  };
+
+  method[2]=[](const rcg::Buffer *buffer)
+  {
+    // all numeric values of the buffer and its parts
+
+    size_t ret=20;
+
+    buffer->getGlobalBase();
+    buffer->getGlobalSize();
+    buffer->getUserPtr();
+    buffer->getTimestamp();
+    buffer->getTimestampNS();
+    buffer->getNewData();
+    buffer->getIsQueued();
+    buffer->getIsAcquiring();
+    buffer->getIsIncomplete();
+    buffer->getSizeFilled();
+    buffer->getYPadding();
+    buffer->getFrameID();
+    buffer->getPayloadType();
+    buffer->getDeliveredChunkPayloadSize();
+    buffer->getChunkLayoutID();
+    buffer->isBigEndian();
+    buffer->getDataSize();
+    buffer->getDataLargerThanBuffer();
+    buffer->getContainsChunkdata();
+
+    uint32_t npart=buffer->getNumberOfParts();
+    for (uint32_t part=0; part<npart; part++)
+    {
+      buffer->getBase(part);
+      buffer->getSize(part);
+      buffer->getPartDataType(part);
+      buffer->getWidth(part);
+      buffer->getHeight(part);
+      buffer->getXOffset(part);
+      buffer->getYOffset(part);
+      buffer->getXPadding(part);
+      buffer->getImagePresent(part);
+      buffer->getPixelFormat(part);
+      buffer->getPixelFormatNamespace(part);
+      buffer->getPartSourceID(part);
+      buffer->getPartRegionID(part);
+      buffer->getPartDataPurposeID(part);
+      buffer->getDeliveredImageHeight(part);
+
+      ret+=15;
+    }
+
+    return ret;
+  };
+
+  const char *name[]={ "statistics", "images", "all values" };
+  const char *function[]={ "DSGetBufferInfo", "DSGetBufferPartInfo", "DSGetNumBufferParts" };
+
+  std::cout << "Producer calls per buffer of device " << dev->getID() << std::endl;
+  std::cout << std::endl;
+  std::cout << std::left << std::setw(12) << "Access" << std::right << std::setw(8) << "Frames"
+            << std::setw(7) << "Parts" << std::setw(9) << "Getters" << std::setw(12) << "BufferInfo"
+            << std::setw(10) << "PartInfo" << std::setw(10) << "NumParts" << std::setw(13)
+            << "us / frame" << std::endl;
+
+  std::cout << std::fixed;
+
+  int ret=0;
+
+  for (int m=0; m<3; m++)
+  {
+    uint64_t count[3];
+
+    for (int i=0; i<3; i++)
+    {
+      count[i]=system->getProfilingCount(function[i]);
+    }
+
+    size_t frames=0, parts=0, getters=0;
+    double t=0;
+
+    while (frames < n)
+    {
+      const rcg::Buffer *buffer=stream[0]->grab(1000);
+
+      if (buffer == 0)
+      {
+        break;
+      }
+
+      auto tb=std::chrono::steady_clock::now();
+      getters+=method[m](buffer);
+      t+=std::chrono::duration<double>(std::chrono::steady_clock::now()-tb).count();
+
+      parts+=buffer->getNumberOfParts();
+      frames++;
+    }
+
+    if (frames == 0)
+    {
+      std::cerr << "Error: No buffers received" << std::endl;
+      ret=1;
+      break;
+    }
+
+    // the counts include the calls of grab(), e.g. for the payload type
+
+    std::cout << std::left << std::setw(12) << name[m] << std::right << std::setw(8) << frames
+              << std::setprecision(1) << std::setw(7) << static_cast<double>(parts)/frames
+              << std::setw(9) << static_cast<double>(getters)/frames;
+
+    for (int i=0; i<3; i++)
+    {
+      double calls=static_cast<double>(system->getProfilingCount(function[i])-count[i])/frames;
+      std::cout << std::setw(i == 0 ? 12 : 10) << calls;
+    }
+
+    std::cout << std::setprecision(2) << std::setw(13) << 1000000*t/frames << std::endl;
+  }
+
+  std::cout.unsetf(std::ios::fixed);
+
+  stream[0]->stopStreaming();
+  stream[0]->close();
+  dev->close();
+
+  return ret;
+}
+
+void printHelp(const char *prog)
+{
+  std::cout << prog << " -h | <command> [<parameters>]" << std::endl;
+  std::cout << std::endl;
+  std::cout << "Measures the throughput of parts of the library. Commands:" << std::endl;
+  std::cout << std::endl;
+  std::cout << "convert [<w>x<h> [<s>]]  Image conversion per format and kernel implementation" << std::endl;
+  std::cout << "                         (default: 1920x1200, 0.5 s per measurement)" << std::endl;
+  std::cout << "threads [<n> [<w>x<h> [<s>]]]" << std::endl;
+  std::cout << "                         Scaling of image conversion with 1 to n threads" << std::endl;
+  std::cout << "                         (default: number of cores)" << std::endl;
+  std::cout << "pointcloud [<w>x<h> [<n> [<s>]]]" << std::endl;
+  std::cout << "                         Point cloud in memory and as ascii and binary ply file" << std::endl;
+  std::cout << "                         with n threads (default: 1280x960, number of cores, 2 s)" << std::endl;
+  std::cout << "imagelist [<s>]          Adding, finding and removing images of image lists with" << std::endl;
+  std::cout << "                         25 to 1000 images" << std::endl;
+  std::cout << "png [<w>x<h> [<n> [<s>]]]" << std::endl;
+  std::cout << "                         Storing Mono8, Mono16 and RGB8 images as PNG with 1 and n" << std::endl;
+  std::cout << "                         threads (default: 1920x1200, number of cores, 1 s)" << std::endl;
+  std::cout << "port [<id> [<file>]]     Register transactions of the remote port for printing the" << std::endl;
+  std::cout << "                         nodemap and loading parameters (default: replay)" << std::endl;
+  std::cout << "chunk [<id> [<s>]]       Extraction of chunk values per buffer by name, with" << std::endl;
+  std::cout << "                         feature handles and getChunkData() (default: replay, 2 s)" << std::endl;
+  std::cout << "buffer [<id> [<n>]]      Calls into the producer per multi-part buffer for reading" << std::endl;
+  std::cout << "                         buffer information (default: replay, 200 buffers)" << std::endl;
+  std::cout << "file [<id> [<name> [<mb>]]]" << std::endl;
+  std::cout << "                         Saving and loading a file of the device with different" << std::endl;
+  std::cout << "                         block sizes. The file is overwritten! (default: replay," << std::endl;
+  std::cout << "                         UserData, 4 MB)" << std::endl;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+  int ret=0;
+
+  try
+  {
+    if (argc >= 2 && std::string(argv[1]) != "-h")
+    {
+      std::string cmd=argv[1];
+
+      if (cmd == "convert")
+      {
+        ret=runConvert(argc, argv, 2);
+      }
+      else if (cmd == "threads")
+      {
+        ret=runThreads(argc, argv, 2);
+      }
+      else if (cmd == "pointcloud")
+      {
+        ret=runPointCloud(argc, argv, 2);
+      }
+      else if (cmd == "imagelist")
+      {
+        ret=runImageList(argc, argv, 2);
+      }
+      else if (cmd == "png")
+      {
+        ret=runPng(argc, argv, 2);
+      }
+      else if (cmd == "port")
+      {
+        ret=runPort(argc, argv, 2);
+      }
+      else if (cmd == "chunk")
+      {
+        ret=runChunk(argc, argv, 2);
+      }
+      else if (cmd == "buffer")
+      {
+        ret=runBuffer(argc, argv, 2);
+      }
+      else if (cmd == "file")
+      {
+        ret=runFile(argc, argv, 2);
+      }
+      else
+      {
+        std::cerr << "Error: Unknown command: " << cmd << std::endl;
+        ret=1;
+      }
+    }
+    else
+    {
+      printHelp(argv[0]);
+      ret=1;
+    }
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << ex.what() << std::endl;
+    ret=2;
+  }
+  catch (const GENICAM_NAMESPACE::GenericException &ex)
+  {
+    std::cerr << ex.what() << std::endl;
+    ret=2;
+  }
+
+  rcg::System::clearSystems();
+
+  return ret;
+}
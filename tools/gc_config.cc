@@ -37,6 +37,7 @@
 #include <rc_genicam_api/interface.h>
 #include <rc_genicam_api/device.h>
 #include <rc_genicam_api/config.h>
+#include <rc_genicam_api/exception.h>
 
 #include <iostream>
 
@@ -193,13 +194,39 @@ int main(int argc, char *argv[])
 
               try
               {
+                dev->startRemoteBatch();
                 rcg::loadStreamableParameters(nodemap, p.substr(1).c_str(), true);
+                dev->endRemoteBatch();
               }
               catch (const std::exception &ex)
               {
                 std::cerr << "Warning: Loading of parameters from file '" << p.substr(1) <<
-                  "' failed at least partially" << std::endl;
+                  "' failed at least partially";
+
+                // writes are sent in a batch, thus the exception only knows the
+                // address of the register that failed, but not the parameter
+
+                const rcg::GenTLException *gex=dynamic_cast<const rcg::GenTLException *>(&ex);
+                if (gex != 0 && gex->hasAddress())
+                {
+                  std::cerr << " at register address 0x" << std::hex << gex->getAddress() << std::dec;
+                }
+
+                std::cerr << std::endl;
                 std::cerr << ex.what() << std::endl;
+
+                // send remaining writes if loading failed
+
+                try
+                {
+                  dev->endRemoteBatch();
+                }
+                catch (const std::exception &exf)
+                {
+                  std::cerr << "Warning: Sending remaining parameters from file '" << p.substr(1) <<
+                    "' failed" << std::endl;
+                  std::cerr << exf.what() << std::endl;
+                }
               }
             }
             else if (p.find('=') != std::string::npos)
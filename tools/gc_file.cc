@@ -42,6 +42,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <iomanip>
 #include <limits>
 
 #ifdef _WIN32
@@ -49,6 +50,30 @@
 #undef max
 #endif
 
+/**
+  Prints progress and throughput of file transfer on stderr.
+*/
+
+void printProgress(uint64_t done, uint64_t total, double seconds)
+{
+  std::cerr << "\r" << done;
+
+  if (total > 0)
+  {
+    std::cerr << " of " << total;
+  }
+
+  std::cerr << " bytes";
+
+  if (seconds > 0)
+  {
+    std::cerr << ", " << std::fixed << std::setprecision(3) << done/seconds/1000000.0 << " MB/s";
+    std::cerr.unsetf(std::ios::fixed);
+  }
+
+  std::cerr << "   " << std::flush;
+}
+
 int main(int argc, char *argv[])
 {
   int ret=0;
@@ -109,35 +134,39 @@ int main(int argc, char *argv[])
 
               if (op == "-w")
               {
-                std::ifstream in(file);
+                std::ifstream in(file, std::ios::binary);
 
                 if (!in)
                 {
                   throw std::invalid_argument("Cannot open file: "+file);
                 }
 
-                std::ostringstream buffer;
-                buffer << in.rdbuf();
-                std::string data=buffer.str();
+                in.seekg(0, std::ios::end);
+                uint64_t size=static_cast<uint64_t>(in.tellg());
+                in.seekg(0, std::ios::beg);
 
-                std::cout << "Input file length: " << data.size() << std::endl;
+                std::cout << "Input file length: " << size << std::endl;
 
-                rcg::saveFile(nodemap, devfile.c_str(), data, true);
+                rcg::saveFile(nodemap, devfile.c_str(), in, true, printProgress, 0, size);
+                std::cerr << std::endl;
               }
-              else if (op == "-r" || op == "")
+              else if (op == "-r")
               {
-                std::string data=rcg::loadFile(nodemap, devfile.c_str(), true);
+                std::ofstream out(file, std::ios::binary);
 
-                if (op == "-r")
-                {
-                  std::ofstream out(file);
-                  out << data;
-                  out.close();
-                }
-                else
+                if (!out)
                 {
-                  std::cout << data;
+                  throw std::invalid_argument("Cannot create file: "+file);
                 }
+
+                rcg::loadFile(nodemap, devfile.c_str(), out, true, printProgress);
+                std::cerr << std::endl;
+
+                out.close();
+              }
+              else if (op == "")
+              {
+                rcg::loadFile(nodemap, devfile.c_str(), std::cout, true);
               }
               else
               {
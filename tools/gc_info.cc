@@ -41,6 +41,8 @@
 #include <rc_genicam_api/nodemap_edit.h>
 
 #include <iostream>
+#include <thread>
+#include <chrono>
 
 int main(int argc, char *argv[])
 {
@@ -274,7 +276,12 @@ int main(int argc, char *argv[])
 
               if (module_event_timeout >= 0)
               {
-                dev->enableModuleEvents();
+                dev->addModuleEventCallback(-1, [](int64_t eventid, const uint8_t *, size_t)
+                {
+                  std::cout << "Received module event with ID: " << eventid << std::endl;
+                });
+
+                dev->startModuleEventDispatcher();
 
                 std::shared_ptr<GenApi::CNodeMapRef> lnodemap;
                 lnodemap=dev->getNodeMap();
@@ -301,7 +308,9 @@ int main(int argc, char *argv[])
                   {
                     // load streamable parameters from file into nodemap
 
+                    dev->startRemoteBatch();
                     rcg::loadStreamableParameters(nodemap, p.substr(1).c_str(), true);
+                    dev->endRemoteBatch();
                   }
                   else if (p.find('=') != std::string::npos)
                   {
@@ -326,17 +335,20 @@ int main(int argc, char *argv[])
                 {
                   std::cout << "Waiting for events" << std::endl;
 
-                  int64_t eventid=dev->getModuleEvent(1000*module_event_timeout);
+                  std::this_thread::sleep_for(std::chrono::seconds(module_event_timeout));
+                  dev->stopModuleEventDispatcher();
+
+                  rcg::ModuleEventStatistics stat=dev->getModuleEventStatistics();
 
-                  if (eventid < 0)
+                  if (stat.dispatched == 0)
                   {
                     std::cout << "Received no module events" << std::endl;
                   }
-
-                  while (eventid >= 0)
+                  else
                   {
-                    std::cout << "Received module event with ID: " << eventid << std::endl;
-                    eventid=dev->getModuleEvent(0);
+                    std::cout << "Dispatched module events: " << stat.dispatched
+                              << ", max. queue depth: " << stat.max_queue_depth
+                              << ", mean latency: " << stat.mean_latency << " ms" << std::endl;
                   }
 
                   std::cout << std::endl;
@@ -39,9 +39,10 @@
 #include <rc_genicam_api/stream.h>
 #include <rc_genicam_api/buffer.h>
 #include <rc_genicam_api/image.h>
-#include <rc_genicam_api/imagelist.h>
+#include <rc_genicam_api/imagesetsync.h>
 #include <rc_genicam_api/pointcloud.h>
 #include <rc_genicam_api/config.h>
+#include <rc_genicam_api/exception.h>
 
 #include <rc_genicam_api/pixel_formats.h>
 
@@ -58,13 +59,14 @@ void printHelp(const char *prgname)
 {
   // show help
 
-  std::cout << prgname << " -h | [-o <output-filename>] [<interface-id>:]<device-id> [@<file>] [<key>=<value>] ..." << std::endl;
+  std::cout << prgname << " -h | [-o <output-filename>] [-b] [<interface-id>:]<device-id> [@<file>] [<key>=<value>] ..." << std::endl;
   std::cout << std::endl;
-  std::cout << "Gets the first synchronized image set of the Roboception rc_visard, consisting of left, disparity, confidence and error image, creates a point cloud and stores it in ply ascii format." << std::endl;
+  std::cout << "Gets the first synchronized image set of the Roboception rc_visard, consisting of left, disparity, confidence and error image, creates a point cloud and stores it in ply ascii or binary format." << std::endl;
   std::cout << std::endl;
   std::cout << "Options:" << std::endl;
   std::cout << "-h        Prints help information and exits" << std::endl;
   std::cout << "-o <file> Set name of output file (default is 'rc_visard_<timestamp>.ply')" << std::endl;
+  std::cout << "-b        Store point cloud in binary instead of ascii ply format" << std::endl;
   std::cout << std::endl;
   std::cout << "Parameters:" << std::endl;
   std::cout << "<interface-id> Optional GenICam ID of interface for connecting to the device" << std::endl;
@@ -84,6 +86,7 @@ int main(int argc, char *argv[])
     // optional parameters
 
     std::string name="";
+    rcg::PlyFmt fmt=rcg::PLY_ASCII;
 
     int i=1;
 
@@ -94,6 +97,11 @@ int main(int argc, char *argv[])
         i++;
         name=argv[i++];
       }
+      else if (std::string(argv[i]) == "-b")
+      {
+        i++;
+        fmt=rcg::PLY_BINARY;
+      }
       else
       {
         std::cout << "Unknown parameter: " << argv[i] << std::endl;
@@ -202,13 +210,39 @@ int main(int argc, char *argv[])
 
           try
           {
+            dev->startRemoteBatch();
             rcg::loadStreamableParameters(nodemap, key.substr(1).c_str(), true);
+            dev->endRemoteBatch();
           }
           catch (const std::exception &ex)
           {
             std::cerr << "Warning: Loading of parameters from file '" << key.substr(1) <<
-              "' failed at least partially" << std::endl;
+              "' failed at least partially";
+
+            // writes are sent in a batch, thus the exception only knows the
+            // address of the register that failed, but not the parameter
+
+            const rcg::GenTLException *gex=dynamic_cast<const rcg::GenTLException *>(&ex);
+            if (gex != 0 && gex->hasAddress())
+            {
+              std::cerr << " at register address 0x" << std::hex << gex->getAddress() << std::dec;
+            }
+
+            std::cerr << std::endl;
             std::cerr << ex.what() << std::endl;
+
+            // send remaining writes if loading failed
+
+            try
+            {
+              dev->endRemoteBatch();
+            }
+            catch (const std::exception &exf)
+            {
+              std::cerr << "Warning: Sending remaining parameters from file '" << key.substr(1) <<
+                "' failed" << std::endl;
+              std::cerr << exf.what() << std::endl;
+            }
           }
         }
         else
@@ -246,13 +280,23 @@ int main(int argc, char *argv[])
         stream[0]->open();
         stream[0]->startStreaming();
 
-        // prepare buffers for time synchronization of images (buffer at most
-        // 25 images in each list)
+        // prepare synchronization of images, with disparity images as
+        // reference (buffer at most 25 images of each component)
+
+        rcg::ImageSetSynchronizer sync(nodemap, 25);
+
+        sync.addComponent("Disparity");
+        size_t ileft=sync.addComponent("Intensity", tol);
+        size_t iconf=sync.addComponent("Confidence");
+        size_t ierror=sync.addComponent("Error");
+
+        sync.setCallback([&](const std::vector<std::shared_ptr<const rcg::Image> > &set)
+        {
+          // compute and store point cloud from synchronized image set
 
-        rcg::ImageList left_list(50);
-        rcg::ImageList disp_list(25);
-        rcg::ImageList conf_list(25);
-        rcg::ImageList error_list(25);
+          rcg::storePointCloud(name, f, t, scale, set[ileft], set[0], set[iconf],
+                               set[ierror], fmt);
+        });
 
         bool run=true;
         int async=0, maxasync=50; // maximum number of asynchroneous images before giving up
@@ -266,85 +310,13 @@ int main(int argc, char *argv[])
           const rcg::Buffer *buffer=stream[0]->grab(5000);
           if (buffer != 0)
           {
-            // check for a complete image in the buffer
+            // in this example, we exit the grabbing loop after receiving the
+            // first synchronized image set
 
-            if (!buffer->getIsIncomplete())
+            if (sync.add(buffer) > 0)
             {
-              // go through all parts in case of multi-part buffer
-
-              size_t partn=buffer->getNumberOfParts();
-              for (uint32_t part=0; part<partn; part++)
-              {
-                if (buffer->getImagePresent(part))
-                {
-                  // store image in the corresponding list
-
-                  uint64_t left_tol=0;
-                  uint64_t disp_tol=0;
-
-                  std::string component=rcg::getComponetOfPart(nodemap, buffer, part);
-
-                  if (component == "Intensity")
-                  {
-                    left_list.add(buffer, part);
-                    disp_tol=tol;
-                  }
-                  else if (component == "Disparity")
-                  {
-                    disp_list.add(buffer, part);
-                    left_tol=tol;
-                  }
-                  else if (component == "Confidence")
-                  {
-                    conf_list.add(buffer, part);
-                    left_tol=tol;
-                  }
-                  else if (component == "Error")
-                  {
-                    error_list.add(buffer, part);
-                    left_tol=tol;
-                  }
-
-                  // get corresponding left and disparity images
-
-                  uint64_t timestamp=buffer->getTimestampNS();
-                  std::shared_ptr<const rcg::Image> left=left_list.find(timestamp, left_tol);
-                  std::shared_ptr<const rcg::Image> disp=disp_list.find(timestamp, disp_tol);
-
-                  // get confidence and error images that correspond to the
-                  // disparity image
-
-                  std::shared_ptr<const rcg::Image> conf;
-                  std::shared_ptr<const rcg::Image> error;
-
-                  if (disp)
-                  {
-                    conf=conf_list.find(disp->getTimestampNS());
-                    error=error_list.find(disp->getTimestampNS());
-                  }
-
-                  if (left && disp && conf && error)
-                  {
-                    // compute and store point cloud from synchronized image pair
-
-                    rcg::storePointCloud(name, f, t, scale, left, disp, conf, error);
-
-                    // remove all images from the buffer with the current or an
-                    // older time stamp
-
-                    async=0;
-                    left_list.removeOld(timestamp);
-                    disp_list.removeOld(timestamp);
-                    conf_list.removeOld(timestamp);
-                    error_list.removeOld(timestamp);
-
-                    // in this example, we exit the grabbing loop after receiving
-                    // the first synchronized image pair
-
-                    run=false;
-                  }
-                }
-              }
+              async=0;
+              run=false;
             }
           }
           else
@@ -40,7 +40,14 @@
 #include <rc_genicam_api/buffer.h>
 #include <rc_genicam_api/image.h>
 #include <rc_genicam_api/image_store.h>
+#include <rc_genicam_api/async_image_store.h>
+
+#ifdef INCLUDE_RECORDING
+#include <rc_genicam_api/recording.h>
+#endif
 #include <rc_genicam_api/config.h>
+#include <rc_genicam_api/exception.h>
+#include <rc_genicam_api/feature_handle.h>
 #include <rc_genicam_api/nodemap_edit.h>
 #include <rc_genicam_api/nodemap_out.h>
 
@@ -52,13 +59,17 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <atomic>
 #include <thread>
+#include <mutex>
 #include <chrono>
+#include <cmath>
 
 #ifdef _WIN32
+#include <Windows.h>
 #undef min
 #undef max
 #endif
@@ -66,6 +77,7 @@
 #ifndef _WIN32
 
 #include <iostream>
+#include <sys/resource.h>
 #include <termios.h>
 #include <unistd.h>
 #include <sys/select.h>
@@ -150,7 +162,7 @@ void printHelp()
 {
   // show help
 
-  std::cout << "gc_stream -h | [-c] [-f <fmt>] [-r <n>] [-t] [-e] [<interface-id>:]<device-id> [n=<n>] [@<file>] [<key>=<value>] ..." << std::endl;
+  std::cout << "gc_stream -h | [-c] [-f <fmt>] [-r <n>] [-w <n>] [-o <file>] [-t] [-j] [-b <s>] [-e] [<interface-id>:]<device-id> [n=<n>] [@<file>] [<key>=<value>] ..." << std::endl;
   std::cout << std::endl;
   std::cout << "Stores images from the specified device after applying the given optional GenICam parameters." << std::endl;
   std::cout << std::endl;
@@ -158,8 +170,16 @@ void printHelp()
   std::cout << "-h         Prints help information and exits" << std::endl;
   std::cout << "-c         Print ChunkDataControl category for all received buffers" << std::endl;
   std::cout << "-f pnm|png Format for storing images. Default is pnm" << std::endl;
+  std::cout << "           PNG compression can be chosen by png:default|best|fast|none" << std::endl;
   std::cout << "-r <n>     Number of times grabbing is retried. Default: 5" << std::endl;
+  std::cout << "-w <n>     Number of threads for storing images in the background. Default: 1" << std::endl;
+#ifdef INCLUDE_RECORDING
+  std::cout << "-o <file>  Record complete buffers into one raw recording file instead of storing images" << std::endl;
+#endif
   std::cout << "-t         Testmode, which does not store images and provides extended statistics" << std::endl;
+  std::cout << "-j         Print stream statistics at the end in JSON format" << std::endl;
+  std::cout << "-b <s>     Benchmark mode, which grabs for the given number of seconds (or n images" << std::endl;
+  std::cout << "           if 0) without storing or printing and reports the results in JSON format" << std::endl;
   std::cout << "-e         Allow editing of nodemap, after applying parameters and before streaming" << std::endl;
   std::cout << std::endl;
   std::cout << "Parameters:" << std::endl;
@@ -174,6 +194,122 @@ void printHelp()
 #endif
 }
 
+/**
+  Returns the given string as quoted JSON string with escaped special
+  characters.
+*/
+
+std::string toJSONString(const std::string &s)
+{
+  std::ostringstream out;
+
+  out << '"';
+
+  for (size_t i=0; i<s.size(); i++)
+  {
+    const unsigned char c=static_cast<unsigned char>(s[i]);
+
+    switch (c)
+    {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\r': out << "\\r"; break;
+      case '\t': out << "\\t"; break;
+
+      default:
+        if (c < 0x20)
+        {
+          out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+              << std::dec << std::setfill(' ');
+        }
+        else
+        {
+          out << s[i];
+        }
+        break;
+    }
+  }
+
+  out << '"';
+
+  return out.str();
+}
+
+/**
+  Prints a histogram of the stream statistics in one line as text or as JSON
+  object.
+*/
+
+void printHistogram(const char *name, const rcg::HistogramSnapshot &h, bool json)
+{
+  if (json)
+  {
+    std::cout << "  \"" << name << "\": {\"count\": " << h.count << ", \"min\": " << h.min
+              << ", \"mean\": " << h.mean << ", \"p50\": " << h.p50 << ", \"p90\": " << h.p90
+              << ", \"p99\": " << h.p99 << ", \"p999\": " << h.p999 << ", \"max\": " << h.max
+              << "}";
+  }
+  else
+  {
+    std::string label=std::string(name)+" [ms]:";
+    label.resize(std::max(label.size(), static_cast<size_t>(20)), ' ');
+
+    std::cout << label << "mean " << h.mean << ", p50 " << h.p50 << ", p90 " << h.p90 << ", p99 "
+              << h.p99 << ", p99.9 " << h.p999 << ", max " << h.max << std::endl;
+  }
+}
+
+/**
+  Prints the statistics of the stream as text or JSON. The latency is only
+  printed if the clock of the device is synchronized to the host.
+*/
+
+void printStatistics(const rcg::StreamStatisticsSnapshot &stat, bool latency, bool json)
+{
+  std::cout << std::setprecision(5);
+
+  if (json)
+  {
+    std::cout << "{" << std::endl;
+    std::cout << "  \"received\": " << stat.received << "," << std::endl;
+    std::cout << "  \"incomplete\": " << stat.incomplete << "," << std::endl;
+    std::cout << "  \"lost\": " << stat.lost << "," << std::endl;
+    std::cout << "  \"restarted\": " << stat.restarted << "," << std::endl;
+
+    if (latency)
+    {
+      printHistogram("latency", stat.latency, true);
+      std::cout << "," << std::endl;
+    }
+
+    printHistogram("interval", stat.interval, true);
+    std::cout << "," << std::endl;
+    printHistogram("jitter", stat.jitter, true);
+    std::cout << std::endl << "}" << std::endl;
+  }
+  else
+  {
+    std::cout << "Lost frame IDs:     " << stat.lost << std::endl;
+
+    if (stat.restarted > 0)
+    {
+      std::cout << "Frame ID restarts:  " << stat.restarted << std::endl;
+    }
+
+    if (latency && stat.latency.count > 0)
+    {
+      printHistogram("Latency", stat.latency, false);
+    }
+
+    if (stat.interval.count > 0)
+    {
+      printHistogram("Interval", stat.interval, false);
+      printHistogram("Jitter", stat.jitter, false);
+    }
+  }
+}
+
 /**
   Get status of digital input and output lines as separate bit fields if available.
 */
@@ -219,12 +355,52 @@ std::string getDigitalIO(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap)
 }
 
 /**
-  Store image in given buffer.
+  Collects the names of the images that have been stored by the writer
+  threads, so that they are printed by the main thread without interleaving
+  with its own output.
+*/
+
+class StoredImageNames
+{
+  public:
+
+    void add(const std::string &name)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      list.push_back(name);
+    }
+
+    void print()
+    {
+      std::vector<std::string> current;
+
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        current.swap(list);
+      }
+
+      for (size_t i=0; i<current.size(); i++)
+      {
+        std::cout << "Image '" << current[i] << "' stored" << std::endl;
+      }
+    }
+
+  private:
+
+    std::mutex mtx;
+    std::vector<std::string> list;
+};
+
+/**
+  Queue image of given buffer for storing. The image must have been created
+  from the given buffer and part.
 */
 
-std::string storeBuffer(rcg::ImgFmt fmt, const std::shared_ptr<GenApi::CNodeMapRef> &nodemap,
-                        const std::string &component, const rcg::Buffer *buffer, uint32_t part,
-                        size_t yoffset=0, size_t height=0)
+void storeBuffer(rcg::AsyncImageStore &store, rcg::ImgFmt fmt,
+                 const std::shared_ptr<GenApi::CNodeMapRef> &nodemap,
+                 const std::string &component, const rcg::Buffer *buffer,
+                 const std::shared_ptr<const rcg::Image> &image,
+                 size_t yoffset=0, size_t height=0)
 {
   // prepare file name
 
@@ -242,41 +418,32 @@ std::string storeBuffer(rcg::ImgFmt fmt, const std::shared_ptr<GenApi::CNodeMapR
 
   if (buffer->getContainsChunkdata())
   {
+    buffer->attachChunkData();
     name << getDigitalIO(nodemap);
   }
 
   // store image (see e.g. the sv tool of cvkit for show images)
 
-  std::string full_name;
-  if (!buffer->getIsIncomplete() && buffer->getImagePresent(part))
+  if (!store.storeImage(name.str(), fmt, image, yoffset, height))
   {
-    rcg::Image image(buffer, part);
-    full_name=storeImage(name.str(), fmt, image, yoffset, height);
-  }
-  else if (buffer->getIsIncomplete())
-  {
-    std::cerr << "storeBuffer(): Received incomplete buffer" << std::endl;
-  }
-  else if (!buffer->getImagePresent(part))
-  {
-    std::cerr << "storeBuffer(): Received buffer without image" << std::endl;
+    std::cerr << "storeBuffer(): Image dropped since writers are too slow" << std::endl;
   }
-
-  return full_name;
 }
 
 /**
   This method expects in the given buffer an image of format Coord3D_C16 and
   ChunkScan3d parameters in the nodemap. The chunk adapter must have already
   been attached to the nodemap. If this function succeeds, then a floating
-  point disparity image and a parameter file is stored and the name of the
-  disparity image returned.
+  point disparity image is queued for storing and true is returned, even if
+  the image had to be dropped because the queue is full.
 */
 
-std::string storeBufferAsDisparity(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap,
-                                   const rcg::Buffer *buffer, uint32_t part)
+bool storeBufferAsDisparity(rcg::AsyncImageStore &store,
+                            const std::shared_ptr<GenApi::CNodeMapRef> &nodemap,
+                            const rcg::Buffer *buffer, uint32_t part,
+                            const std::shared_ptr<const rcg::Image> &image)
 {
-  std::string dispname;
+  bool ret=false;
 
   if (!buffer->getIsIncomplete() && buffer->getImagePresent(part) &&
       buffer->getPixelFormat(part) == Coord3D_C16 && buffer->getContainsChunkdata())
@@ -285,6 +452,7 @@ std::string storeBufferAsDisparity(const std::shared_ptr<GenApi::CNodeMapRef> &n
 
     int inv=-1;
 
+    buffer->attachChunkData();
     rcg::setString(nodemap, "ChunkComponentSelector", "Disparity");
 
     if (rcg::getBoolean(nodemap, "ChunkScan3dInvalidDataFlag"))
@@ -311,8 +479,13 @@ std::string storeBufferAsDisparity(const std::shared_ptr<GenApi::CNodeMapRef> &n
 
     // store image
 
-    rcg::Image image(buffer, part);
-    dispname=storeImageAsDisparityPFM(name.str(), image, inv, static_cast<float>(scale), static_cast<float>(offset));
+    ret=true;
+
+    if (!store.storeImageAsDisparityPFM(name.str(), image, inv, static_cast<float>(scale),
+                                        static_cast<float>(offset)))
+    {
+      std::cerr << "storeBuffer(): Image dropped since writers are too slow" << std::endl;
+    }
   }
   else if (buffer->getIsIncomplete())
   {
@@ -323,7 +496,28 @@ std::string storeBufferAsDisparity(const std::shared_ptr<GenApi::CNodeMapRef> &n
     std::cerr << "storeBuffer(): Received buffer without image" << std::endl;
   }
 
-  return dispname;
+  return ret;
+}
+
+/**
+  Handles of chunk features that are read for each stored buffer, but are not
+  part of rcg::ChunkData, so that the features are looked up only once.
+*/
+
+struct ChunkParameter
+{
+  rcg::FeatureHandle<std::string> line_selector;
+  rcg::FeatureHandle<double> line_ratio;
+
+  ChunkParameter(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap) :
+    line_selector(nodemap, "ChunkLineSelector"),
+    line_ratio(nodemap, "ChunkRcLineRatio")
+  { }
+};
+
+inline double nanToZero(double v)
+{
+  return std::isnan(v) ? 0 : v;
 }
 
 /**
@@ -331,8 +525,8 @@ std::string storeBufferAsDisparity(const std::shared_ptr<GenApi::CNodeMapRef> &n
 */
 
 void storeParameter(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap,
-                    const std::string &component, const rcg::Buffer *buffer,
-                    size_t height=0, bool dispinfo=false)
+                    const ChunkParameter &chunk, const std::string &component,
+                    const rcg::Buffer *buffer, size_t height=0, bool dispinfo=false)
 {
   if (buffer->getContainsChunkdata())
   {
@@ -352,33 +546,35 @@ void storeParameter(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap,
 
     // Append out1 and out2 status to file name: _<out1>_<out2>
 
+    buffer->attachChunkData();
     name << getDigitalIO(nodemap);
     name << "_param.txt";
 
-    // get 3D parameter
+    // get 3D parameter, decoded directly from the chunk data
 
-    rcg::setString(nodemap, "ChunkComponentSelector", component.c_str());
+    rcg::ChunkData data;
+    buffer->getChunkData(data, component);
 
-    int width=static_cast<int>(rcg::getInteger(nodemap, "ChunkWidth"));
-    if (height == 0) height=rcg::getInteger(nodemap, "ChunkHeight");
-    double f=rcg::getFloat(nodemap, "ChunkScan3dFocalLength");
-    double t=rcg::getFloat(nodemap, "ChunkScan3dBaseline");
-    double u=rcg::getFloat(nodemap, "ChunkScan3dPrincipalPointU");
-    double v=rcg::getFloat(nodemap, "ChunkScan3dPrincipalPointV");
-    double exp=rcg::getFloat(nodemap, "ChunkExposureTime")/1000000.0;
-    double gain=rcg::getFloat(nodemap, "ChunkGain");
+    int width=static_cast<int>(data.width);
+    if (height == 0 && data.height > 0) height=static_cast<size_t>(data.height);
+    double f=data.scan3d_focal_length;
+    double t=data.scan3d_baseline;
+    double u=nanToZero(data.scan3d_principal_point_u);
+    double v=nanToZero(data.scan3d_principal_point_v);
+    double exp=nanToZero(data.exposure_time)/1000000.0;
+    double gain=nanToZero(data.gain);
     int inv=-1;
     double scale=0, offset=0;
 
     if (dispinfo)
     {
-      if (rcg::getBoolean(nodemap, "ChunkScan3dInvalidDataFlag"))
+      if (data.scan3d_invalid_data_flag == 1)
       {
-        inv=static_cast<int>(rcg::getFloat(nodemap, "ChunkScan3dInvalidDataValue"));
+        inv=static_cast<int>(nanToZero(data.scan3d_invalid_data_value));
       }
 
-      scale=rcg::getFloat(nodemap, "ChunkScan3dCoordinateScale");
-      offset=rcg::getFloat(nodemap, "ChunkScan3dCoordinateOffset");
+      scale=nanToZero(data.scan3d_coordinate_scale);
+      offset=nanToZero(data.scan3d_coordinate_offset);
     }
 
     // create parameter file
@@ -397,36 +593,27 @@ void storeParameter(const std::shared_ptr<GenApi::CNodeMapRef> &nodemap,
       out << "rho=" << f*t << std::endl;
       out << "t=" << t << std::endl;
 
-      try
+      if (!std::isnan(data.rc_noise))
       {
-        float v=static_cast<float>(rcg::getFloat(nodemap, "ChunkRcNoise", 0, 0, true));
-        out << "camera.noise=" << v << std::endl;
+        out << "camera.noise=" << static_cast<float>(data.rc_noise) << std::endl;
       }
-      catch (const std::exception &)
-      { }
 
-      try
+      if (!std::isnan(data.rc_brightness))
       {
-        float v=static_cast<float>(rcg::getFloat(nodemap, "ChunkRcBrightness", 0, 0, true));
-        out << "camera.brightness=" << v << std::endl;
+        out << "camera.brightness=" << static_cast<float>(data.rc_brightness) << std::endl;
       }
-      catch (const std::exception &)
-      { }
 
-      try
+      if (!std::isnan(data.rc_out1_reduction))
       {
-        float v=static_cast<float>(rcg::getFloat(nodemap, "ChunkRcOut1Reduction", 0, 0, true));
-        out << "camera.out1_reduction=" << v << std::endl;
+        out << "camera.out1_reduction=" << static_cast<float>(data.rc_out1_reduction) << std::endl;
       }
-      catch (const std::exception &)
-      { }
 
       for (int i=0; i<4; i++)
       {
         try
         {
-          rcg::setEnum(nodemap, "ChunkLineSelector", ("Out"+std::to_string(i)).c_str(), true);
-          float v=static_cast<float>(rcg::getFloat(nodemap, "ChunkRcLineRatio", 0, 0, true));
+          chunk.line_selector.setValue("Out"+std::to_string(i), true);
+          float v=static_cast<float>(chunk.line_ratio.getValue(true));
           out << "camera.out" << i << "_ratio=" << v << std::endl;
         }
         catch (const std::exception &)
@@ -471,6 +658,170 @@ void checkUserInterrupt()
 
 #endif
 
+/**
+  Returns the CPU time in seconds that has been used by this process so far.
+*/
+
+double getProcessCPUTime()
+{
+#ifdef _WIN32
+  FILETIME tcreate, texit, tkernel, tuser;
+
+  if (GetProcessTimes(GetCurrentProcess(), &tcreate, &texit, &tkernel, &tuser))
+  {
+    ULARGE_INTEGER k, u;
+
+    k.LowPart=tkernel.dwLowDateTime;
+    k.HighPart=tkernel.dwHighDateTime;
+    u.LowPart=tuser.dwLowDateTime;
+    u.HighPart=tuser.dwHighDateTime;
+
+    return (k.QuadPart+u.QuadPart)*1.0e-7;
+  }
+#else
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+  {
+    return usage.ru_utime.tv_sec+usage.ru_utime.tv_usec*1.0e-6+
+      usage.ru_stime.tv_sec+usage.ru_stime.tv_usec*1.0e-6;
+  }
+#endif
+
+  return 0;
+}
+
+/**
+  Grabs for the given duration in seconds or the given number of images if
+  the duration is 0, without any I/O per image. Each buffer is given back to
+  the transport layer directly after receiving it. The results are printed in
+  JSON format.
+*/
+
+int runBenchmark(const std::shared_ptr<rcg::Stream> &stream,
+                 const std::shared_ptr<GenApi::CNodeMapRef> &nodemap, const std::string &devid,
+                 double duration, int n)
+{
+  stream->open();
+  stream->startStreaming();
+
+  rcg::Histogram grab_to_release, requeue;
+  uint64_t frames=0, incomplete=0, bytes=0;
+  double cpu_start=0;
+
+  auto time_start=std::chrono::steady_clock::now();
+  auto time_stop=time_start+std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(duration));
+  auto time_last=time_start;
+  auto time_first=time_start;
+
+  while (!user_interrupt)
+  {
+    auto t0=std::chrono::steady_clock::now();
+
+    if ((duration > 0 && t0 >= time_stop) || (duration <= 0 && frames >= static_cast<uint64_t>(n)))
+    {
+      break;
+    }
+
+    std::shared_ptr<const rcg::Buffer> buffer=stream->grabLeased(100);
+
+    if (buffer)
+    {
+      auto t1=std::chrono::steady_clock::now();
+
+      if (frames == 0)
+      {
+        time_first=t1;
+        cpu_start=getProcessCPUTime();
+      }
+
+      if (buffer->getIsIncomplete())
+      {
+        incomplete++;
+      }
+      else if (frames > 0)
+      {
+        // the measured interval starts with the first frame, thus only the
+        // data of the following frames is counted, like for the frame rate
+
+        bytes+=buffer->getSizeFilled();
+      }
+
+      frames++;
+
+      // give the buffer back and measure the time from calling grabLeased()
+      // until release as well as the time of giving the buffer back to the
+      // transport layer
+
+      auto t2=std::chrono::steady_clock::now();
+
+      buffer.reset();
+
+      time_last=std::chrono::steady_clock::now();
+      grab_to_release.add(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time_last-t0).count()));
+      requeue.add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        time_last-t2).count()));
+    }
+    else if (t0-time_last > std::chrono::seconds(3))
+    {
+      std::cerr << "Cannot grab images" << std::endl;
+      break;
+    }
+  }
+
+  double cpu=getProcessCPUTime()-cpu_start;
+  double seconds=std::chrono::duration<double>(time_last-time_first).count();
+
+  uint64_t underrun=stream->getNumUnderrun();
+  size_t nbuffers=stream->getNumAnnounced();
+  rcg::StreamStatisticsSnapshot sstat=stream->getStatistics();
+
+  stream->stopStreaming();
+  stream->close();
+
+  // report results
+
+  double fps=0, mbps=0, cpu_percent=0;
+
+  if (seconds > 0)
+  {
+    fps=(frames-1)/seconds;
+    mbps=bytes/(1024.0*1024.0)/seconds;
+    cpu_percent=100*cpu/seconds;
+  }
+
+  std::cout << std::setprecision(5);
+  std::cout << "{" << std::endl;
+  std::cout << "  \"device\": " << toJSONString(devid) << "," << std::endl;
+  std::cout << "  \"pixel_format\": " << toJSONString(rcg::getEnum(nodemap, "PixelFormat", false))
+            << "," << std::endl;
+  std::cout << "  \"payload_size\": " << rcg::getInteger(nodemap, "PayloadSize", 0, 0, false)
+            << "," << std::endl;
+  std::cout << "  \"packet_size\": " << rcg::getInteger(nodemap, "GevSCPSPacketSize", 0, 0,
+                                                            false) << "," << std::endl;
+  std::cout << "  \"buffers\": " << nbuffers << "," << std::endl;
+  std::cout << "  \"frames\": " << frames << "," << std::endl;
+  std::cout << "  \"incomplete\": " << incomplete << "," << std::endl;
+  std::cout << "  \"lost\": " << sstat.lost << "," << std::endl;
+  std::cout << "  \"underrun\": " << underrun << "," << std::endl;
+  std::cout << "  \"seconds\": " << seconds << "," << std::endl;
+  std::cout << "  \"frames_per_second\": " << fps << "," << std::endl;
+  std::cout << "  \"mb_per_second\": " << mbps << "," << std::endl;
+  std::cout << "  \"cpu_percent\": " << cpu_percent << "," << std::endl;
+  printHistogram("grab_to_release", grab_to_release.getSnapshot(), true);
+  std::cout << "," << std::endl;
+  printHistogram("requeue", requeue.getSnapshot(), true);
+  std::cout << "," << std::endl;
+  printHistogram("interval", sstat.interval, true);
+  std::cout << "," << std::endl;
+  printHistogram("jitter", sstat.jitter, true);
+  std::cout << std::endl << "}" << std::endl;
+
+  return frames > incomplete ? 0 : 1;
+}
+
 }
 
 int main(int argc, char *argv[])
@@ -484,8 +835,13 @@ int main(int argc, char *argv[])
     bool print_chunk_data=false;
     bool store=true;
     int nretry=5;
+    int nwriter=1;
+    std::string recname;
     rcg::ImgFmt fmt=rcg::PNM;
+    rcg::PngOptions png;
     bool edit=false;
+    bool json=false;
+    double benchmark=-1;
     int i=1;
 
     // get parameters
@@ -509,6 +865,25 @@ int main(int argc, char *argv[])
         store=false;
         i++;
       }
+      else if (param == "-j")
+      {
+        json=true;
+        i++;
+      }
+      else if (param == "-b")
+      {
+        i++;
+
+        if (i < argc)
+        {
+          benchmark=std::max(0.0, std::stod(argv[i]));
+          i++;
+        }
+        else
+        {
+          throw std::invalid_argument("Argument expected after '-b'!");
+        }
+      }
       else if (param == "-r")
       {
         i++;
@@ -523,6 +898,36 @@ int main(int argc, char *argv[])
           throw std::invalid_argument("Argument expected after '-r'!");
         }
       }
+      else if (param == "-w")
+      {
+        i++;
+
+        if (i < argc)
+        {
+          nwriter=std::max(1, std::stoi(argv[i]));
+          i++;
+        }
+        else
+        {
+          throw std::invalid_argument("Argument expected after '-w'!");
+        }
+      }
+#ifdef INCLUDE_RECORDING
+      else if (param == "-o")
+      {
+        i++;
+
+        if (i < argc)
+        {
+          recname=argv[i];
+          i++;
+        }
+        else
+        {
+          throw std::invalid_argument("Argument expected after '-o'!");
+        }
+      }
+#endif
       else if (param == "-f")
       {
         i++;
@@ -538,6 +943,11 @@ int main(int argc, char *argv[])
           {
             fmt=rcg::PNG;
           }
+          else if (imgfmt.compare(0, 4, "png:") == 0)
+          {
+            fmt=rcg::PNG;
+            png=rcg::getPngPreset(imgfmt.substr(4));
+          }
           else
           {
             throw std::invalid_argument(std::string("Invalid argument of '-f': ")+argv[i]);
@@ -591,13 +1001,39 @@ int main(int argc, char *argv[])
 
             try
             {
+              dev->startRemoteBatch();
               rcg::loadStreamableParameters(nodemap, key.substr(1).c_str(), true);
+              dev->endRemoteBatch();
             }
             catch (const std::exception &ex)
             {
               std::cerr << "Warning: Loading of parameters from file '" << key.substr(1) <<
-                "' failed at least partially" << std::endl;
+                "' failed at least partially";
+
+              // writes are sent in a batch, thus the exception only knows the
+              // address of the register that failed, but not the parameter
+
+              const rcg::GenTLException *gex=dynamic_cast<const rcg::GenTLException *>(&ex);
+              if (gex != 0 && gex->hasAddress())
+              {
+                std::cerr << " at register address 0x" << std::hex << gex->getAddress() << std::dec;
+              }
+
+              std::cerr << std::endl;
               std::cerr << ex.what() << std::endl;
+
+              // send remaining writes if loading failed
+
+              try
+              {
+                dev->endRemoteBatch();
+              }
+              catch (const std::exception &exf)
+              {
+                std::cerr << "Warning: Sending remaining parameters from file '" << key.substr(1) <<
+                  "' failed" << std::endl;
+                std::cerr << exf.what() << std::endl;
+              }
             }
           }
           else
@@ -690,8 +1126,10 @@ int main(int argc, char *argv[])
           std::cout << std::endl;
         }
 
-        // print enabled streams
+        // print enabled streams, except in benchmark mode, which only prints
+        // the results
 
+        if (benchmark < 0)
         {
           std::vector<std::string> component;
 
@@ -720,7 +1158,16 @@ int main(int argc, char *argv[])
 
         std::vector<std::shared_ptr<rcg::Stream> > stream=dev->getStreams();
 
-        if (stream.size() > 0)
+        if (stream.size() > 0 && benchmark >= 0)
+        {
+#ifdef _WIN32
+          std::thread thread_cui(checkUserInterrupt);
+          thread_cui.detach();
+#endif
+
+          ret=runBenchmark(stream[0], nodemap, dev->getID(), benchmark, n);
+        }
+        else if (stream.size() > 0)
         {
 #ifdef _WIN32
           // start background thread for checking user input
@@ -731,20 +1178,50 @@ int main(int argc, char *argv[])
           // opening first stream
 
           stream[0]->open();
-          stream[0]->attachBuffers(true);
+          // buffers are only attached to the nodemap if chunk values are
+          // needed, e.g. for storing images
+
+          stream[0]->attachBuffers(true, true);
           stream[0]->startStreaming();
 
           std::cout << "Package size: " << rcg::getString(nodemap, "GevSCPSPacketSize") << std::endl;
 
+          // look up chunk features only once
+
+          ChunkParameter chunk(nodemap);
+
 #ifdef _WIN32
           std::cout << "Press 'Enter' to abort grabbing." << std::endl;
 #endif
           std::cout << std::endl;
 
+          // start writer threads for storing images in the background
+
+          std::unique_ptr<rcg::AsyncImageStore> writer;
+          StoredImageNames stored_names;
+
+#ifdef INCLUDE_RECORDING
+          std::unique_ptr<rcg::RecordingWriter> recorder;
+
+          if (store && recname.size() > 0)
+          {
+            recorder.reset(new rcg::RecordingWriter(recname));
+          }
+          else
+#endif
+          if (store)
+          {
+            writer.reset(new rcg::AsyncImageStore(static_cast<size_t>(nwriter), 8*nwriter));
+            writer->setPngOptions(png);
+            writer->setCallback([&stored_names](const std::string &name)
+            {
+              stored_names.add(name);
+            });
+          }
+
           int buffers_received=0;
           int buffers_incomplete=0;
           auto time_start=std::chrono::steady_clock::now();
-          double latency_ns=0;
 
           bool triggered=(rcg::getEnum(nodemap, "TriggerMode", false) == "On");
 
@@ -776,37 +1253,53 @@ int main(int argc, char *argv[])
 
                 if (!buffer->getIsIncomplete())
                 {
-                  // store images in all parts
+                  // record complete buffer or store images in all parts
 
+#ifdef INCLUDE_RECORDING
+                  if (recorder)
+                  {
+                    recorder->append(buffer);
+                    retry=0;
+                  }
+                  else
+#endif
                   if (store)
                   {
+                    // the component name may be taken from chunk data
+
+                    buffer->attachChunkData();
+
                     uint32_t npart=buffer->getNumberOfParts();
                     for (uint32_t part=0; part<npart; part++)
                     {
                       if (buffer->getImagePresent(part))
                       {
-                        std::string name;
+                        bool stored=false;
 
                         // get component name
 
                         std::string component=rcg::getComponetOfPart(nodemap, buffer, part);
 
+                        // copy image, since the buffer is only valid until
+                        // the next grab
+
+                        std::shared_ptr<const rcg::Image> image(new rcg::Image(buffer, part));
+
                         // try storing disparity as float image with meta information
 
                         if (component == "Disparity" && fmt == rcg::PNM)
                         {
-                          name=storeBufferAsDisparity(nodemap, buffer, part);
+                          stored=storeBufferAsDisparity(*writer, nodemap, buffer, part, image);
 
-                          if (name.size() != 0)
+                          if (stored)
                           {
-                            std::cout << "Image '" << name << "' stored" << std::endl;
-                            storeParameter(nodemap, component, buffer);
+                            storeParameter(nodemap, chunk, component, buffer);
                           }
                         }
 
                         // otherwise, store as ordinary image
 
-                        if (name.size() == 0)
+                        if (!stored)
                         {
                           if (component == "IntensityCombined" || component == "RawCombined")
                           {
@@ -816,53 +1309,40 @@ int main(int argc, char *argv[])
                             std::string comp_name = component.substr(0, component.size() - 8);
 
                             size_t h2=buffer->getHeight(part)/2;
-                            name=storeBuffer(fmt, nodemap, comp_name, buffer, part, 0, h2);
-
-                            if (name.size() > 0)
-                            {
-                              std::cout << "Image '" << name << "' stored" << std::endl;
-                            }
-
-                            name=storeBuffer(fmt, nodemap, comp_name.append("Right"), buffer, part, h2, h2);
-
-                            if (name.size() > 0)
-                            {
-                              std::cout << "Image '" << name << "' stored" << std::endl;
-                            }
+                            storeBuffer(*writer, fmt, nodemap, comp_name, buffer, image, 0, h2);
+                            storeBuffer(*writer, fmt, nodemap, comp_name.append("Right"), buffer,
+                                        image, h2, h2);
                           }
                           else
                           {
-                            name=storeBuffer(fmt, nodemap, component, buffer, part);
-
-                            if (name.size() > 0)
-                            {
-                              std::cout << "Image '" << name << "' stored" << std::endl;
-                            }
+                            storeBuffer(*writer, fmt, nodemap, component, buffer, image);
                           }
 
+                          stored=true;
+
                           // store 3D parameters for intensity and disparity
                           // components (nothing is done if chunk parameters are
                           // not available)
 
                           if (component == "Intensity")
                           {
-                            storeParameter(nodemap, component, buffer);
+                            storeParameter(nodemap, chunk, component, buffer);
                           }
                           else if (component == "Disparity")
                           {
-                            storeParameter(nodemap, component, buffer, 0, true);
+                            storeParameter(nodemap, chunk, component, buffer, 0, true);
                           }
                           else if (component == "IntensityCombined" || component == "RawCombined")
                           {
                             std::string comp_name = component.substr(0, component.size() - 8);
                             size_t h2=buffer->getHeight(part)/2;
-                            storeParameter(nodemap, comp_name, buffer, h2, false);
+                            storeParameter(nodemap, chunk, comp_name, buffer, h2, false);
                           }
                         }
 
                         // report success
 
-                        if (name.size() > 0)
+                        if (stored)
                         {
                           retry=0;
                         }
@@ -879,19 +1359,14 @@ int main(int argc, char *argv[])
                     std::cout << "Received buffer with timestamp: " << t_sec << "."
                               << std::setfill('0') << std::setw(9) << t_nsec << std::endl;
                     retry=0;
-
-                    // accumulate mean latency
-
-                    auto current=std::chrono::system_clock::now();
-                    latency_ns+=
-                      static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(current.time_since_epoch()).count())-
-                      static_cast<double>(buffer->getTimestampNS());
                   }
 
                   // optinally print chunk data
 
                   if (print_chunk_data)
                   {
+                    buffer->attachChunkData();
+
                     // apply chunk parameters
 
                     for (size_t i=0; i<chunk_param.size(); i++)
@@ -932,13 +1407,44 @@ int main(int argc, char *argv[])
                 retry--;
               }
             }
+
+            // report images that have been stored in the meantime
+
+            stored_names.print();
           }
 
           auto time_stop=std::chrono::steady_clock::now();
 
+          rcg::StreamStatisticsSnapshot sstat=stream[0]->getStatistics();
+
           stream[0]->stopStreaming();
           stream[0]->close();
 
+          // close recording and wait for storing all remaining images
+
+#ifdef INCLUDE_RECORDING
+          uint64_t recorded=0, recorded_bytes=0;
+
+          if (recorder)
+          {
+            recorder->close();
+            recorded=recorder->getNumFrames();
+            recorded_bytes=recorder->getNumBytes();
+            recorder.reset();
+          }
+#endif
+
+          rcg::AsyncImageStoreStatistics wstat;
+
+          if (writer)
+          {
+            writer->flush();
+            wstat=writer->getStatistics();
+            writer.reset();
+
+            stored_names.print();
+          }
+
           // report received and incomplete buffers
 
           std::cout << std::endl;
@@ -949,20 +1455,37 @@ int main(int argc, char *argv[])
                     << 1000.0*buffers_received/std::chrono::duration_cast<std::chrono::milliseconds>(time_stop-time_start).count()
                     << std::endl;
 
-          if (!store)
+#ifdef INCLUDE_RECORDING
+          if (store && recname.size() > 0)
           {
-            if (rcg::getBoolean(nodemap, "PtpEnable") || rcg::getBoolean(nodemap, "GevIEEE1588"))
-            {
-              if (buffers_received-buffers_incomplete > 0)
-              {
-                latency_ns/=buffers_received-buffers_incomplete;
-              }
+            std::cout << "Recorded buffers:   " << recorded << std::endl;
+            std::cout << "Recorded MB:        " << std::setprecision(3)
+                      << recorded_bytes/(1024.0*1024.0) << std::endl;
+          }
+          else
+#endif
+          if (store)
+          {
+            std::cout << "Stored images:      " << wstat.written << std::endl;
+            std::cout << "Dropped images:     " << wstat.dropped << std::endl;
+            std::cout << "Failed images:      " << wstat.failed << std::endl;
+            std::cout << "Max. write queue:   " << wstat.max_queue_depth << std::endl;
+            std::cout << "MB per second:      " << std::setprecision(3)
+                      << wstat.bytes_per_second/(1024*1024) << std::endl;
+          }
 
-              std::cout << "Mean latency:       " << std::setprecision(5) << latency_ns/1.0e6
-                        << " ms" << std::endl;
-            }
+          // report statistics of the stream
+
+          bool synchronized=rcg::getBoolean(nodemap, "PtpEnable") ||
+            rcg::getBoolean(nodemap, "GevIEEE1588");
+
+          if (json)
+          {
+            std::cout << std::endl;
           }
 
+          printStatistics(sstat, synchronized, json);
+
           // return error code if no images could be received
 
           if (buffers_incomplete == buffers_received)